@@ -12,6 +12,7 @@ static matf32_t m1;
 static float m2data[MAX_MAT_SIZE];
 static matf32_t m2;
 static float p1[MAX_VEC_SIZE];
+static matf32_band_t band;
 
 
 void
@@ -38,6 +39,10 @@ print_linsolve_method(linsolve_method_t lsm)
         case LU:
             printf("LU\n");
             break;
+
+        case BANDED:
+            printf("BANDED\n");
+            break;
     }
 }
 
@@ -69,6 +74,15 @@ matf32_linsolve_get_method(const matf32_t* const p_a)
         return CHOLESKY;
     }
 
+    // banded matrix, only worth it while the band covers less than half of the matrix
+    uint16_t kl, ku;
+    matf32_bandwidth(p_a, &kl, &ku);
+
+    if (2*(kl + ku) < p_a->num_rows)
+    {
+        return BANDED;
+    }
+
     // add method for hessenberg?
 
     return LU; //general square solver
@@ -330,7 +344,15 @@ matf32_qr(const matf32_t* const p_a, matf32_t* const p_q, matf32_t* const p_r)
         normx = norm(temp_v, rows, 1);
         //printf("norm: %f\n\n", normx);
 
-        u1 = p_r_data[i*cols + i] + sign(p_r_data[i*cols + i])*normx;
+        // column already zero, nothing to reflect
+        if (normx == 0)
+        {
+            continue;
+        }
+
+        // a zero pivot reflects as a positive one, sign(0) would give u1 = 0
+        float s = (p_r_data[i*cols + i] < 0)? -1 : 1;
+        u1 = p_r_data[i*cols + i] + s*normx;
 
         //printf("w:\n");
         for (uint16_t j = 0; j < rows-i; ++j)
@@ -340,7 +362,7 @@ matf32_qr(const matf32_t* const p_a, matf32_t* const p_q, matf32_t* const p_r)
         }
         w_vec[0] = 1;
 
-        tau = sign(p_r_data[i*cols + i]) * u1 / normx;
+        tau = s * u1 / normx;
 
         // tau*w
         scale(w_vec, rows-i, tau, w_tau_vec);
@@ -381,6 +403,7 @@ matf32_qr(const matf32_t* const p_a, matf32_t* const p_q, matf32_t* const p_r)
 
     }
 
+    return MATH_SUCCESS;
 }
 
 // make inline to reduce call stack?
@@ -452,6 +475,33 @@ matf32_linsolve_method(const matf32_t* const p_a, const matf32_t* const p_b, mat
 
             return status;
             break;
+
+        case BANDED:
+            // band storage never needs more than the dense matrix
+            status = matf32_bandwidth(p_a, &band.kl, &band.ku);
+
+            if (MATH_SUCCESS != status)
+            {
+                return status;
+            }
+
+            matf32_band_init(&band, p_a->num_rows, band.kl, band.ku, m1data);
+            matf32_band_from_dense(p_a, &band);
+
+            if ((1 == band.kl) && (1 == band.ku))
+            {
+                return matf32_band_tridiag_solve(&band, p_b, p_x);
+            }
+
+            status = matf32_band_lu(&band);
+
+            if (MATH_SUCCESS != status)
+            {
+                return status;
+            }
+
+            return matf32_band_lu_solve(&band, p_b, p_x);
+            break;
     }
 }
 
@@ -500,3 +550,113 @@ matf32_cholesky_solve(matf32_t* const p_c,  const matf32_t* const p_b, matf32_t*
 
     return status;
 }
+
+
+err_status_t
+matf32_lu_factor(matf32_t* const p_a, uint16_t* const p_piv)
+{
+    const uint16_t n = p_a->num_rows;
+    float* const p_data = p_a->p_data;
+
+    if (p_a->num_cols != n)
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+
+    float a_max = 0;
+    for (uint32_t i = 0; i < (uint32_t)n*n; ++i)
+    {
+        a_max = fmaxf(a_max, fabsf(p_data[i]));
+    }
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        uint16_t p = j;
+        for (uint16_t i = j + 1; i < n; ++i)
+        {
+            if (fabsf(p_data[i*n + j]) > fabsf(p_data[p*n + j]))
+            {
+                p = i;
+            }
+        }
+        p_piv[j] = p;
+
+        if (fabsf(p_data[p*n + j]) <= FLT_EPSILON*a_max)
+        {
+            return MATH_SINGULAR;
+        }
+
+        for (uint16_t k = 0; k < n; ++k)
+        {
+            float tmp = p_data[j*n + k];
+            p_data[j*n + k] = p_data[p*n + k];
+            p_data[p*n + k] = tmp;
+        }
+
+        for (uint16_t i = j + 1; i < n; ++i)
+        {
+            p_data[i*n + j] /= p_data[j*n + j];
+            for (uint16_t k = j + 1; k < n; ++k)
+            {
+                p_data[i*n + k] -= p_data[i*n + j]*p_data[j*n + k];
+            }
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_lu_factor_solve(const matf32_t* const p_lu, const uint16_t* const p_piv, matf32_t* const p_b)
+{
+    const uint16_t n = p_lu->num_rows;
+    const uint16_t k = p_b->num_cols;
+    const float* const p_w = p_lu->p_data;
+    float* const p_x = p_b->p_data;
+
+#ifdef MATH_MATRIX_CHECK
+    if ((p_lu->num_cols != n) || (p_b->num_rows != n))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        for (uint16_t c = 0; c < k; ++c)
+        {
+            float tmp = p_x[j*k + c];
+            p_x[j*k + c] = p_x[p_piv[j]*k + c];
+            p_x[p_piv[j]*k + c] = tmp;
+        }
+    }
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        for (uint16_t j = 0; j < i; ++j)
+        {
+            for (uint16_t c = 0; c < k; ++c)
+            {
+                p_x[i*k + c] -= p_w[i*n + j]*p_x[j*k + c];
+            }
+        }
+    }
+
+    for (int16_t i = n - 1; i >= 0; --i)
+    {
+        for (uint16_t j = i + 1; j < n; ++j)
+        {
+            for (uint16_t c = 0; c < k; ++c)
+            {
+                p_x[i*k + c] -= p_w[i*n + j]*p_x[j*k + c];
+            }
+        }
+        for (uint16_t c = 0; c < k; ++c)
+        {
+            p_x[i*k + c] /= p_w[i*n + i];
+        }
+    }
+
+    return MATH_SUCCESS;
+}
@@ -29,7 +29,8 @@ typedef enum
     BACKWARD_SUBS,
     CHOLESKY,
     QR,
-    LU
+    LU,
+    BANDED
 } linsolve_method_t;
 
 /**
@@ -51,6 +52,7 @@ print_linsolve_method(linsolve_method_t lsm);
  *              CHOLESKY :      Cholesky factorization
  *              QR :            QR factorization.
  *              LU :            LU factorization.
+ *              BANDED :        Banded LU factorization (Thomas algorithm if tridiagonal).
  */
 linsolve_method_t
 matf32_linsolve_get_method(const matf32_t* const p_a);
@@ -130,6 +132,38 @@ err_status_t
 matf32_lu_solve(const matf32_t* const p_l, const matf32_t* const p_u,  const matf32_t* const p_b, matf32_t* const p_x);
 
 
+/**
+ * @brief   LU factorization with partial pivoting of a square matrix in place, PA = LU with the unit lower
+ * factor L stored below the diagonal and U on and above it. Uses no storage besides p_a and p_piv, so it is
+ * safe to call concurrently on different matrices.
+ *
+ * @param[in, out]  p_a     Points to the matrix to factorize, overwritten by L and U.
+ * @param[out]      p_piv   Points to num_rows pivot indices, row j was swapped with row p_piv[j].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix is not square.
+ *              MATH_SINGULAR :         A pivot is below FLT_EPSILON times the largest element.
+ */
+err_status_t
+matf32_lu_factor(matf32_t* const p_a, uint16_t* const p_piv);
+
+
+/**
+ * @brief   Solves AX = B in place, with A factored by matf32_lu_factor and any number of columns in B.
+ *
+ * @param[in]       p_lu    Points to the factorization of A.
+ * @param[in]       p_piv   Points to the pivot indices of the factorization.
+ * @param[in, out]  p_b     Points to B, overwritten by X.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_lu_factor_solve(const matf32_t* const p_lu, const uint16_t* const p_piv, matf32_t* const p_b);
+
+
 err_status_t
 matf32_qr(const matf32_t* const p_a, matf32_t* const p_q, matf32_t* const p_r);
 
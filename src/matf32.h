@@ -11,5 +11,8 @@
 #include "matf32_def.h"
 #include "matf32_math.h"
 #include "matf32_check.h"
+#include "matf32_band.h"
+#include "matf32_sparse.h"
+#include "matf32_sym.h"
 
 #endif // ROBOTAT_MATF32_H_
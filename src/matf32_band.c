@@ -0,0 +1,373 @@
+/**
+ * @file matf32_band.c
+ */
+
+#include "matf32_band.h"
+
+
+void
+matf32_band_init(matf32_band_t* const instance, uint16_t num_rows, uint16_t kl, uint16_t ku, float* p_data)
+{
+    instance->num_rows = num_rows;
+    instance->kl = kl;
+    instance->ku = ku;
+    instance->p_data = p_data;
+}
+
+
+err_status_t
+matf32_bandwidth(const matf32_t* const p_src, uint16_t* const p_kl, uint16_t* const p_ku)
+{
+    if (p_src->num_rows != p_src->num_cols)
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+
+    uint16_t n = p_src->num_rows;
+    uint16_t kl = 0;
+    uint16_t ku = 0;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        // furthest nonzero to the left of the diagonal
+        for (uint16_t j = 0; j + kl < i; ++j)
+        {
+            if (!is_equal_margin(0, p_src->p_data[i*n + j]))
+            {
+                kl = i - j;
+                break;
+            }
+        }
+
+        // furthest nonzero to the right of the diagonal
+        for (uint16_t j = n-1; j > i + ku; --j)
+        {
+            if (!is_equal_margin(0, p_src->p_data[i*n + j]))
+            {
+                ku = j - i;
+                break;
+            }
+        }
+    }
+
+    *p_kl = kl;
+    *p_ku = ku;
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_band_from_dense(const matf32_t* const p_src, matf32_band_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_src, p_dst->num_rows, p_dst->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_dst->num_rows;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        uint16_t i_min = (j > p_dst->ku)? j - p_dst->ku : 0;
+        uint16_t i_max = (j + p_dst->kl < n)? j + p_dst->kl : n-1;
+
+        for (uint16_t i = i_min; i <= i_max; ++i)
+        {
+            *matf32_band_at(p_dst, i, j) = p_src->p_data[i*n + j];
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_band_to_dense(const matf32_band_t* const p_src, matf32_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_dst, p_src->num_rows, p_src->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_src->num_rows;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            p_dst->p_data[i*n + j] = matf32_band_in_band(p_src, i, j)? *matf32_band_at(p_src, i, j) : 0;
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+void
+matf32_band_vecmul(const matf32_band_t* const p_a, const float* const p_x, float* const p_y)
+{
+    uint16_t n = p_a->num_rows;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        uint16_t j_min = (i > p_a->kl)? i - p_a->kl : 0;
+        uint16_t j_max = (i + p_a->ku < n)? i + p_a->ku : n-1;
+
+        float sum = 0;
+        for (uint16_t j = j_min; j <= j_max; ++j)
+        {
+            sum += *matf32_band_at(p_a, i, j) * p_x[j];
+        }
+        p_y[i] = sum;
+    }
+}
+
+
+// ====================================================================================================
+// Banded factorizations and solvers
+// ====================================================================================================
+
+
+// kij gaussian elimination restricted to the band
+err_status_t
+matf32_band_lu(matf32_band_t* const p_a)
+{
+    uint16_t n = p_a->num_rows;
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        float pivot = *matf32_band_at(p_a, k, k);
+
+        if (fabsf(pivot) < FLT_EPSILON)
+        {
+            return MATH_SINGULAR;
+        }
+
+        uint16_t i_max = (k + p_a->kl < n)? k + p_a->kl : n-1;
+        uint16_t j_max = (k + p_a->ku < n)? k + p_a->ku : n-1;
+
+        for (uint16_t i = k+1; i <= i_max; ++i)
+        {
+            float* p_lik = matf32_band_at(p_a, i, k);
+            *p_lik /= pivot;
+
+            for (uint16_t j = k+1; j <= j_max; ++j)
+            {
+                *matf32_band_at(p_a, i, j) -= (*p_lik) * (*matf32_band_at(p_a, k, j));
+            }
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_band_lu_solve(const matf32_band_t* const p_lu, const matf32_t* const p_b, matf32_t* const p_x)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_b, p_lu->num_rows, 1) || !matf32_size_check(p_x, p_lu->num_rows, 1))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_lu->num_rows;
+    float* x = p_x->p_data;
+
+    if (x != p_b->p_data)
+    {
+        memcpy(x, p_b->p_data, n*sizeof(float));
+    }
+
+    // Ly = b, unit diagonal
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        uint16_t j_min = (i > p_lu->kl)? i - p_lu->kl : 0;
+
+        for (uint16_t j = j_min; j < i; ++j)
+        {
+            x[i] -= *matf32_band_at(p_lu, i, j) * x[j];
+        }
+    }
+
+    // Ux = y
+    for (int16_t i = n-1; i >= 0; --i)
+    {
+        uint16_t j_max = (i + p_lu->ku < n)? i + p_lu->ku : n-1;
+
+        for (uint16_t j = i+1; j <= j_max; ++j)
+        {
+            x[i] -= *matf32_band_at(p_lu, i, j) * x[j];
+        }
+
+        x[i] /= *matf32_band_at(p_lu, i, i);
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_band_cholesky(matf32_band_t* const p_a)
+{
+    if (p_a->kl != p_a->ku)
+    {
+        return MATH_ARGUMENT_ERROR;
+    }
+
+    uint16_t n = p_a->num_rows;
+    uint16_t kd = p_a->kl;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        uint16_t k_min = (j > kd)? j - kd : 0;
+
+        // L(j,j) = sqrt(A(j,j) - sum L(j,k)^2)
+        float sum = *matf32_band_at(p_a, j, j);
+        for (uint16_t k = k_min; k < j; ++k)
+        {
+            float ljk = *matf32_band_at(p_a, j, k);
+            sum -= ljk*ljk;
+        }
+
+        if (sum <= 0.0)
+        {
+            return MATH_DECOMPOSITION_FAILURE;
+        }
+
+        float ljj = sqrtf(sum);
+        *matf32_band_at(p_a, j, j) = ljj;
+
+        // L(i,j) = (A(i,j) - sum L(i,k)*L(j,k))/L(j,j), only rows inside the band
+        uint16_t i_max = (j + kd < n)? j + kd : n-1;
+        for (uint16_t i = j+1; i <= i_max; ++i)
+        {
+            uint16_t ki_min = (i > kd)? i - kd : 0;
+
+            sum = *matf32_band_at(p_a, i, j);
+            for (uint16_t k = ki_min; k < j; ++k)
+            {
+                sum -= (*matf32_band_at(p_a, i, k)) * (*matf32_band_at(p_a, j, k));
+            }
+
+            *matf32_band_at(p_a, i, j) = sum / ljj;
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_band_cholesky_solve(const matf32_band_t* const p_c, const matf32_t* const p_b, matf32_t* const p_x)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_b, p_c->num_rows, 1) || !matf32_size_check(p_x, p_c->num_rows, 1))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_c->num_rows;
+    uint16_t kd = p_c->kl;
+    float* x = p_x->p_data;
+
+    if (x != p_b->p_data)
+    {
+        memcpy(x, p_b->p_data, n*sizeof(float));
+    }
+
+    // Ly = b
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        uint16_t j_min = (i > kd)? i - kd : 0;
+
+        for (uint16_t j = j_min; j < i; ++j)
+        {
+            x[i] -= *matf32_band_at(p_c, i, j) * x[j];
+        }
+
+        x[i] /= *matf32_band_at(p_c, i, i);
+    }
+
+    // L'x = y, L'(i,j) = L(j,i)
+    for (int16_t i = n-1; i >= 0; --i)
+    {
+        uint16_t j_max = (i + kd < n)? i + kd : n-1;
+
+        for (uint16_t j = i+1; j <= j_max; ++j)
+        {
+            x[i] -= *matf32_band_at(p_c, j, i) * x[j];
+        }
+
+        x[i] /= *matf32_band_at(p_c, i, i);
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_band_tridiag_solve(matf32_band_t* const p_a, const matf32_t* const p_b, matf32_t* const p_x)
+{
+    if ((p_a->kl != 1) || (p_a->ku != 1))
+    {
+        return MATH_ARGUMENT_ERROR;
+    }
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_b, p_a->num_rows, 1) || !matf32_size_check(p_x, p_a->num_rows, 1))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_a->num_rows;
+    float* x = p_x->p_data;
+
+    // With kl = ku = 1 each column holds [super, diag, sub], so the band is walked with fixed strides
+    float* p_band = p_a->p_data;
+
+    if (x != p_b->p_data)
+    {
+        memcpy(x, p_b->p_data, n*sizeof(float));
+    }
+
+    // forward sweep: u_i = d_i - l_i*c_(i-1), l_i = a_i/u_(i-1)
+    if (fabsf(p_band[1]) < FLT_EPSILON)
+    {
+        return MATH_SINGULAR;
+    }
+
+    for (uint16_t i = 1; i < n; ++i)
+    {
+        float* p_sub = &p_band[3*(i-1) + 2];   // A(i,i-1)
+        float* p_diag = &p_band[3*i + 1];      // A(i,i)
+        float c_prev = p_band[3*i];            // A(i-1,i)
+
+        *p_sub /= p_band[3*(i-1) + 1];
+        *p_diag -= (*p_sub) * c_prev;
+
+        if (fabsf(*p_diag) < FLT_EPSILON)
+        {
+            return MATH_SINGULAR;
+        }
+
+        x[i] -= (*p_sub) * x[i-1];
+    }
+
+    // back substitution
+    x[n-1] /= p_band[3*(n-1) + 1];
+    for (int16_t i = n-2; i >= 0; --i)
+    {
+        x[i] = (x[i] - p_band[3*(i+1)]*x[i+1]) / p_band[3*i + 1];
+    }
+
+    return MATH_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file matf32_band.h
+ *
+ * Banded matrix type definition and banded factorizations.
+ *
+ * Band storage follows the LAPACK layout: the matrix is stored column by column, each column holding
+ * the (kl + ku + 1) elements of the band, so that A(i,j) is found at p_data[j*(kl + ku + 1) + ku + i - j]
+ * for max(0, j - ku) <= i <= min(n - 1, j + kl). Zero-based indexing is used throughout this file.
+ *
+ */
+
+#ifndef ROBOTAT_MATF32_BAND_H_
+#define ROBOTAT_MATF32_BAND_H_
+
+ /**
+  * Dependencies.
+  */
+
+#include <stdint.h>                     // For uint8_t, uint16_t and uint16_t.
+#include <stdbool.h>                    // For bool datatype.
+
+#include "matf32_def.h"
+#include "constants.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief Floating point square banded matrix data structure.
+ */
+typedef struct
+{
+    uint16_t num_rows;  /**< Number of rows (and columns) of the matrix. */
+    uint16_t kl;        /**< Number of sub-diagonals. */
+    uint16_t ku;        /**< Number of super-diagonals. */
+    float* p_data;      /**< Points to the band data, (kl + ku + 1)*num_rows elements. */
+} matf32_band_t;
+
+
+// ====================================================================================================
+// Util functions directly related to the matf32_band datatype
+// ====================================================================================================
+
+
+/**
+ * @brief   Constructor for the banded matrix data structure.
+ *
+ * @param[in, out]  instance    Points to an instance of the banded matrix structure.
+ * @param[in]       num_rows    Number of rows (and columns) of the matrix.
+ * @param[in]       kl          Number of sub-diagonals.
+ * @param[in]       ku          Number of super-diagonals.
+ * @param[in]       p_data      Points to the band data array, at least (kl + ku + 1)*num_rows elements.
+ *
+ * @return  None
+ */
+void
+matf32_band_init(matf32_band_t* const instance, uint16_t num_rows, uint16_t kl, uint16_t ku, float* p_data);
+
+
+/**
+ * @brief   Leading dimension of the band storage (elements stored per column).
+ *
+ * @param[in]   p_src   Points to banded matrix.
+ *
+ * @return  kl + ku + 1.
+ */
+static inline uint16_t
+matf32_band_ld(const matf32_band_t* p_src)
+{
+    return p_src->kl + p_src->ku + 1;
+}
+
+
+/**
+ * @brief   Checks if the element (row, col) lies inside the band.
+ *
+ * @param[in]   p_src   Points to banded matrix.
+ * @param[in]   row     Zero-based row.
+ * @param[in]   col     Zero-based column.
+ *
+ * @return  true if the element is stored, false otherwise.
+ */
+static inline bool
+matf32_band_in_band(const matf32_band_t* p_src, uint16_t row, uint16_t col)
+{
+    return ((row + p_src->ku >= col) && (col + p_src->kl >= row));
+}
+
+
+/**
+ * @brief   Pointer to the stored element (row, col). The element must lie inside the band.
+ *
+ * @param[in]   p_src   Points to banded matrix.
+ * @param[in]   row     Zero-based row.
+ * @param[in]   col     Zero-based column.
+ *
+ * @return  Pointer to the element.
+ */
+static inline float*
+matf32_band_at(const matf32_band_t* p_src, uint16_t row, uint16_t col)
+{
+    return &p_src->p_data[col*matf32_band_ld(p_src) + p_src->ku + row - col];
+}
+
+
+/**
+ * @brief   Measures the lower and upper bandwidth of a square dense matrix. Elements are considered
+ * zero within MATH_EQUAL_PRECISION.
+ *
+ * @param[in]       p_src   Points to square matrix.
+ * @param[in, out]  p_kl    Points to variable to store the number of sub-diagonals.
+ * @param[in, out]  p_ku    Points to variable to store the number of super-diagonals.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix is not square.
+ */
+err_status_t
+matf32_bandwidth(const matf32_t* const p_src, uint16_t* const p_kl, uint16_t* const p_ku);
+
+
+/**
+ * @brief   Copies a square dense matrix into band storage. Elements outside the band of p_dst are ignored,
+ * so p_dst->kl and p_dst->ku must be set (see matf32_bandwidth) before calling this routine.
+ *
+ * @param[in]       p_src   Points to square dense matrix.
+ * @param[in, out]  p_dst   Points to banded matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_band_from_dense(const matf32_t* const p_src, matf32_band_t* const p_dst);
+
+
+/**
+ * @brief   Expands a banded matrix into a square dense matrix.
+ *
+ * @param[in]       p_src   Points to banded matrix.
+ * @param[in, out]  p_dst   Points to square dense matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_band_to_dense(const matf32_band_t* const p_src, matf32_t* const p_dst);
+
+
+/**
+ * @brief   Banded matrix-vector multiplication y = Ax, O(n*(kl + ku)).
+ *
+ * @param[in]       p_a     Points to banded matrix.
+ * @param[in]       p_x     Points to input vector, length num_rows.
+ * @param[in, out]  p_y     Points to output vector, length num_rows. Cannot be the same as p_x.
+ *
+ * @return  None.
+ */
+void
+matf32_band_vecmul(const matf32_band_t* const p_a, const float* const p_x, float* const p_y);
+
+
+// ====================================================================================================
+// Banded factorizations and solvers
+// ====================================================================================================
+
+
+/**
+ * @brief   In-place LU factorization (without pivoting) of a banded matrix, A = LU, in O(n*kl*ku).
+ * L (unit diagonal) overwrites the sub-diagonals and U the diagonal and super-diagonals. Since no pivoting is
+ * done the factors keep the same bandwidth, use it on diagonally dominant or SPD systems (splines, MPC).
+ *
+ * @param[in, out]  p_a     Points to banded matrix to factorize.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SINGULAR :         Zero pivot found.
+ */
+err_status_t
+matf32_band_lu(matf32_band_t* const p_a);
+
+
+/**
+ * @brief   Solves LUx = b with the factors computed by matf32_band_lu.
+ *
+ * @param[in]       p_lu    Points to factorized banded matrix.
+ * @param[in]       p_b     Points to b vector.
+ * @param[in, out]  p_x     Points to output x vector (can be the same as p_b).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_band_lu_solve(const matf32_band_t* const p_lu, const matf32_t* const p_b, matf32_t* const p_x);
+
+
+/**
+ * @brief   In-place Cholesky factorization of a symmetric positive definite banded matrix, A = LL', in
+ * O(n*kd^2). Requires kl == ku. Only the diagonal and sub-diagonals are read and overwritten with L.
+ *
+ * @param[in, out]  p_a     Points to banded matrix to factorize.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_ARGUMENT_ERROR :           Band is not symmetric (kl != ku).
+ *              MATH_DECOMPOSITION_FAILURE :    Matrix is not positive definite.
+ */
+err_status_t
+matf32_band_cholesky(matf32_band_t* const p_a);
+
+
+/**
+ * @brief   Solves LL'x = b with the factor computed by matf32_band_cholesky.
+ *
+ * @param[in]       p_c     Points to factorized banded matrix.
+ * @param[in]       p_b     Points to b vector.
+ * @param[in, out]  p_x     Points to output x vector (can be the same as p_b).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_band_cholesky_solve(const matf32_band_t* const p_c, const matf32_t* const p_b, matf32_t* const p_x);
+
+
+/**
+ * @brief   Solves a tridiagonal system (kl == ku == 1) with the Thomas algorithm in O(n).
+ *
+ * WARNING: the band data of p_a is overwritten with its LU factors.
+ *
+ * @param[in, out]  p_a     Points to tridiagonal matrix.
+ * @param[in]       p_b     Points to b vector.
+ * @param[in, out]  p_x     Points to output x vector (can be the same as p_b).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_ARGUMENT_ERROR :   Matrix is not tridiagonal.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_SINGULAR :         Zero pivot found.
+ */
+err_status_t
+matf32_band_tridiag_solve(matf32_band_t* const p_a, const matf32_t* const p_b, matf32_t* const p_x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_MATF32_BAND_H_
@@ -0,0 +1,562 @@
+/**
+ * @file matf32_sparse.c
+ */
+
+#include "matf32_sparse.h"
+
+
+void
+spmatf32_init(spmatf32_t* const instance, uint16_t num_rows, uint16_t num_cols, spmat_format_t format,
+              uint16_t nnz_max, uint16_t* p_ptr, uint16_t* p_ind, float* p_data)
+{
+    instance->num_rows = num_rows;
+    instance->num_cols = num_cols;
+    instance->format = format;
+    instance->nnz_max = nnz_max;
+    instance->p_ptr = p_ptr;
+    instance->p_ind = p_ind;
+    instance->p_data = p_data;
+
+    memset(p_ptr, 0, (spmatf32_major_dim(instance) + 1)*sizeof(uint16_t));
+}
+
+
+err_status_t
+spmatf32_from_matf32(const matf32_t* const p_src, spmatf32_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_src, p_dst->num_rows, p_dst->num_cols))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    bool is_csc = (SPMAT_CSC == p_dst->format);
+    uint16_t major = spmatf32_major_dim(p_dst);
+    uint16_t minor = is_csc? p_dst->num_rows : p_dst->num_cols;
+    bool is_square = (p_src->num_rows == p_src->num_cols);
+    uint16_t nnz = 0;
+
+    for (uint16_t j = 0; j < major; ++j)
+    {
+        p_dst->p_ptr[j] = nnz;
+
+        for (uint16_t i = 0; i < minor; ++i)
+        {
+            float value = is_csc? p_src->p_data[i*p_src->num_cols + j] : p_src->p_data[j*p_src->num_cols + i];
+
+            if (is_equal_margin(0, value) && !(is_square && (i == j)))
+            {
+                continue;
+            }
+
+            if (nnz >= p_dst->nnz_max)
+            {
+                return MATH_LENGTH_ERROR;
+            }
+
+            p_dst->p_ind[nnz] = i;
+            p_dst->p_data[nnz] = value;
+            nnz++;
+        }
+    }
+
+    p_dst->p_ptr[major] = nnz;
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+spmatf32_to_matf32(const spmatf32_t* const p_src, matf32_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_dst, p_src->num_rows, p_src->num_cols))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    bool is_csc = (SPMAT_CSC == p_src->format);
+
+    matf32_zeros(p_dst);
+
+    for (uint16_t j = 0; j < spmatf32_major_dim(p_src); ++j)
+    {
+        for (uint16_t p = p_src->p_ptr[j]; p < p_src->p_ptr[j+1]; ++p)
+        {
+            uint16_t i = p_src->p_ind[p];
+
+            if (is_csc)
+            {
+                p_dst->p_data[i*p_dst->num_cols + j] = p_src->p_data[p];
+            }
+            else
+            {
+                p_dst->p_data[j*p_dst->num_cols + i] = p_src->p_data[p];
+            }
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+// counting sort transpose of the compressed arrays
+err_status_t
+spmatf32_convert(const spmatf32_t* const p_src, spmatf32_t* const p_dst)
+{
+    if (p_src->format == p_dst->format)
+    {
+        return MATH_ARGUMENT_ERROR;
+    }
+
+#ifdef MATH_MATRIX_CHECK
+    if ((p_src->num_rows != p_dst->num_rows) || (p_src->num_cols != p_dst->num_cols))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t nnz = spmatf32_nnz(p_src);
+    uint16_t src_major = spmatf32_major_dim(p_src);
+    uint16_t dst_major = spmatf32_major_dim(p_dst);
+
+    if (nnz > p_dst->nnz_max)
+    {
+        return MATH_LENGTH_ERROR;
+    }
+
+    // count entries per destination major index, then shift into starting positions
+    memset(p_dst->p_ptr, 0, (dst_major + 1)*sizeof(uint16_t));
+
+    for (uint16_t p = 0; p < nnz; ++p)
+    {
+        p_dst->p_ptr[p_src->p_ind[p] + 1]++;
+    }
+
+    for (uint16_t j = 0; j < dst_major; ++j)
+    {
+        p_dst->p_ptr[j+1] += p_dst->p_ptr[j];
+    }
+
+    // p_ptr[j] is used as insertion cursor, which leaves it pointing at the start of j + 1
+    for (uint16_t j = 0; j < src_major; ++j)
+    {
+        for (uint16_t p = p_src->p_ptr[j]; p < p_src->p_ptr[j+1]; ++p)
+        {
+            uint16_t q = p_dst->p_ptr[p_src->p_ind[p]]++;
+            p_dst->p_ind[q] = j;
+            p_dst->p_data[q] = p_src->p_data[p];
+        }
+    }
+
+    for (uint16_t j = dst_major; j > 0; --j)
+    {
+        p_dst->p_ptr[j] = p_dst->p_ptr[j-1];
+    }
+    p_dst->p_ptr[0] = 0;
+
+    return MATH_SUCCESS;
+}
+
+
+void
+spmatf32_vecmul(const spmatf32_t* const p_a, const float* const p_x, float* const p_y)
+{
+    if (SPMAT_CSR == p_a->format)
+    {
+        for (uint16_t i = 0; i < p_a->num_rows; ++i)
+        {
+            float sum = 0;
+            for (uint16_t p = p_a->p_ptr[i]; p < p_a->p_ptr[i+1]; ++p)
+            {
+                sum += p_a->p_data[p] * p_x[p_a->p_ind[p]];
+            }
+            p_y[i] = sum;
+        }
+    }
+    else
+    {
+        memset(p_y, 0, p_a->num_rows*sizeof(float));
+
+        for (uint16_t j = 0; j < p_a->num_cols; ++j)
+        {
+            float xj = p_x[j];
+            for (uint16_t p = p_a->p_ptr[j]; p < p_a->p_ptr[j+1]; ++p)
+            {
+                p_y[p_a->p_ind[p]] += p_a->p_data[p] * xj;
+            }
+        }
+    }
+}
+
+
+void
+spmatf32_vecmul_trans(const spmatf32_t* const p_a, const float* const p_x, float* const p_y)
+{
+    if (SPMAT_CSC == p_a->format)
+    {
+        for (uint16_t j = 0; j < p_a->num_cols; ++j)
+        {
+            float sum = 0;
+            for (uint16_t p = p_a->p_ptr[j]; p < p_a->p_ptr[j+1]; ++p)
+            {
+                sum += p_a->p_data[p] * p_x[p_a->p_ind[p]];
+            }
+            p_y[j] = sum;
+        }
+    }
+    else
+    {
+        memset(p_y, 0, p_a->num_cols*sizeof(float));
+
+        for (uint16_t i = 0; i < p_a->num_rows; ++i)
+        {
+            float xi = p_x[i];
+            for (uint16_t p = p_a->p_ptr[i]; p < p_a->p_ptr[i+1]; ++p)
+            {
+                p_y[p_a->p_ind[p]] += p_a->p_data[p] * xi;
+            }
+        }
+    }
+}
+
+
+// ====================================================================================================
+// Sparse LDL' factorization
+// ====================================================================================================
+
+
+static inline uint16_t
+popcount16(uint16_t word)
+{
+    uint16_t count = 0;
+    while (word)
+    {
+        word &= word - 1;
+        count++;
+    }
+    return count;
+}
+
+
+err_status_t
+spmatf32_order_mindeg(const spmatf32_t* const p_a, uint16_t* const p_perm, uint16_t* const p_work)
+{
+    if (p_a->num_rows != p_a->num_cols)
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+
+    uint16_t n = p_a->num_rows;
+    uint16_t words = (n + 15)/16;
+
+    uint16_t* p_deg = p_work;           // degree of each node, SPMAT_NONE once eliminated
+    uint16_t* p_adj = p_work + n;       // adjacency bit rows, words elements each
+
+    memset(p_adj, 0, n*words*sizeof(uint16_t));
+
+    // symmetric adjacency without the diagonal
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        for (uint16_t p = p_a->p_ptr[j]; p < p_a->p_ptr[j+1]; ++p)
+        {
+            uint16_t i = p_a->p_ind[p];
+            if (i != j)
+            {
+                p_adj[i*words + j/16] |= (uint16_t)(1u << (j%16));
+                p_adj[j*words + i/16] |= (uint16_t)(1u << (i%16));
+            }
+        }
+    }
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        p_deg[i] = 0;
+        for (uint16_t w = 0; w < words; ++w)
+        {
+            p_deg[i] += popcount16(p_adj[i*words + w]);
+        }
+    }
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        // pick the node of minimum degree (lowest index on ties)
+        uint16_t pivot = SPMAT_NONE;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            if ((SPMAT_NONE != p_deg[i]) && ((SPMAT_NONE == pivot) || (p_deg[i] < p_deg[pivot])))
+            {
+                pivot = i;
+            }
+        }
+
+        p_perm[k] = pivot;
+        p_deg[pivot] = SPMAT_NONE;
+
+        uint16_t* p_row = &p_adj[pivot*words];
+
+        // eliminating the pivot turns its neighbourhood into a clique
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            if (!(p_row[j/16] & (1u << (j%16))))
+            {
+                continue;
+            }
+
+            uint16_t* p_nbr = &p_adj[j*words];
+            p_deg[j] = 0;
+
+            for (uint16_t w = 0; w < words; ++w)
+            {
+                p_nbr[w] |= p_row[w];
+            }
+
+            p_nbr[j/16] &= (uint16_t)~(1u << (j%16));
+            p_nbr[pivot/16] &= (uint16_t)~(1u << (pivot%16));
+
+            for (uint16_t w = 0; w < words; ++w)
+            {
+                p_deg[j] += popcount16(p_nbr[w]);
+            }
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+void
+spldl_symbolic_init(spldl_symbolic_t* const p_sym, uint16_t n, uint16_t* p_buf)
+{
+    p_sym->n = n;
+    p_sym->lnz = 0;
+    p_sym->p_perm = p_buf;
+    p_sym->p_iperm = p_buf + n;
+    p_sym->p_parent = p_buf + 2*n;
+    p_sym->p_Lp = p_buf + 3*n;
+    p_sym->p_iwork = p_buf + 4*n + 1;
+}
+
+
+// Up-looking LDL' (T. Davis, "Algorithm 849: A concise sparse Cholesky factorization package")
+err_status_t
+spldl_symbolic(const spmatf32_t* const p_a, spldl_symbolic_t* const p_sym, const uint16_t* const p_perm)
+{
+    uint16_t n = p_sym->n;
+
+#ifdef MATH_MATRIX_CHECK
+    if ((p_a->num_rows != n) || (p_a->num_cols != n))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t* p_flag = p_sym->p_iwork;
+    uint16_t* p_lnz = p_sym->p_iwork + n;
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        p_sym->p_perm[k] = (NULL == p_perm)? k : p_perm[k];
+    }
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        p_sym->p_iperm[p_sym->p_perm[k]] = k;
+    }
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        p_sym->p_parent[k] = SPMAT_NONE;
+        p_flag[k] = k;
+        p_lnz[k] = 0;
+
+        uint16_t kk = p_sym->p_perm[k];
+
+        // row k of L follows the paths from each nonzero of A(0:k-1, k) up the elimination tree
+        for (uint16_t p = p_a->p_ptr[kk]; p < p_a->p_ptr[kk+1]; ++p)
+        {
+            uint16_t i = p_sym->p_iperm[p_a->p_ind[p]];
+
+            if (i < k)
+            {
+                for (; p_flag[i] != k; i = p_sym->p_parent[i])
+                {
+                    if (SPMAT_NONE == p_sym->p_parent[i])
+                    {
+                        p_sym->p_parent[i] = k;
+                    }
+
+                    p_lnz[i]++;
+                    p_flag[i] = k;
+                }
+            }
+        }
+    }
+
+    p_sym->p_Lp[0] = 0;
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        p_sym->p_Lp[k+1] = p_sym->p_Lp[k] + p_lnz[k];
+    }
+
+    p_sym->lnz = p_sym->p_Lp[n];
+
+    return MATH_SUCCESS;
+}
+
+
+void
+spldl_numeric_init(spldl_numeric_t* const p_num, const spldl_symbolic_t* const p_sym, uint16_t lnz_max,
+                   uint16_t* p_ibuf, float* p_fbuf)
+{
+    uint16_t n = p_sym->n;
+
+    p_num->p_sym = p_sym;
+    p_num->lnz_max = lnz_max;
+    p_num->p_Li = p_ibuf;
+    p_num->p_iwork = p_ibuf + lnz_max;
+    p_num->p_Lx = p_fbuf;
+    p_num->p_D = p_fbuf + lnz_max;
+    p_num->p_work = p_fbuf + lnz_max + n;
+}
+
+
+static err_status_t
+spldl_factor(const spmatf32_t* const p_a, spldl_numeric_t* const p_num, bool is_posdef)
+{
+    const spldl_symbolic_t* p_sym = p_num->p_sym;
+    uint16_t n = p_sym->n;
+
+    if (p_sym->lnz > p_num->lnz_max)
+    {
+        return MATH_LENGTH_ERROR;
+    }
+
+    float* p_y = p_num->p_work;
+    uint16_t* p_pattern = p_num->p_iwork;
+    uint16_t* p_flag = p_num->p_iwork + n;
+    uint16_t* p_lnz = p_num->p_iwork + 2*n;
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        // scatter column k of P*A*P' into y and find the pattern of row k of L
+        p_y[k] = 0;
+        uint16_t top = n;
+        p_flag[k] = k;
+        p_lnz[k] = 0;
+
+        uint16_t kk = p_sym->p_perm[k];
+
+        for (uint16_t p = p_a->p_ptr[kk]; p < p_a->p_ptr[kk+1]; ++p)
+        {
+            uint16_t i = p_sym->p_iperm[p_a->p_ind[p]];
+
+            if (i <= k)
+            {
+                p_y[i] += p_a->p_data[p];
+
+                uint16_t len = 0;
+                for (; p_flag[i] != k; i = p_sym->p_parent[i])
+                {
+                    p_pattern[len++] = i;
+                    p_flag[i] = k;
+                }
+
+                while (len > 0)
+                {
+                    p_pattern[--top] = p_pattern[--len];
+                }
+            }
+        }
+
+        // sparse triangular solve for row k of L and the pivot D(k)
+        p_num->p_D[k] = p_y[k];
+        p_y[k] = 0;
+
+        for (; top < n; ++top)
+        {
+            uint16_t i = p_pattern[top];
+            float yi = p_y[i];
+            p_y[i] = 0;
+
+            uint16_t p2 = p_sym->p_Lp[i] + p_lnz[i];
+            for (uint16_t p = p_sym->p_Lp[i]; p < p2; ++p)
+            {
+                p_y[p_num->p_Li[p]] -= p_num->p_Lx[p] * yi;
+            }
+
+            float l_ki = yi / p_num->p_D[i];
+            p_num->p_D[k] -= l_ki * yi;
+            p_num->p_Li[p2] = k;
+            p_num->p_Lx[p2] = l_ki;
+            p_lnz[i]++;
+        }
+
+        if ((fabsf(p_num->p_D[k]) < FLT_EPSILON) || (is_posdef && (p_num->p_D[k] <= 0)))
+        {
+            return MATH_DECOMPOSITION_FAILURE;
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+spldl_numeric(const spmatf32_t* const p_a, spldl_numeric_t* const p_num)
+{
+    return spldl_factor(p_a, p_num, false);
+}
+
+
+err_status_t
+spldl_cholesky(const spmatf32_t* const p_a, spldl_numeric_t* const p_num)
+{
+    return spldl_factor(p_a, p_num, true);
+}
+
+
+void
+spldl_solve(const spldl_numeric_t* const p_num, const float* const p_b, float* const p_x)
+{
+    const spldl_symbolic_t* p_sym = p_num->p_sym;
+    uint16_t n = p_sym->n;
+    float* p_y = p_num->p_work;
+
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        p_y[k] = p_b[p_sym->p_perm[k]];
+    }
+
+    // Ly = Pb
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        for (uint16_t p = p_sym->p_Lp[j]; p < p_sym->p_Lp[j+1]; ++p)
+        {
+            p_y[p_num->p_Li[p]] -= p_num->p_Lx[p] * p_y[j];
+        }
+    }
+
+    // Dz = y
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        p_y[j] /= p_num->p_D[j];
+    }
+
+    // L'w = z
+    for (int16_t j = n-1; j >= 0; --j)
+    {
+        for (uint16_t p = p_sym->p_Lp[j]; p < p_sym->p_Lp[j+1]; ++p)
+        {
+            p_y[j] -= p_num->p_Lx[p] * p_y[p_num->p_Li[p]];
+        }
+    }
+
+    // x = P'w
+    for (uint16_t k = 0; k < n; ++k)
+    {
+        p_x[p_sym->p_perm[k]] = p_y[k];
+    }
+}
@@ -0,0 +1,345 @@
+/**
+ * @file matf32_sparse.h
+ *
+ * Compressed sparse matrix type (CSC/CSR), sparse matrix-vector products, fill-reducing ordering and
+ * sparse LDL'/Cholesky factorization with separate symbolic and numeric phases.
+ *
+ * All storage is provided by the caller (no dynamic allocation); the X_IWORK / X_FWORK macros give the
+ * number of uint16_t/float elements each structure needs. Zero-based indexing is used throughout this file.
+ *
+ */
+
+#ifndef ROBOTAT_MATF32_SPARSE_H_
+#define ROBOTAT_MATF32_SPARSE_H_
+
+ /**
+  * Dependencies.
+  */
+
+#include <stdint.h>                     // For uint8_t, uint16_t and uint16_t.
+#include <stdbool.h>                    // For bool datatype.
+
+#include "matf32_def.h"
+#include "constants.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define SPMAT_NONE                  (0xFFFF)    /**< Empty index (e.g. root of the elimination tree). */
+
+#define SPMAT_MINDEG_IWORK(n)       ((n) + (n)*(((n) + 15)/16))    /**< uint16_t workspace for spmatf32_order_mindeg. */
+#define SPLDL_SYMBOLIC_IWORK(n)     (6*(n) + 1)                    /**< uint16_t storage for spldl_symbolic_init. */
+#define SPLDL_NUMERIC_IWORK(n, lnz) ((lnz) + 3*(n))                /**< uint16_t storage for spldl_numeric_init. */
+#define SPLDL_NUMERIC_FWORK(n, lnz) ((lnz) + 2*(n))                /**< float storage for spldl_numeric_init. */
+#define SPLDL_DENSE_LNZ(n)          (((n)*((n) - 1))/2)            /**< Worst case (dense) nonzeros of L. */
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief Compressed storage format.
+ */
+typedef enum
+{
+    SPMAT_CSC,  /**< Compressed sparse column, p_ptr indexes columns and p_ind holds row indices. */
+    SPMAT_CSR   /**< Compressed sparse row, p_ptr indexes rows and p_ind holds column indices. */
+} spmat_format_t;
+
+
+/**
+ * @brief Floating point compressed sparse matrix data structure.
+ */
+typedef struct
+{
+    uint16_t num_rows;      /**< Number of rows of the matrix. */
+    uint16_t num_cols;      /**< Number of columns of the matrix. */
+    uint16_t nnz_max;       /**< Capacity of p_ind and p_data. */
+    spmat_format_t format;  /**< Storage format. */
+    uint16_t* p_ptr;        /**< Start of each column (CSC) or row (CSR), num_cols + 1 (num_rows + 1) elements. */
+    uint16_t* p_ind;        /**< Row (CSC) or column (CSR) index of each stored element. */
+    float* p_data;          /**< Value of each stored element. */
+} spmatf32_t;
+
+
+/**
+ * @brief Symbolic analysis of a sparse LDL' factorization: ordering, elimination tree and column counts.
+ * Only depends on the sparsity pattern, so it can be reused by every numeric factorization of the same pattern.
+ */
+typedef struct
+{
+    uint16_t n;             /**< Dimension of the matrix. */
+    uint16_t lnz;           /**< Number of nonzeros of L (strictly lower part). */
+    uint16_t* p_perm;       /**< Fill-reducing permutation, p_perm[k] is the original index of pivot k. */
+    uint16_t* p_iperm;      /**< Inverse permutation. */
+    uint16_t* p_parent;     /**< Elimination tree, SPMAT_NONE for roots. */
+    uint16_t* p_Lp;         /**< Column pointers of L, n + 1 elements. */
+    uint16_t* p_iwork;      /**< Workspace, 2n elements. */
+} spldl_symbolic_t;
+
+
+/**
+ * @brief Numeric sparse LDL' factorization, P*A*P' = L*D*L' with L unit lower triangular (stored in CSC).
+ */
+typedef struct
+{
+    const spldl_symbolic_t* p_sym;  /**< Symbolic analysis this factorization belongs to. */
+    uint16_t lnz_max;               /**< Capacity of p_Li and p_Lx. */
+    uint16_t* p_Li;                 /**< Row indices of L. */
+    float* p_Lx;                    /**< Values of L. */
+    float* p_D;                     /**< Diagonal of D, n elements. */
+    float* p_work;                  /**< Workspace, n elements. */
+    uint16_t* p_iwork;              /**< Workspace, 3n elements. */
+} spldl_numeric_t;
+
+
+// ====================================================================================================
+// Util functions directly related to the spmatf32 datatype
+// ====================================================================================================
+
+
+/**
+ * @brief   Constructor for the sparse matrix data structure. The matrix is initialized empty.
+ *
+ * @param[in, out]  instance    Points to an instance of the sparse matrix structure.
+ * @param[in]       num_rows    Number of rows in the matrix.
+ * @param[in]       num_cols    Number of columns in the matrix.
+ * @param[in]       format      Storage format.
+ * @param[in]       nnz_max     Capacity of p_ind and p_data.
+ * @param[in]       p_ptr       Points to the pointer array (num_cols + 1 for CSC, num_rows + 1 for CSR).
+ * @param[in]       p_ind       Points to the index array.
+ * @param[in]       p_data      Points to the value array.
+ *
+ * @return  None
+ */
+void
+spmatf32_init(spmatf32_t* const instance, uint16_t num_rows, uint16_t num_cols, spmat_format_t format,
+              uint16_t nnz_max, uint16_t* p_ptr, uint16_t* p_ind, float* p_data);
+
+
+/**
+ * @brief   Number of compressed columns (CSC) or rows (CSR).
+ *
+ * @param[in]   p_src   Points to sparse matrix.
+ *
+ * @return  Length of p_ptr minus one.
+ */
+static inline uint16_t
+spmatf32_major_dim(const spmatf32_t* p_src)
+{
+    return (SPMAT_CSC == p_src->format)? p_src->num_cols : p_src->num_rows;
+}
+
+
+/**
+ * @brief   Number of stored elements.
+ *
+ * @param[in]   p_src   Points to sparse matrix.
+ *
+ * @return  Number of stored elements.
+ */
+static inline uint16_t
+spmatf32_nnz(const spmatf32_t* p_src)
+{
+    return p_src->p_ptr[spmatf32_major_dim(p_src)];
+}
+
+
+/**
+ * @brief   Compresses a dense matrix. Elements are considered zero within MATH_EQUAL_PRECISION, except
+ * for the diagonal of square matrices which is always stored (factorizations need it).
+ *
+ * @param[in]       p_src   Points to dense matrix.
+ * @param[in, out]  p_dst   Points to sparse matrix, its format and capacity must be set.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_LENGTH_ERROR :     Not enough capacity in p_dst.
+ */
+err_status_t
+spmatf32_from_matf32(const matf32_t* const p_src, spmatf32_t* const p_dst);
+
+
+/**
+ * @brief   Expands a sparse matrix into a dense one.
+ *
+ * @param[in]       p_src   Points to sparse matrix.
+ * @param[in, out]  p_dst   Points to dense matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+spmatf32_to_matf32(const spmatf32_t* const p_src, matf32_t* const p_dst);
+
+
+/**
+ * @brief   Changes the storage format (CSC <-> CSR) of a sparse matrix, keeping the same matrix.
+ * Indices come out sorted.
+ *
+ * @param[in]       p_src   Points to sparse matrix.
+ * @param[in, out]  p_dst   Points to sparse matrix with the opposite format, cannot share storage with p_src.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_ARGUMENT_ERROR :   Both matrices have the same format.
+ *              MATH_LENGTH_ERROR :     Not enough capacity in p_dst.
+ */
+err_status_t
+spmatf32_convert(const spmatf32_t* const p_src, spmatf32_t* const p_dst);
+
+
+/**
+ * @brief   Sparse matrix-vector multiplication y = Ax.
+ *
+ * @param[in]       p_a     Points to sparse matrix.
+ * @param[in]       p_x     Points to input vector, num_cols elements.
+ * @param[in, out]  p_y     Points to output vector, num_rows elements. Cannot be the same as p_x.
+ *
+ * @return  None.
+ */
+void
+spmatf32_vecmul(const spmatf32_t* const p_a, const float* const p_x, float* const p_y);
+
+
+/**
+ * @brief   Transposed sparse matrix-vector multiplication y = A'x.
+ *
+ * @param[in]       p_a     Points to sparse matrix.
+ * @param[in]       p_x     Points to input vector, num_rows elements.
+ * @param[in, out]  p_y     Points to output vector, num_cols elements. Cannot be the same as p_x.
+ *
+ * @return  None.
+ */
+void
+spmatf32_vecmul_trans(const spmatf32_t* const p_a, const float* const p_x, float* const p_y);
+
+
+// ====================================================================================================
+// Sparse LDL' factorization
+// ====================================================================================================
+
+
+/**
+ * @brief   Minimum degree fill-reducing ordering of a square, structurally symmetric sparse matrix.
+ *
+ * The elimination graph is kept as bit rows, which gives exact external degrees (the quantity AMD
+ * approximates) at O(n^3/16) word operations, cheap at the sizes this library targets.
+ *
+ * @param[in]       p_a     Points to sparse matrix, only its pattern is used.
+ * @param[in, out]  p_perm  Points to output permutation, n elements.
+ * @param[in]       p_work  Points to workspace, SPMAT_MINDEG_IWORK(n) elements.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix is not square.
+ */
+err_status_t
+spmatf32_order_mindeg(const spmatf32_t* const p_a, uint16_t* const p_perm, uint16_t* const p_work);
+
+
+/**
+ * @brief   Constructor for the symbolic analysis structure.
+ *
+ * @param[in, out]  p_sym   Points to symbolic analysis structure.
+ * @param[in]       n       Dimension of the matrix.
+ * @param[in]       p_buf   Points to storage, SPLDL_SYMBOLIC_IWORK(n) elements.
+ *
+ * @return  None
+ */
+void
+spldl_symbolic_init(spldl_symbolic_t* const p_sym, uint16_t n, uint16_t* p_buf);
+
+
+/**
+ * @brief   Symbolic analysis: elimination tree and column counts of L for the permuted matrix P*A*P'.
+ *
+ * p_a must be square and store both triangles (structurally symmetric); its format is irrelevant since
+ * CSC and CSR coincide for symmetric matrices.
+ *
+ * @param[in]       p_a     Points to sparse matrix.
+ * @param[in, out]  p_sym   Points to symbolic analysis structure.
+ * @param[in]       p_perm  Points to permutation to use (e.g. from spmatf32_order_mindeg), NULL for natural order.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+spldl_symbolic(const spmatf32_t* const p_a, spldl_symbolic_t* const p_sym, const uint16_t* const p_perm);
+
+
+/**
+ * @brief   Constructor for the numeric factorization structure.
+ *
+ * @param[in, out]  p_num   Points to numeric factorization structure.
+ * @param[in]       p_sym   Points to the symbolic analysis to use.
+ * @param[in]       lnz_max Capacity for L, at least p_sym->lnz (SPLDL_DENSE_LNZ(n) always suffices).
+ * @param[in]       p_ibuf  Points to storage, SPLDL_NUMERIC_IWORK(n, lnz_max) elements.
+ * @param[in]       p_fbuf  Points to storage, SPLDL_NUMERIC_FWORK(n, lnz_max) elements.
+ *
+ * @return  None
+ */
+void
+spldl_numeric_init(spldl_numeric_t* const p_num, const spldl_symbolic_t* const p_sym, uint16_t lnz_max,
+                   uint16_t* p_ibuf, float* p_fbuf);
+
+
+/**
+ * @brief   Numeric LDL' factorization. Works for any matrix whose leading principal minors (after
+ * permutation) are nonsingular, e.g. SPD or quasi-definite (KKT) matrices. Can be called again on a
+ * matrix with the same pattern without redoing the symbolic analysis.
+ *
+ * @param[in]       p_a     Points to sparse matrix, same pattern used in spldl_symbolic.
+ * @param[in, out]  p_num   Points to numeric factorization structure.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_LENGTH_ERROR :             Not enough capacity for L.
+ *              MATH_DECOMPOSITION_FAILURE :    Zero pivot found.
+ */
+err_status_t
+spldl_numeric(const spmatf32_t* const p_a, spldl_numeric_t* const p_num);
+
+
+/**
+ * @brief   Sparse Cholesky factorization, computed as LDL' (the Cholesky factor is L*sqrt(D)) but failing
+ * if the matrix is not positive definite. Solve with spldl_solve.
+ *
+ * @param[in]       p_a     Points to sparse matrix, same pattern used in spldl_symbolic.
+ * @param[in, out]  p_num   Points to numeric factorization structure.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_LENGTH_ERROR :             Not enough capacity for L.
+ *              MATH_DECOMPOSITION_FAILURE :    Matrix is not positive definite.
+ */
+err_status_t
+spldl_cholesky(const spmatf32_t* const p_a, spldl_numeric_t* const p_num);
+
+
+/**
+ * @brief   Solves Ax = b using the factorization P*A*P' = L*D*L'.
+ *
+ * @param[in]       p_num   Points to numeric factorization.
+ * @param[in]       p_b     Points to b vector, n elements.
+ * @param[in, out]  p_x     Points to x vector, n elements (can be the same as p_b).
+ *
+ * @return  None.
+ */
+void
+spldl_solve(const spldl_numeric_t* const p_num, const float* const p_b, float* const p_x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_MATF32_SPARSE_H_
@@ -0,0 +1,364 @@
+/**
+ * @file matf32_sym.c
+ */
+
+#include "matf32_sym.h"
+
+
+void
+matf32_sym_init(matf32_sym_t* const instance, uint16_t num_rows, float* p_data)
+{
+    instance->num_rows = num_rows;
+    instance->p_data = p_data;
+}
+
+
+err_status_t
+matf32_sym_from_dense(const matf32_t* const p_src, matf32_sym_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_src, p_dst->num_rows, p_dst->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_dst->num_rows;
+    float* p_col = p_dst->p_data;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        for (uint16_t i = 0; i <= j; ++i)
+        {
+            p_col[i] = p_src->p_data[i*n + j];
+        }
+        p_col += j + 1;
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_to_dense(const matf32_sym_t* const p_src, matf32_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_dst, p_src->num_rows, p_src->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_src->num_rows;
+    const float* p_col = p_src->p_data;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        for (uint16_t i = 0; i <= j; ++i)
+        {
+            p_dst->p_data[i*n + j] = p_col[i];
+            p_dst->p_data[j*n + i] = p_col[i];
+        }
+        p_col += j + 1;
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_copy(const matf32_sym_t* const p_src, matf32_sym_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (p_src->num_rows != p_dst->num_rows)
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    memcpy(p_dst->p_data, p_src->p_data, MATF32_SYM_SIZE(p_src->num_rows)*sizeof(float));
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_add(const matf32_sym_t* const p_a, const matf32_sym_t* const p_b, matf32_sym_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if ((p_a->num_rows != p_b->num_rows) || (p_a->num_rows != p_dst->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint32_t size = MATF32_SYM_SIZE(p_a->num_rows);
+
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        p_dst->p_data[k] = p_a->p_data[k] + p_b->p_data[k];
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+// ====================================================================================================
+// Symmetric kernels
+// ====================================================================================================
+
+
+// Each stored element S(k,j), k < j, is read once and applied to both S(k,j) and S(j,k)
+void
+matf32_sym_vecmul(const matf32_sym_t* const p_s, const float* const p_x, float* const p_y)
+{
+    uint16_t n = p_s->num_rows;
+    const float* p_col = p_s->p_data;
+
+    memset(p_y, 0, n*sizeof(float));
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        float sum = 0;
+        for (uint16_t k = 0; k < j; ++k)
+        {
+            p_y[k] += p_col[k] * p_x[j];
+            sum += p_col[k] * p_x[k];
+        }
+        p_y[j] += sum + p_col[j] * p_x[j];
+        p_col += j + 1;
+    }
+}
+
+
+err_status_t
+matf32_sym_mul(const matf32_t* const p_a, const matf32_sym_t* const p_s, matf32_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if ((p_a->num_cols != p_s->num_rows) || !matf32_size_check(p_dst, p_a->num_rows, p_s->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t m = p_a->num_rows;
+    uint16_t n = p_s->num_rows;
+
+    for (uint16_t r = 0; r < m; ++r)
+    {
+        const float* p_arow = &p_a->p_data[r*n];
+        float* p_drow = &p_dst->p_data[r*n];
+        const float* p_col = p_s->p_data;
+
+        memset(p_drow, 0, n*sizeof(float));
+
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            float sum = 0;
+            for (uint16_t k = 0; k < j; ++k)
+            {
+                sum += p_arow[k] * p_col[k];
+                p_drow[k] += p_arow[j] * p_col[k];
+            }
+            p_drow[j] += sum + p_arow[j] * p_col[j];
+            p_col += j + 1;
+        }
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_congruence(const matf32_t* const p_a, const matf32_sym_t* const p_s, float beta, matf32_sym_t* const p_dst,
+    float* const p_work)
+{
+#ifdef MATH_MATRIX_CHECK
+    if ((p_a->num_cols != p_s->num_rows) || (p_dst->num_rows != p_a->num_rows))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t m = p_a->num_rows;
+    uint16_t n = p_a->num_cols;
+    matf32_t W;
+
+    // W = A*S
+    matf32_init(&W, m, n, p_work);
+    matf32_sym_mul(p_a, p_s, &W);
+
+    // dst(i,j) = beta*dst(i,j) + W(i,:)*A(j,:)', i <= j
+    float* p_col = p_dst->p_data;
+    for (uint16_t j = 0; j < m; ++j)
+    {
+        const float* p_aj = &p_a->p_data[j*n];
+
+        for (uint16_t i = 0; i <= j; ++i)
+        {
+            const float* p_wi = &p_work[i*n];
+            float sum = 0;
+
+            for (uint16_t k = 0; k < n; ++k)
+            {
+                sum += p_wi[k] * p_aj[k];
+            }
+            p_col[i] = (beta == 0)? sum : beta*p_col[i] + sum;
+        }
+        p_col += j + 1;
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_rank_update(const matf32_t* const p_v, float alpha, matf32_sym_t* const p_dst)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (p_v->num_cols != p_dst->num_rows)
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t k = p_v->num_rows;
+    uint16_t n = p_v->num_cols;
+    float* p_col = p_dst->p_data;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        for (uint16_t i = 0; i <= j; ++i)
+        {
+            float sum = 0;
+            for (uint16_t r = 0; r < k; ++r)
+            {
+                sum += p_v->p_data[r*n + i] * p_v->p_data[r*n + j];
+            }
+            p_col[i] += alpha*sum;
+        }
+        p_col += j + 1;
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+// ====================================================================================================
+// Packed Cholesky factorization and solvers
+// ====================================================================================================
+
+
+// Column oriented (left-looking) U'U factorization, every inner product runs over two contiguous columns
+err_status_t
+matf32_sym_cholesky(matf32_sym_t* const p_a)
+{
+    uint16_t n = p_a->num_rows;
+    float* p_colj = p_a->p_data;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        const float* p_coli = p_a->p_data;
+
+        // U(i,j) = (A(i,j) - sum U(k,i)*U(k,j))/U(i,i), i < j
+        for (uint16_t i = 0; i < j; ++i)
+        {
+            float sum = p_colj[i];
+            for (uint16_t k = 0; k < i; ++k)
+            {
+                sum -= p_coli[k] * p_colj[k];
+            }
+            p_colj[i] = sum / p_coli[i];
+            p_coli += i + 1;
+        }
+
+        // U(j,j) = sqrt(A(j,j) - sum U(k,j)^2)
+        float sum = p_colj[j];
+        for (uint16_t k = 0; k < j; ++k)
+        {
+            sum -= p_colj[k] * p_colj[k];
+        }
+
+        if (sum <= 0.0)
+        {
+            p_colj[j] = sum;
+            return MATH_DECOMPOSITION_FAILURE;
+        }
+
+        p_colj[j] = sqrtf(sum);
+        p_colj += j + 1;
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_cholesky_fwdsub(const matf32_sym_t* const p_u, matf32_t* const p_b)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (p_b->num_rows != p_u->num_rows)
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_u->num_rows;
+    uint16_t nrhs = p_b->num_cols;
+    float* b = p_b->p_data;
+
+    // U'(i,k) = U(k,i), k < i, is the contiguous column i of U
+    const float* p_col = p_u->p_data;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        for (uint16_t c = 0; c < nrhs; ++c)
+        {
+            float sum = b[i*nrhs + c];
+            for (uint16_t k = 0; k < i; ++k)
+            {
+                sum -= p_col[k] * b[k*nrhs + c];
+            }
+            b[i*nrhs + c] = sum / p_col[i];
+        }
+        p_col += i + 1;
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+err_status_t
+matf32_sym_cholesky_solve(const matf32_sym_t* const p_u, const matf32_t* const p_b, matf32_t* const p_x)
+{
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_b, p_u->num_rows, 1) || !matf32_size_check(p_x, p_u->num_rows, 1))
+    {
+        return MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    uint16_t n = p_u->num_rows;
+    float* x = p_x->p_data;
+
+    if (x != p_b->p_data)
+    {
+        memcpy(x, p_b->p_data, n*sizeof(float));
+    }
+
+    // U'y = b
+    matf32_sym_cholesky_fwdsub(p_u, p_x);
+
+    // Ux = y, column sweep so that U is read contiguously
+    for (int16_t j = n-1; j >= 0; --j)
+    {
+        const float* p_col = &p_u->p_data[matf32_sym_idx(0, j)];
+
+        x[j] /= p_col[j];
+        for (uint16_t i = 0; i < j; ++i)
+        {
+            x[i] -= p_col[i] * x[j];
+        }
+    }
+
+    return MATH_SUCCESS;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file matf32_sym.h
+ *
+ * Packed symmetric matrix type definition and symmetric kernels.
+ *
+ * Only the upper triangle of a symmetric n x n matrix is stored, column by column (LAPACK 'U' packed
+ * layout), so that A(i,j) with i <= j is found at p_data[i + j*(j + 1)/2]. This takes n*(n + 1)/2 floats
+ * instead of n*n and keeps each column of the upper triangle (and of its Cholesky factor) contiguous.
+ * Zero-based indexing is used throughout this file.
+ *
+ */
+
+#ifndef ROBOTAT_MATF32_SYM_H_
+#define ROBOTAT_MATF32_SYM_H_
+
+ /**
+  * Dependencies.
+  */
+
+#include <stdint.h>                     // For uint8_t, uint16_t and uint16_t.
+#include <stdbool.h>                    // For bool datatype.
+
+#include "matf32_def.h"
+#include "constants.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define MATF32_SYM_SIZE(n)      ((n)*((n) + 1)/2)   /**< Number of floats of a packed n x n symmetric matrix. */
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief Floating point packed symmetric matrix data structure.
+ */
+typedef struct
+{
+    uint16_t num_rows;  /**< Number of rows (and columns) of the matrix. */
+    float* p_data;      /**< Points to the packed upper triangle, MATF32_SYM_SIZE(num_rows) elements. */
+} matf32_sym_t;
+
+
+// ====================================================================================================
+// Util functions directly related to the matf32_sym datatype
+// ====================================================================================================
+
+
+/**
+ * @brief   Constructor for the packed symmetric matrix data structure.
+ *
+ * @param[in, out]  instance    Points to an instance of the packed symmetric matrix structure.
+ * @param[in]       num_rows    Number of rows (and columns) of the matrix.
+ * @param[in]       p_data      Points to the packed data array, at least MATF32_SYM_SIZE(num_rows) elements.
+ *
+ * @return  None
+ */
+void
+matf32_sym_init(matf32_sym_t* const instance, uint16_t num_rows, float* p_data);
+
+
+/**
+ * @brief   Offset of the element (row, col) inside the packed array. Either triangle can be addressed.
+ *
+ * @param[in]   row     Zero-based row.
+ * @param[in]   col     Zero-based column.
+ *
+ * @return  Packed offset.
+ */
+static inline uint32_t
+matf32_sym_idx(uint16_t row, uint16_t col)
+{
+    return (row <= col)? (row + (uint32_t)col*(col + 1)/2) : (col + (uint32_t)row*(row + 1)/2);
+}
+
+
+/**
+ * @brief   Pointer to the stored element (row, col). A(row, col) and A(col, row) share storage.
+ *
+ * @param[in]   p_src   Points to packed symmetric matrix.
+ * @param[in]   row     Zero-based row.
+ * @param[in]   col     Zero-based column.
+ *
+ * @return  Pointer to the element.
+ */
+static inline float*
+matf32_sym_at(const matf32_sym_t* p_src, uint16_t row, uint16_t col)
+{
+    return &p_src->p_data[matf32_sym_idx(row, col)];
+}
+
+
+/**
+ * @brief   Packs the upper triangle of a square dense matrix. The strictly lower triangle is not read.
+ *
+ * @param[in]       p_src   Points to square dense matrix.
+ * @param[in, out]  p_dst   Points to packed symmetric matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_from_dense(const matf32_t* const p_src, matf32_sym_t* const p_dst);
+
+
+/**
+ * @brief   Expands a packed symmetric matrix into a full square dense matrix.
+ *
+ * @param[in]       p_src   Points to packed symmetric matrix.
+ * @param[in, out]  p_dst   Points to square dense matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_to_dense(const matf32_sym_t* const p_src, matf32_t* const p_dst);
+
+
+/**
+ * @brief   Copies a packed symmetric matrix.
+ *
+ * @param[in]       p_src   Points to source packed matrix.
+ * @param[in, out]  p_dst   Points to destination packed matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_copy(const matf32_sym_t* const p_src, matf32_sym_t* const p_dst);
+
+
+/**
+ * @brief   Packed symmetric matrix addition, dst = a + b.
+ *
+ * @param[in]       p_a     Points to first packed matrix.
+ * @param[in]       p_b     Points to second packed matrix.
+ * @param[in, out]  p_dst   Points to output packed matrix (can be the same as p_a or p_b).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_add(const matf32_sym_t* const p_a, const matf32_sym_t* const p_b, matf32_sym_t* const p_dst);
+
+
+// ====================================================================================================
+// Symmetric kernels
+// ====================================================================================================
+
+
+/**
+ * @brief   Packed symmetric matrix-vector multiplication y = Sx.
+ *
+ * @param[in]       p_s     Points to packed symmetric matrix.
+ * @param[in]       p_x     Points to input vector, length num_rows.
+ * @param[in, out]  p_y     Points to output vector, length num_rows. Cannot be the same as p_x.
+ *
+ * @return  None.
+ */
+void
+matf32_sym_vecmul(const matf32_sym_t* const p_s, const float* const p_x, float* const p_y);
+
+
+/**
+ * @brief   Dense times packed symmetric matrix multiplication, dst = A*S.
+ *
+ * @param[in]       p_a     Points to m x n dense matrix.
+ * @param[in]       p_s     Points to n x n packed symmetric matrix.
+ * @param[in, out]  p_dst   Points to m x n dense output matrix. Cannot be the same as p_a.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_mul(const matf32_t* const p_a, const matf32_sym_t* const p_s, matf32_t* const p_dst);
+
+
+/**
+ * @brief   Congruence transform dst = A*S*A' + beta*dst. Only the upper triangle of the result is formed,
+ * which saves about half of the flops of the outer product compared to two dense multiplications.
+ *
+ * @param[in]       p_a     Points to m x n dense matrix.
+ * @param[in]       p_s     Points to n x n packed symmetric matrix.
+ * @param[in]       beta    Scale of the previous contents of p_dst (0 to overwrite).
+ * @param[in, out]  p_dst   Points to m x m packed symmetric output matrix. Cannot be the same as p_s.
+ * @param[in, out]  p_work  Points to a work array of at least m*n floats. Holds A*S (row-major) on exit.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_congruence(const matf32_t* const p_a, const matf32_sym_t* const p_s, float beta, matf32_sym_t* const p_dst,
+    float* const p_work);
+
+
+/**
+ * @brief   Symmetric rank-k update dst = dst + alpha*V'*V, upper triangle only.
+ *
+ * @param[in]       p_v     Points to k x n dense matrix.
+ * @param[in]       alpha   Scale of the update (negative for a downdate).
+ * @param[in, out]  p_dst   Points to n x n packed symmetric matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_rank_update(const matf32_t* const p_v, float alpha, matf32_sym_t* const p_dst);
+
+
+// ====================================================================================================
+// Packed Cholesky factorization and solvers
+// ====================================================================================================
+
+
+/**
+ * @brief   In-place Cholesky factorization of a packed symmetric positive definite matrix, A = U'U.
+ * The upper triangular factor U overwrites the packed data, column by column.
+ *
+ * If the pivot of column j is not positive the factorization stops with columns 0..j-1 of U and U(0:j-1, j)
+ * computed, and that pivot A(j,j) - U(0:j-1,j)'U(0:j-1,j) <= 0 stored in place of U(j,j).
+ *
+ * @param[in, out]  p_a     Points to packed matrix to factorize.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_DECOMPOSITION_FAILURE :    Matrix is not positive definite.
+ */
+err_status_t
+matf32_sym_cholesky(matf32_sym_t* const p_a);
+
+
+/**
+ * @brief   Solves U'X = B in place by forward substitution, with U computed by matf32_sym_cholesky.
+ *
+ * @param[in]       p_u     Points to packed Cholesky factor, n x n.
+ * @param[in, out]  p_b     Points to n x k right hand side, overwritten with X.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_cholesky_fwdsub(const matf32_sym_t* const p_u, matf32_t* const p_b);
+
+
+/**
+ * @brief   Solves U'Ux = b with the factor computed by matf32_sym_cholesky.
+ *
+ * @param[in]       p_u     Points to packed Cholesky factor.
+ * @param[in]       p_b     Points to b vector.
+ * @param[in, out]  p_x     Points to output x vector (can be the same as p_b).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+matf32_sym_cholesky_solve(const matf32_sym_t* const p_u, const matf32_t* const p_b, matf32_t* const p_x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_MATF32_SYM_H_
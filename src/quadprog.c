@@ -6,17 +6,6 @@
 
 #include "quadprog.h"
 
-float M_data[MAX_MAT_SIZE];
-matf32_t M;
-
-float y_data[MAX_MAT_SIZE];
-matf32_t y;
-
-float n_data[MAX_MAT_SIZE];
-matf32_t n;
-
-float temp_Aeq_data[MAX_MAT_SIZE];
-matf32_t temp_Aeq;
 
 
 void
@@ -35,6 +24,18 @@ quadprog_init(quadprog_t* const p_qp,
     p_qp->p_x0 = p_x0;
 }
 
+void
+quadprog_workspace_init(quadprog_workspace_t* const p_ws, uint16_t n, uint16_t meq, uint16_t min,
+                        float* p_fwork, int16_t* p_iwork)
+{
+    p_ws->n = n;
+    p_ws->meq = meq;
+    p_ws->min = min;
+    p_ws->p_fwork = p_fwork;
+    p_ws->p_iwork = p_iwork;
+}
+
+
 void
 quadprog_status_print(quadprog_status_t status)
 {
@@ -55,12 +56,39 @@ quadprog_status_print(quadprog_status_t status)
         case QP_NOT_CONVEX:
             printf("QP_NOT_CONVEX\n");
             break;
+
+        case QP_BAD_DEFINED:
+            printf("QP_BAD_DEFINED\n");
+            break;
+
+        case QP_INFEASIBLE:
+            printf("QP_INFEASIBLE\n");
+            break;
+
+        case QP_MAX_ITERATIONS:
+            printf("QP_MAX_ITERATIONS\n");
+            break;
+
+        case QP_TRUNCATED:
+            printf("QP_TRUNCATED\n");
+            break;
+
+        case QP_UNBOUNDED:
+            printf("QP_UNBOUNDED\n");
+            break;
     }
 }
 
 
+static bool
+box_is_bounds(const matf32_t* const p_Ain);
+
+static quadprog_status_t
+box_from_inequalities(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x);
+
+
 quadprog_status_t
-quadprog(quadprog_t* p_qp, matf32_t* const p_x)
+quadprog(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x)
 {
     // badly defined
     if ((NULL == p_qp->p_Q) && (NULL == p_qp->p_c))
@@ -84,275 +112,2458 @@ quadprog(quadprog_t* p_qp, matf32_t* const p_x)
     // equality restrictions
     if ((NULL == p_qp->p_Ain) && (NULL == p_qp->p_bin))
     {
-        return quadprog_qp(p_qp, p_x);
+        return quadprog_qp(p_qp, p_ws, p_x);
+    }
+
+    // bounds only
+    if ((NULL == p_qp->p_Aeq) && (NULL != p_qp->p_Ain) && (NULL != p_qp->p_bin) && box_is_bounds(p_qp->p_Ain))
+    {
+        return box_from_inequalities(p_qp, p_ws, p_x);
     }
 
     // inequality restrictions
     if ((NULL != p_qp->p_Ain) && (NULL != p_qp->p_bin))
     {
-        return quadprog_sqp(p_qp, p_x);
+        return quadprog_sqp(p_qp, p_ws, p_x);
     }
 
-    // general solver? something that can solve a QP with any mix of conditions
+    return QP_BAD_DEFINED;
 }
 
-// TODO: reorder in
-// quadprog_qp for simple case
-// quadprog_sqp for inequality case
-// better error handling
-quadprog_status_t
-quadprog_qp(quadprog_t* p_qp, matf32_t* const p_x)
+// ====================================================================================================
+// Equality constrained problems
+// ====================================================================================================
+
+//
+// The KKT system [Q Aeq'; Aeq 0][x; lambda] = [-c; beq] is never assembled. With Q = U'U the range-space
+// (Schur complement) method solves
+//
+//      (Aeq Q^-1 Aeq') lambda = -(beq + Aeq Q^-1 c),  x = -Q^-1 (c + Aeq' lambda),
+//
+// and with Aeq' = [Y Z][R; 0] the null-space method writes x = Y xy + Z xz and solves
+//
+//      R' xy = beq,  (Z'QZ) xz = -Z'(c + Q Y xy).
+//
+// Both only factor symmetric positive definite matrices with Cholesky.
+
+
+static quadprog_status_t
+quadprog_qp_schur(const quadprog_t* const p_qp, uint16_t n, uint16_t meq, float* p_fwork, matf32_t* const p_x)
 {
+    matf32_sym_t U, S;
+    matf32_t G, t, lambda;
+    float* x = p_x->p_data;
+
+    matf32_sym_init(&U, n, p_fwork);
+    p_fwork += MATF32_SYM_SIZE(n);
+    matf32_init(&t, n, 1, p_fwork);
+    p_fwork += n;
+
+    matf32_sym_from_dense(p_qp->p_Q, &U);
+    if (MATH_SUCCESS != matf32_sym_cholesky(&U))
+    {
+        return QP_NOT_CONVEX;
+    }
+
+    // t = Q^-1 c
+    matf32_sym_cholesky_solve(&U, p_qp->p_c, &t);
 
-    /*
-        * Linear system: My=n
+    memcpy(x, p_qp->p_c->p_data, n*sizeof(float));
+
+    if (meq > 0)
+    {
+        const float* Aeq = p_qp->p_Aeq->p_data;
 
-        create M = [Q Aeq'; Aeq 0]
-        copy Q, Aeq in M
-        transpose Aeq in temp Aeq
-        copy Aeq' en M
+        matf32_init(&lambda, meq, 1, p_fwork);
+        p_fwork += meq;
+        matf32_sym_init(&S, meq, p_fwork);
+        p_fwork += MATF32_SYM_SIZE(meq);
+        matf32_init(&G, n, meq, p_fwork);
 
-        create y = [x; lambda]
+        // S = Aeq Q^-1 Aeq' = G'G with U'G = Aeq'. The transpose is written directly, matf32_trans copies
+        // through a fixed size static buffer
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                G.p_data[i*meq + k] = Aeq[k*n + i];
+            }
+        }
+        matf32_sym_cholesky_fwdsub(&U, &G);
+        memset(S.p_data, 0, MATF32_SYM_SIZE(meq)*sizeof(float));
+        matf32_sym_rank_update(&G, 1.0f, &S);
 
-        create n = [-c, -beq]
-        copy c y beq in n
-        n = -n
+        if (MATH_SUCCESS != matf32_sym_cholesky(&S))
+        {
+            return QP_BAD_DEFINED;
+        }
 
-        solve My=n
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            float sum = p_qp->p_beq->p_data[k];
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                sum += Aeq[k*n + i] * t.p_data[i];
+            }
+            lambda.p_data[k] = -sum;
+        }
+        matf32_sym_cholesky_solve(&S, &lambda, &lambda);
 
-        copy x from y
-    */
+        // x = c + Aeq' lambda
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                x[i] += Aeq[k*n + i] * lambda.p_data[k];
+            }
+        }
+    }
 
-    const matf32_t* p_Q = p_qp->p_Q;
-    const matf32_t* p_c = p_qp->p_c;
-    const matf32_t* p_Aeq = p_qp->p_Aeq;
-    const matf32_t* p_beq = p_qp->p_beq;
+    // x = -Q^-1 (c + Aeq' lambda)
+    matf32_sym_cholesky_solve(&U, p_x, p_x);
+    matf32_scale(p_x, -1, p_x);
 
+    return QP_SUCESS;
+}
 
-#ifdef MATH_MATRIX_CHECK
-    // TODO: add size checks for matrices, use above comment as guide
-#endif
 
+// Householder QR of the n x meq row-major array p_a in place, H_{meq-1}...H_0 A = [R; 0]. The reflector
+// H_j = I - v*v'/(v'v/2) is stored in column j from row j down, R above the diagonal and its diagonal in
+// p_rdiag. Returns false when A does not have full column rank.
+static bool
+null_space_qr(float* const p_a, float* const p_rdiag, uint16_t n, uint16_t meq)
+{
+    for (uint16_t j = 0; j < meq; ++j)
+    {
+        float norm = 0;
+        for (uint16_t i = j; i < n; ++i)
+        {
+            norm += p_a[i*meq + j] * p_a[i*meq + j];
+        }
+        norm = sqrtf(norm);
 
-    uint16_t rows = p_qp->p_Q->num_rows + p_qp->p_Aeq->num_rows; 
-    uint16_t cols = p_qp->p_Q->num_cols + p_qp->p_Aeq->num_rows; // Aeq is used transposed here
+        float alpha = (p_a[j*meq + j] > 0)? -norm : norm;
+        p_rdiag[j] = alpha;
+        if (norm > 0)
+        {
+            p_a[j*meq + j] -= alpha;
+            float vtv_2 = -alpha * p_a[j*meq + j];
 
-    // init matrices
-    matf32_init(&M, rows, cols, M_data);
-    matf32_zeros(&M);
+            for (uint16_t k = j + 1; k < meq; ++k)
+            {
+                float dot = 0;
+                for (uint16_t i = j; i < n; ++i)
+                {
+                    dot += p_a[i*meq + j] * p_a[i*meq + k];
+                }
+                dot /= vtv_2;
+                for (uint16_t i = j; i < n; ++i)
+                {
+                    p_a[i*meq + k] -= dot * p_a[i*meq + j];
+                }
+            }
+        }
+    }
 
-    matf32_init(&y, rows, 1, y_data);
-    matf32_zeros(&y);
+    for (uint16_t k = 0; k < meq; ++k)
+    {
+        if (fabsf(p_rdiag[k]) <= FLT_EPSILON * (1 + fabsf(p_rdiag[0])))
+        {
+            return false;
+        }
+    }
 
-    matf32_init(&n, rows, 1, n_data);
-    matf32_zeros(&n);
+    return true;
+}
 
-    matf32_init(&temp_Aeq, p_Aeq->num_cols, p_Aeq->num_rows, temp_Aeq_data);
 
+// w = H_0...H_{meq-1} w for the reflectors of null_space_qr, w being n elements spaced by stride
+static void
+null_space_apply(const float* const p_a, const float* const p_rdiag, uint16_t n, uint16_t meq, float* const p_w,
+                 uint16_t stride)
+{
+    for (uint16_t j = meq; j-- > 0;)
+    {
+        float vtv_2 = -p_rdiag[j] * p_a[j*meq + j];
+        if (vtv_2 <= 0)
+        {
+            continue;
+        }
 
-    matf32_submatrix_copy(p_Q, &M, 0, 0, 0, 0, p_Q->num_rows, p_Q->num_cols);
+        float dot = 0;
+        for (uint16_t i = j; i < n; ++i)
+        {
+            dot += p_a[i*meq + j] * p_w[i*stride];
+        }
+        dot /= vtv_2;
+        for (uint16_t i = j; i < n; ++i)
+        {
+            p_w[i*stride] -= dot * p_a[i*meq + j];
+        }
+    }
+}
 
-    matf32_submatrix_copy(p_Aeq, &M, 0, 0, p_Q->num_rows, 0, p_Aeq->num_rows, p_Aeq->num_cols);
 
+static quadprog_status_t
+quadprog_qp_null_space(const quadprog_t* const p_qp, uint16_t n, uint16_t meq, float* p_fwork, matf32_t* const p_x)
+{
+    const uint16_t nz = n - meq;
+    const float* Q = p_qp->p_Q->p_data;
+    float* x = p_x->p_data;
+    matf32_t H_rhs;
+    matf32_sym_t H;
+
+    float* A = p_fwork;
+    p_fwork += n*meq;
+    float* rdiag = p_fwork;
+    p_fwork += meq;
+    float* Z = p_fwork;
+    p_fwork += n*nz;
+    float* QZ = p_fwork;
+    p_fwork += n*nz;
+    matf32_sym_init(&H, nz, p_fwork);
+    p_fwork += MATF32_SYM_SIZE(nz);
+    float* g = p_fwork;
+    p_fwork += n;
+    matf32_init(&H_rhs, nz, 1, p_fwork);
+
+    // Aeq' = [Y Z][R; 0] with Y Z the product of the reflectors: Y spans range(Aeq'), Z its null space
+    for (uint16_t k = 0; k < meq; ++k)
+    {
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            A[i*meq + k] = p_qp->p_Aeq->p_data[k*n + i];
+        }
+    }
+    if (!null_space_qr(A, rdiag, n, meq))
+    {
+        return QP_BAD_DEFINED;
+    }
 
-    // transpose A
-    matf32_trans(p_Aeq, &temp_Aeq);
+    // R'xy = beq, x = Y xy
+    for (uint16_t k = 0; k < meq; ++k)
+    {
+        float sum = p_qp->p_beq->p_data[k];
+        for (uint16_t j = 0; j < k; ++j)
+        {
+            sum -= A[j*meq + k] * x[j];
+        }
+        x[k] = sum / rdiag[k];
+    }
+    memset(x + meq, 0, nz*sizeof(float));
+    null_space_apply(A, rdiag, n, meq, x, 1);
 
-    matf32_submatrix_copy(&temp_Aeq, &M, 0, 0, 0, p_Q->num_cols, p_Aeq->num_cols, p_Aeq->num_rows);
+    // Z = Y [0; I]
+    memset(Z, 0, n*nz*sizeof(float));
+    for (uint16_t k = 0; k < nz; ++k)
+    {
+        Z[(meq + k)*nz + k] = 1;
+        null_space_apply(A, rdiag, n, meq, Z + k, nz);
+    }
 
+    // g = c + Q x, QZ = Q Z, H = Z'QZ
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        float sum = p_qp->p_c->p_data[i];
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            sum += Q[i*n + j] * x[j];
+        }
+        g[i] = sum;
 
-    matf32_submatrix_copy(p_c,   &n, 0, 0,               0, 0,   p_c->num_rows, 1);
-    matf32_submatrix_copy(p_beq, &n, 0, 0, p_c->num_rows, 0, p_beq->num_rows, 1);
+        for (uint16_t k = 0; k < nz; ++k)
+        {
+            sum = 0;
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                sum += Q[i*n + j] * Z[j*nz + k];
+            }
+            QZ[i*nz + k] = sum;
+        }
+    }
 
+    for (uint16_t j = 0; j < nz; ++j)
+    {
+        for (uint16_t i = 0; i <= j; ++i)
+        {
+            float sum = 0;
+            for (uint16_t r = 0; r < n; ++r)
+            {
+                sum += Z[r*nz + i] * QZ[r*nz + j];
+            }
+            *matf32_sym_at(&H, i, j) = sum;
+        }
+    }
 
-    matf32_scale(&n, -1, &n);
+    if (MATH_SUCCESS != matf32_sym_cholesky(&H))
+    {
+        return QP_NOT_CONVEX;
+    }
 
-    matf32_linsolve(&M, &n, &y);
+    // (Z'QZ) xz = -Z'g, x = x + Z xz
+    for (uint16_t k = 0; k < nz; ++k)
+    {
+        float sum = 0;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            sum -= Z[i*nz + k] * g[i];
+        }
+        H_rhs.p_data[k] = sum;
+    }
+    matf32_sym_cholesky_solve(&H, &H_rhs, &H_rhs);
 
-    matf32_submatrix_copy(&y, p_x, 0, 0, 0, 0, p_c->num_rows, 1);
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        for (uint16_t k = 0; k < nz; ++k)
+        {
+            x[i] += Z[i*nz + k] * H_rhs.p_data[k];
+        }
+    }
 
     return QP_SUCESS;
 }
 
-// active set binding direction method
+
 quadprog_status_t
-quadprog_sqp(quadprog_t* p_qp, matf32_t* const p_x)
+quadprog_qp(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x)
 {
-    /*
-        Express active set of inequalities as equalities
+    uint16_t n = (NULL != p_qp->p_Q)? p_qp->p_Q->num_rows : 0;
+    uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
 
-        solve each iteration with quadsolve_qp
+    // many equalities leave a small null space, the reduced Hessian is then cheaper than the Schur complement
+    quadprog_kkt_method_t method = (2*meq > n)? QP_KKT_NULL_SPACE : QP_KKT_SCHUR;
 
-        next iteration x = x + alpha*p;
+    return quadprog_qp_method(p_qp, p_ws, p_x, method);
+}
 
-    */
 
-    const matf32_t* p_Q = p_qp->p_Q;
-    const matf32_t* p_c = p_qp->p_c;
-    const matf32_t* p_Aeq = p_qp->p_Aeq;
-    const matf32_t* p_beq = p_qp->p_beq;
-    const matf32_t* p_Ain = p_qp->p_Ain;
-    const matf32_t* p_bin = p_qp->p_bin;
+quadprog_status_t
+quadprog_qp_method(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x,
+                   quadprog_kkt_method_t method)
+{
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return QP_BAD_DEFINED;
+    }
 
-    matf32_t Aeq_zero, beq_zero;
-    matf32_init(&Aeq_zero, 0, 0, NULL);
-    matf32_init(&beq_zero, 0, 0, NULL);
+    uint16_t n = p_qp->p_Q->num_rows;
+    uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
 
-    if (NULL == p_Aeq)
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, n, n) || !matf32_size_check(p_qp->p_c, n, 1) || !matf32_size_check(p_x, n, 1))
     {
-        p_Aeq = &Aeq_zero;
+        return QP_SIZE_MISMATCH;
     }
 
-    if (NULL == p_beq)
+    if ((meq > 0) && (!matf32_size_check(p_qp->p_Aeq, meq, n) || !matf32_size_check(p_qp->p_beq, meq, 1)))
     {
-        p_beq = &beq_zero;
+        return QP_SIZE_MISMATCH;
     }
-
-#ifdef MATH_MATRIX_CHECK
-    // TODO: check size, positive definite
 #endif
 
-    // if available, set starting point
-    if (NULL == p_qp->p_x0)
+    if ((n > p_ws->n) || (meq > p_ws->meq))
     {
-        matf32_zeros(p_x);
+        return QP_SIZE_MISMATCH;
     }
-    else
+
+    if ((QP_KKT_NULL_SPACE == method) && (meq > 0))
     {
-        matf32_copy(p_qp->p_x0, p_x);
+        if (meq > n)
+        {
+            return QP_BAD_DEFINED;
+        }
+        return quadprog_qp_null_space(p_qp, n, meq, p_ws->p_fwork, p_x);
     }
 
-    float p_data[MAX_MAT_SIZE];
-    matf32_t p;
-    matf32_init(&p, p_x->num_rows, 1, p_data);
+    return quadprog_qp_schur(p_qp, n, meq, p_ws->p_fwork, p_x);
+}
+
+
 
+// ====================================================================================================
+// Goldfarb-Idnani dual active-set method
+// ====================================================================================================
 
-    matf32_t sigma;
-    matf32_init(&sigma, p_Ain->num_rows, 1, y_data+p_Aeq->num_rows+1);
 
+#define QP_GI_FEASIBILITY_TOLERANCE (100*FLT_EPSILON)  /**< Relative tolerance of the inequality constraints. */
+#define QP_GI_PIVOT_TOLERANCE       (10*FLT_EPSILON)   /**< Cholesky pivots below this fraction of Q(j,j) are zero. */
+#define QP_GI_CERT_TOLERANCE        (1e3*FLT_EPSILON)  /**< Relative tolerance of an unboundedness certificate. */
 
-    float sub_c_data[MAX_MAT_SIZE];
-    matf32_t sub_c;
-    matf32_init(&sub_c, p_c->num_rows, 1, sub_c_data);
 
+/**
+ * @brief Working data of the dual active-set solver.
+ */
+typedef struct
+{
+    uint16_t n;         /** Number of variables */
+    uint16_t meq;       /** Number of equality constraints */
+    uint16_t min;       /** Number of inequality constraints */
+    float R_norm;       /** Largest diagonal of R, used to detect dependent constraints */
+    float* p_J;         /** n x n, J = U^-1*Q_N */
+    float* p_R;         /** n x n, upper triangular factor of the active normals */
+    float* p_U;         /** Packed Cholesky factor of Q */
+    float* p_d;         /** n, J'*np */
+    float* p_z;         /** n, primal step direction */
+    float* p_np;        /** n, normal of the constraint being added */
+    float* p_x_old;     /** n, primal point before the last add */
+    float* p_x_best;    /** n, least infeasible iterate, returned when the budget runs out */
+    float* p_r;         /** meq+min+1, dual step direction */
+    float* p_u;         /** meq+min+1, multipliers of the active set */
+    float* p_u_old;     /** meq+min+1, multipliers before the last add */
+    float* p_s;         /** min, inequality slacks */
+    int16_t* p_A;       /** meq+min+1, active set (equality k stored as -k-1) */
+    int16_t* p_A_old;   /** meq+min+1, active set before the last add */
+    int16_t* p_iai;     /** min, -1 if inequality is active */
+    int16_t* p_iaexcl;  /** min, false if inequality was found degenerate in this iteration */
+    quadprog_cert_t* p_cert;    /** Certificate storage of the caller, can be NULL */
+} gi_work_t;
+
+//
+// Constraints are handled internally in the form n_k'x + b0_k (= 0 for equalities, >= 0 for inequalities):
+// equality k has n_k = Aeq(k,:)', b0_k = -beq(k) and inequality k has n_k = -Ain(k,:)', b0_k = bin(k).
+//
+// The method starts from the unconstrained minimum (which is dual feasible) and adds violated constraints one
+// at a time. With Q = U'U and N the matrix of active normals, J = U^-1 Q_N and R are kept such that
+// J'N = [R; 0], so adding or dropping a constraint only costs a sequence of Givens rotations on J and R.
+
+
+static void
+gi_normal(const gi_work_t* const p_ws, const quadprog_t* const p_qp, uint16_t k, float* const p_np, float* const p_b0)
+{
+    uint16_t n = p_ws->n;
+
+    if (k < p_ws->meq)
+    {
+        memcpy(p_np, &p_qp->p_Aeq->p_data[k*n], n*sizeof(float));
+        *p_b0 = -p_qp->p_beq->p_data[k];
+    }
+    else
+    {
+        const float* p_row = &p_qp->p_Ain->p_data[(k - p_ws->meq)*n];
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            p_np[i] = -p_row[i];
+        }
+        *p_b0 = p_qp->p_bin->p_data[k - p_ws->meq];
+    }
+}
 
-    float sub_Aeq_data[MAX_MAT_SIZE];
-    matf32_t sub_Aeq;
-    matf32_init(&sub_Aeq, p_Aeq->num_rows + p_Ain->num_rows, p_Ain->num_cols, sub_Aeq_data);
-    matf32_zeros(&sub_Aeq);
-    matf32_submatrix_copy(p_Aeq, &sub_Aeq, 0, 0, 0, 0, p_Aeq->num_rows, p_Aeq->num_cols);
 
+static float
+gi_dot(const float* const p_a, const float* const p_b, uint16_t n)
+{
+    float sum = 0;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        sum += p_a[i] * p_b[i];
+    }
+    return sum;
+}
 
-    float sub_beq_data[MAX_MAT_SIZE];
-    matf32_t sub_beq;
-    matf32_init(&sub_beq, p_beq->num_rows + p_bin->num_rows, 1, sub_beq_data);
-    matf32_zeros(&sub_beq);
 
-    bool flags_active_ineqs[p_Ain->num_rows];
-    float alpha_list[p_Ain->num_rows];
+// d = J'*np, z = J(:,iq:n)*d(iq:n) (primal step direction), r = R^-1*d(0:iq) (dual step direction)
+static void
+gi_step_directions(gi_work_t* const p_ws, uint16_t iq)
+{
+    uint16_t n = p_ws->n;
+    const float* J = p_ws->p_J;
+    const float* R = p_ws->p_R;
 
-    for (uint16_t i = 0; i < p_Ain->num_rows; ++i)
+    for (uint16_t i = 0; i < n; ++i)
     {
-        flags_active_ineqs[i] = false;
+        float sum = 0;
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            sum += J[j*n + i] * p_ws->p_np[j];
+        }
+        p_ws->p_d[i] = sum;
     }
 
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        float sum = 0;
+        for (uint16_t j = iq; j < n; ++j)
+        {
+            sum += J[i*n + j] * p_ws->p_d[j];
+        }
+        p_ws->p_z[i] = sum;
+    }
 
-    float Ain_row_data[MAX_MAT_SIZE];
-    matf32_t Ain_row;
-    matf32_init(&Ain_row, 1, p_Ain->num_cols, Ain_row_data);
+    for (int16_t i = iq-1; i >= 0; --i)
+    {
+        float sum = p_ws->p_d[i];
+        for (uint16_t j = i+1; j < iq; ++j)
+        {
+            sum -= R[i*n + j] * p_ws->p_r[j];
+        }
+        p_ws->p_r[i] = sum / R[i*n + i];
+    }
+}
 
-    // printf("Q:\n");
-    // matf32_print(p_Q);
 
-    // printf("sub_c:\n");
-    // matf32_print(&sub_c);
+// Appends d (already J'*np) as column iq of R, zeroing d(iq+1:n) with Givens rotations applied to J
+static bool
+gi_add_constraint(gi_work_t* const p_ws, uint16_t* const p_iq)
+{
+    uint16_t n = p_ws->n;
+    uint16_t iq = *p_iq;
+    float* J = p_ws->p_J;
+    float* d = p_ws->p_d;
 
-    // printf("sub_Aeq:\n");
-    // matf32_print(&sub_Aeq);
+    for (uint16_t j = n-1; j > iq; --j)
+    {
+        float cc = d[j-1];
+        float ss = d[j];
+        float h = hypotf(cc, ss);
 
-    // printf("sub_beq:\n");
-    // matf32_print(&sub_beq);
+        if (h == 0)
+        {
+            continue;
+        }
 
-    quadprog_t subproblem;
-    quadprog_init(&subproblem, p_Q, &sub_c, &sub_Aeq, &sub_beq, NULL, NULL, NULL);
+        d[j] = 0;
+        cc /= h;
+        ss /= h;
+        if (cc < 0)
+        {
+            cc = -cc;
+            ss = -ss;
+            d[j-1] = -h;
+        }
+        else
+        {
+            d[j-1] = h;
+        }
 
+        float xny = ss / (1 + cc);
+        for (uint16_t k = 0; k < n; ++k)
+        {
+            float t1 = J[k*n + j-1];
+            float t2 = J[k*n + j];
+            J[k*n + j-1] = t1*cc + t2*ss;
+            J[k*n + j] = xny*(t1 + J[k*n + j-1]) - t2;
+        }
+    }
 
+    for (uint16_t i = 0; i <= iq; ++i)
+    {
+        p_ws->p_R[i*n + iq] = d[i];
+    }
+    *p_iq = iq + 1;
 
-    for (uint16_t i = 0; i < MAX_ITERATION_COUNT_SQP; ++i)
+    // new normal is linearly dependent on the active ones
+    if (fabsf(d[iq]) <= FLT_EPSILON * p_ws->R_norm)
     {
-        // prepare subproblem c vector
-        matf32_trans(p_Q, p_Q);
-        matf32_mul(p_Q, p_x, &sub_c);
-        matf32_trans(p_Q, p_Q);
-        matf32_add(p_c, &sub_c, &sub_c);
-        matf32_scale(&sub_c, -1, &sub_c);
+        return false;
+    }
 
-        quadprog_qp(&subproblem, &p);
+    p_ws->R_norm = fmaxf(p_ws->R_norm, fabsf(d[iq]));
+    return true;
+}
 
-        matf32_scale(&sigma, -1, &sigma);
 
-        // p < err
-        if (matf32_is_equal_scalar(&p, 0))
+// Removes active constraint l, restoring the triangular form of R with Givens rotations applied to R and J
+static void
+gi_delete_constraint(gi_work_t* const p_ws, uint16_t* const p_iq, int16_t l)
+{
+    uint16_t n = p_ws->n;
+    uint16_t iq = *p_iq;
+    float* J = p_ws->p_J;
+    float* R = p_ws->p_R;
+    int16_t* A = p_ws->p_A;
+    float* u = p_ws->p_u;
+    uint16_t qq = p_ws->meq;
+
+    for (uint16_t i = p_ws->meq; i < iq; ++i)
+    {
+        if (A[i] == l)
         {
-            if (matf32_is_equal_less_scalar(&sigma, 0))
-            {
-                return QP_SUCESS;
-            }
+            qq = i;
+            break;
+        }
+    }
 
-            for (uint16_t j = 0; j < sigma.num_rows; ++j)
-            {
-                if (sigma.p_data[j] > 0)
-                {
-                    matf32_set_row(&sub_Aeq, j, 0);
-                    flags_active_ineqs[j] = 0;
-                }
-            }
+    for (uint16_t i = qq; i + 1 < iq; ++i)
+    {
+        A[i] = A[i+1];
+        u[i] = u[i+1];
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            R[j*n + i] = R[j*n + i+1];
+        }
+    }
+
+    A[iq-1] = A[iq];
+    u[iq-1] = u[iq];
+    A[iq] = 0;
+    u[iq] = 0;
+    for (uint16_t j = 0; j < iq; ++j)
+    {
+        R[j*n + iq-1] = 0;
+    }
+
+    iq--;
+    *p_iq = iq;
+
+    for (uint16_t j = qq; j < iq; ++j)
+    {
+        float cc = R[j*n + j];
+        float ss = R[(j+1)*n + j];
+        float h = hypotf(cc, ss);
+
+        if (h == 0)
+        {
+            continue;
+        }
+
+        cc /= h;
+        ss /= h;
+        R[(j+1)*n + j] = 0;
+        if (cc < 0)
+        {
+            R[j*n + j] = -h;
+            cc = -cc;
+            ss = -ss;
         }
         else
         {
-            float alpha = 1.0/0.0;
-            float alpha_temp = 0;
-            uint16_t alpha_index = 0;
+            R[j*n + j] = h;
+        }
+
+        float xny = ss / (1 + cc);
+        for (uint16_t k = j+1; k < iq; ++k)
+        {
+            float t1 = R[j*n + k];
+            float t2 = R[(j+1)*n + k];
+            R[j*n + k] = t1*cc + t2*ss;
+            R[(j+1)*n + k] = xny*(t1 + R[j*n + k]) - t2;
+        }
+        for (uint16_t k = 0; k < n; ++k)
+        {
+            float t1 = J[k*n + j];
+            float t2 = J[k*n + j+1];
+            J[k*n + j] = t1*cc + t2*ss;
+            J[k*n + j+1] = xny*(J[k*n + j] + t1) - t2;
+        }
+    }
+}
+
+
+// Next violated inequality: previously active ones first (warm start), then the most violated
+static int16_t
+gi_select(const gi_work_t* const p_ws, const quadprog_active_set_t* const p_warm)
+{
+    const float* s = p_ws->p_s;
 
-            for (uint16_t j = 0; j < p_Ain->num_rows; ++j)
+    if (NULL != p_warm)
+    {
+        for (uint16_t k = 0; k < p_warm->num_active; ++k)
+        {
+            uint16_t i = p_warm->p_index[k];
+            if ((i < p_ws->min) && (s[i] < 0) && (p_ws->p_iai[i] != -1) && p_ws->p_iaexcl[i])
             {
-                matf32_submatrix_copy(p_Ain, &Ain_row, j, 0, 0, 0, 1, p_Ain->num_cols);
+                return i;
+            }
+        }
+    }
 
-                float ain_row_p = 0;
-                matf32_dot(&Ain_row, &p, &ain_row_p);
+    float ss = 0;
+    int16_t ip = -1;
+    for (uint16_t i = 0; i < p_ws->min; ++i)
+    {
+        if ((s[i] < ss) && (p_ws->p_iai[i] != -1) && p_ws->p_iaexcl[i])
+        {
+            ss = s[i];
+            ip = i;
+        }
+    }
 
-                float ain_row_x = 0;
-                matf32_dot(&Ain_row, p_x, &ain_row_x);
+    return ip;
+}
 
-                if (1 == flags_active_ineqs[j] || ain_row_p >= 0)
-                {
-                    continue;
-                }
-                else
-                {
-                    alpha_temp = (ain_row_x + p_bin->p_data[j])/ain_row_p;
-                }
 
-                if (alpha_temp < alpha)
-                {
-                    alpha = alpha_temp;
-                    alpha_index = j;
-                }
-            }
+static void
+gi_normalize(float* const p_v, uint16_t n)
+{
+    float v_max = 0;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        v_max = fmaxf(v_max, fabsf(p_v[i]));
+    }
+    for (uint16_t i = 0; (i < n) && (v_max > 0); ++i)
+    {
+        p_v[i] /= v_max;
+    }
+}
 
-            if (alpha < 1)
-            {
-                matf32_submatrix_copy(p_Ain, &sub_Aeq,
-                                        alpha_index, 0,
-                                        p_Aeq->num_rows + alpha_index, 0,
-                                        1, p_Ain->num_cols);
 
-                flags_active_ineqs[alpha_index] = 1;
+// Farkas certificate from a constraint row_new whose normal is N*r, the combination of the iq active normals
+// in the current step directions: u = [-r; 1] gives sum u_k n_k = 0. In the [y_eq; y_in] convention y_eq = -u
+// and y_in = u. With only equalities involved the sign is free and chosen so that beq'y_eq + bin'y_in < 0.
+static void
+gi_farkas(const gi_work_t* const p_ws, const quadprog_t* const p_qp, uint16_t iq, uint16_t row_new,
+          float* const p_y)
+{
+    const uint16_t meq = p_ws->meq;
+    float by = 0;
 
-                matf32_scale(&p, alpha, &p);
-            }
+    memset(p_y, 0, (meq + p_ws->min)*sizeof(float));
+    for (uint16_t k = 0; k <= iq; ++k)
+    {
+        uint16_t row = row_new;
+        float u = 1;
+        if (k < iq)
+        {
+            row = (p_ws->p_A[k] < 0)? (uint16_t)(-p_ws->p_A[k] - 1) : meq + p_ws->p_A[k];
+            u = -p_ws->p_r[k];
+        }
+        p_y[row] += (row < meq)? -u : u;
+    }
 
-            matf32_sub(p_x, &p, p_x);
+    for (uint16_t k = 0; k < meq + p_ws->min; ++k)
+    {
+        by += p_y[k] * ((k < meq)? p_qp->p_beq->p_data[k] : p_qp->p_bin->p_data[k - meq]);
+    }
+    if ((row_new < meq) && (by > 0))
+    {
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            p_y[k] = -p_y[k];
         }
     }
+
+    gi_normalize(p_y, meq + p_ws->min);
+}
+
+
+// Direction d = [-U11^-1*U(0:j,j); 1; 0] of a Cholesky factor that broke down at pivot j, d'Qd is that pivot.
+// It proves unboundedness if Qd = 0, Aeq d = 0 and c'd != 0 with Ain d <= 0 for the sign that makes c'd < 0.
+static quadprog_status_t
+gi_curvature(gi_work_t* const p_ws, const quadprog_t* const p_qp, const matf32_sym_t* const p_U, uint16_t j)
+{
+    const uint16_t n = p_ws->n;
+    const float* Q = p_qp->p_Q->p_data;
+    float* d = p_ws->p_z;
+
+    memset(d, 0, n*sizeof(float));
+    d[j] = 1;
+    for (int16_t i = j - 1; i >= 0; --i)
+    {
+        float sum = -p_U->p_data[matf32_sym_idx(i, j)];
+        for (uint16_t k = i + 1; k < j; ++k)
+        {
+            sum -= p_U->p_data[matf32_sym_idx(i, k)] * d[k];
+        }
+        d[i] = sum / p_U->p_data[matf32_sym_idx(i, i)];
+    }
+    gi_normalize(d, n);
+
+    float q_max = 0;
+    float Qd_max = 0;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        Qd_max = fmaxf(Qd_max, fabsf(gi_dot(&Q[i*n], d, n)));
+        for (uint16_t k = 0; k < n; ++k)
+        {
+            q_max = fmaxf(q_max, fabsf(Q[i*n + k]));
+        }
+    }
+
+    float c_max = 0;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        c_max = fmaxf(c_max, fabsf(p_qp->p_c->p_data[i]));
+    }
+    float cd = gi_dot(p_qp->p_c->p_data, d, n);
+
+    quadprog_status_t status = QP_NOT_CONVEX;
+    if ((Qd_max <= QP_GI_CERT_TOLERANCE*q_max) && (fabsf(cd) > QP_GI_CERT_TOLERANCE*c_max))
+    {
+        float sign = (cd > 0)? -1.0f : 1.0f;
+        status = QP_UNBOUNDED;
+
+        // rows are compared to the tolerance times their largest entry
+        for (uint16_t k = 0; (k < p_ws->meq + p_ws->min) && (QP_UNBOUNDED == status); ++k)
+        {
+            float b0;
+            gi_normal(p_ws, p_qp, k, p_ws->p_np, &b0);
+
+            float a_max = 0;
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                a_max = fmaxf(a_max, fabsf(p_ws->p_np[i]));
+            }
+
+            float nd = sign * gi_dot(p_ws->p_np, d, n);
+            if (((k < p_ws->meq) && (fabsf(nd) > QP_GI_CERT_TOLERANCE*a_max))
+                || ((k >= p_ws->meq) && (nd < -QP_GI_CERT_TOLERANCE*a_max)))
+            {
+                status = QP_NOT_CONVEX;
+            }
+        }
+
+        for (uint16_t i = 0; (i < n) && (QP_UNBOUNDED == status); ++i)
+        {
+            d[i] *= sign;
+        }
+    }
+
+    if ((NULL != p_ws->p_cert) && (NULL != p_ws->p_cert->p_d))
+    {
+        memcpy(p_ws->p_cert->p_d, d, n*sizeof(float));
+    }
+
+    return status;
+}
+
+
+// Q = U'U, kept in the workspace for later solves with the same Q. A pivot that is not positive, or that lost
+// all but rounding of Q(j,j) (Q is semidefinite), gives a curvature direction instead.
+static quadprog_status_t
+gi_factor(gi_work_t* const p_ws, const quadprog_t* const p_qp)
+{
+    matf32_sym_t U;
+
+    matf32_sym_init(&U, p_ws->n, p_ws->p_U);
+    matf32_sym_from_dense(p_qp->p_Q, &U);
+
+    bool is_pd = (MATH_SUCCESS == matf32_sym_cholesky(&U));
+
+    for (uint16_t j = 0; j < p_ws->n; ++j)
+    {
+        float pivot = U.p_data[matf32_sym_idx(j, j)];
+        if (!is_pd && (pivot <= 0))
+        {
+            return gi_curvature(p_ws, p_qp, &U, j);
+        }
+        if (is_pd && (pivot*pivot <= QP_GI_PIVOT_TOLERANCE*p_qp->p_Q->p_data[j*p_ws->n + j]))
+        {
+            return gi_curvature(p_ws, p_qp, &U, j);
+        }
+    }
+
+    return QP_SUCESS;
+}
+
+
+// Starts from the unconstrained minimum with J = U^-1 (so that J*J' = Q^-1) and adds the equalities
+static quadprog_status_t
+gi_start_cold(gi_work_t* const p_ws, const quadprog_t* const p_qp, matf32_t* const p_x, uint16_t* const p_iq)
+{
+    const uint16_t n = p_ws->n;
+    const uint16_t meq = p_ws->meq;
+    float* x = p_x->p_data;
+    float* J = p_ws->p_J;
+    float* u = p_ws->p_u;
+    float* r = p_ws->p_r;
+    float* z = p_ws->p_z;
+    float* np = p_ws->p_np;
+    int16_t* A = p_ws->p_A;
+    float b0;
+    uint16_t iq = 0;
+    matf32_sym_t U;
+    matf32_t c;
+
+    matf32_sym_init(&U, n, p_ws->p_U);
+    memset(p_ws->p_R, 0, n*n*sizeof(float));
+
+    memset(J, 0, n*n*sizeof(float));
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        J[i*n + i] = 1;
+        for (int16_t j = i; j >= 0; --j)
+        {
+            const float* p_col = &U.p_data[matf32_sym_idx(0, j)];
+
+            J[j*n + i] /= p_col[j];
+            for (uint16_t k = 0; k < j; ++k)
+            {
+                J[k*n + i] -= p_col[k] * J[j*n + i];
+            }
+        }
+    }
+
+    // unconstrained minimum x = -Q^-1*c
+    matf32_init(&c, n, 1, p_qp->p_c->p_data);
+    matf32_sym_cholesky_solve(&U, &c, p_x);
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        x[i] = -x[i];
+    }
+
+    p_ws->R_norm = 1;
+
+    // equality constraints are added with full steps and never dropped
+    for (uint16_t k = 0; k < meq; ++k)
+    {
+        gi_normal(p_ws, p_qp, k, np, &b0);
+        gi_step_directions(p_ws, iq);
+
+        float t2 = 0;
+        float ntx = gi_dot(np, x, n);
+        float ztn = gi_dot(z, np, n);
+        if (gi_dot(z, z, n) > FLT_EPSILON)
+        {
+            t2 = -(ntx + b0) / ztn;
+        }
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            x[i] += t2 * z[i];
+        }
+        u[iq] = t2;
+        for (uint16_t i = 0; i < iq; ++i)
+        {
+            u[i] -= t2 * r[i];
+        }
+        A[iq] = -(int16_t)k - 1;
+
+        if (!gi_add_constraint(p_ws, &iq))
+        {
+            // equality k depends on the previous ones, it is only an error if it contradicts them
+            *p_iq = iq;
+            if (fabsf(ntx + b0) <= QP_GI_FEASIBILITY_TOLERANCE*(1 + fabsf(ntx) + fabsf(b0)))
+            {
+                return QP_BAD_DEFINED;
+            }
+            if ((NULL != p_ws->p_cert) && (NULL != p_ws->p_cert->p_y))
+            {
+                gi_farkas(p_ws, p_qp, iq - 1, k, p_ws->p_cert->p_y);
+            }
+            return QP_INFEASIBLE;
+        }
+    }
+
+    *p_iq = iq;
+
+    return QP_SUCESS;
+}
+
+
+// Solves the problem restricted to the active set A (J and R already factored) for the current c and b:
+// with J'N = [R; 0], x = J1*w - J2*J2'*c with R'w = -b0 and u = R^-1*(w + J1'*c)
+static void
+gi_active_solution(gi_work_t* const p_ws, const quadprog_t* const p_qp, float* const x, uint16_t iq)
+{
+    const uint16_t n = p_ws->n;
+    const float* J = p_ws->p_J;
+    const float* R = p_ws->p_R;
+    const float* c = p_qp->p_c->p_data;
+    float* w = p_ws->p_d;
+    float* u = p_ws->p_u;
+    float b0;
+
+    for (uint16_t k = 0; k < iq; ++k)
+    {
+        int16_t a = p_ws->p_A[k];
+        gi_normal(p_ws, p_qp, (a < 0)? (uint16_t)(-a - 1) : p_ws->meq + a, p_ws->p_np, &b0);
+
+        float sum = -b0;
+        for (uint16_t j = 0; j < k; ++j)
+        {
+            sum -= R[j*n + k] * w[j];
+        }
+        w[k] = sum / R[k*n + k];
+    }
+
+    for (uint16_t k = iq; k < n; ++k)
+    {
+        w[k] = 0;
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            w[k] -= J[j*n + k] * c[j];
+        }
+    }
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        x[i] = gi_dot(&J[i*n], w, n);
+    }
+
+    for (int16_t k = iq - 1; k >= 0; --k)
+    {
+        float sum = w[k];
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            sum += J[j*n + k] * c[j];
+        }
+        for (uint16_t j = k + 1; j < iq; ++j)
+        {
+            sum -= R[k*n + j] * u[j];
+        }
+        u[k] = sum / R[k*n + k];
+    }
+}
+
+
+// Restarts from the active set kept in J, R and A by a previous solve: the restricted problem is solved for
+// the new c and b, and inequalities with negative multipliers are dropped until the point is dual feasible
+static uint16_t
+gi_start_warm(gi_work_t* const p_ws, const quadprog_t* const p_qp, matf32_t* const p_x, uint16_t* const p_iq)
+{
+    uint16_t drops = 0;
+
+    while (true)
+    {
+        gi_active_solution(p_ws, p_qp, p_x->p_data, *p_iq);
+
+        int16_t l = -1;
+        float u_min = 0;
+        for (uint16_t k = p_ws->meq; k < *p_iq; ++k)
+        {
+            if (p_ws->p_u[k] < u_min)
+            {
+                u_min = p_ws->p_u[k];
+                l = p_ws->p_A[k];
+            }
+        }
+
+        if (l < 0)
+        {
+            return drops;
+        }
+
+        gi_delete_constraint(p_ws, p_iq, l);
+        drops++;
+    }
+}
+
+
+// 1/2 x'Qx + c'x
+static float
+gi_cost(const gi_work_t* const p_ws, const quadprog_t* const p_qp, const float* const x)
+{
+    const uint16_t n = p_ws->n;
+    float cost = 0;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        cost += x[i] * (p_qp->p_c->p_data[i] + 0.5f*gi_dot(&p_qp->p_Q->p_data[i*n], x, n));
+    }
+
+    return cost;
+}
+
+
+// Largest violation of the equalities and inequalities at x
+static float
+gi_violation(gi_work_t* const p_ws, const quadprog_t* const p_qp, const float* const x)
+{
+    float viol = 0;
+    float b0;
+
+    for (uint16_t k = 0; k < p_ws->meq + p_ws->min; ++k)
+    {
+        gi_normal(p_ws, p_qp, k, p_ws->p_np, &b0);
+        float s = gi_dot(p_ws->p_np, x, p_ws->n) + b0;
+        viol = fmaxf(viol, (k < p_ws->meq)? fabsf(s) : -s);
+    }
+
+    return viol;
+}
+
+
+// Budget exhausted at iteration iter, t0 is the clock at the start of the call
+static bool
+gi_budget_spent(const quadprog_budget_t* const p_budget, uint16_t iter, uint32_t t0)
+{
+    if (NULL == p_budget)
+    {
+        return iter >= MAX_ITERATION_COUNT_SQP;
+    }
+
+    if (iter >= ((0 != p_budget->max_iter)? p_budget->max_iter : MAX_ITERATION_COUNT_SQP))
+    {
+        return true;
+    }
+
+    // unsigned difference, correct across a wrap of the counter
+    return (NULL != p_budget->p_clock) && ((uint32_t)(p_budget->p_clock(p_budget->p_ctx) - t0) >= p_budget->max_ticks);
+}
+
+
+// Dual active-set iteration from a dual feasible start, followed by one refinement step. Stops early when the
+// budget (NULL for MAX_ITERATION_COUNT_SQP iterations) runs out, leaving the least infeasible iterate in p_x.
+static quadprog_status_t
+gi_iterate(gi_work_t* const p_ws, const quadprog_t* const p_qp, matf32_t* const p_x,
+           const quadprog_active_set_t* const p_warm, uint16_t* const p_iq,
+           const quadprog_budget_t* const p_budget, uint32_t t0, quadprog_stats_t* const p_stats)
+{
+    const uint16_t n = p_ws->n;
+    const uint16_t meq = p_ws->meq;
+    const uint16_t min = p_ws->min;
+    float* x = p_x->p_data;
+    float* J = p_ws->p_J;
+    float* u = p_ws->p_u;
+    float* r = p_ws->p_r;
+    float* z = p_ws->p_z;
+    float* np = p_ws->p_np;
+    int16_t* A = p_ws->p_A;
+    float b0;
+
+    for (uint16_t i = 0; i < min; ++i)
+    {
+        p_ws->p_iai[i] = i;
+    }
+
+    quadprog_status_t status = QP_MAX_ITERATIONS;
+    uint16_t iq = *p_iq;
+    float viol_best = INFINITY;
+
+    uint16_t iter;
+    for (iter = 0; ; ++iter)
+    {
+        // step 1: evaluate all inequalities at the current point
+        for (uint16_t i = meq; i < iq; ++i)
+        {
+            p_ws->p_iai[A[i]] = -1;
+        }
+
+        // a violation within the rounding of n'x + b0 is not one
+        float psi = 0;
+        float viol = 0;
+        for (uint16_t i = 0; i < min; ++i)
+        {
+            p_ws->p_iaexcl[i] = true;
+            gi_normal(p_ws, p_qp, meq + i, np, &b0);
+
+            float ntx = gi_dot(np, x, n);
+            p_ws->p_s[i] = ntx + b0;
+            if (p_ws->p_s[i] > -QP_GI_FEASIBILITY_TOLERANCE*(1 + fabsf(ntx) + fabsf(b0)))
+            {
+                p_ws->p_s[i] = fmaxf(p_ws->p_s[i], 0);
+            }
+            psi += fminf(0, p_ws->p_s[i]);
+            viol = fmaxf(viol, -p_ws->p_s[i]);
+        }
+
+        if (0 == psi)
+        {
+            status = QP_SUCESS;
+            break;
+        }
+
+        if (viol < viol_best)
+        {
+            viol_best = viol;
+            memcpy(p_ws->p_x_best, x, n*sizeof(float));
+        }
+
+        if (gi_budget_spent(p_budget, iter, t0))
+        {
+            status = (NULL != p_budget)? QP_TRUNCATED : QP_MAX_ITERATIONS;
+            break;
+        }
+
+        memcpy(p_ws->p_u_old, u, iq*sizeof(float));
+        memcpy(p_ws->p_A_old, A, iq*sizeof(int16_t));
+        memcpy(p_ws->p_x_old, x, n*sizeof(float));
+
+        // step 2: choose a violated constraint
+        int16_t ip;
+step2:
+        ip = gi_select(p_ws, p_warm);
+        if (ip < 0)
+        {
+            status = QP_SUCESS;
+            break;
+        }
+
+        gi_normal(p_ws, p_qp, meq + ip, np, &b0);
+        u[iq] = 0;
+        A[iq] = ip;
+
+step2a:
+        // step 2a: primal and dual step directions
+        gi_step_directions(p_ws, iq);
+
+        // step 2b: partial step length t1 (keeps duals feasible) and full step length t2
+        int16_t l = 0;
+        float t1 = INFINITY;
+        for (uint16_t k = meq; k < iq; ++k)
+        {
+            if ((r[k] > 0) && (u[k] / r[k] < t1))
+            {
+                t1 = u[k] / r[k];
+                l = A[k];
+            }
+        }
+
+        float t2 = INFINITY;
+        if (gi_dot(z, z, n) > FLT_EPSILON)
+        {
+            t2 = -p_ws->p_s[ip] / gi_dot(z, np, n);
+        }
+
+        float t = fminf(t1, t2);
+
+        // step 2c: no step in primal or dual space, the constraints are inconsistent
+        if (isinf(t))
+        {
+            if ((NULL != p_ws->p_cert) && (NULL != p_ws->p_cert->p_y))
+            {
+                gi_farkas(p_ws, p_qp, iq, meq + ip, p_ws->p_cert->p_y);
+            }
+            status = QP_INFEASIBLE;
+            break;
+        }
+
+        // step in dual space only
+        if (isinf(t2))
+        {
+            for (uint16_t k = 0; k < iq; ++k)
+            {
+                u[k] -= t * r[k];
+            }
+            u[iq] += t;
+            p_ws->p_iai[l] = l;
+            gi_delete_constraint(p_ws, &iq, l);
+            p_stats->drops++;
+            goto step2a;
+        }
+
+        // step in primal and dual space
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            x[i] += t * z[i];
+        }
+        for (uint16_t k = 0; k < iq; ++k)
+        {
+            u[k] -= t * r[k];
+        }
+        u[iq] += t;
+
+        if (t2 <= t1)
+        {
+            // full step, add constraint ip to the active set
+            if (!gi_add_constraint(p_ws, &iq))
+            {
+                // degenerate, exclude ip and restore the previous state
+                p_ws->p_iaexcl[ip] = false;
+                gi_delete_constraint(p_ws, &iq, ip);
+                for (uint16_t i = 0; i < min; ++i)
+                {
+                    p_ws->p_iai[i] = i;
+                }
+                for (uint16_t i = meq; i < iq; ++i)
+                {
+                    A[i] = p_ws->p_A_old[i];
+                    u[i] = p_ws->p_u_old[i];
+                    p_ws->p_iai[A[i]] = -1;
+                }
+                memcpy(x, p_ws->p_x_old, n*sizeof(float));
+                goto step2;
+            }
+            p_ws->p_iai[ip] = -1;
+            p_stats->adds++;
+            continue;
+        }
+
+        // partial step, drop the blocking constraint l and retry ip
+        p_ws->p_iai[l] = l;
+        gi_delete_constraint(p_ws, &iq, l);
+        p_stats->drops++;
+        p_ws->p_s[ip] = gi_dot(np, x, n) + b0;
+        goto step2a;
+    }
+
+    // one step of iterative refinement on the KKT conditions of the final active set, with the residuals
+    // r1 = Q*x + c - N*u and r2 = N'x + b0 the correction is dx = -J2*J2'*r1 - J1*R^-T*r2
+    if (QP_SUCESS == status)
+    {
+        float* t = p_ws->p_d;
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            z[i] = p_qp->p_c->p_data[i];
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                z[i] += p_qp->p_Q->p_data[i*n + j] * x[j];
+            }
+        }
+
+        for (uint16_t k = 0; k < iq; ++k)
+        {
+            uint16_t row = (A[k] < 0)? (uint16_t)(-A[k] - 1) : meq + A[k];
+            gi_normal(p_ws, p_qp, row, np, &b0);
+
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                z[i] -= u[k] * np[i];
+            }
+
+            float sum = gi_dot(np, x, n) + b0;
+            for (uint16_t j = 0; j < k; ++j)
+            {
+                sum -= p_ws->p_R[j*n + k] * t[j];
+            }
+            t[k] = sum / p_ws->p_R[k*n + k];
+        }
+
+        for (uint16_t i = iq; i < n; ++i)
+        {
+            t[i] = 0;
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                t[i] += J[j*n + i] * z[j];
+            }
+        }
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            x[i] -= gi_dot(&J[i*n], t, n);
+        }
+    }
+
+    // the last iterate solves a relaxation of the problem, its cost bounds the optimum from below
+    p_stats->bound = gi_cost(p_ws, p_qp, x);
+    if (QP_TRUNCATED == status)
+    {
+        memcpy(x, p_ws->p_x_best, n*sizeof(float));
+    }
+
+    *p_iq = iq;
+    p_stats->iter += iter;
+
+    return status;
+}
+
+
+// Fills the residual and cost of the returned point and the ticks used
+static void
+gi_stats_finish(gi_work_t* const p_ws, const quadprog_t* const p_qp, const float* const x,
+                const quadprog_budget_t* const p_budget, uint32_t t0, quadprog_stats_t* const p_stats)
+{
+    p_stats->r_prim = gi_violation(p_ws, p_qp, x);
+    p_stats->cost = gi_cost(p_ws, p_qp, x);
+    p_stats->ticks = ((NULL != p_budget) && (NULL != p_budget->p_clock))?
+                     (uint32_t)(p_budget->p_clock(p_budget->p_ctx) - t0) : 0;
+}
+
+
+static void
+gi_active_set_store(const gi_work_t* const p_ws, uint16_t iq, quadprog_active_set_t* const p_active)
+{
+    p_active->num_active = 0;
+    for (uint16_t i = p_ws->meq; i < iq; ++i)
+    {
+        p_active->p_index[p_active->num_active] = p_ws->p_A[i];
+        p_active->p_lambda[p_active->num_active] = p_ws->p_u[i];
+        p_active->num_active++;
+    }
+}
+
+
+// Checks the problem against the workspace and points the solver data into it
+static quadprog_status_t
+gi_work_init(gi_work_t* const p_ws, const quadprog_t* const p_qp, const quadprog_workspace_t* const p_work,
+             const matf32_t* const p_x)
+{
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return QP_BAD_DEFINED;
+    }
+
+    p_ws->n = p_qp->p_Q->num_rows;
+    p_ws->meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+    p_ws->min = (NULL != p_qp->p_Ain)? p_qp->p_Ain->num_rows : 0;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, p_ws->n, p_ws->n) || !matf32_size_check(p_qp->p_c, p_ws->n, 1)
+        || !matf32_size_check(p_x, p_ws->n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((p_ws->meq > 0)
+        && (!matf32_size_check(p_qp->p_Aeq, p_ws->meq, p_ws->n) || !matf32_size_check(p_qp->p_beq, p_ws->meq, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((p_ws->min > 0)
+        && (!matf32_size_check(p_qp->p_Ain, p_ws->min, p_ws->n) || !matf32_size_check(p_qp->p_bin, p_ws->min, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    if ((p_ws->n > p_work->n) || (p_ws->meq > p_work->meq) || (p_ws->min > p_work->min))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    uint16_t m = p_ws->meq + p_ws->min + 1;
+
+    p_ws->p_J = p_work->p_fwork;
+    p_ws->p_R = &p_ws->p_J[p_ws->n*p_ws->n];
+    p_ws->p_U = &p_ws->p_R[p_ws->n*p_ws->n];
+    p_ws->p_d = &p_ws->p_U[MATF32_SYM_SIZE(p_ws->n)];
+    p_ws->p_z = &p_ws->p_d[p_ws->n];
+    p_ws->p_np = &p_ws->p_z[p_ws->n];
+    p_ws->p_x_old = &p_ws->p_np[p_ws->n];
+    p_ws->p_x_best = &p_ws->p_x_old[p_ws->n];
+    p_ws->p_r = &p_ws->p_x_best[p_ws->n];
+    p_ws->p_u = &p_ws->p_r[m];
+    p_ws->p_u_old = &p_ws->p_u[m];
+    p_ws->p_s = &p_ws->p_u_old[m];
+    p_ws->p_A = p_work->p_iwork;
+    p_ws->p_A_old = &p_ws->p_A[m];
+    p_ws->p_iai = &p_ws->p_A_old[m];
+    p_ws->p_iaexcl = &p_ws->p_iai[p_ws->min];
+    p_ws->p_cert = NULL;
+
+    return QP_SUCESS;
+}
+
+
+quadprog_status_t
+quadprog_gi(quadprog_t* p_qp, quadprog_workspace_t* const p_work, matf32_t* const p_x,
+            quadprog_active_set_t* const p_active)
+{
+    return quadprog_gi_budget(p_qp, p_work, p_x, p_active, NULL, NULL, NULL);
+}
+
+
+quadprog_status_t
+quadprog_gi_budget(quadprog_t* p_qp, quadprog_workspace_t* const p_work, matf32_t* const p_x,
+                   quadprog_active_set_t* const p_active, const quadprog_budget_t* const p_budget,
+                   quadprog_stats_t* const p_stats, quadprog_cert_t* const p_cert)
+{
+    gi_work_t ws;
+    uint16_t iq;
+    quadprog_stats_t stats = {0};
+    uint32_t t0 = ((NULL != p_budget) && (NULL != p_budget->p_clock))? p_budget->p_clock(p_budget->p_ctx) : 0;
+
+    quadprog_status_t status = gi_work_init(&ws, p_qp, p_work, p_x);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    if ((NULL != p_active) && (ws.min > MAX_CONSTRAINT_COUNT_QP))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+    ws.p_cert = p_cert;
+
+    status = gi_factor(&ws, p_qp);
+    if (QP_SUCESS == status)
+    {
+        status = gi_start_cold(&ws, p_qp, p_x, &iq);
+    }
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    const quadprog_active_set_t* p_warm = ((NULL != p_active) && (p_active->num_active > 0))? p_active : NULL;
+    status = gi_iterate(&ws, p_qp, p_x, p_warm, &iq, p_budget, t0, &stats);
+
+    if (NULL != p_active)
+    {
+        gi_active_set_store(&ws, iq, p_active);
+    }
+
+    if (NULL != p_stats)
+    {
+        gi_stats_finish(&ws, p_qp, p_x->p_data, p_budget, t0, &stats);
+        *p_stats = stats;
+    }
+
+    return status;
+}
+
+
+quadprog_status_t
+quadprog_sqp(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x)
+{
+    return quadprog_gi(p_qp, p_ws, p_x, NULL);
+}
+
+
+void
+quadprog_warm_init(quadprog_warm_t* const p_h, quadprog_workspace_t* const p_ws)
+{
+    p_h->p_ws = p_ws;
+    p_h->iter = 0;
+    quadprog_warm_reset(p_h);
+}
+
+
+void
+quadprog_warm_reset(quadprog_warm_t* const p_h)
+{
+    p_h->is_factored = false;
+    p_h->is_warm = false;
+    p_h->num_constraints = 0;
+    p_h->active.num_active = 0;
+}
+
+
+quadprog_status_t
+quadprog_solve_warm(quadprog_warm_t* const p_h, quadprog_t* p_qp, matf32_t* const p_x)
+{
+    return quadprog_solve_warm_budget(p_h, p_qp, p_x, NULL, NULL, NULL);
+}
+
+
+quadprog_status_t
+quadprog_solve_warm_budget(quadprog_warm_t* const p_h, quadprog_t* p_qp, matf32_t* const p_x,
+                           const quadprog_budget_t* const p_budget, quadprog_stats_t* const p_stats,
+                           quadprog_cert_t* const p_cert)
+{
+    gi_work_t ws;
+    uint16_t iq = p_h->num_constraints;
+    quadprog_stats_t stats = {0};
+    uint32_t t0 = ((NULL != p_budget) && (NULL != p_budget->p_clock))? p_budget->p_clock(p_budget->p_ctx) : 0;
+
+    quadprog_status_t status = gi_work_init(&ws, p_qp, p_h->p_ws, p_x);
+    if ((QP_SUCESS == status) && (ws.min > MAX_CONSTRAINT_COUNT_QP))
+    {
+        status = QP_SIZE_MISMATCH;
+    }
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+    ws.p_cert = p_cert;
+
+    if (!p_h->is_factored)
+    {
+        status = gi_factor(&ws, p_qp);
+        if (QP_SUCESS != status)
+        {
+            return status;
+        }
+        p_h->is_factored = true;
+        p_h->is_warm = false;
+    }
+
+    if (p_h->is_warm)
+    {
+        // J, R and the active set of the previous solve are still in the workspace
+        ws.R_norm = 1;
+        for (uint16_t k = 0; k < iq; ++k)
+        {
+            ws.R_norm = fmaxf(ws.R_norm, fabsf(ws.p_R[k*ws.n + k]));
+        }
+        stats.drops = gi_start_warm(&ws, p_qp, p_x, &iq);
+    }
+    else
+    {
+        status = gi_start_cold(&ws, p_qp, p_x, &iq);
+    }
+
+    if (QP_SUCESS == status)
+    {
+        status = gi_iterate(&ws, p_qp, p_x, NULL, &iq, p_budget, t0, &stats);
+    }
+
+    // a failed solve leaves J and R in an unknown state, the next call starts cold from the kept Cholesky factor;
+    // a truncated one stopped between iterations with a consistent active set and resumes from it
+    bool is_consistent = (QP_SUCESS == status) || (QP_TRUNCATED == status);
+    p_h->is_warm = is_consistent;
+    p_h->num_constraints = iq;
+    p_h->iter = stats.adds + stats.drops;
+    gi_active_set_store(&ws, is_consistent? iq : ws.meq, &p_h->active);
+
+    if (NULL != p_stats)
+    {
+        gi_stats_finish(&ws, p_qp, p_x->p_data, p_budget, t0, &stats);
+        *p_stats = stats;
+    }
+
+    return status;
+}
+
+
+
+// ====================================================================================================
+// Mehrotra predictor-corrector interior-point method
+// ====================================================================================================
+
+#define QP_IPM_TOLERANCE        (1e-5)  /**< Relative tolerance of the primal and dual residuals. */
+#define QP_IPM_MU_TOLERANCE     (1e-7)  /**< Relative tolerance of the average complementarity s'z/min. */
+#define QP_IPM_STEP_MIN         (1e-8)  /**< Step length below which the iteration is considered stalled. */
+#define QP_IPM_STEP_FRACTION    (0.99f) /**< Fraction of the step to the boundary, keeps s and z strictly positive. */
+#define QP_IPM_SHIFT            (1e-6)  /**< First diagonal shift of M, relative to its largest diagonal, when not definite. */
+#define QP_IPM_SHIFT_ATTEMPTS   (3)     /**< Number of growing shifts tried before giving up. */
+
+
+/**
+ * @brief Vector with the block structure of the interior-point unknowns (x, y, s, z).
+ */
+typedef struct
+{
+    float* p_x;         /** n */
+    float* p_y;         /** meq */
+    float* p_s;         /** min */
+    float* p_z;         /** min */
+} ipm_point_t;
+
+
+/**
+ * @brief Working data of the interior-point solver.
+ */
+typedef struct
+{
+    uint16_t n;         /** Number of variables */
+    uint16_t meq;       /** Number of equality constraints */
+    uint16_t min;       /** Number of inequality constraints */
+    matf32_sym_t U;     /** Cholesky factor of Q */
+    matf32_sym_t M0;    /** A Q^-1 A', A = [Aeq; Ain] */
+    matf32_sym_t M;     /** Cholesky factor of M0 + diag(0, S Z^-1) */
+    matf32_t G;         /** n x (meq + min), U^-T A' */
+    ipm_point_t pt;     /** Current iterate */
+    ipm_point_t res;    /** Residuals (rd, re, ri, rsz) */
+    ipm_point_t d;      /** Newton step */
+    ipm_point_t f;      /** Residual of the Newton step, for iterative refinement */
+    ipm_point_t dc;     /** Correction of the Newton step */
+    float* p_r1;        /** n, work */
+    float* p_t;         /** meq + min, multiplier step */
+} ipm_work_t;
+
+//
+// With slacks s = bin - Ain x >= 0 and multipliers z >= 0 the optimality conditions are
+//
+//      rd = Qx + c + Aeq'y + Ain'z = 0,  re = Aeq x - beq = 0,  ri = Ain x + s - bin = 0,  s.*z = 0.
+//
+// The Newton step K d = -r (with the last block Z ds + S dz = -rsz) is solved by eliminating ds and then dx,
+// which leaves the multiplier system
+//
+//      (A Q^-1 A' + diag(0, S Z^-1)) [dy; dz] = [re; ri - Z^-1 rsz] - A Q^-1 rd,  dx = -Q^-1 (rd + A'[dy; dz]).
+//
+// Q and A Q^-1 A' are factored/formed once per solve, each iteration only adds the diagonal and factors M once
+// for both the predictor and the corrector. Unlike the primal normal equations Q + Ain' Z S^-1 Ain, the diagonal
+// stays bounded as active slacks vanish, which keeps the step accurate in float; one refinement step on K
+// absorbs the remaining rounding and the diagonal shift used when active normals are dependent.
+
+
+static void
+ipm_point_init(ipm_point_t* const p_pt, float** pp_vec, float** pp_con, uint16_t n, uint16_t meq, uint16_t min)
+{
+    p_pt->p_x = *pp_vec;
+    *pp_vec += n;
+    p_pt->p_y = *pp_con;
+    p_pt->p_s = &p_pt->p_y[meq];
+    p_pt->p_z = &p_pt->p_s[min];
+    *pp_con += meq + 2*min;
+}
+
+
+// Row k of A = [Aeq; Ain]
+static inline const float*
+ipm_row(const ipm_work_t* const p_ws, const quadprog_t* const p_qp, uint16_t k)
+{
+    return (k < p_ws->meq)? &p_qp->p_Aeq->p_data[k*p_ws->n] : &p_qp->p_Ain->p_data[(k - p_ws->meq)*p_ws->n];
+}
+
+
+// res = (Qx + c + Aeq'y + Ain'z, Aeq x - beq, Ain x + s - bin), rsz is left untouched
+static void
+ipm_residuals(ipm_work_t* const p_ws, const quadprog_t* const p_qp)
+{
+    const uint16_t n = p_ws->n;
+    const ipm_point_t* p_pt = &p_ws->pt;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        p_ws->res.p_x[i] = gi_dot(&p_qp->p_Q->p_data[i*n], p_pt->p_x, n) + p_qp->p_c->p_data[i];
+    }
+
+    for (uint16_t k = 0; k < p_ws->meq; ++k)
+    {
+        const float* p_a = &p_qp->p_Aeq->p_data[k*n];
+        p_ws->res.p_y[k] = gi_dot(p_a, p_pt->p_x, n) - p_qp->p_beq->p_data[k];
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            p_ws->res.p_x[i] += p_a[i] * p_pt->p_y[k];
+        }
+    }
+
+    for (uint16_t k = 0; k < p_ws->min; ++k)
+    {
+        const float* p_a = &p_qp->p_Ain->p_data[k*n];
+        p_ws->res.p_s[k] = gi_dot(p_a, p_pt->p_x, n) + p_pt->p_s[k] - p_qp->p_bin->p_data[k];
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            p_ws->res.p_x[i] += p_a[i] * p_pt->p_z[k];
+        }
+    }
+}
+
+
+// Q = U'U and M0 = A Q^-1 A' = G'G with G = U^-T A', once per solve
+static quadprog_status_t
+ipm_setup(ipm_work_t* const p_ws, const quadprog_t* const p_qp)
+{
+    const uint16_t n = p_ws->n;
+    const uint16_t m = p_ws->meq + p_ws->min;
+
+    matf32_sym_from_dense(p_qp->p_Q, &p_ws->U);
+    if (MATH_SUCCESS != matf32_sym_cholesky(&p_ws->U))
+    {
+        return QP_NOT_CONVEX;
+    }
+
+    if (m > 0)
+    {
+        for (uint16_t k = 0; k < m; ++k)
+        {
+            const float* p_a = ipm_row(p_ws, p_qp, k);
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                p_ws->G.p_data[i*m + k] = p_a[i];
+            }
+        }
+        matf32_sym_cholesky_fwdsub(&p_ws->U, &p_ws->G);
+
+        memset(p_ws->M0.p_data, 0, MATF32_SYM_SIZE(m)*sizeof(float));
+        matf32_sym_rank_update(&p_ws->G, 1.0f, &p_ws->M0);
+    }
+
+    return QP_SUCESS;
+}
+
+
+// M = M0 + diag(0, S Z^-1), factored once per iteration
+static quadprog_status_t
+ipm_factor(ipm_work_t* const p_ws)
+{
+    const uint16_t m = p_ws->meq + p_ws->min;
+    float delta = 0;
+
+    if (0 == m)
+    {
+        return QP_SUCESS;
+    }
+
+    for (uint16_t attempt = 0; ; ++attempt)
+    {
+        float diag_max = 0;
+
+        matf32_sym_copy(&p_ws->M0, &p_ws->M);
+        for (uint16_t k = 0; k < m; ++k)
+        {
+            float* p_mkk = matf32_sym_at(&p_ws->M, k, k);
+            diag_max = fmaxf(diag_max, *p_mkk);
+            if (k >= p_ws->meq)
+            {
+                *p_mkk += p_ws->pt.p_s[k - p_ws->meq] / p_ws->pt.p_z[k - p_ws->meq];
+            }
+            *p_mkk += delta;
+        }
+
+        if (MATH_SUCCESS == matf32_sym_cholesky(&p_ws->M))
+        {
+            return QP_SUCESS;
+        }
+
+        // active constraint normals are (numerically) dependent
+        if (attempt == QP_IPM_SHIFT_ATTEMPTS)
+        {
+            return QP_BAD_DEFINED;
+        }
+
+        delta = (0 == delta)? QP_IPM_SHIFT*diag_max : 100*delta;
+    }
+}
+
+
+// Solves K d = -r with the factors from ipm_setup and ipm_factor
+static void
+ipm_newton(ipm_work_t* const p_ws, const quadprog_t* const p_qp, const ipm_point_t* const p_r, ipm_point_t* const p_d)
+{
+    const uint16_t n = p_ws->n;
+    const uint16_t meq = p_ws->meq;
+    const uint16_t m = meq + p_ws->min;
+    const ipm_point_t* p_pt = &p_ws->pt;
+    matf32_t r1, dx, t;
+
+    matf32_init(&r1, n, 1, p_ws->p_r1);
+    matf32_init(&dx, n, 1, p_d->p_x);
+    matf32_init(&t, m, 1, p_ws->p_t);
+
+    // t = [re; ri - Z^-1 rsz] - A Q^-1 rd
+    memcpy(p_ws->p_r1, p_r->p_x, n*sizeof(float));
+    matf32_sym_cholesky_solve(&p_ws->U, &r1, &r1);
+
+    for (uint16_t k = 0; k < m; ++k)
+    {
+        float rhs = (k < meq)? p_r->p_y[k] : p_r->p_s[k - meq] - p_r->p_z[k - meq]/p_pt->p_z[k - meq];
+        p_ws->p_t[k] = rhs - gi_dot(ipm_row(p_ws, p_qp, k), p_ws->p_r1, n);
+    }
+
+    if (m > 0)
+    {
+        matf32_sym_cholesky_solve(&p_ws->M, &t, &t);
+    }
+
+    // dx = -Q^-1 (rd + A't)
+    memcpy(p_ws->p_r1, p_r->p_x, n*sizeof(float));
+    for (uint16_t k = 0; k < m; ++k)
+    {
+        const float* p_a = ipm_row(p_ws, p_qp, k);
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            p_ws->p_r1[i] += p_a[i] * p_ws->p_t[k];
+        }
+    }
+    matf32_sym_cholesky_solve(&p_ws->U, &r1, &dx);
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        p_d->p_x[i] = -p_d->p_x[i];
+    }
+
+    memcpy(p_d->p_y, p_ws->p_t, meq*sizeof(float));
+    memcpy(p_d->p_z, &p_ws->p_t[meq], p_ws->min*sizeof(float));
+
+    // ds from the block that is accurate for the constraint: linearized feasibility when inactive (s > z),
+    // linearized complementarity when active
+    for (uint16_t k = 0; k < p_ws->min; ++k)
+    {
+        if (p_pt->p_s[k] > p_pt->p_z[k])
+        {
+            p_d->p_s[k] = -p_r->p_s[k] - gi_dot(&p_qp->p_Ain->p_data[k*n], p_d->p_x, n);
+        }
+        else
+        {
+            p_d->p_s[k] = -(p_r->p_z[k] + p_pt->p_s[k]*p_d->p_z[k]) / p_pt->p_z[k];
+        }
+    }
+}
+
+
+// Newton step for the residuals in res, refined once: f = r + K d, d = d + K^-1 (-f)
+static void
+ipm_direction(ipm_work_t* const p_ws, const quadprog_t* const p_qp)
+{
+    const uint16_t n = p_ws->n;
+    const ipm_point_t* p_pt = &p_ws->pt;
+    const ipm_point_t* p_r = &p_ws->res;
+    ipm_point_t* p_d = &p_ws->d;
+    ipm_point_t* p_f = &p_ws->f;
+
+    ipm_newton(p_ws, p_qp, p_r, p_d);
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        p_f->p_x[i] = p_r->p_x[i] + gi_dot(&p_qp->p_Q->p_data[i*n], p_d->p_x, n);
+    }
+
+    for (uint16_t k = 0; k < p_ws->meq; ++k)
+    {
+        const float* p_a = &p_qp->p_Aeq->p_data[k*n];
+        p_f->p_y[k] = p_r->p_y[k] + gi_dot(p_a, p_d->p_x, n);
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            p_f->p_x[i] += p_a[i] * p_d->p_y[k];
+        }
+    }
+
+    for (uint16_t k = 0; k < p_ws->min; ++k)
+    {
+        const float* p_a = &p_qp->p_Ain->p_data[k*n];
+        p_f->p_s[k] = p_r->p_s[k] + gi_dot(p_a, p_d->p_x, n) + p_d->p_s[k];
+        p_f->p_z[k] = p_r->p_z[k] + p_pt->p_z[k]*p_d->p_s[k] + p_pt->p_s[k]*p_d->p_z[k];
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            p_f->p_x[i] += p_a[i] * p_d->p_z[k];
+        }
+    }
+
+    ipm_newton(p_ws, p_qp, p_f, &p_ws->dc);
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        p_d->p_x[i] += p_ws->dc.p_x[i];
+    }
+    for (uint16_t k = 0; k < p_ws->meq; ++k)
+    {
+        p_d->p_y[k] += p_ws->dc.p_y[k];
+    }
+    for (uint16_t k = 0; k < p_ws->min; ++k)
+    {
+        p_d->p_s[k] += p_ws->dc.p_s[k];
+        p_d->p_z[k] += p_ws->dc.p_z[k];
+    }
+}
+
+
+// Largest step in (0, 1] keeping s and z nonnegative, scaled by fraction when a component would reach the
+// boundary, so that s and z stay strictly positive
+static float
+ipm_step_length(const ipm_work_t* const p_ws, float fraction)
+{
+    float alpha = INFINITY;
+
+    for (uint16_t k = 0; k < p_ws->min; ++k)
+    {
+        if (p_ws->d.p_s[k] < 0)
+        {
+            alpha = fminf(alpha, -p_ws->pt.p_s[k]/p_ws->d.p_s[k]);
+        }
+        if (p_ws->d.p_z[k] < 0)
+        {
+            alpha = fminf(alpha, -p_ws->pt.p_z[k]/p_ws->d.p_z[k]);
+        }
+    }
+
+    return fminf(1.0f, fraction*alpha);
+}
+
+
+static void
+ipm_take_step(ipm_work_t* const p_ws, float alpha)
+{
+    for (uint16_t i = 0; i < p_ws->n; ++i)
+    {
+        p_ws->pt.p_x[i] += alpha*p_ws->d.p_x[i];
+    }
+    for (uint16_t k = 0; k < p_ws->meq; ++k)
+    {
+        p_ws->pt.p_y[k] += alpha*p_ws->d.p_y[k];
+    }
+    for (uint16_t k = 0; k < p_ws->min; ++k)
+    {
+        p_ws->pt.p_s[k] += alpha*p_ws->d.p_s[k];
+        p_ws->pt.p_z[k] += alpha*p_ws->d.p_z[k];
+    }
+}
+
+
+static float
+ipm_norm_inf(const float* const p_v, uint16_t length)
+{
+    float norm = 0;
+    for (uint16_t i = 0; i < length; ++i)
+    {
+        norm = fmaxf(norm, fabsf(p_v[i]));
+    }
+    return norm;
+}
+
+
+static quadprog_status_t
+ipm_solve(ipm_work_t* const p_ws, const quadprog_t* const p_qp, matf32_t* const p_x, quadprog_ipm_info_t* const p_info)
+{
+    const uint16_t min = p_ws->min;
+    ipm_point_t* p_pt = &p_ws->pt;
+    quadprog_status_t status;
+
+    float c_norm = ipm_norm_inf(p_qp->p_c->p_data, p_ws->n);
+    float b_norm = 0;
+    if (p_ws->meq > 0)
+    {
+        b_norm = ipm_norm_inf(p_qp->p_beq->p_data, p_ws->meq);
+    }
+    if (min > 0)
+    {
+        b_norm = fmaxf(b_norm, ipm_norm_inf(p_qp->p_bin->p_data, min));
+    }
+
+    // starting point: affine step from x = 0, s = z = 1, then s and z pushed back into the interior
+    memset(p_pt->p_x, 0, p_ws->n*sizeof(float));
+    memset(p_pt->p_y, 0, p_ws->meq*sizeof(float));
+    for (uint16_t k = 0; k < min; ++k)
+    {
+        p_pt->p_s[k] = 1.0f;
+        p_pt->p_z[k] = 1.0f;
+        p_ws->res.p_z[k] = 1.0f;
+    }
+
+    status = ipm_setup(p_ws, p_qp);
+    if (QP_SUCESS == status)
+    {
+        status = ipm_factor(p_ws);
+    }
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+    ipm_residuals(p_ws, p_qp);
+    ipm_direction(p_ws, p_qp);
+    ipm_take_step(p_ws, 1.0f);
+
+    for (uint16_t k = 0; k < min; ++k)
+    {
+        p_pt->p_s[k] = fmaxf(1.0f, fabsf(p_pt->p_s[k]));
+        p_pt->p_z[k] = fmaxf(1.0f, fabsf(p_pt->p_z[k]));
+    }
+
+    uint16_t iter;
+    for (iter = 0; ; ++iter)
+    {
+        ipm_residuals(p_ws, p_qp);
+
+        float r_prim = fmaxf(ipm_norm_inf(p_ws->res.p_y, p_ws->meq), ipm_norm_inf(p_ws->res.p_s, min));
+        float r_dual = ipm_norm_inf(p_ws->res.p_x, p_ws->n);
+        float gap = gi_dot(p_pt->p_s, p_pt->p_z, min);
+        float mu = (min > 0)? gap/min : 0;
+
+        // a step that lost the iterate to rounding ends the solve, p_x keeps the last finite iterate
+        if (!isfinite(r_prim) || !isfinite(r_dual) || !isfinite(gap))
+        {
+            status = QP_MAX_ITERATIONS;
+            break;
+        }
+        memcpy(p_x->p_data, p_pt->p_x, p_ws->n*sizeof(float));
+
+        if (NULL != p_info)
+        {
+            p_info->iter = iter;
+            p_info->p_r_prim[iter] = r_prim;
+            p_info->p_r_dual[iter] = r_dual;
+            p_info->p_gap[iter] = gap;
+        }
+
+        if ((r_prim <= QP_IPM_TOLERANCE*(1 + b_norm)) && (r_dual <= QP_IPM_TOLERANCE*(1 + c_norm))
+            && (mu <= QP_IPM_MU_TOLERANCE*(1 + fmaxf(b_norm, c_norm))))
+        {
+            status = QP_SUCESS;
+            break;
+        }
+
+        if (iter == MAX_ITERATION_COUNT_IPM)
+        {
+            status = QP_MAX_ITERATIONS;
+            break;
+        }
+
+        // one factorization per iteration, shared by the predictor and the corrector
+        status = ipm_factor(p_ws);
+        if (QP_SUCESS != status)
+        {
+            break;
+        }
+
+        // predictor (affine scaling) step
+        for (uint16_t k = 0; k < min; ++k)
+        {
+            p_ws->res.p_z[k] = p_pt->p_s[k]*p_pt->p_z[k];
+        }
+        ipm_direction(p_ws, p_qp);
+
+        if (min > 0)
+        {
+            float alpha_aff = ipm_step_length(p_ws, 1.0f);
+            float gap_aff = 0;
+            for (uint16_t k = 0; k < min; ++k)
+            {
+                gap_aff += (p_pt->p_s[k] + alpha_aff*p_ws->d.p_s[k]) * (p_pt->p_z[k] + alpha_aff*p_ws->d.p_z[k]);
+            }
+            float sigma = gap_aff/gap;
+            sigma = sigma*sigma*sigma;
+
+            // corrector step, centering plus second order term of the predictor, damped by the predictor step
+            // length (the full term makes badly centered pairs cycle near degenerate constraints)
+            for (uint16_t k = 0; k < min; ++k)
+            {
+                p_ws->res.p_z[k] += alpha_aff*p_ws->d.p_s[k]*p_ws->d.p_z[k] - sigma*mu;
+            }
+            ipm_direction(p_ws, p_qp);
+        }
+
+        float alpha = ipm_step_length(p_ws, QP_IPM_STEP_FRACTION);
+        if (!(alpha >= QP_IPM_STEP_MIN))
+        {
+            status = QP_MAX_ITERATIONS;
+            break;
+        }
+
+        ipm_take_step(p_ws, alpha);
+    }
+
+    return status;
+}
+
+
+quadprog_status_t
+quadprog_ipm(quadprog_t* p_qp, quadprog_workspace_t* const p_work, matf32_t* const p_x,
+             quadprog_ipm_info_t* const p_info)
+{
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return QP_BAD_DEFINED;
+    }
+
+    ipm_work_t ws;
+    ws.n = p_qp->p_Q->num_rows;
+    ws.meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+    ws.min = (NULL != p_qp->p_Ain)? p_qp->p_Ain->num_rows : 0;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, ws.n, ws.n) || !matf32_size_check(p_qp->p_c, ws.n, 1)
+        || !matf32_size_check(p_x, ws.n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((ws.meq > 0) && (!matf32_size_check(p_qp->p_Aeq, ws.meq, ws.n) || !matf32_size_check(p_qp->p_beq, ws.meq, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((ws.min > 0) && (!matf32_size_check(p_qp->p_Ain, ws.min, ws.n) || !matf32_size_check(p_qp->p_bin, ws.min, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    if ((ws.n > p_work->n) || (ws.meq > p_work->meq) || (ws.min > p_work->min))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    uint16_t m = ws.meq + ws.min;
+    float* p_fwork = p_work->p_fwork;
+
+    matf32_sym_init(&ws.U, ws.n, p_fwork);
+    p_fwork += MATF32_SYM_SIZE(ws.n);
+    matf32_sym_init(&ws.M0, m, p_fwork);
+    p_fwork += MATF32_SYM_SIZE(m);
+    matf32_sym_init(&ws.M, m, p_fwork);
+    p_fwork += MATF32_SYM_SIZE(m);
+    matf32_init(&ws.G, ws.n, m, p_fwork);
+    p_fwork += ws.n*m;
+
+    float* p_vec = p_fwork;
+    float* p_con = &p_fwork[6*ws.n];
+
+    ipm_point_init(&ws.pt, &p_vec, &p_con, ws.n, ws.meq, ws.min);
+    ipm_point_init(&ws.res, &p_vec, &p_con, ws.n, ws.meq, ws.min);
+    ipm_point_init(&ws.d, &p_vec, &p_con, ws.n, ws.meq, ws.min);
+    ipm_point_init(&ws.f, &p_vec, &p_con, ws.n, ws.meq, ws.min);
+    ipm_point_init(&ws.dc, &p_vec, &p_con, ws.n, ws.meq, ws.min);
+    ws.p_r1 = p_vec;
+    ws.p_t = p_con;
+
+    return ipm_solve(&ws, p_qp, p_x, p_info);
+}
+
+
+
+// ====================================================================================================
+// Bound constrained problems (projected Newton)
+// ====================================================================================================
+
+#define QP_BOX_TOLERANCE        (1e-5)  /**< Tolerance of the projected gradient, relative to the gradient terms. */
+#define QP_BOX_ARMIJO           (1e-4)  /**< Sufficient decrease fraction of the line search. */
+#define QP_BOX_LINE_SEARCH      (30)    /**< Maximum number of step halvings of the line search. */
+
+
+static bool
+box_is_bounds(const matf32_t* const p_Ain)
+{
+    uint16_t n = p_Ain->num_cols;
+
+    for (uint16_t k = 0; k < p_Ain->num_rows; ++k)
+    {
+        uint16_t nnz = 0;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            float a = p_Ain->p_data[k*n + i];
+            if (a != 0)
+            {
+                if (((a != 1) && (a != -1)) || (++nnz > 1))
+                {
+                    return false;
+                }
+            }
+        }
+
+        if (0 == nnz)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static inline float
+box_clamp(float x, float lb, float ub)
+{
+    return (x < lb)? lb : ((x > ub)? ub : x);
+}
+
+
+/**
+ * @brief   Change of the cost 1/2 x'Qx + c'x along the step s from the point with gradient g.
+ */
+static float
+box_cost_change(const float* Q, const float* g, const float* s, uint16_t n)
+{
+    float df = 0;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        if (s[i] != 0)
+        {
+            float qs = 0;
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                qs += Q[i*n + j] * s[j];
+            }
+            df += s[i]*(g[i] + 0.5f*qs);
+        }
+    }
+
+    return df;
+}
+
+
+/**
+ * @brief   Backtracking projected line search along d. Stores the accepted point in xt.
+ *
+ * @return  true if a point with sufficient decrease was found.
+ */
+static bool
+box_line_search(const float* Q, const float* x, const float* g, const float* d, const float* lb, const float* ub,
+                uint16_t n, float* xt, float* s)
+{
+    float alpha = 1;
+
+    for (uint16_t k = 0; k < QP_BOX_LINE_SEARCH; ++k)
+    {
+        float gs = 0;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            xt[i] = box_clamp(x[i] + alpha*d[i], lb[i], ub[i]);
+            s[i] = xt[i] - x[i];
+            gs += g[i]*s[i];
+        }
+
+        if ((gs < 0) && (box_cost_change(Q, g, s, n) <= QP_BOX_ARMIJO*gs))
+        {
+            return true;
+        }
+
+        alpha *= 0.5f;
+    }
+
+    return false;
+}
+
+
+static quadprog_status_t
+box_solve(const quadprog_t* const p_qp, const float* lb, const float* ub, float* p_fwork, int16_t* p_free,
+          matf32_t* const p_x)
+{
+    uint16_t n = p_qp->p_Q->num_rows;
+    const float* Q = p_qp->p_Q->p_data;
+    const float* c = p_qp->p_c->p_data;
+    float* x = p_x->p_data;
+    matf32_sym_t H;
+    matf32_t rhs;
+
+    matf32_sym_init(&H, n, p_fwork);
+    p_fwork += MATF32_SYM_SIZE(n);
+    float* g = p_fwork;
+    float* d = &p_fwork[n];
+    float* xt = &p_fwork[2*n];
+    float* s = &p_fwork[3*n];
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        if (lb[i] > ub[i])
+        {
+            return QP_INFEASIBLE;
+        }
+
+        float x0 = (NULL != p_qp->p_x0)? p_qp->p_x0->p_data[i] : 0;
+        x[i] = box_clamp(x0, lb[i], ub[i]);
+    }
+
+    for (uint16_t iter = 0; iter < MAX_ITERATION_COUNT_BOX; ++iter)
+    {
+        // g = Qx + c and the projected gradient norm(x - clamp(x - g), inf)
+        float pg = 0;
+        float scale = 1;
+        uint16_t nf = 0;
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            float sum = c[i];
+            scale = fmaxf(scale, fabsf(c[i]));
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                float qx = Q[i*n + j] * x[j];
+                sum += qx;
+                scale = fmaxf(scale, fabsf(qx));
+            }
+            g[i] = sum;
+            pg = fmaxf(pg, fabsf(x[i] - box_clamp(x[i] - g[i], lb[i], ub[i])));
+
+            // variables pushed against their bound stay there, the rest are free
+            if (!(((x[i] <= lb[i]) && (g[i] > 0)) || ((x[i] >= ub[i]) && (g[i] < 0))))
+            {
+                p_free[nf++] = i;
+            }
+        }
+
+        if (pg <= QP_BOX_TOLERANCE*scale)
+        {
+            return QP_SUCESS;
+        }
+
+        // Newton step on the free variables, H = Q(F, F), H d(F) = -g(F)
+        matf32_sym_init(&H, nf, H.p_data);
+        matf32_init(&rhs, nf, 1, s);
+        for (uint16_t j = 0; j < nf; ++j)
+        {
+            for (uint16_t i = 0; i <= j; ++i)
+            {
+                *matf32_sym_at(&H, i, j) = Q[p_free[i]*n + p_free[j]];
+            }
+            s[j] = -g[p_free[j]];
+        }
+
+        if (MATH_SUCCESS != matf32_sym_cholesky(&H))
+        {
+            return QP_NOT_CONVEX;
+        }
+        matf32_sym_cholesky_solve(&H, &rhs, &rhs);
+
+        memset(d, 0, n*sizeof(float));
+        for (uint16_t j = 0; j < nf; ++j)
+        {
+            d[p_free[j]] = s[j];
+        }
+
+        // the projected Newton direction can fail to descend when it leaves the box, fall back to -g then
+        if (!box_line_search(Q, x, g, d, lb, ub, n, xt, s))
+        {
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                d[i] = -g[i];
+            }
+
+            if (!box_line_search(Q, x, g, d, lb, ub, n, xt, s))
+            {
+                // no decrease is representable, x is optimal up to rounding
+                return QP_SUCESS;
+            }
+        }
+
+        memcpy(x, xt, n*sizeof(float));
+    }
+
+    return QP_MAX_ITERATIONS;
+}
+
+
+static quadprog_status_t
+box_check(const quadprog_t* const p_qp, const quadprog_workspace_t* const p_ws, const matf32_t* const p_x)
+{
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return QP_BAD_DEFINED;
+    }
+
+    uint16_t n = p_qp->p_Q->num_rows;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, n, n) || !matf32_size_check(p_qp->p_c, n, 1) || !matf32_size_check(p_x, n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((NULL != p_qp->p_x0) && !matf32_size_check(p_qp->p_x0, n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    if (n > p_ws->n)
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    return QP_SUCESS;
+}
+
+
+static quadprog_status_t
+box_from_inequalities(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x)
+{
+    quadprog_status_t status = box_check(p_qp, p_ws, p_x);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    uint16_t n = p_qp->p_Q->num_rows;
+    uint16_t min = p_qp->p_Ain->num_rows;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Ain, min, n) || !matf32_size_check(p_qp->p_bin, min, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    float* lb = p_ws->p_fwork;
+    float* ub = &p_ws->p_fwork[n];
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        lb[i] = -INFINITY;
+        ub[i] = INFINITY;
+    }
+
+    // x_i <= b or -x_i <= b, repeated rows keep the tightest bound
+    for (uint16_t k = 0; k < min; ++k)
+    {
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            float a = p_qp->p_Ain->p_data[k*n + i];
+            float b = p_qp->p_bin->p_data[k];
+
+            if (a > 0)
+            {
+                ub[i] = fminf(ub[i], b);
+            }
+            else if (a < 0)
+            {
+                lb[i] = fmaxf(lb[i], -b);
+            }
+        }
+    }
+
+    return box_solve(p_qp, lb, ub, &p_ws->p_fwork[2*n], p_ws->p_iwork, p_x);
+}
+
+
+quadprog_status_t
+quadprog_box(quadprog_t* p_qp, const matf32_t* const p_lb, const matf32_t* const p_ub,
+             quadprog_workspace_t* const p_ws, matf32_t* const p_x)
+{
+    quadprog_status_t status = box_check(p_qp, p_ws, p_x);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    uint16_t n = p_qp->p_Q->num_rows;
+
+#ifdef MATH_MATRIX_CHECK
+    if (((NULL != p_lb) && !matf32_size_check(p_lb, n, 1)) || ((NULL != p_ub) && !matf32_size_check(p_ub, n, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    float* lb = p_ws->p_fwork;
+    float* ub = &p_ws->p_fwork[n];
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        lb[i] = (NULL != p_lb)? p_lb->p_data[i] : -INFINITY;
+        ub[i] = (NULL != p_ub)? p_ub->p_data[i] : INFINITY;
+    }
+
+    return box_solve(p_qp, lb, ub, &p_ws->p_fwork[2*n], p_ws->p_iwork, p_x);
 }
@@ -13,6 +13,32 @@
 extern "C" {
 #endif
 
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define QUADPROG_MAX(a, b)      (((a) > (b))? (a) : (b))
+
+/** float storage used by quadprog_qp (the larger of the Schur complement and null-space methods). */
+#define QUADPROG_QP_FWORK(n, meq)       QUADPROG_MAX(MATF32_SYM_SIZE(n) + (n) + (meq) + MATF32_SYM_SIZE(meq) + (n)*(meq), \
+                                        2*(n)*(n) + 2*(n) + MATF32_SYM_SIZE(n))
+
+/** float storage used by quadprog_gi. */
+#define QUADPROG_GI_FWORK(n, meq, min)  (2*(n)*(n) + MATF32_SYM_SIZE(n) + 5*(n) + 3*((meq) + (min) + 1) + (min))
+
+/** float storage used by quadprog_ipm. */
+#define QUADPROG_IPM_FWORK(n, meq, min) (MATF32_SYM_SIZE(n) + 2*MATF32_SYM_SIZE((meq) + (min)) \
+                                        + (n)*((meq) + (min)) + 6*(n) + 6*(meq) + 11*(min))
+
+/** float storage used by quadprog_box (bounds extracted by quadprog included). */
+#define QUADPROG_BOX_FWORK(n)           (MATF32_SYM_SIZE(n) + 6*(n))
+
+/** float storage of a workspace usable by every solver for n variables, meq equalities and min inequalities. */
+#define QUADPROG_WORKSPACE_FWORK(n, meq, min)   QUADPROG_MAX(QUADPROG_MAX(QUADPROG_QP_FWORK(n, meq), QUADPROG_BOX_FWORK(n)), \
+                                                QUADPROG_MAX(QUADPROG_GI_FWORK(n, meq, min), QUADPROG_IPM_FWORK(n, meq, min)))
+
+/** int16_t storage of a workspace for n variables, meq equalities and min inequalities. */
+#define QUADPROG_WORKSPACE_IWORK(n, meq, min)   QUADPROG_MAX(2*((meq) + (min) + 1) + 2*(min), (n))
+
 // ====================================================================================================
 // Data structures, enums and type definitions
 // ====================================================================================================
@@ -34,6 +60,20 @@ typedef struct qp_t
 } quadprog_t;
 
 
+/**
+ * @brief Solver workspace. Holds every buffer a solve needs, so problems with separate workspaces can be
+ * solved concurrently. Create it once for the largest dimensions and reuse it across solves.
+ */
+typedef struct
+{
+    uint16_t n;             /** Maximum number of variables */
+    uint16_t meq;           /** Maximum number of equality constraints */
+    uint16_t min;           /** Maximum number of inequality constraints */
+    float* p_fwork;         /** QUADPROG_WORKSPACE_FWORK(n, meq, min) elements */
+    int16_t* p_iwork;       /** QUADPROG_WORKSPACE_IWORK(n, meq, min) elements */
+} quadprog_workspace_t;
+
+
 /**
  * @brief Operation status from quadprog.
  * 
@@ -44,10 +84,115 @@ typedef enum
     QP_SIZE_MISMATCH,   /** Matrices/vectors are not the correct size */
     QP_NOT_RESTRICTED,  /** Missing restrictions */
     QP_NOT_CONVEX,      /** Problem is not convex */
-    QP_BAD_DEFINED      /** Problem is not correctly defined */
+    QP_BAD_DEFINED,     /** Problem is not correctly defined */
+    QP_INFEASIBLE,      /** Constraints are inconsistent */
+    QP_MAX_ITERATIONS,  /** Iteration limit reached before convergence */
+    QP_TRUNCATED,       /** Budget of the call exhausted, the best iterate found is returned */
+    QP_UNBOUNDED        /** Cost is unbounded below along a direction that keeps every constraint */
 } quadprog_status_t;
 
 
+/**
+ * @brief KKT solution method of equality constrained problems.
+ *
+ */
+typedef enum
+{
+    QP_KKT_SCHUR,       /** Range-space: Cholesky of Q and of the Schur complement Aeq*Q^-1*Aeq' */
+    QP_KKT_NULL_SPACE   /** Null-space: QR of Aeq' and Cholesky of the reduced Hessian Z'QZ */
+} quadprog_kkt_method_t;
+
+
+/**
+ * @brief Active inequality set of a quadprog solution.
+ *
+ * Filled by the dual active-set solver on exit and, when passed back in, used to warm start the next solve.
+ */
+typedef struct
+{
+    uint16_t num_active;                            /** Number of active inequalities */
+    uint16_t p_index[MAX_CONSTRAINT_COUNT_QP];      /** Rows of Ain that are active */
+    float p_lambda[MAX_CONSTRAINT_COUNT_QP];        /** Lagrange multipliers of the active rows */
+} quadprog_active_set_t;
+
+
+/**
+ * @brief Warm start handle of the dual active-set solver for sequences of problems that share Q, Aeq and Ain
+ * (receding horizon control). It keeps the Cholesky factor of Q and the factorization of the active constraints
+ * of the last solution in its workspace, so the next solve restarts from the previous optimum.
+ */
+typedef struct
+{
+    quadprog_workspace_t* p_ws;     /** Workspace owned by the handle, holds the factorizations between calls */
+    bool is_factored;               /** Cholesky factor of Q is valid */
+    bool is_warm;                   /** Active set factorization of the last solve is valid */
+    uint16_t num_constraints;       /** Active constraints (equalities included) of the last solve */
+    uint16_t iter;                  /** Active set changes (adds and drops) done by the last solve */
+    quadprog_active_set_t active;   /** Active inequalities and multipliers of the last solve */
+} quadprog_warm_t;
+
+
+/**
+ * @brief Per call budget of the dual active-set solver, for callers with a bounded latency (control loops).
+ *
+ * The budget is checked once per iteration, so a call can exceed its time limit by the duration of one
+ * constraint addition (and the drops it causes).
+ */
+typedef struct
+{
+    uint16_t max_iter;                  /** Iterations allowed, 0 for MAX_ITERATION_COUNT_SQP */
+    uint32_t (*p_clock)(void* p_ctx);   /** Free running tick counter (e.g. a timer in us), NULL for no time limit */
+    void* p_ctx;                        /** Passed to p_clock */
+    uint32_t max_ticks;                 /** Ticks allowed since the call started, Cholesky factorization included */
+} quadprog_budget_t;
+
+
+/**
+ * @brief Report of a dual active-set solve.
+ */
+typedef struct
+{
+    uint16_t iter;      /** Iterations done (constraint additions tried) */
+    uint16_t adds;      /** Inequalities added to the active set */
+    uint16_t drops;     /** Inequalities dropped from the active set */
+    uint32_t ticks;     /** Ticks used, 0 without a clock */
+    float r_prim;       /** Largest constraint violation at p_x, max(|Aeq x - beq|, Ain x - bin, 0) */
+    float cost;         /** Cost 1/2 x'Qx + c'x at p_x */
+    float bound;        /** Lower bound on the optimal cost: cost of the last (dual feasible) iterate */
+} quadprog_stats_t;
+
+
+/**
+ * @brief Storage for the certificate of a failed solve, either pointer can be NULL. Both are scaled to unit
+ * infinity norm.
+ *
+ * QP_INFEASIBLE : p_y ([y_eq; y_in], meq + min elements) with Aeq'y_eq + Ain'y_in = 0, y_in >= 0 and
+ *                 beq'y_eq + bin'y_in < 0 (Farkas), so no x meets the constraints.
+ * QP_UNBOUNDED :  p_d (n elements) with Qd = 0, c'd < 0, Aeq d = 0 and Ain d <= 0, so the cost decreases
+ *                 without bound from any feasible point along d.
+ * QP_NOT_CONVEX : p_d with d'Qd <= 0.
+ */
+typedef struct
+{
+    float* p_y;     /** meq + min, multipliers proving primal infeasibility */
+    float* p_d;     /** n, direction of unboundedness or non-positive curvature */
+} quadprog_cert_t;
+
+
+/**
+ * @brief Per iteration report of the interior-point solver.
+ *
+ * Entry k of each history corresponds to the point at the start of iteration k, the last entry to the point returned.
+ */
+typedef struct
+{
+    uint16_t iter;                                  /** Iterations done */
+    float p_r_prim[MAX_ITERATION_COUNT_IPM + 1];    /** Primal residual norm([Aeq x - beq; Ain x + s - bin], inf) */
+    float p_r_dual[MAX_ITERATION_COUNT_IPM + 1];    /** Dual residual norm(Qx + c + Aeq'y + Ain'z, inf) */
+    float p_gap[MAX_ITERATION_COUNT_IPM + 1];       /** Duality gap s'z */
+} quadprog_ipm_info_t;
+
+
 /**
  * @brief   Print quadprog status.
  *
@@ -81,40 +226,261 @@ quadprog_init(quadprog_t* const p_qp,
               const matf32_t* const p_x0);
 
 
+/**
+ * @brief   Constructor for the solver workspace.
+ *
+ * @param[in, out]  p_ws        Points to the workspace.
+ * @param[in]       n           Maximum number of variables.
+ * @param[in]       meq         Maximum number of equality constraints.
+ * @param[in]       min         Maximum number of inequality constraints.
+ * @param[in]       p_fwork     Points to storage, QUADPROG_WORKSPACE_FWORK(n, meq, min) elements.
+ * @param[in]       p_iwork     Points to storage, QUADPROG_WORKSPACE_IWORK(n, meq, min) elements.
+ *
+ * @return  None
+ */
+void
+quadprog_workspace_init(quadprog_workspace_t* const p_ws, uint16_t n, uint16_t meq, uint16_t min,
+                        float* p_fwork, int16_t* p_iwork);
+
+
 /**
  * @brief   Quadratic convex problem solver.
  * 
- * @param[in]  p_qp Points to the structure representing the problem to solve.
- * @param[out] p_x  Points to the vector to store the result.
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws    Points to the solver workspace.
+ * @param[out]      p_x     Points to the vector to store the result.
  * 
  * @return  Execution status.
  */
 quadprog_status_t
-quadprog(quadprog_t* p_qp, matf32_t* const p_x);
+quadprog(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x);
 
 
 /**
- * @brief   Equality restricted quadratic convex problem solver
+ * @brief   Equality restricted quadratic convex problem solver. Uses the null-space method when more than
+ * half of the variables are fixed by equalities (2*meq > n) and the Schur complement method otherwise.
  *
- * @param[in]  p_qp Points to the structure representing the problem to solve.
- * @param[out] p_x  Points to the vector to store the result.
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws    Points to the solver workspace.
+ * @param[out]      p_x     Points to the vector to store the result.
  *
- * @return  Execution status.
+ * @return  Execution status, see quadprog_qp_method.
  */
 quadprog_status_t
-quadprog_qp(quadprog_t* p_qp, matf32_t* const p_x);
+quadprog_qp(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x);
 
 
 /**
- * @brief   Inequality restricted quadratic convex problem solver.
+ * @brief   Equality restricted quadratic convex problem solver with a given KKT method. Aeq/beq can be NULL.
  *
- * @param[in]  p_qp Points to the structure representing the problem to solve.
- * @param[out] p_x  Points to the vector to store the result.
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws    Points to the solver workspace.
+ * @param[out]      p_x     Points to the vector to store the result.
+ * @param[in]       method  KKT solution method.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or exceed the workspace.
+ *              QP_NOT_CONVEX :     Q (Schur complement) or Z'QZ (null-space) is not positive definite.
+ *              QP_BAD_DEFINED :    Q or c missing, or equality constraints are linearly dependent.
+ */
+quadprog_status_t
+quadprog_qp_method(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x,
+                   quadprog_kkt_method_t method);
+
+
+/**
+ * @brief   Bound constrained solver for min 1/2 x'Qx + c'x s.t. lb <= x <= ub (projected Newton).
+ *
+ * Each iteration fixes the variables held at a bound by the gradient, takes a Newton step on the remaining
+ * (free) variables with a Cholesky factorization of their block of Q, and projects it back onto the box with a
+ * backtracking line search. The iteration starts from p_x0 when given (clamped onto the box), and from the
+ * origin clamped onto the box otherwise. Aeq/beq and Ain/bin of p_qp are not used.
+ *
+ * quadprog dispatches to this solver when there are no equalities and every row of Ain is a signed unit
+ * vector (x_i <= b or -x_i <= b).
+ *
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[in]       p_lb    Points to the lower bounds, NULL or -INFINITY entries for none.
+ * @param[in]       p_ub    Points to the upper bounds, NULL or INFINITY entries for none.
+ * @param[in, out]  p_ws    Points to the solver workspace.
+ * @param[out]      p_x     Points to the vector to store the result.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or exceed the workspace.
+ *              QP_NOT_CONVEX :     A block of Q on the free variables is not positive definite.
+ *              QP_BAD_DEFINED :    Q or c missing.
+ *              QP_INFEASIBLE :     Some lower bound is above its upper bound.
+ *              QP_MAX_ITERATIONS : MAX_ITERATION_COUNT_BOX iterations reached, p_x holds the last iterate.
+ */
+quadprog_status_t
+quadprog_box(quadprog_t* p_qp, const matf32_t* const p_lb, const matf32_t* const p_ub,
+             quadprog_workspace_t* const p_ws, matf32_t* const p_x);
+
+
+/**
+ * @brief   Inequality restricted quadratic convex problem solver. Cold starts quadprog_gi.
+ *
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws    Points to the solver workspace.
+ * @param[out]      p_x     Points to the vector to store the result.
  *
  * @return  Execution status.
  */
 quadprog_status_t
-quadprog_sqp(quadprog_t* p_qp, matf32_t* const p_x);
+quadprog_sqp(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x);
+
+
+/**
+ * @brief   Goldfarb-Idnani dual active-set solver for min 1/2 x'Qx + c'x s.t. Aeq x = beq, Ain x <= bin.
+ *
+ * Q is factored once per call (Cholesky) and the factorization of the active constraints is updated with
+ * Givens rotations on every add/drop, so no linear system is solved from scratch inside the iteration.
+ * The iteration starts from the unconstrained minimum, p_x0 is not used. Either constraint pair can be NULL.
+ *
+ * @param[in]       p_qp        Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws        Points to the solver workspace.
+ * @param[out]      p_x         Points to the vector to store the result.
+ * @param[in, out]  p_active    Active set of a previous solve to warm start from (its inequalities are tried
+ *                              first), overwritten with the active set at the solution. Can be NULL.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or exceed the workspace.
+ *              QP_NOT_CONVEX :     Q is not positive definite.
+ *              QP_UNBOUNDED :      Q is singular and the cost is unbounded below on the constraints.
+ *              QP_BAD_DEFINED :    Q or c missing, or equalities are linearly dependent (but consistent).
+ *              QP_INFEASIBLE :     Constraints are inconsistent.
+ *              QP_MAX_ITERATIONS : MAX_ITERATION_COUNT_SQP constraint additions reached.
+ */
+quadprog_status_t
+quadprog_gi(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x,
+            quadprog_active_set_t* const p_active);
+
+
+/**
+ * @brief   quadprog_gi with a per call iteration and time budget (anytime mode).
+ *
+ * Every iterate of the dual method is optimal for the constraints active so far, so it is only primal feasible
+ * at the end. When the budget runs out the iterate with the smallest constraint violation seen is returned,
+ * and its cost together with the cost of the last iterate (a lower bound on the optimum) are reported in p_stats.
+ *
+ * Failures are detected as they happen: inconsistent constraints when a violated constraint cannot be added
+ * (its normal is a non-negative combination of the active ones), non-convexity when Q cannot be factored.
+ * Both cost at most one iteration and are reported with a certificate.
+ *
+ * @param[in]       p_qp        Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws        Points to the solver workspace.
+ * @param[out]      p_x         Points to the vector to store the result.
+ * @param[in, out]  p_active    Same as in quadprog_gi. Can be NULL.
+ * @param[in]       p_budget    Points to the budget. NULL behaves as quadprog_gi.
+ * @param[out]      p_stats     Points to the report. Can be NULL.
+ * @param[out]      p_cert      Points to the certificate storage. Can be NULL.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or exceed the workspace.
+ *              QP_NOT_CONVEX :     Q is not positive definite, p_cert->p_d has d'Qd <= 0.
+ *              QP_UNBOUNDED :      Q is singular and the cost decreases along p_cert->p_d.
+ *              QP_BAD_DEFINED :    Q or c missing, or equalities are linearly dependent (but consistent).
+ *              QP_INFEASIBLE :     Constraints are inconsistent, p_cert->p_y proves it.
+ *              QP_MAX_ITERATIONS : MAX_ITERATION_COUNT_SQP constraint additions reached without a budget.
+ *              QP_TRUNCATED :      Budget exhausted, p_x holds the least infeasible iterate.
+ */
+quadprog_status_t
+quadprog_gi_budget(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x,
+                   quadprog_active_set_t* const p_active, const quadprog_budget_t* const p_budget,
+                   quadprog_stats_t* const p_stats, quadprog_cert_t* const p_cert);
+
+
+/**
+ * @brief   Constructor for the warm start handle.
+ *
+ * @param[in, out]  p_h     Points to the handle.
+ * @param[in]       p_ws    Points to the workspace, used only through this handle afterwards.
+ *
+ * @return  None
+ */
+void
+quadprog_warm_init(quadprog_warm_t* const p_h, quadprog_workspace_t* const p_ws);
+
+
+/**
+ * @brief   Discards the kept factorizations, call it after Q, Aeq or Ain change. c, beq and bin can change
+ * between calls without a reset.
+ *
+ * @param[in, out]  p_h     Points to the handle.
+ *
+ * @return  None
+ */
+void
+quadprog_warm_reset(quadprog_warm_t* const p_h);
+
+
+/**
+ * @brief   Goldfarb-Idnani solve that restarts from the previous optimum kept in the handle.
+ *
+ * The problem restricted to the previous active set is solved directly with the kept factorization for the new
+ * c, beq and bin, inequalities whose multiplier became negative are dropped, and the dual active-set iteration
+ * continues from there. When the active set does not change no constraint is added or dropped. The first call
+ * (or the first after quadprog_warm_reset or a failed solve) starts cold.
+ *
+ * @param[in, out]  p_h     Points to the handle.
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[out]      p_x     Points to the vector to store the result.
+ *
+ * @return  Execution status, same as quadprog_gi.
+ */
+quadprog_status_t
+quadprog_solve_warm(quadprog_warm_t* const p_h, quadprog_t* p_qp, matf32_t* const p_x);
+
+
+/**
+ * @brief   quadprog_solve_warm with a per call budget, see quadprog_gi_budget.
+ *
+ * A truncated solve keeps its active set factorization, so the next call resumes from where this one stopped
+ * (with the new c, beq and bin) instead of starting over.
+ *
+ * @param[in, out]  p_h         Points to the handle.
+ * @param[in]       p_qp        Points to the structure representing the problem to solve.
+ * @param[out]      p_x         Points to the vector to store the result.
+ * @param[in]       p_budget    Points to the budget. NULL behaves as quadprog_solve_warm.
+ * @param[out]      p_stats     Points to the report. Can be NULL.
+ * @param[out]      p_cert      Points to the certificate storage. Can be NULL.
+ *
+ * @return  Execution status, same as quadprog_gi_budget.
+ */
+quadprog_status_t
+quadprog_solve_warm_budget(quadprog_warm_t* const p_h, quadprog_t* p_qp, matf32_t* const p_x,
+                           const quadprog_budget_t* const p_budget, quadprog_stats_t* const p_stats,
+                           quadprog_cert_t* const p_cert);
+
+
+/**
+ * @brief   Mehrotra predictor-corrector primal-dual interior-point solver for
+ * min 1/2 x'Qx + c'x s.t. Aeq x = beq, Ain x <= bin.
+ *
+ * Q must be positive definite; it is factored once per call together with A Q^-1 A' (A = [Aeq; Ain]). Each
+ * iteration then factors the multiplier system A Q^-1 A' + diag(0, S Z^-1) once and reuses it for both the
+ * predictor and the corrector solve. p_x0 is not used. Either constraint pair can be NULL.
+ *
+ * @param[in]       p_qp    Points to the structure representing the problem to solve.
+ * @param[in, out]  p_ws    Points to the solver workspace.
+ * @param[out]      p_x     Points to the vector to store the result.
+ * @param[out]      p_info  Points to the iteration report. Can be NULL.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Residuals and duality gap within tolerance.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or exceed the workspace.
+ *              QP_NOT_CONVEX :     Q is not positive definite.
+ *              QP_BAD_DEFINED :    Q or c missing, or constraint normals are linearly dependent.
+ *              QP_MAX_ITERATIONS : MAX_ITERATION_COUNT_IPM iterations reached or the iteration stalled, p_x holds
+ *                                  the last finite iterate.
+ */
+quadprog_status_t
+quadprog_ipm(quadprog_t* p_qp, quadprog_workspace_t* const p_ws, matf32_t* const p_x,
+             quadprog_ipm_info_t* const p_info);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,551 @@
+/**
+ * @file quadprog_admm.c
+ */
+
+#include "quadprog_admm.h"
+
+#define QP_ADMM_RHO_EQ_SCALE    (1e3)   /**< Equality rows use a larger step size (they are always active). */
+#define QP_ADMM_RHO_MIN         (1e-6)
+#define QP_ADMM_RHO_MAX         (1e6)
+#define QP_ADMM_RHO_TOLERANCE   (5.0)   /**< Refactor only if rho changes by more than this factor. */
+
+
+// Row k of A = [Aeq; Ain]
+static inline const float*
+admm_row(const quadprog_t* const p_qp, uint16_t meq, uint16_t n, uint16_t k)
+{
+    return (k < meq)? &p_qp->p_Aeq->p_data[k*n] : &p_qp->p_Ain->p_data[(k - meq)*n];
+}
+
+
+static inline void
+admm_bounds(const quadprog_t* const p_qp, uint16_t meq, uint16_t k, float* const p_l, float* const p_u)
+{
+    if (k < meq)
+    {
+        *p_l = p_qp->p_beq->p_data[k];
+        *p_u = *p_l;
+    }
+    else
+    {
+        *p_l = -INFINITY;
+        *p_u = p_qp->p_bin->p_data[k - meq];
+    }
+}
+
+
+static void
+admm_set_rho(quadprog_admm_t* const p_h, float rho)
+{
+    p_h->settings.rho = rho;
+
+    for (uint16_t k = 0; k < p_h->m; ++k)
+    {
+        p_h->p_rho[k] = (k < p_h->meq)? QP_ADMM_RHO_EQ_SCALE*rho : rho;
+        p_h->kkt.p_data[p_h->p_rho_pos[k]] = -1.0f / p_h->p_rho[k];
+    }
+}
+
+
+// Primal infeasibility: dy, without the components that leave the recession cone of [l, u] (dy_k < 0 on rows
+// without lower bound), satisfies A'dy ~ 0 and u'max(dy, 0) + l'min(dy, 0) < 0. Normalizes dy when it does.
+static bool
+admm_prim_infeasible(quadprog_admm_t* const p_h, const quadprog_t* const p_qp)
+{
+    const uint16_t n = p_h->n;
+    float* dy = p_h->p_dy;
+    float* w = p_h->p_w;
+    float* w2 = p_h->p_w2;
+    float dy_max = 0;
+    float l, u;
+
+    for (uint16_t k = p_h->meq; k < p_h->m; ++k)
+    {
+        dy[k] = fmaxf(dy[k], 0);
+    }
+    for (uint16_t k = 0; k < p_h->m; ++k)
+    {
+        dy_max = fmaxf(dy_max, fabsf(dy[k]));
+    }
+    if (dy_max <= FLT_EPSILON)
+    {
+        return false;
+    }
+
+    float bound = 0;
+    for (uint16_t k = 0; k < p_h->m; ++k)
+    {
+        dy[k] /= dy_max;
+        admm_bounds(p_qp, p_h->meq, k, &l, &u);
+        bound += u*dy[k];
+    }
+    if (bound >= -p_h->settings.eps_prim_inf)
+    {
+        return false;
+    }
+
+    // KKT*[0; dy] = [A'dy; -dy/rho]
+    memset(w2, 0, n*sizeof(float));
+    memcpy(&w2[n], dy, p_h->m*sizeof(float));
+    spmatf32_vecmul(&p_h->kkt, w2, w);
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        if (fabsf(w[i]) > p_h->settings.eps_prim_inf)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Dual infeasibility: dx satisfies Qdx ~ 0, c'dx < 0, Aeq dx ~ 0 and Ain dx <= 0. Normalizes dx when it does.
+static bool
+admm_dual_infeasible(quadprog_admm_t* const p_h, const quadprog_t* const p_qp)
+{
+    const uint16_t n = p_h->n;
+    const float eps = p_h->settings.eps_dual_inf;
+    float* dx = p_h->p_dx;
+    float* w = p_h->p_w;
+    float* w2 = p_h->p_w2;
+    float dx_max = 0;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        dx_max = fmaxf(dx_max, fabsf(dx[i]));
+    }
+    if (dx_max <= FLT_EPSILON)
+    {
+        return false;
+    }
+
+    float cdx = 0;
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        dx[i] /= dx_max;
+        cdx += p_qp->p_c->p_data[i]*dx[i];
+    }
+    if (cdx >= -eps)
+    {
+        return false;
+    }
+
+    // KKT*[dx; 0] = [(Q + sigma*I)dx; A dx]
+    memcpy(w2, dx, n*sizeof(float));
+    memset(&w2[n], 0, p_h->m*sizeof(float));
+    spmatf32_vecmul(&p_h->kkt, w2, w);
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        if (fabsf(w[i] - p_h->settings.sigma*dx[i]) > eps)
+        {
+            return false;
+        }
+    }
+    for (uint16_t k = 0; k < p_h->m; ++k)
+    {
+        if (((k < p_h->meq) && (fabsf(w[n + k]) > eps)) || ((k >= p_h->meq) && (w[n + k] > eps)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Pattern of [Q + sigma*I A'; A -diag(1/rho)], both triangles, column by column
+static quadprog_status_t
+admm_kkt_pattern(quadprog_admm_t* const p_h, const quadprog_t* const p_qp)
+{
+    uint16_t n = p_h->n;
+    uint16_t m = p_h->m;
+    spmatf32_t* p_kkt = &p_h->kkt;
+    uint16_t nnz = 0;
+
+    for (uint16_t j = 0; j < n + m; ++j)
+    {
+        p_kkt->p_ptr[j] = nnz;
+
+        for (uint16_t i = 0; i < n + m; ++i)
+        {
+            bool is_nz;
+
+            if ((i < n) && (j < n))
+            {
+                is_nz = (i == j) || (p_qp->p_Q->p_data[i*n + j] != 0);
+            }
+            else if (j < n)
+            {
+                is_nz = (admm_row(p_qp, p_h->meq, n, i - n)[j] != 0);
+            }
+            else if (i < n)
+            {
+                is_nz = (admm_row(p_qp, p_h->meq, n, j - n)[i] != 0);
+            }
+            else
+            {
+                is_nz = (i == j);
+            }
+
+            if (!is_nz)
+            {
+                continue;
+            }
+
+            if (nnz >= p_kkt->nnz_max)
+            {
+                return QP_SIZE_MISMATCH;
+            }
+
+            if ((j >= n) && (i == j))
+            {
+                p_h->p_rho_pos[j - n] = nnz;
+            }
+            p_kkt->p_ind[nnz++] = i;
+        }
+    }
+
+    p_kkt->p_ptr[n + m] = nnz;
+
+    return QP_SUCESS;
+}
+
+
+// Refills the values of the KKT matrix from the problem, keeping its pattern, and factors it
+static quadprog_status_t
+admm_kkt_factor(quadprog_admm_t* const p_h, const quadprog_t* const p_qp)
+{
+    uint16_t n = p_h->n;
+    spmatf32_t* p_kkt = &p_h->kkt;
+
+    for (uint16_t j = 0; j < n + p_h->m; ++j)
+    {
+        for (uint16_t p = p_kkt->p_ptr[j]; p < p_kkt->p_ptr[j+1]; ++p)
+        {
+            uint16_t i = p_kkt->p_ind[p];
+            float value;
+
+            if ((i < n) && (j < n))
+            {
+                value = p_qp->p_Q->p_data[i*n + j] + ((i == j)? p_h->settings.sigma : 0);
+            }
+            else if (j < n)
+            {
+                value = admm_row(p_qp, p_h->meq, n, i - n)[j];
+            }
+            else if (i < n)
+            {
+                value = admm_row(p_qp, p_h->meq, n, j - n)[i];
+            }
+            else
+            {
+                value = -1.0f / p_h->p_rho[j - n];
+            }
+
+            p_kkt->p_data[p] = value;
+        }
+    }
+
+    p_h->info.num_factor++;
+
+    return (MATH_SUCCESS == spldl_numeric(p_kkt, &p_h->num))? QP_SUCESS : QP_NOT_CONVEX;
+}
+
+
+quadprog_status_t
+quadprog_admm_init(quadprog_admm_t* const p_h, const quadprog_t* const p_qp, uint16_t nnz_max, uint16_t lnz_max,
+                   float* p_fbuf, uint16_t* p_ibuf)
+{
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return QP_BAD_DEFINED;
+    }
+
+    uint16_t n = p_qp->p_Q->num_rows;
+    uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+    uint16_t m = meq + ((NULL != p_qp->p_Ain)? p_qp->p_Ain->num_rows : 0);
+    uint16_t dim = n + m;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, n, n) || !matf32_size_check(p_qp->p_c, n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((meq > 0) && (!matf32_size_check(p_qp->p_Aeq, meq, n) || !matf32_size_check(p_qp->p_beq, meq, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((m > meq) && (!matf32_size_check(p_qp->p_Ain, m - meq, n) || !matf32_size_check(p_qp->p_bin, m - meq, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    p_h->n = n;
+    p_h->meq = meq;
+    p_h->m = m;
+
+    p_h->settings.rho = 0.1f;
+    p_h->settings.sigma = 1e-6f;
+    p_h->settings.alpha = 1.6f;
+    p_h->settings.eps_abs = 1e-4f;
+    p_h->settings.eps_rel = 1e-4f;
+    p_h->settings.eps_prim_inf = 1e-4f;
+    p_h->settings.eps_dual_inf = 1e-4f;
+    p_h->settings.max_iter = 4000;
+    p_h->settings.adapt_interval = 25;
+
+    memset(&p_h->info, 0, sizeof(quadprog_admm_info_t));
+
+    // float storage
+    float* p_kkt_data = p_fbuf;
+    p_fbuf += nnz_max;
+    float* p_num_fbuf = p_fbuf;
+    p_fbuf += SPLDL_NUMERIC_FWORK(dim, lnz_max);
+    p_h->p_x = p_fbuf;
+    p_fbuf += n;
+    p_h->p_xt = p_fbuf;
+    p_fbuf += n;
+    p_h->p_z = p_fbuf;
+    p_fbuf += m;
+    p_h->p_y = p_fbuf;
+    p_fbuf += m;
+    p_h->p_zt = p_fbuf;
+    p_fbuf += m;
+    p_h->p_rho = p_fbuf;
+    p_fbuf += m;
+    p_h->p_w = p_fbuf;
+    p_fbuf += dim;
+    p_h->p_w2 = p_fbuf;
+    p_fbuf += dim;
+    p_h->p_dx = p_fbuf;
+    p_fbuf += n;
+    p_h->p_dy = p_fbuf;
+
+    // uint16_t storage
+    uint16_t* p_kkt_ptr = p_ibuf;
+    p_ibuf += dim + 1;
+    uint16_t* p_kkt_ind = p_ibuf;
+    p_ibuf += nnz_max;
+    uint16_t* p_sym_buf = p_ibuf;
+    p_ibuf += SPLDL_SYMBOLIC_IWORK(dim);
+    uint16_t* p_num_ibuf = p_ibuf;
+    p_ibuf += SPLDL_NUMERIC_IWORK(dim, lnz_max);
+    uint16_t* p_order_work = p_ibuf;
+    p_ibuf += SPMAT_MINDEG_IWORK(dim);
+    uint16_t* p_perm = p_ibuf;
+    p_ibuf += dim;
+    p_h->p_rho_pos = p_ibuf;
+
+    spmatf32_init(&p_h->kkt, dim, dim, SPMAT_CSC, nnz_max, p_kkt_ptr, p_kkt_ind, p_kkt_data);
+
+    quadprog_status_t status = admm_kkt_pattern(p_h, p_qp);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    // ordering and symbolic analysis are done once for the lifetime of the handle
+    spmatf32_order_mindeg(&p_h->kkt, p_perm, p_order_work);
+    spldl_symbolic_init(&p_h->sym, dim, p_sym_buf);
+    spldl_symbolic(&p_h->kkt, &p_h->sym, p_perm);
+
+    if (p_h->sym.lnz > lnz_max)
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    spldl_numeric_init(&p_h->num, &p_h->sym, lnz_max, p_num_ibuf, p_num_fbuf);
+
+    admm_set_rho(p_h, p_h->settings.rho);
+    quadprog_admm_cold_start(p_h);
+
+    return admm_kkt_factor(p_h, p_qp);
+}
+
+
+quadprog_status_t
+quadprog_admm_update_matrices(quadprog_admm_t* const p_h, const quadprog_t* const p_qp)
+{
+    return admm_kkt_factor(p_h, p_qp);
+}
+
+
+void
+quadprog_admm_warm_start(quadprog_admm_t* const p_h, const float* const p_x, const float* const p_y)
+{
+    if (NULL != p_x)
+    {
+        memcpy(p_h->p_x, p_x, p_h->n*sizeof(float));
+    }
+
+    if (NULL != p_y)
+    {
+        memcpy(p_h->p_y, p_y, p_h->m*sizeof(float));
+    }
+}
+
+
+void
+quadprog_admm_cold_start(quadprog_admm_t* const p_h)
+{
+    memset(p_h->p_x, 0, p_h->n*sizeof(float));
+    memset(p_h->p_z, 0, p_h->m*sizeof(float));
+    memset(p_h->p_y, 0, p_h->m*sizeof(float));
+}
+
+
+quadprog_status_t
+quadprog_admm(quadprog_admm_t* const p_h, const quadprog_t* const p_qp, matf32_t* const p_x)
+{
+    const uint16_t n = p_h->n;
+    const uint16_t m = p_h->m;
+    const quadprog_admm_settings_t* const p_set = &p_h->settings;
+    const float* q = p_qp->p_c->p_data;
+    float* x = p_h->p_x;
+    float* z = p_h->p_z;
+    float* y = p_h->p_y;
+    float* rho = p_h->p_rho;
+    float* w = p_h->p_w;
+    float* w2 = p_h->p_w2;
+    float l, u;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_x, n, 1) || !matf32_size_check(p_qp->p_c, n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    quadprog_status_t status = QP_MAX_ITERATIONS;
+    p_h->info.num_factor = 0;
+
+    // a new right hand side can leave z outside [l, u], project it before the first iteration
+    for (uint16_t k = 0; k < m; ++k)
+    {
+        admm_bounds(p_qp, p_h->meq, k, &l, &u);
+        z[k] = fminf(fmaxf(z[k], l), u);
+    }
+
+    uint16_t iter;
+    for (iter = 1; iter <= p_set->max_iter; ++iter)
+    {
+        // (xt, v) from the cached factorization, zt = z + (v - y)/rho
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            w[i] = p_set->sigma*x[i] - q[i];
+        }
+        for (uint16_t k = 0; k < m; ++k)
+        {
+            w[n + k] = z[k] - y[k]/rho[k];
+        }
+
+        spldl_solve(&p_h->num, w, w);
+
+        for (uint16_t k = 0; k < m; ++k)
+        {
+            p_h->p_zt[k] = z[k] + (w[n + k] - y[k])/rho[k];
+        }
+
+        // relaxed updates of x, z (projection onto [l, u]) and y, keeping the steps dx and dy
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            float x_new = p_set->alpha*w[i] + (1 - p_set->alpha)*x[i];
+            p_h->p_dx[i] = x_new - x[i];
+            x[i] = x_new;
+        }
+        for (uint16_t k = 0; k < m; ++k)
+        {
+            float z_relax = p_set->alpha*p_h->p_zt[k] + (1 - p_set->alpha)*z[k];
+
+            admm_bounds(p_qp, p_h->meq, k, &l, &u);
+            float z_new = fminf(fmaxf(z_relax + y[k]/rho[k], l), u);
+
+            p_h->p_dy[k] = rho[k]*(z_relax - z_new);
+            y[k] += p_h->p_dy[k];
+            z[k] = z_new;
+        }
+
+        // residuals, KKT*[x; 0] = [(Q + sigma*I)x; Ax] and KKT*[0; y] = [A'y; -y/rho]
+        memcpy(w2, x, n*sizeof(float));
+        memset(&w2[n], 0, m*sizeof(float));
+        spmatf32_vecmul(&p_h->kkt, w2, w);
+
+        float r_prim = 0;
+        float prim_scale = 0;
+        for (uint16_t k = 0; k < m; ++k)
+        {
+            r_prim = fmaxf(r_prim, fabsf(w[n + k] - z[k]));
+            prim_scale = fmaxf(prim_scale, fmaxf(fabsf(w[n + k]), fabsf(z[k])));
+        }
+
+        float* Qx = p_h->p_xt;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            Qx[i] = w[i] - p_set->sigma*x[i];
+        }
+
+        memset(w2, 0, n*sizeof(float));
+        memcpy(&w2[n], y, m*sizeof(float));
+        spmatf32_vecmul(&p_h->kkt, w2, w);
+
+        float r_dual = 0;
+        float dual_scale = 0;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            r_dual = fmaxf(r_dual, fabsf(Qx[i] + q[i] + w[i]));
+            dual_scale = fmaxf(dual_scale, fmaxf(fabsf(Qx[i]), fmaxf(fabsf(w[i]), fabsf(q[i]))));
+        }
+
+        p_h->info.r_prim = r_prim;
+        p_h->info.r_dual = r_dual;
+
+        if ((r_prim <= p_set->eps_abs + p_set->eps_rel*prim_scale)
+            && (r_dual <= p_set->eps_abs + p_set->eps_rel*dual_scale))
+        {
+            status = QP_SUCESS;
+            break;
+        }
+
+        if ((m > 0) && admm_prim_infeasible(p_h, p_qp))
+        {
+            status = QP_INFEASIBLE;
+            break;
+        }
+
+        if (admm_dual_infeasible(p_h, p_qp))
+        {
+            status = QP_UNBOUNDED;
+            break;
+        }
+
+        // rho adaptation balancing the relative residuals, refactor only on a significant change
+        if ((p_set->adapt_interval > 0) && (0 == iter % p_set->adapt_interval) && (m > 0))
+        {
+            float ratio = (r_prim / fmaxf(prim_scale, FLT_EPSILON)) / fmaxf(r_dual / fmaxf(dual_scale, FLT_EPSILON), FLT_EPSILON);
+            float rho_new = fminf(fmaxf(p_set->rho * sqrtf(ratio), QP_ADMM_RHO_MIN), QP_ADMM_RHO_MAX);
+
+            if ((rho_new > QP_ADMM_RHO_TOLERANCE*p_set->rho) || (rho_new < p_set->rho/QP_ADMM_RHO_TOLERANCE))
+            {
+                // the dual variables are kept, z and y stay consistent because only the scaling changes
+                admm_set_rho(p_h, rho_new);
+                p_h->info.num_factor++;
+                if (MATH_SUCCESS != spldl_numeric(&p_h->kkt, &p_h->num))
+                {
+                    status = QP_NOT_CONVEX;
+                    break;
+                }
+            }
+        }
+    }
+
+    p_h->info.iter = (iter > p_set->max_iter)? p_set->max_iter : iter;
+    memcpy(p_x->p_data, x, n*sizeof(float));
+
+    return status;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file quadprog_admm.h
+ *
+ * Operator splitting (ADMM) quadratic program solver, following the OSQP iteration.
+ *
+ * The problem min 1/2 x'Qx + c'x s.t. Aeq x = beq, Ain x <= bin is handled as l <= Ax <= u with
+ * A = [Aeq; Ain], l = [beq; -inf] and u = [beq; bin]. Every iteration solves the quasi-definite KKT system
+ *
+ *      [Q + sigma*I   A'          ] [x]   [sigma*x_k - c]
+ *      [A             -diag(1/rho)] [v] = [z_k - y_k/rho]
+ *
+ * whose sparse LDL' factorization is computed once (symbolic analysis and numeric factor) and reused by all
+ * iterations and all later calls. It is only refactored when rho is adapted or when the matrices change.
+ * All memory is provided by the caller at initialization.
+ *
+ * The differences of consecutive iterates converge to certificates when the problem has no solution: dy to
+ * a Farkas vector (A'dy = 0, beq'dy_eq + bin'dy_in < 0, dy_in >= 0) and dx to a direction of unbounded
+ * descent (Qdx = 0, c'dx < 0, Aeq dx = 0, Ain dx <= 0). Both are checked every iteration, so infeasible and
+ * unbounded problems stop long before max_iter.
+ *
+ */
+
+#ifndef ROBOTAT_QUADPROG_ADMM_H_
+#define ROBOTAT_QUADPROG_ADMM_H_
+
+#include "quadprog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define QP_ADMM_KKT_NNZ_MAX(n, m)   ((n)*(n) + 2*(n)*(m) + (m))     /**< Worst case (dense) nonzeros of the KKT matrix. */
+#define QP_ADMM_LNZ_MAX(n, m)       SPLDL_DENSE_LNZ((n) + (m))      /**< Worst case (dense) nonzeros of its L factor. */
+
+/** float storage for quadprog_admm_init. */
+#define QP_ADMM_FWORK(n, m, nnz, lnz)   ((nnz) + SPLDL_NUMERIC_FWORK((n) + (m), lnz) + 5*(n) + 7*(m))
+
+/** uint16_t storage for quadprog_admm_init. */
+#define QP_ADMM_IWORK(n, m, nnz, lnz)   ((n) + (m) + 1 + (nnz) + SPLDL_SYMBOLIC_IWORK((n) + (m)) \
+                                        + SPLDL_NUMERIC_IWORK((n) + (m), lnz) + SPMAT_MINDEG_IWORK((n) + (m)) \
+                                        + (n) + (m) + (m))
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief ADMM solver settings. quadprog_admm_init fills them with defaults, change them afterwards if needed.
+ */
+typedef struct
+{
+    float rho;                  /** Initial step size, adapted during the iteration */
+    float sigma;                /** Regularization of the primal block of the KKT matrix */
+    float alpha;                /** Relaxation parameter, in (0, 2) */
+    float eps_abs;              /** Absolute tolerance of the primal and dual residuals */
+    float eps_rel;              /** Relative tolerance of the primal and dual residuals */
+    float eps_prim_inf;         /** Relative tolerance of the primal infeasibility certificate */
+    float eps_dual_inf;         /** Relative tolerance of the dual infeasibility (unboundedness) certificate */
+    uint16_t max_iter;          /** Maximum number of iterations per call */
+    uint16_t adapt_interval;    /** Iterations between rho adaptations, 0 disables adaptation */
+} quadprog_admm_settings_t;
+
+
+/**
+ * @brief ADMM solver statistics of the last call.
+ */
+typedef struct
+{
+    uint16_t iter;              /** Iterations done */
+    uint16_t num_factor;        /** Numeric factorizations done */
+    float r_prim;               /** Primal residual norm(Ax - z, inf) */
+    float r_dual;               /** Dual residual norm(Qx + c + A'y, inf) */
+} quadprog_admm_info_t;
+
+
+/**
+ * @brief ADMM solver handle. Holds the KKT factorization and the iterates between calls (warm start).
+ */
+typedef struct
+{
+    uint16_t n;                         /** Number of variables */
+    uint16_t meq;                       /** Number of equality constraints */
+    uint16_t m;                         /** Total number of constraints */
+    quadprog_admm_settings_t settings;  /** Solver settings */
+    quadprog_admm_info_t info;          /** Statistics of the last call */
+    float* p_x;                         /** n, primal iterate */
+    float* p_z;                         /** m, constraint iterate z = Ax */
+    float* p_y;                         /** m, dual iterate */
+    float* p_rho;                       /** m, step size of each constraint row */
+    float* p_xt;                        /** n, work */
+    float* p_zt;                        /** m, work */
+    float* p_w;                         /** n + m, KKT right hand side and products */
+    float* p_w2;                        /** n + m, products */
+    float* p_dx;                        /** n, last primal step, the certificate after QP_UNBOUNDED */
+    float* p_dy;                        /** m, last dual step, the certificate after QP_INFEASIBLE */
+    uint16_t* p_rho_pos;                /** m, position of the -1/rho entries in the KKT matrix */
+    spmatf32_t kkt;                     /** KKT matrix, both triangles stored */
+    spldl_symbolic_t sym;               /** Symbolic analysis of the KKT matrix */
+    spldl_numeric_t num;                /** LDL' factorization of the KKT matrix */
+} quadprog_admm_t;
+
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+
+/**
+ * @brief   Initializes the ADMM handle for a problem: builds the KKT matrix pattern, computes a fill-reducing
+ * ordering and the symbolic analysis, factors it and cold starts the iterates.
+ *
+ * An entry of Q, Aeq or Ain that is exactly zero at this point is treated as structurally zero afterwards.
+ *
+ * @param[in, out]  p_h         Points to the solver handle.
+ * @param[in]       p_qp        Points to the problem. Aeq/beq and Ain/bin can be NULL.
+ * @param[in]       nnz_max     Capacity for the KKT matrix, QP_ADMM_KKT_NNZ_MAX(n, m) always suffices.
+ * @param[in]       lnz_max     Capacity for the L factor, QP_ADMM_LNZ_MAX(n, m) always suffices.
+ * @param[in]       p_fbuf      Points to storage, QP_ADMM_FWORK(n, m, nnz_max, lnz_max) elements.
+ * @param[in]       p_ibuf      Points to storage, QP_ADMM_IWORK(n, m, nnz_max, lnz_max) elements.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_BAD_DEFINED :    Q or c missing.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or capacities are too small.
+ *              QP_NOT_CONVEX :     KKT matrix could not be factored.
+ */
+quadprog_status_t
+quadprog_admm_init(quadprog_admm_t* const p_h, const quadprog_t* const p_qp, uint16_t nnz_max, uint16_t lnz_max,
+                   float* p_fbuf, uint16_t* p_ibuf);
+
+
+/**
+ * @brief   Refactors the KKT matrix after the values of Q, Aeq or Ain changed. The sparsity pattern must
+ * not grow (new nonzeros outside the pattern seen at initialization are ignored), c, beq and bin can
+ * change freely between calls without calling this routine.
+ *
+ * @param[in, out]  p_h     Points to the solver handle.
+ * @param[in]       p_qp    Points to the problem.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_NOT_CONVEX :     KKT matrix could not be factored.
+ */
+quadprog_status_t
+quadprog_admm_update_matrices(quadprog_admm_t* const p_h, const quadprog_t* const p_qp);
+
+
+/**
+ * @brief   Sets the primal and/or dual iterates to start the next solve from.
+ *
+ * @param[in, out]  p_h     Points to the solver handle.
+ * @param[in]       p_x     Points to primal start, n elements, or NULL to keep the current one.
+ * @param[in]       p_y     Points to dual start, m elements, or NULL to keep the current one.
+ *
+ * @return  None.
+ */
+void
+quadprog_admm_warm_start(quadprog_admm_t* const p_h, const float* const p_x, const float* const p_y);
+
+
+/**
+ * @brief   Resets the iterates to zero.
+ *
+ * @param[in, out]  p_h     Points to the solver handle.
+ *
+ * @return  None.
+ */
+void
+quadprog_admm_cold_start(quadprog_admm_t* const p_h);
+
+
+/**
+ * @brief   Runs the ADMM iteration from the iterates stored in the handle (the previous solution unless
+ * changed with quadprog_admm_warm_start/quadprog_admm_cold_start).
+ *
+ * @param[in, out]  p_h     Points to the solver handle.
+ * @param[in]       p_qp    Points to the problem, same dimensions and matrices used to initialize p_h.
+ * @param[out]      p_x     Points to the vector to store the result.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Residuals within tolerance.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size.
+ *              QP_NOT_CONVEX :     KKT matrix could not be refactored after a rho update.
+ *              QP_INFEASIBLE :     Constraints are inconsistent, p_h->p_dy holds the certificate (unit inf-norm).
+ *              QP_UNBOUNDED :      Cost is unbounded below, p_h->p_dx holds the direction (unit inf-norm).
+ *              QP_MAX_ITERATIONS : settings.max_iter reached, p_x holds the last iterate.
+ */
+quadprog_status_t
+quadprog_admm(quadprog_admm_t* const p_h, const quadprog_t* const p_qp, matf32_t* const p_x);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_QUADPROG_ADMM_H_
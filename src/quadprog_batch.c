@@ -0,0 +1,430 @@
+/**
+ * @file quadprog_batch.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "quadprog_batch.h"
+
+
+/** Offset of element k of a lockstep array, the QP_BATCH_LANES values of an element are contiguous. */
+#define LANE(k)     ((k)*QP_BATCH_LANES)
+
+
+/**
+ * @brief Shared arguments of the batch workers.
+ */
+typedef struct
+{
+    quadprog_batch_t* p_batch;
+    quadprog_workspace_t* p_ws;
+} batch_worker_arg_t;
+
+
+// ====================================================================================================
+// Lockstep kernels, every innermost loop runs over the lanes
+// ====================================================================================================
+
+
+/**
+ * @brief   In place Cholesky factorization A = U'U of m x m lockstep matrices, only the upper triangle is used.
+ * Lanes that are not positive definite get a unit pivot (to keep the others going) and are flagged.
+ */
+static void
+lane_cholesky(float* A, uint16_t m, bool* p_ok)
+{
+    for (uint16_t i = 0; i < m; ++i)
+    {
+        float* aii = &A[LANE(i*m + i)];
+
+        for (uint16_t k = 0; k < i; ++k)
+        {
+            const float* uki = &A[LANE(k*m + i)];
+            for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+            {
+                aii[l] -= uki[l]*uki[l];
+            }
+        }
+
+        for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+        {
+            p_ok[l] = p_ok[l] && (aii[l] > 0);
+            aii[l] = sqrtf((aii[l] > 0)? aii[l] : 1);
+        }
+
+        for (uint16_t j = i + 1; j < m; ++j)
+        {
+            float* aij = &A[LANE(i*m + j)];
+
+            for (uint16_t k = 0; k < i; ++k)
+            {
+                const float* uki = &A[LANE(k*m + i)];
+                const float* ukj = &A[LANE(k*m + j)];
+                for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+                {
+                    aij[l] -= uki[l]*ukj[l];
+                }
+            }
+
+            for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+            {
+                aij[l] /= aii[l];
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief   Solves U'X = B in place for the m x k lockstep matrices B.
+ */
+static void
+lane_fwdsub(const float* U, uint16_t m, float* B, uint16_t k)
+{
+    for (uint16_t c = 0; c < k; ++c)
+    {
+        for (uint16_t i = 0; i < m; ++i)
+        {
+            float* bi = &B[LANE(i*k + c)];
+
+            for (uint16_t j = 0; j < i; ++j)
+            {
+                const float* uji = &U[LANE(j*m + i)];
+                const float* bj = &B[LANE(j*k + c)];
+                for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+                {
+                    bi[l] -= uji[l]*bj[l];
+                }
+            }
+
+            const float* uii = &U[LANE(i*m + i)];
+            for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+            {
+                bi[l] /= uii[l];
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief   Solves Ux = b in place for the lockstep vectors b.
+ */
+static void
+lane_backsub(const float* U, uint16_t m, float* b)
+{
+    for (int16_t i = m - 1; i >= 0; --i)
+    {
+        float* bi = &b[LANE(i)];
+
+        for (uint16_t j = i + 1; j < m; ++j)
+        {
+            const float* uij = &U[LANE(i*m + j)];
+            const float* bj = &b[LANE(j)];
+            for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+            {
+                bi[l] -= uij[l]*bj[l];
+            }
+        }
+
+        const float* uii = &U[LANE(i*m + i)];
+        for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+        {
+            bi[l] /= uii[l];
+        }
+    }
+}
+
+
+/**
+ * @brief   Schur complement solve (see quadprog_qp) of QP_BATCH_LANES equality constrained problems of the
+ * same size. p_qps[l] of the unused lanes repeat a used problem.
+ */
+static void
+lane_solve(const quadprog_t* const* p_qps, uint16_t n, uint16_t meq, float* p_fwork, bool* p_okQ, bool* p_okS,
+           float* const* p_x)
+{
+    float* U = p_fwork;
+    float* G = &U[LANE(n*n)];
+    float* S = &G[LANE(n*meq)];
+    float* t = &S[LANE(meq*meq)];
+    float* r = &t[LANE(n)];
+    float* lambda = &r[LANE(n)];
+
+    // gather Q, c and Aeq'
+    for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+    {
+        const float* Q = p_qps[l]->p_Q->p_data;
+        const float* c = p_qps[l]->p_c->p_data;
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            for (uint16_t j = i; j < n; ++j)
+            {
+                U[LANE(i*n + j) + l] = Q[i*n + j];
+            }
+            t[LANE(i) + l] = c[i];
+            r[LANE(i) + l] = c[i];
+        }
+
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            const float* Aeq = p_qps[l]->p_Aeq->p_data;
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                G[LANE(i*meq + k) + l] = Aeq[k*n + i];
+            }
+        }
+
+        p_okQ[l] = true;
+        p_okS[l] = true;
+    }
+
+    // Q = U'U, t = Q^-1 c
+    lane_cholesky(U, n, p_okQ);
+    lane_fwdsub(U, n, t, 1);
+    lane_backsub(U, n, t);
+
+    if (meq > 0)
+    {
+        // S = Aeq Q^-1 Aeq' = G'G with U'G = Aeq'
+        lane_fwdsub(U, n, G, meq);
+
+        for (uint16_t a = 0; a < meq; ++a)
+        {
+            for (uint16_t b = a; b < meq; ++b)
+            {
+                float* sab = &S[LANE(a*meq + b)];
+                for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+                {
+                    sab[l] = 0;
+                }
+
+                for (uint16_t i = 0; i < n; ++i)
+                {
+                    const float* gia = &G[LANE(i*meq + a)];
+                    const float* gib = &G[LANE(i*meq + b)];
+                    for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+                    {
+                        sab[l] += gia[l]*gib[l];
+                    }
+                }
+            }
+        }
+        lane_cholesky(S, meq, p_okS);
+
+        // lambda = -S^-1 (beq + Aeq t)
+        for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+        {
+            const float* Aeq = p_qps[l]->p_Aeq->p_data;
+            const float* beq = p_qps[l]->p_beq->p_data;
+
+            for (uint16_t k = 0; k < meq; ++k)
+            {
+                float sum = beq[k];
+                for (uint16_t i = 0; i < n; ++i)
+                {
+                    sum += Aeq[k*n + i]*t[LANE(i) + l];
+                }
+                lambda[LANE(k) + l] = -sum;
+            }
+        }
+        lane_fwdsub(S, meq, lambda, 1);
+        lane_backsub(S, meq, lambda);
+
+        // r = c + Aeq' lambda
+        for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+        {
+            const float* Aeq = p_qps[l]->p_Aeq->p_data;
+
+            for (uint16_t k = 0; k < meq; ++k)
+            {
+                for (uint16_t i = 0; i < n; ++i)
+                {
+                    r[LANE(i) + l] += Aeq[k*n + i]*lambda[LANE(k) + l];
+                }
+            }
+        }
+    }
+
+    // x = -Q^-1 r
+    lane_fwdsub(U, n, r, 1);
+    lane_backsub(U, n, r);
+
+    for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+    {
+        if (NULL != p_x[l])
+        {
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                p_x[l][i] = -r[LANE(i) + l];
+            }
+        }
+    }
+}
+
+
+// ====================================================================================================
+// Batch
+// ====================================================================================================
+
+
+/**
+ * @brief   Checks whether problems [first, first + num) can be solved in lockstep: equalities only, all of the
+ * same size, fitting the workspace.
+ */
+static bool
+batch_is_lockstep(const quadprog_batch_t* const p_batch, uint16_t first, uint16_t num,
+                  const quadprog_workspace_t* const p_ws)
+{
+    const quadprog_t* p_qp = &p_batch->p_qps[first];
+
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return false;
+    }
+
+    uint16_t n = p_qp->p_Q->num_rows;
+    uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+
+    if ((n > p_ws->n) || (meq > p_ws->meq))
+    {
+        return false;
+    }
+
+    for (uint16_t k = first; k < first + num; ++k)
+    {
+        p_qp = &p_batch->p_qps[k];
+
+        if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c) || (NULL != p_qp->p_Ain)
+            || !matf32_size_check(p_qp->p_Q, n, n) || !matf32_size_check(p_qp->p_c, n, 1)
+            || !matf32_size_check(&p_batch->p_x[k], n, 1))
+        {
+            return false;
+        }
+
+        if ((meq > 0) && ((NULL == p_qp->p_Aeq) || (NULL == p_qp->p_beq)
+            || !matf32_size_check(p_qp->p_Aeq, meq, n) || !matf32_size_check(p_qp->p_beq, meq, 1)))
+        {
+            return false;
+        }
+
+        if ((0 == meq) && (NULL != p_qp->p_Aeq))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void
+batch_solve_lockstep(quadprog_batch_t* const p_batch, uint16_t first, uint16_t num, quadprog_workspace_t* const p_ws)
+{
+    const quadprog_t* p_qps[QP_BATCH_LANES];
+    float* p_x[QP_BATCH_LANES];
+    bool okQ[QP_BATCH_LANES];
+    bool okS[QP_BATCH_LANES];
+
+    // unused lanes repeat the first problem and are not stored
+    for (uint16_t l = 0; l < QP_BATCH_LANES; ++l)
+    {
+        p_qps[l] = &p_batch->p_qps[first + ((l < num)? l : 0)];
+        p_x[l] = (l < num)? p_batch->p_x[first + l].p_data : NULL;
+    }
+
+    uint16_t n = p_qps[0]->p_Q->num_rows;
+    uint16_t meq = (NULL != p_qps[0]->p_Aeq)? p_qps[0]->p_Aeq->num_rows : 0;
+
+    lane_solve(p_qps, n, meq, p_ws->p_fwork, okQ, okS, p_x);
+
+    for (uint16_t l = 0; l < num; ++l)
+    {
+        p_batch->p_status[first + l] = !okQ[l]? QP_NOT_CONVEX : (!okS[l]? QP_BAD_DEFINED : QP_SUCESS);
+    }
+}
+
+
+void
+quadprog_batch_init(quadprog_batch_t* const p_batch, quadprog_t* p_qps, matf32_t* p_x, quadprog_status_t* p_status,
+                    uint16_t count, quadprog_batch_mode_t mode)
+{
+    p_batch->p_qps = p_qps;
+    p_batch->p_x = p_x;
+    p_batch->p_status = p_status;
+    p_batch->count = count;
+    p_batch->mode = mode;
+    __atomic_store_n(&p_batch->next, 0, __ATOMIC_RELAXED);
+}
+
+
+uint16_t
+quadprog_batch_worker(quadprog_batch_t* const p_batch, quadprog_workspace_t* const p_ws)
+{
+    uint16_t chunk = (QP_BATCH_LOCKSTEP == p_batch->mode)? QP_BATCH_LANES : 1;
+    uint16_t solved = 0;
+
+    while (true)
+    {
+        uint32_t first = __atomic_fetch_add(&p_batch->next, chunk, __ATOMIC_RELAXED);
+        if (first >= p_batch->count)
+        {
+            break;
+        }
+
+        uint16_t num = ((p_batch->count - first) < chunk)? (p_batch->count - first) : chunk;
+
+        if ((QP_BATCH_LOCKSTEP == p_batch->mode) && batch_is_lockstep(p_batch, first, num, p_ws))
+        {
+            batch_solve_lockstep(p_batch, first, num, p_ws);
+        }
+        else
+        {
+            for (uint16_t k = first; k < first + num; ++k)
+            {
+                p_batch->p_status[k] = quadprog(&p_batch->p_qps[k], p_ws, &p_batch->p_x[k]);
+            }
+        }
+
+        solved += num;
+    }
+
+    return solved;
+}
+
+
+static void
+batch_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+    (void) num_workers;
+    batch_worker_arg_t* p = (batch_worker_arg_t*) p_arg;
+    quadprog_batch_worker(p->p_batch, &p->p_ws[worker]);
+}
+
+
+quadprog_status_t
+quadprog_batch(quadprog_batch_t* const p_batch, quadprog_workspace_t* const p_ws, uint16_t num_workers)
+{
+    if ((0 == num_workers) || (num_workers > QP_BATCH_MAX_THREADS))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    __atomic_store_n(&p_batch->next, 0, __ATOMIC_RELAXED);
+
+    batch_worker_arg_t arg = {p_batch, p_ws};
+    parallel_run(batch_task, &arg, num_workers);
+
+    for (uint16_t k = 0; k < p_batch->count; ++k)
+    {
+        if (QP_SUCESS != p_batch->p_status[k])
+        {
+            return p_batch->p_status[k];
+        }
+    }
+
+    return QP_SUCESS;
+}
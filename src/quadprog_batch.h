@@ -0,0 +1,127 @@
+/**
+ * @file quadprog_batch.h
+ *
+ * Solver for batches of small independent quadratic programs (Monte Carlo runs, explicit MPC sampling, per robot
+ * allocation).
+ *
+ * Workers claim problems from a shared atomic counter, so a worker that finishes early keeps taking problems
+ * until the batch is exhausted, and each worker solves with its own quadprog_workspace_t. quadprog_batch starts
+ * the workers with parallel_run, as POSIX threads when the library is built with PARALLEL_PTHREAD defined (and
+ * linked with -pthread); by default, or on an RTOS, the workers run in the calling thread and quadprog_batch_worker
+ * can be called directly from as many tasks as wanted.
+ *
+ * The lockstep mode solves groups of QP_BATCH_LANES equality constrained problems of the same size at once, with
+ * the data of the group interleaved so that every inner loop runs over the lanes and maps to SIMD instructions.
+ *
+ */
+
+#ifndef ROBOTAT_QUADPROG_BATCH_H_
+#define ROBOTAT_QUADPROG_BATCH_H_
+
+#include "quadprog.h"
+#include "robotat_parallel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define QP_BATCH_LANES          (8)     /**< Problems solved together in lockstep mode. */
+#define QP_BATCH_MAX_THREADS    (PARALLEL_MAX_WORKERS)  /**< Maximum number of workers started by quadprog_batch. */
+
+/** float storage of a lockstep group for n variables and meq equalities. */
+#define QUADPROG_BATCH_LOCKSTEP_FWORK(n, meq)   (QP_BATCH_LANES*((n)*(n) + (n)*(meq) + (meq)*(meq) + 2*(n) + (meq)))
+
+/** float storage of a worker workspace usable in both modes. */
+#define QUADPROG_BATCH_FWORK(n, meq, min)       QUADPROG_MAX(QUADPROG_WORKSPACE_FWORK(n, meq, min), \
+                                                QUADPROG_BATCH_LOCKSTEP_FWORK(n, meq))
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief Batch solution mode.
+ */
+typedef enum
+{
+    QP_BATCH_GENERAL,   /** Every problem is solved by quadprog on its own */
+    QP_BATCH_LOCKSTEP   /** Groups of same size equality constrained problems are solved together */
+} quadprog_batch_mode_t;
+
+
+/**
+ * @brief Batch of independent problems.
+ */
+typedef struct
+{
+    quadprog_t* p_qps;              /** count problems */
+    matf32_t* p_x;                  /** count result vectors */
+    quadprog_status_t* p_status;    /** count statuses */
+    uint16_t count;                 /** Number of problems */
+    quadprog_batch_mode_t mode;     /** Solution mode */
+    uint32_t next;                  /** Next problem not claimed by a worker, only accessed atomically */
+} quadprog_batch_t;
+
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+
+/**
+ * @brief   Constructor for a batch of problems.
+ *
+ * @param[in, out]  p_batch     Points to the batch.
+ * @param[in]       p_qps       Points to the problems.
+ * @param[out]      p_x         Points to the result vectors, one per problem.
+ * @param[out]      p_status    Points to the statuses, one per problem.
+ * @param[in]       count       Number of problems.
+ * @param[in]       mode        Solution mode.
+ *
+ * @return  None.
+ */
+void
+quadprog_batch_init(quadprog_batch_t* const p_batch, quadprog_t* p_qps, matf32_t* p_x, quadprog_status_t* p_status,
+                    uint16_t count, quadprog_batch_mode_t mode);
+
+
+/**
+ * @brief   Solves problems of the batch until none is left. Safe to call concurrently from several threads,
+ * each with its own workspace.
+ *
+ * In lockstep mode the workspace fwork must hold QUADPROG_BATCH_FWORK(n, meq, min) elements. Groups that mix
+ * sizes or have inequalities are solved one problem at a time.
+ *
+ * @param[in, out]  p_batch     Points to the batch.
+ * @param[in, out]  p_ws        Points to the workspace of this worker, large enough for every problem.
+ *
+ * @return  Number of problems solved by this worker.
+ */
+uint16_t
+quadprog_batch_worker(quadprog_batch_t* const p_batch, quadprog_workspace_t* const p_ws);
+
+
+/**
+ * @brief   Solves the whole batch with num_workers workers, the calling thread being one of them.
+ *
+ * @param[in, out]  p_batch         Points to the batch, claimed from the start.
+ * @param[in, out]  p_ws            Points to num_workers workspaces.
+ * @param[in]       num_workers     Number of workers, at most QP_BATCH_MAX_THREADS.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Every problem solved, otherwise the status of the first failed problem.
+ *              QP_SIZE_MISMATCH :  num_workers is 0 or above QP_BATCH_MAX_THREADS.
+ */
+quadprog_status_t
+quadprog_batch(quadprog_batch_t* const p_batch, quadprog_workspace_t* const p_ws, uint16_t num_workers);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_QUADPROG_BATCH_H_
@@ -0,0 +1,992 @@
+/**
+ * @file quadprog_mp.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "quadprog_mp.h"
+
+
+#define QP_MP_TOLERANCE         (1e-4f)     /**< Chebyshev radius (relative to the box) of an empty region or facet. */
+#define QP_MP_ACTIVE            (1e-5f)     /**< Relative slack and multiplier under which an inequality is active. */
+#define QP_MP_STEP              (2e-3f)     /**< Step across a facet to a neighbour region, relative to the box. */
+#define QP_MP_REG               (1e-3f)     /**< Regularization making the Chebyshev center LP a strictly convex QP. */
+#define QP_MP_EVAL_TOLERANCE    (1e-4f)     /**< Facet violation accepted by quadprog_mp_eval. */
+
+
+/**
+ * @brief Exploration and tree building state. The output arrays are the writable views of the law arrays.
+ */
+typedef struct
+{
+    const quadprog_mp_t* p_mp;
+    quadprog_workspace_t* p_ws;
+    uint16_t n;                 /** Variables */
+    uint16_t min;               /** Inequalities */
+    uint16_t p;                 /** Parameters */
+    uint16_t nout;              /** Outputs */
+    uint16_t words;             /** Words of an active set */
+    float scale;                /** Largest half width of the parameter box */
+    const float* p_W;           /** Q^-1 [F c], n x (p + 1) */
+    float* p_region;
+    float* p_law;
+    float* p_plane;
+    uint16_t* p_row;
+    uint16_t* p_set;            /** Active set of each region, words bits */
+    uint16_t* p_child;
+    uint16_t* p_leaf;
+    uint16_t max_regions;
+    uint16_t max_rows;
+    uint16_t max_nodes;
+    uint16_t max_leaf;
+    uint16_t num_regions;
+    uint16_t num_nodes;
+    uint16_t num_leaf;
+} mp_builder_t;
+
+
+// ====================================================================================================
+// Helpers
+// ====================================================================================================
+
+
+static inline float
+mp_dot(const float* a, const float* b, uint16_t len)
+{
+    float sum = 0;
+    for (uint16_t i = 0; i < len; ++i)
+    {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+
+/**
+ * @brief   Largest violation max(h'theta - k) of rows [h, k].
+ */
+static float
+mp_violation(const float* p_rows, uint16_t num_rows, uint16_t p, const float* p_theta)
+{
+    float viol = -INFINITY;
+    for (uint16_t i = 0; i < num_rows; ++i)
+    {
+        const float* row = &p_rows[i*(p + 1)];
+        viol = fmaxf(viol, mp_dot(row, p_theta, p) - row[p]);
+    }
+
+    return viol;
+}
+
+
+/**
+ * @brief   Chebyshev center of {theta : rows} (restricted to the plane p_eq when given) from
+ * max r s.t. h'theta + r*norm(h projected on the plane) <= k, r <= scale, solved by quadprog_gi with a small
+ * regularization. Returns whether the radius is above the emptiness tolerance.
+ */
+static bool
+mp_chebyshev(mp_builder_t* b, const float* p_rows, uint16_t num_rows, const float* p_eq, float* p_center)
+{
+    const uint16_t p = b->p;
+    const uint16_t ny = p + 1;
+    const quadprog_mp_t* p_mp = b->p_mp;
+
+    float Q_data[ny*ny];
+    float c_data[ny];
+    float A_data[(num_rows + 1)*ny];
+    float bin_data[num_rows + 1];
+    float y_data[ny];
+    float beq = (NULL != p_eq) ? p_eq[p] : 0;
+    matf32_t Q, c, Ain, bin, Aeq, meq, y;
+    quadprog_t qp;
+
+    // 1/2 reg (|theta - center|^2 + r^2) - r
+    memset(Q_data, 0, sizeof(Q_data));
+    for (uint16_t i = 0; i < ny; ++i)
+    {
+        Q_data[i*ny + i] = QP_MP_REG;
+    }
+    for (uint16_t i = 0; i < p; ++i)
+    {
+        c_data[i] = -QP_MP_REG * 0.5f*(p_mp->p_theta_min[i] + p_mp->p_theta_max[i]);
+    }
+    c_data[p] = -1;
+
+    for (uint16_t i = 0; i < num_rows; ++i)
+    {
+        const float* row = &p_rows[i*ny];
+        float norm = 1;
+        if (NULL != p_eq)
+        {
+            float cosine = mp_dot(row, p_eq, p);
+            norm = sqrtf(fmaxf(0, 1 - cosine*cosine));
+        }
+
+        memcpy(&A_data[i*ny], row, p*sizeof(float));
+        A_data[i*ny + p] = norm;
+        bin_data[i] = row[p];
+    }
+    memset(&A_data[num_rows*ny], 0, p*sizeof(float));
+    A_data[num_rows*ny + p] = 1;
+    bin_data[num_rows] = b->scale;
+
+    matf32_init(&Q, ny, ny, Q_data);
+    matf32_init(&c, ny, 1, c_data);
+    matf32_init(&Ain, num_rows + 1, ny, A_data);
+    matf32_init(&bin, num_rows + 1, 1, bin_data);
+    matf32_init(&y, ny, 1, y_data);
+
+    // the plane row gets a zero radius coefficient
+    float eq_data[ny];
+    if (NULL != p_eq)
+    {
+        memcpy(eq_data, p_eq, p*sizeof(float));
+        eq_data[p] = 0;
+        matf32_init(&Aeq, 1, ny, eq_data);
+        matf32_init(&meq, 1, 1, &beq);
+    }
+    quadprog_init(&qp, &Q, &c, (NULL != p_eq) ? &Aeq : NULL, (NULL != p_eq) ? &meq : NULL, &Ain, &bin, NULL);
+
+    if (QP_SUCESS != quadprog_gi(&qp, b->p_ws, &y, NULL))
+    {
+        return false;
+    }
+
+    memcpy(p_center, y_data, p*sizeof(float));
+
+    return y_data[p] > QP_MP_TOLERANCE*b->scale;
+}
+
+
+/**
+ * @brief   Solves the QP at theta and marks the inequalities with (relative) zero slack in p_set.
+ */
+static quadprog_status_t
+mp_solve_point(mp_builder_t* b, const float* p_theta, uint16_t* p_set)
+{
+    const uint16_t n = b->n;
+    const uint16_t min = b->min;
+    const uint16_t p = b->p;
+    const quadprog_mp_t* p_mp = b->p_mp;
+    const float* Ain = p_mp->p_qp->p_Ain->p_data;
+
+    float c_data[n];
+    float bin_data[min];
+    float z_data[n];
+    matf32_t c, bin, z;
+    quadprog_t qp;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        c_data[i] = p_mp->p_qp->p_c->p_data[i] + mp_dot(&p_mp->p_F->p_data[i*p], p_theta, p);
+    }
+    for (uint16_t i = 0; i < min; ++i)
+    {
+        bin_data[i] = p_mp->p_qp->p_bin->p_data[i] + ((NULL != p_mp->p_S) ? mp_dot(&p_mp->p_S->p_data[i*p], p_theta, p) : 0);
+    }
+
+    matf32_init(&c, n, 1, c_data);
+    matf32_init(&bin, min, 1, bin_data);
+    matf32_init(&z, n, 1, z_data);
+    quadprog_init(&qp, p_mp->p_qp->p_Q, &c, NULL, NULL, p_mp->p_qp->p_Ain, &bin, NULL);
+
+    quadprog_status_t status = quadprog_gi(&qp, b->p_ws, &z, NULL);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    memset(p_set, 0, b->words*sizeof(uint16_t));
+    for (uint16_t i = 0; i < min; ++i)
+    {
+        float slack = bin_data[i] - mp_dot(&Ain[i*n], z_data, n);
+        if (slack <= QP_MP_ACTIVE*(1 + fabsf(bin_data[i])))
+        {
+            p_set[i/16] |= (uint16_t)(1u << (i % 16));
+        }
+    }
+
+    return QP_SUCESS;
+}
+
+
+/**
+ * @brief   Critical region and affine law of an active set. With A the active rows and W = Q^-1 [F c]:
+ *
+ *      [Ltheta l0] = -(A Q^-1 A')^-1 ([S_A bin_A] + A W)       multipliers lambda = Ltheta theta + l0
+ *      [Ztheta z0] = -(W + Q^-1 A' [Ltheta l0])                solution z = Ztheta theta + z0
+ *
+ * and the region is primal feasibility of the inactive rows, dual feasibility of the active ones and the box.
+ * Active rows whose multiplier is negative at p_theta (weakly active at the solution found) are dropped from
+ * p_set first. Returns false when the active rows are dependent or the region is empty.
+ */
+static bool
+mp_region(mp_builder_t* b, uint16_t* p_set, const float* p_theta, float* p_rows, uint16_t* p_num_rows, float* p_law)
+{
+    const uint16_t n = b->n;
+    const uint16_t min = b->min;
+    const uint16_t p = b->p;
+    const uint16_t np = p + 1;
+    const quadprog_mp_t* p_mp = b->p_mp;
+    const float* Ain = p_mp->p_qp->p_Ain->p_data;
+    const float* bin = p_mp->p_qp->p_bin->p_data;
+    const float* S = (NULL != p_mp->p_S) ? p_mp->p_S->p_data : NULL;
+    const float* W = b->p_W;
+
+    uint16_t idx[n];
+    float QiA[n*n];
+    float M_data[MATF32_SYM_SIZE(n)];
+    float X[n*np];
+    float Z[n*np];
+    float col_data[n];
+    matf32_sym_t M;
+    matf32_t col;
+
+    while (true)
+    {
+        uint16_t na = 0;
+        for (uint16_t i = 0; i < min; ++i)
+        {
+            if (p_set[i/16] & (1u << (i % 16)))
+            {
+                if (na == n)
+                {
+                    return false;
+                }
+                idx[na++] = i;
+            }
+        }
+
+        // Q^-1 A' one column at a time (W holds Q^-1 F, the rows of Q^-1 are its columns)
+        for (uint16_t j = 0; j < na; ++j)
+        {
+            const float* a = &Ain[idx[j]*n];
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                QiA[i*na + j] = mp_dot(&b->p_W[(p + 1)*n + i*n], a, n);
+            }
+        }
+
+        if (na > 0)
+        {
+            matf32_sym_init(&M, na, M_data);
+            for (uint16_t j = 0; j < na; ++j)
+            {
+                for (uint16_t i = 0; i <= j; ++i)
+                {
+                    float sum = 0;
+                    for (uint16_t l = 0; l < n; ++l)
+                    {
+                        sum += Ain[idx[i]*n + l] * QiA[l*na + j];
+                    }
+                    *matf32_sym_at(&M, i, j) = sum;
+                }
+            }
+
+            if (MATH_SUCCESS != matf32_sym_cholesky(&M))
+            {
+                return false;
+            }
+
+            // X = -(A Q^-1 A')^-1 ([S_A bin_A] + A W), one column at a time
+            matf32_init(&col, na, 1, col_data);
+            for (uint16_t l = 0; l < np; ++l)
+            {
+                for (uint16_t j = 0; j < na; ++j)
+                {
+                    const uint16_t i = idx[j];
+                    float sum = (l < p) ? ((NULL != S) ? S[i*p + l] : 0) : bin[i];
+                    for (uint16_t r = 0; r < n; ++r)
+                    {
+                        sum += Ain[i*n + r] * W[r*np + l];
+                    }
+                    col_data[j] = sum;
+                }
+                matf32_sym_cholesky_solve(&M, &col, &col);
+                for (uint16_t j = 0; j < na; ++j)
+                {
+                    X[j*np + l] = -col_data[j];
+                }
+            }
+
+            // drop the most negative multiplier at theta and start over
+            float lambda_min = 0;
+            uint16_t drop = na;
+            for (uint16_t j = 0; j < na; ++j)
+            {
+                float lambda = mp_dot(&X[j*np], p_theta, p) + X[j*np + p];
+                if (lambda < lambda_min - QP_MP_ACTIVE*(1 + fabsf(X[j*np + p])))
+                {
+                    lambda_min = lambda;
+                    drop = j;
+                }
+            }
+            if (drop < na)
+            {
+                p_set[idx[drop]/16] &= (uint16_t)~(1u << (idx[drop] % 16));
+                continue;
+            }
+        }
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            for (uint16_t l = 0; l < np; ++l)
+            {
+                float sum = W[i*np + l];
+                for (uint16_t j = 0; j < na; ++j)
+                {
+                    sum += QiA[i*na + j] * X[j*np + l];
+                }
+                Z[i*np + l] = -sum;
+            }
+        }
+
+        // rows [h, k]: inactive (Ain_i Ztheta - S_i) theta <= bin_i - Ain_i z0, active -Ltheta_j theta <= l0_j
+        uint16_t num_rows = 0;
+        uint16_t j = 0;
+        for (uint16_t i = 0; i < min + 2*p; ++i)
+        {
+            float* row = &p_rows[num_rows*np];
+
+            if (i >= min)
+            {
+                const uint16_t l = (i - min)/2;
+                const bool upper = (0 == (i - min) % 2);
+                memset(row, 0, p*sizeof(float));
+                row[l] = upper ? 1 : -1;
+                row[p] = upper ? p_mp->p_theta_max[l] : -p_mp->p_theta_min[l];
+            }
+            else if ((j < na) && (idx[j] == i))
+            {
+                for (uint16_t l = 0; l < np; ++l)
+                {
+                    row[l] = -X[j*np + l];
+                }
+                row[p] = X[j*np + p];
+                ++j;
+            }
+            else
+            {
+                for (uint16_t l = 0; l < np; ++l)
+                {
+                    float sum = 0;
+                    for (uint16_t r = 0; r < n; ++r)
+                    {
+                        sum += Ain[i*n + r] * Z[r*np + l];
+                    }
+                    row[l] = sum;
+                }
+                for (uint16_t l = 0; l < p; ++l)
+                {
+                    row[l] -= (NULL != S) ? S[i*p + l] : 0;
+                }
+                row[p] = bin[i] - row[p];
+            }
+
+            // unit normals, rows without a normal are either always met or make the region empty
+            float norm = sqrtf(mp_dot(row, row, p));
+            if (norm <= QP_MP_ACTIVE*(1 + fabsf(row[p])))
+            {
+                if (row[p] < -QP_MP_TOLERANCE*b->scale)
+                {
+                    return false;
+                }
+                continue;
+            }
+            for (uint16_t l = 0; l < np; ++l)
+            {
+                row[l] /= norm;
+            }
+            ++num_rows;
+        }
+
+        for (uint16_t i = 0; i < b->nout; ++i)
+        {
+            memcpy(&p_law[i*np], &Z[i*np], np*sizeof(float));
+        }
+        *p_num_rows = num_rows;
+
+        return true;
+    }
+}
+
+
+/**
+ * @brief   Keeps the rows of a region that are facets (the region restricted to their plane is not empty) and drops
+ * duplicates and redundant rows. Returns false when the region itself is empty.
+ */
+static bool
+mp_facets(mp_builder_t* b, float* p_rows, uint16_t* p_num_rows)
+{
+    const uint16_t np = b->p + 1;
+    uint16_t num = 0;
+    float center[np];
+    float others[(*p_num_rows)*np];
+
+    for (uint16_t i = 0; i < *p_num_rows; ++i)
+    {
+        bool duplicate = false;
+        for (uint16_t j = 0; (j < num) && !duplicate; ++j)
+        {
+            float diff = 0;
+            for (uint16_t l = 0; l < np; ++l)
+            {
+                diff = fmaxf(diff, fabsf(p_rows[i*np + l] - p_rows[j*np + l]));
+            }
+            duplicate = (diff <= QP_MP_ACTIVE*(1 + b->scale));
+        }
+        if (!duplicate)
+        {
+            memmove(&p_rows[num*np], &p_rows[i*np], np*sizeof(float));
+            ++num;
+        }
+    }
+
+    if (!mp_chebyshev(b, p_rows, num, NULL, center))
+    {
+        return false;
+    }
+
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < num; ++i)
+    {
+        uint16_t k = 0;
+        for (uint16_t j = 0; j < num; ++j)
+        {
+            if (j != i)
+            {
+                memcpy(&others[(k++)*np], &p_rows[j*np], np*sizeof(float));
+            }
+        }
+
+        if (mp_chebyshev(b, others, k, &p_rows[i*np], center))
+        {
+            memmove(&p_rows[kept*np], &p_rows[i*np], np*sizeof(float));
+            ++kept;
+        }
+    }
+    *p_num_rows = kept;
+
+    return kept > 0;
+}
+
+
+/**
+ * @brief   Adds the region of the QP solution at theta unless it is empty or already known.
+ */
+static quadprog_status_t
+mp_add_region(mp_builder_t* b, const float* p_theta)
+{
+    const uint16_t np = b->p + 1;
+    const uint16_t r = b->num_regions;
+    uint16_t set[b->words];
+    float rows[(b->min + 2*b->p)*np];
+    float law[b->nout*np];
+    uint16_t num_rows;
+
+    quadprog_status_t status = mp_solve_point(b, p_theta, set);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    if (!mp_region(b, set, p_theta, rows, &num_rows, law))
+    {
+        return QP_SUCESS;
+    }
+
+    for (uint16_t i = 0; i < r; ++i)
+    {
+        if (0 == memcmp(&b->p_set[i*b->words], set, b->words*sizeof(uint16_t)))
+        {
+            return QP_SUCESS;
+        }
+    }
+
+    if (!mp_facets(b, rows, &num_rows))
+    {
+        return QP_SUCESS;
+    }
+
+    if ((r == b->max_regions) || (b->p_row[r] + num_rows > b->max_rows))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    memcpy(&b->p_region[b->p_row[r]*np], rows, num_rows*np*sizeof(float));
+    memcpy(&b->p_law[r*b->nout*np], law, b->nout*np*sizeof(float));
+    memcpy(&b->p_set[r*b->words], set, b->words*sizeof(uint16_t));
+    b->p_row[r + 1] = b->p_row[r] + num_rows;
+    ++b->num_regions;
+
+    return QP_SUCESS;
+}
+
+
+/**
+ * @brief   Steps across every facet of every region (the list grows while it is walked) and adds the regions
+ * found on the other side.
+ */
+static quadprog_status_t
+mp_explore(mp_builder_t* b)
+{
+    const uint16_t p = b->p;
+    const uint16_t np = p + 1;
+    const quadprog_mp_t* p_mp = b->p_mp;
+    const float step = QP_MP_STEP*b->scale;
+
+    for (uint16_t r = 0; r < b->num_regions; ++r)
+    {
+        const uint16_t first = b->p_row[r];
+        const uint16_t num = b->p_row[r + 1] - first;
+
+        for (uint16_t i = 0; i < num; ++i)
+        {
+            const float* facet = &b->p_region[(first + i)*np];
+            float others[num*np];
+            float theta[p];
+            uint16_t k = 0;
+
+            for (uint16_t j = 0; j < num; ++j)
+            {
+                if (j != i)
+                {
+                    memcpy(&others[(k++)*np], &b->p_region[(first + j)*np], np*sizeof(float));
+                }
+            }
+
+            if (!mp_chebyshev(b, others, k, facet, theta))
+            {
+                continue;
+            }
+
+            bool inside_box = true;
+            for (uint16_t l = 0; l < p; ++l)
+            {
+                theta[l] += step*facet[l];
+                inside_box = inside_box && (theta[l] >= p_mp->p_theta_min[l]) && (theta[l] <= p_mp->p_theta_max[l]);
+            }
+            if (!inside_box)
+            {
+                continue;
+            }
+
+            bool known = false;
+            for (uint16_t j = 0; (j < b->num_regions) && !known; ++j)
+            {
+                known = (mp_violation(&b->p_region[b->p_row[j]*np], b->p_row[j + 1] - b->p_row[j], p, theta) <= 0);
+            }
+            if (known)
+            {
+                continue;
+            }
+
+            // an infeasible QP beyond the facet is the border of the feasible parameter set
+            if (QP_SIZE_MISMATCH == mp_add_region(b, theta))
+            {
+                return QP_SIZE_MISMATCH;
+            }
+        }
+    }
+
+    return QP_SUCESS;
+}
+
+
+/**
+ * @brief   Whether region r restricted to the cell and to the half space plane has an interior.
+ */
+static bool
+mp_in_cell(mp_builder_t* b, uint16_t r, const float* p_cell, uint16_t depth, const float* p_plane)
+{
+    const uint16_t np = b->p + 1;
+    const uint16_t first = b->p_row[r];
+    const uint16_t num = b->p_row[r + 1] - first;
+    float rows[(num + depth + 1)*np];
+    float center[np];
+
+    memcpy(rows, &b->p_region[first*np], num*np*sizeof(float));
+    memcpy(&rows[num*np], p_cell, depth*np*sizeof(float));
+    memcpy(&rows[(num + depth)*np], p_plane, np*sizeof(float));
+
+    return mp_chebyshev(b, rows, num + depth + 1, NULL, center);
+}
+
+
+/**
+ * @brief   Builds the subtree over the regions of a cell (intersection of the half spaces p_cell). Every node
+ * takes the facet plane that best balances the regions on its two sides, a cell with a single region (or where
+ * no facet separates them) is a leaf. Returns the child code of the subtree, p_status reports exceeded capacities.
+ */
+static uint16_t
+mp_tree(mp_builder_t* b, const uint16_t* p_regions, uint16_t count, float* p_cell, uint16_t depth,
+        quadprog_status_t* p_status)
+{
+    const uint16_t np = b->p + 1;
+    float best_plane[np];
+    bool left[count];
+    bool right[count];
+    bool best_left[count];
+    bool best_right[count];
+    uint16_t best_score = count;
+
+    for (uint16_t ri = 0; (ri < count) && (count > 1) && (depth < QP_MP_MAX_DEPTH); ++ri)
+    {
+        const uint16_t r = p_regions[ri];
+        for (uint16_t i = b->p_row[r]; i < b->p_row[r + 1]; ++i)
+        {
+            float plane[np];
+            float flipped[np];
+            uint16_t nl = 0;
+            uint16_t nr = 0;
+
+            memcpy(plane, &b->p_region[i*np], np*sizeof(float));
+            for (uint16_t l = 0; l < np; ++l)
+            {
+                flipped[l] = -plane[l];
+            }
+
+            for (uint16_t j = 0; (j < count) && (nl < count) && (nr < count); ++j)
+            {
+                left[j] = mp_in_cell(b, p_regions[j], p_cell, depth, plane);
+                right[j] = mp_in_cell(b, p_regions[j], p_cell, depth, flipped);
+                nl += left[j];
+                nr += right[j];
+            }
+
+            uint16_t score = (nl > nr) ? nl : nr;
+            if ((nl < count) && (nr < count) && (nl > 0) && (nr > 0) && (score < best_score))
+            {
+                best_score = score;
+                memcpy(best_plane, plane, sizeof(plane));
+                memcpy(best_left, left, sizeof(left));
+                memcpy(best_right, right, sizeof(right));
+            }
+        }
+    }
+
+    if (best_score == count)
+    {
+        if ((b->num_leaf + 1 + count > b->max_leaf) || (b->num_leaf + 1 + count > QP_MP_LEAF))
+        {
+            *p_status = QP_SIZE_MISMATCH;
+            return QP_MP_LEAF;
+        }
+
+        const uint16_t offset = b->num_leaf;
+        b->p_leaf[b->num_leaf++] = count;
+        memcpy(&b->p_leaf[b->num_leaf], p_regions, count*sizeof(uint16_t));
+        b->num_leaf += count;
+
+        return QP_MP_LEAF | offset;
+    }
+
+    if (b->num_nodes == b->max_nodes)
+    {
+        *p_status = QP_SIZE_MISMATCH;
+        return QP_MP_LEAF;
+    }
+
+    const uint16_t node = b->num_nodes++;
+    uint16_t sub[count];
+    uint16_t num_sub = 0;
+    memcpy(&b->p_plane[node*np], best_plane, np*sizeof(float));
+
+    // left: plane'theta <= k, right: the flipped plane
+    for (uint16_t side = 0; side < 2; ++side)
+    {
+        num_sub = 0;
+        for (uint16_t j = 0; j < count; ++j)
+        {
+            if ((0 == side) ? best_left[j] : best_right[j])
+            {
+                sub[num_sub++] = p_regions[j];
+            }
+        }
+
+        for (uint16_t l = 0; l < np; ++l)
+        {
+            p_cell[depth*np + l] = (0 == side) ? best_plane[l] : -best_plane[l];
+        }
+
+        b->p_child[2*node + side] = mp_tree(b, sub, num_sub, p_cell, depth + 1, p_status);
+        if (QP_SUCESS != *p_status)
+        {
+            break;
+        }
+    }
+
+    return node;
+}
+
+
+// ====================================================================================================
+// Public functions
+// ====================================================================================================
+quadprog_status_t
+quadprog_mp_build(const quadprog_mp_t* const p_mp, quadprog_workspace_t* const p_ws, quadprog_mp_law_t* const p_law,
+                  uint16_t max_regions, uint16_t max_rows, uint16_t max_nodes, uint16_t max_leaf,
+                  float* p_fbuf, uint16_t* p_ibuf)
+{
+    const quadprog_t* p_qp = p_mp->p_qp;
+
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c) || (NULL == p_qp->p_Ain) || (NULL == p_qp->p_bin)
+        || (NULL == p_mp->p_F) || (NULL != p_qp->p_Aeq))
+    {
+        return QP_BAD_DEFINED;
+    }
+
+    const uint16_t n = p_qp->p_Q->num_rows;
+    const uint16_t min = p_qp->p_Ain->num_rows;
+    const uint16_t p = p_mp->p_F->num_cols;
+    const uint16_t np = p + 1;
+    const uint16_t nout = p_mp->num_out;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, n, n) || !matf32_size_check(p_qp->p_c, n, 1)
+        || !matf32_size_check(p_qp->p_Ain, min, n) || !matf32_size_check(p_qp->p_bin, min, 1)
+        || !matf32_size_check(p_mp->p_F, n, p) || ((NULL != p_mp->p_S) && !matf32_size_check(p_mp->p_S, min, p))
+        || (nout > n) || (p_ws->n < QUADPROG_MP_WS_N(n, p)) || (p_ws->meq < QUADPROG_MP_WS_MEQ)
+        || (p_ws->min < QUADPROG_MP_WS_MIN(min, p)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    mp_builder_t b;
+    b.p_mp = p_mp;
+    b.p_ws = p_ws;
+    b.n = n;
+    b.min = min;
+    b.p = p;
+    b.nout = nout;
+    b.words = QP_MP_WORDS(min);
+    b.max_regions = max_regions;
+    b.max_rows = max_rows;
+    b.max_nodes = max_nodes;
+    b.max_leaf = max_leaf;
+    b.num_regions = 0;
+    b.num_nodes = 0;
+    b.num_leaf = 0;
+
+    b.scale = 0;
+    float center[p];
+    for (uint16_t l = 0; l < p; ++l)
+    {
+        center[l] = 0.5f*(p_mp->p_theta_min[l] + p_mp->p_theta_max[l]);
+        b.scale = fmaxf(b.scale, 0.5f*(p_mp->p_theta_max[l] - p_mp->p_theta_min[l]));
+    }
+
+    b.p_region = p_fbuf;
+    p_fbuf += max_rows*np;
+    b.p_law = p_fbuf;
+    p_fbuf += max_regions*nout*np;
+    b.p_plane = p_fbuf;
+    b.p_row = p_ibuf;
+    p_ibuf += max_regions + 1;
+    b.p_set = p_ibuf;
+    p_ibuf += max_regions*b.words;
+    b.p_child = p_ibuf;
+    p_ibuf += 2*max_nodes;
+    b.p_leaf = p_ibuf;
+    b.p_row[0] = 0;
+
+    // W = Q^-1 [F c] followed by Q^-1, from the Cholesky factor of Q
+    float U_data[MATF32_SYM_SIZE(n)];
+    float W[n*np + n*n];
+    float col_data[n];
+    matf32_sym_t U;
+    matf32_t col;
+
+    matf32_sym_init(&U, n, U_data);
+    matf32_sym_from_dense(p_qp->p_Q, &U);
+    if (MATH_SUCCESS != matf32_sym_cholesky(&U))
+    {
+        return QP_NOT_CONVEX;
+    }
+
+    matf32_init(&col, n, 1, col_data);
+    for (uint16_t l = 0; l < np + n; ++l)
+    {
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            col_data[i] = (l < p) ? p_mp->p_F->p_data[i*p + l] : ((l == p) ? p_qp->p_c->p_data[i] : (i == l - np));
+        }
+        matf32_sym_cholesky_solve(&U, &col, &col);
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            if (l < np)
+            {
+                W[i*np + l] = col_data[i];
+            }
+            else
+            {
+                W[n*np + (l - np)*n + i] = col_data[i];
+            }
+        }
+    }
+    b.p_W = W;
+
+    quadprog_status_t status = mp_add_region(&b, center);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+    if (0 == b.num_regions)
+    {
+        return QP_INFEASIBLE;
+    }
+
+    status = mp_explore(&b);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    uint16_t regions[b.num_regions];
+    float cell[QP_MP_MAX_DEPTH*np];
+    for (uint16_t r = 0; r < b.num_regions; ++r)
+    {
+        regions[r] = r;
+    }
+
+    const uint16_t root = mp_tree(&b, regions, b.num_regions, cell, 0, &status);
+    if (QP_SUCESS != status)
+    {
+        return status;
+    }
+
+    p_law->num_param = p;
+    p_law->num_out = nout;
+    p_law->num_regions = b.num_regions;
+    p_law->num_nodes = b.num_nodes;
+    p_law->root = root;
+    p_law->p_region_row = b.p_row;
+    p_law->p_region = b.p_region;
+    p_law->p_law = b.p_law;
+    p_law->p_node_plane = b.p_plane;
+    p_law->p_node_child = b.p_child;
+    p_law->p_leaf = b.p_leaf;
+
+    return QP_SUCESS;
+}
+
+
+quadprog_status_t
+quadprog_mp_eval(const quadprog_mp_law_t* const p_law, const float* p_theta, float* p_z, uint16_t* p_region)
+{
+    const uint16_t p = p_law->num_param;
+    const uint16_t np = p + 1;
+    uint16_t node = p_law->root;
+
+    while (!(node & QP_MP_LEAF))
+    {
+        const float* plane = &p_law->p_node_plane[node*np];
+        node = p_law->p_node_child[2*node + (mp_dot(plane, p_theta, p) > plane[p])];
+    }
+
+    // closest region of the leaf (usually the only one)
+    const uint16_t* leaf = &p_law->p_leaf[node & ~QP_MP_LEAF];
+    uint16_t region = leaf[1];
+    float viol = INFINITY;
+    for (uint16_t j = 1; j <= leaf[0]; ++j)
+    {
+        const uint16_t r = leaf[j];
+        const uint16_t first = p_law->p_region_row[r];
+        float v = mp_violation(&p_law->p_region[first*np], p_law->p_region_row[r + 1] - first, p, p_theta);
+        if (v < viol)
+        {
+            viol = v;
+            region = r;
+        }
+    }
+
+    const float* law = &p_law->p_law[region*p_law->num_out*np];
+    for (uint16_t i = 0; i < p_law->num_out; ++i)
+    {
+        p_z[i] = mp_dot(&law[i*np], p_theta, p) + law[i*np + p];
+    }
+
+    if (NULL != p_region)
+    {
+        *p_region = region;
+    }
+
+    return (viol <= QP_MP_EVAL_TOLERANCE) ? QP_SUCESS : QP_INFEASIBLE;
+}
+
+
+static void
+mp_print_floats(const char* name, const char* suffix, const float* p_data, uint16_t len, uint16_t per_line)
+{
+    printf("static const float %s_%s[] = {", name, suffix);
+    for (uint16_t i = 0; i < len; ++i)
+    {
+        printf("%s%.9ef%s", (0 == i % per_line) ? "\n    " : "", p_data[i], (i + 1 < len) ? ", " : "");
+    }
+    printf("\n};\n\n");
+}
+
+
+static void
+mp_print_indices(const char* name, const char* suffix, const uint16_t* p_data, uint16_t len)
+{
+    printf("static const uint16_t %s_%s[] = {", name, suffix);
+    for (uint16_t i = 0; i < len; ++i)
+    {
+        printf("%s%u%s", (0 == i % 16) ? "\n    " : "", p_data[i], (i + 1 < len) ? ", " : "");
+    }
+    printf("\n};\n\n");
+}
+
+
+void
+quadprog_mp_print(const quadprog_mp_law_t* const p_law, const char* name)
+{
+    const uint16_t np = p_law->num_param + 1;
+    const uint16_t num_rows = p_law->p_region_row[p_law->num_regions];
+
+    // leaves are walked from the tree to find the used length of the leaf list
+    uint16_t num_leaf = 0;
+    for (uint16_t i = 0; i <= 2*p_law->num_nodes; ++i)
+    {
+        const uint16_t child = (i < 2*p_law->num_nodes) ? p_law->p_node_child[i] : p_law->root;
+        if (child & QP_MP_LEAF)
+        {
+            const uint16_t offset = child & ~QP_MP_LEAF;
+            const uint16_t end = offset + 1 + p_law->p_leaf[offset];
+            num_leaf = (end > num_leaf) ? end : num_leaf;
+        }
+    }
+
+    printf("// explicit solution: %u parameters, %u outputs, %u regions, %u nodes\n\n", p_law->num_param,
+           p_law->num_out, p_law->num_regions, p_law->num_nodes);
+    mp_print_indices(name, "region_row", p_law->p_region_row, p_law->num_regions + 1);
+    mp_print_floats(name, "region", p_law->p_region, num_rows*np, np);
+    mp_print_floats(name, "law", p_law->p_law, p_law->num_regions*p_law->num_out*np, np);
+    if (p_law->num_nodes > 0)
+    {
+        mp_print_floats(name, "node_plane", p_law->p_node_plane, p_law->num_nodes*np, np);
+        mp_print_indices(name, "node_child", p_law->p_node_child, 2*p_law->num_nodes);
+    }
+    mp_print_indices(name, "leaf", p_law->p_leaf, num_leaf);
+
+    printf("const quadprog_mp_law_t %s =\n{\n", name);
+    printf("    .num_param = %u,\n    .num_out = %u,\n    .num_regions = %u,\n    .num_nodes = %u,\n    .root = %u,\n",
+           p_law->num_param, p_law->num_out, p_law->num_regions, p_law->num_nodes, p_law->root);
+    printf("    .p_region_row = %s_region_row,\n    .p_region = %s_region,\n    .p_law = %s_law,\n", name, name, name);
+    if (p_law->num_nodes > 0)
+    {
+        printf("    .p_node_plane = %s_node_plane,\n    .p_node_child = %s_node_child,\n", name, name);
+    }
+    else
+    {
+        printf("    .p_node_plane = NULL,\n    .p_node_child = NULL,\n");
+    }
+    printf("    .p_leaf = %s_leaf\n};\n", name);
+}
@@ -0,0 +1,160 @@
+/**
+ * @file quadprog_mp.h
+ *
+ * Multi-parametric quadratic programs (explicit MPC).
+ *
+ * The problem
+ *
+ *      min 1/2 z'Qz + (c + F theta)'z  s.t.  Ain z <= bin + S theta,  theta_min <= theta <= theta_max
+ *
+ * has a piecewise affine solution z(theta) = Fr theta + gr over polyhedral critical regions Hr theta <= kr, one per
+ * optimal active set. quadprog_mp_build explores the regions offline: it solves the QP at the center of the parameter
+ * box with quadprog_gi, computes the critical region of the active set found, and steps across each facet of every
+ * region to find its neighbours until no facet leads to an unexplored region. It then builds a binary search tree
+ * whose nodes are facet hyperplanes of the regions, so quadprog_mp_eval locates a parameter with one dot product per
+ * level and evaluates a single affine law, O(log regions) online without any QP solve.
+ *
+ * The result is a quadprog_mp_law_t that only references arrays. quadprog_mp_print writes them as C source, so the
+ * online controller can be built with quadprog_mp_eval alone and the law kept in flash.
+ *
+ */
+
+#ifndef ROBOTAT_QUADPROG_MP_H_
+#define ROBOTAT_QUADPROG_MP_H_
+
+#include "quadprog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define QP_MP_LEAF                  (0x8000)    /**< Flag of a tree child that is an offset into the leaf list. */
+#define QP_MP_MAX_DEPTH             (32)        /**< Deepest tree built, deeper cells become multi-region leaves. */
+
+/** uint16_t words of the active set of a region with min inequalities. */
+#define QP_MP_WORDS(min)            (((min) + 15)/16)
+
+/** float storage for quadprog_mp_build, p parameters and nout outputs. */
+#define QUADPROG_MP_FWORK(p, nout, max_regions, max_rows, max_nodes) \
+                                    (((max_rows) + (max_regions)*(nout) + (max_nodes))*((p) + 1))
+
+/** uint16_t storage for quadprog_mp_build. */
+#define QUADPROG_MP_IWORK(min, max_regions, max_nodes, max_leaf) \
+                                    ((max_regions) + 1 + (max_regions)*QP_MP_WORDS(min) + 2*(max_nodes) + (max_leaf))
+
+/** Variables, equalities and inequalities the workspace passed to quadprog_mp_build must hold. */
+#define QUADPROG_MP_WS_N(n, p)      QUADPROG_MAX(n, (p) + 1)
+#define QUADPROG_MP_WS_MEQ          (1)
+#define QUADPROG_MP_WS_MIN(min, p)  ((min) + 2*(p) + QP_MP_MAX_DEPTH + 2)
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief Multi-parametric problem. p_qp holds Q, c, Ain and bin at theta = 0, its equalities must be NULL.
+ */
+typedef struct
+{
+    const quadprog_t* p_qp;         /** Problem at theta = 0 */
+    const matf32_t* p_F;            /** Parameter term of the gradient, n x p */
+    const matf32_t* p_S;            /** Parameter term of the inequalities, min x p, NULL for none */
+    const float* p_theta_min;       /** Lower corner of the explored parameter box, p elements */
+    const float* p_theta_max;       /** Upper corner of the explored parameter box, p elements */
+    uint16_t num_out;               /** Leading elements of z kept in the law (e.g. u0 of a condensed MPC) */
+} quadprog_mp_t;
+
+
+/**
+ * @brief Explicit (piecewise affine) solution. Every row is stored as [h, k] meaning h'theta <= k.
+ */
+typedef struct
+{
+    uint16_t num_param;             /** Parameters p */
+    uint16_t num_out;               /** Outputs */
+    uint16_t num_regions;           /** Critical regions */
+    uint16_t num_nodes;             /** Tree nodes */
+    uint16_t root;                  /** Root of the tree, a node or QP_MP_LEAF | leaf offset */
+    const uint16_t* p_region_row;   /** num_regions + 1, first row of each region in p_region */
+    const float* p_region;          /** Facets of the regions, (p + 1) per row, unit norm h */
+    const float* p_law;             /** num_regions x num_out rows [Fr, gr] of z = Fr theta + gr */
+    const float* p_node_plane;      /** num_nodes rows [h, k], theta goes left when h'theta <= k */
+    const uint16_t* p_node_child;   /** num_nodes x 2 children, a node or QP_MP_LEAF | leaf offset */
+    const uint16_t* p_leaf;         /** Leaves as a count followed by that many region indices */
+} quadprog_mp_law_t;
+
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+
+/**
+ * @brief   Explores the critical regions of a multi-parametric QP and builds the search tree over them (offline).
+ *
+ * The QP must be feasible at the center of the parameter box. Parameters for which the QP is infeasible are left
+ * uncovered. Q must be positive definite and the active sets are assumed to satisfy LICQ.
+ *
+ * @param[in]       p_mp        Points to the multi-parametric problem.
+ * @param[in, out]  p_ws        Points to a workspace for at least QUADPROG_MP_WS_N(n, p) variables,
+ *                              QUADPROG_MP_WS_MEQ equalities and QUADPROG_MP_WS_MIN(min, p) inequalities.
+ * @param[out]      p_law       Points to the law, it references p_fbuf and p_ibuf.
+ * @param[in]       max_regions Capacity for regions.
+ * @param[in]       max_rows    Capacity for facets summed over all regions.
+ * @param[in]       max_nodes   Capacity for tree nodes. A region cut by a node plane appears under both of its
+ *                              children, so a few times max_regions can be needed.
+ * @param[in]       max_leaf    Capacity of the leaf list, 2 entries per single region leaf.
+ * @param[in]       p_fbuf      Points to storage, QUADPROG_MP_FWORK(p, num_out, max_regions, max_rows, max_nodes).
+ * @param[in]       p_ibuf      Points to storage, QUADPROG_MP_IWORK(min, max_regions, max_nodes, max_leaf).
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size or a capacity was exceeded.
+ *              QP_BAD_DEFINED :    Q, c, Ain, bin or F missing, or equalities given.
+ *              QP_NOT_CONVEX :     Q is not positive definite.
+ *              QP_INFEASIBLE :     The QP is infeasible at the center of the parameter box.
+ */
+quadprog_status_t
+quadprog_mp_build(const quadprog_mp_t* const p_mp, quadprog_workspace_t* const p_ws, quadprog_mp_law_t* const p_law,
+                  uint16_t max_regions, uint16_t max_rows, uint16_t max_nodes, uint16_t max_leaf,
+                  float* p_fbuf, uint16_t* p_ibuf);
+
+
+/**
+ * @brief   Evaluates the explicit solution: point location in the tree and one affine law (online).
+ *
+ * @param[in]   p_law       Points to the law.
+ * @param[in]   p_theta     Points to the parameter, num_param elements.
+ * @param[out]  p_z         Points to the output, num_out elements.
+ * @param[out]  p_region    Points to the region used, can be NULL.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         theta lies in the region found.
+ *              QP_INFEASIBLE :     theta is outside every region (outside the explored box or where the QP is
+ *                                  infeasible), p_z holds the law of the closest region of its leaf.
+ */
+quadprog_status_t
+quadprog_mp_eval(const quadprog_mp_law_t* const p_law, const float* p_theta, float* p_z, uint16_t* p_region);
+
+
+/**
+ * @brief   Prints the law as C source: its arrays and a quadprog_mp_law_t initializer called name.
+ *
+ * @param[in]   p_law   Points to the law.
+ * @param[in]   name    Name of the generated law variable, also prefix of its arrays.
+ *
+ * @return  None.
+ */
+void
+quadprog_mp_print(const quadprog_mp_law_t* const p_law, const char* name);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_QUADPROG_MP_H_
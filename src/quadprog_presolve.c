@@ -0,0 +1,659 @@
+/**
+ * @file quadprog_presolve.c
+ */
+
+#include "quadprog_presolve.h"
+
+#define QP_PRESOLVE_NORM_MIN    (1e-4)  /**< Row/column norms are clamped to [NORM_MIN, NORM_MAX] by Ruiz scaling. */
+#define QP_PRESOLVE_NORM_MAX    (1e4)
+
+
+// Row k of A = [Aeq; Ain]
+static inline const float*
+presolve_row(const quadprog_t* const p_qp, uint16_t meq, uint16_t n, uint16_t k)
+{
+    return (k < meq)? &p_qp->p_Aeq->p_data[k*n] : &p_qp->p_Ain->p_data[(k - meq)*n];
+}
+
+
+// Right hand side k of [beq; bin]
+static inline float
+presolve_rhs(const quadprog_t* const p_qp, uint16_t meq, uint16_t k)
+{
+    return (k < meq)? p_qp->p_beq->p_data[k] : p_qp->p_bin->p_data[k - meq];
+}
+
+
+static inline float
+presolve_clamp(float v)
+{
+    return fminf(fmaxf(v, QP_PRESOLVE_NORM_MIN), QP_PRESOLVE_NORM_MAX);
+}
+
+
+// Number of nonzeros of row a on the free variables, *p_j is the last one found
+static uint16_t
+presolve_count(const quadprog_presolve_t* const p_h, const float* const a, uint16_t* const p_j)
+{
+    uint16_t count = 0;
+
+    for (uint16_t j = 0; j < p_h->n; ++j)
+    {
+        if ((QP_PRESOLVE_NONE != p_h->p_col[j]) && (0 != a[j]))
+        {
+            *p_j = j;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+// a = ratio*b on the free variables
+static bool
+presolve_parallel(const quadprog_presolve_t* const p_h, const float* const a, const float* const b,
+                  float* const p_ratio)
+{
+    float ratio = 0;
+    float a_max = 0;
+
+    for (uint16_t j = 0; j < p_h->n; ++j)
+    {
+        if (QP_PRESOLVE_NONE == p_h->p_col[j])
+        {
+            continue;
+        }
+
+        a_max = fmaxf(a_max, fabsf(a[j]));
+        if ((0 == ratio) && ((0 != a[j]) || (0 != b[j])))
+        {
+            if ((0 == a[j]) || (0 == b[j]))
+            {
+                return false;
+            }
+            ratio = a[j] / b[j];
+        }
+    }
+
+    for (uint16_t j = 0; j < p_h->n; ++j)
+    {
+        if ((QP_PRESOLVE_NONE != p_h->p_col[j]) && (fabsf(a[j] - ratio*b[j]) > p_h->settings.tolerance*a_max))
+        {
+            return false;
+        }
+    }
+
+    *p_ratio = ratio;
+    return true;
+}
+
+
+// Keeps row k as a new reduced row in p_dst (stride n_r) unless it is empty or parallel to one of the
+// num_rows kept so far, whose representatives start at p_rep[first]. Returns the updated number of rows.
+static uint16_t
+presolve_add_row(quadprog_presolve_t* const p_h, const quadprog_t* const p_qp, uint16_t k, float* const p_dst,
+                 uint16_t first, uint16_t num_rows, bool same_sign)
+{
+    const uint16_t n = p_h->n;
+    const float* a = presolve_row(p_qp, p_h->meq, n, k);
+    uint16_t j;
+
+    p_h->p_row[k] = QP_PRESOLVE_NONE;
+    p_h->p_ratio[k] = 1;
+
+    if (0 == presolve_count(p_h, a, &j))
+    {
+        p_h->info.num_empty++;
+        return num_rows;
+    }
+
+    for (uint16_t r = 0; r < num_rows; ++r)
+    {
+        float ratio;
+        if (presolve_parallel(p_h, a, presolve_row(p_qp, p_h->meq, n, p_h->p_rep[first + r]), &ratio)
+            && (!same_sign || (ratio > 0)))
+        {
+            p_h->p_row[k] = r;
+            p_h->p_ratio[k] = ratio;
+            p_h->info.num_duplicate++;
+            return num_rows;
+        }
+    }
+
+    p_h->p_row[k] = num_rows;
+    p_h->p_rep[first + num_rows] = k;
+    for (j = 0; j < n; ++j)
+    {
+        if (QP_PRESOLVE_NONE != p_h->p_col[j])
+        {
+            p_dst[num_rows*p_h->n_r + p_h->p_col[j]] = a[j];
+        }
+    }
+
+    return num_rows + 1;
+}
+
+
+// Ruiz equilibration of [Q A'; A 0], A = [Aeq; Ain_s], followed by the cost scaling
+static void
+presolve_ruiz(quadprog_presolve_t* const p_h, uint16_t ruiz_iter)
+{
+    const uint16_t n = p_h->n_r;
+    const uint16_t m = p_h->meq_r + p_h->min_s;
+    float* Q = p_h->Q.p_data;
+    float* dn = p_h->p_g;
+    float* en = p_h->p_rhs;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        p_h->p_D[j] = 1;
+    }
+    for (uint16_t r = 0; r < m; ++r)
+    {
+        p_h->p_E[r] = 1;
+    }
+    p_h->cs = 1;
+
+    if (0 == ruiz_iter)
+    {
+        return;
+    }
+
+    for (uint16_t it = 0; it < ruiz_iter; ++it)
+    {
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            dn[j] = 0;
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                dn[j] = fmaxf(dn[j], fabsf(Q[i*n + j]));
+            }
+        }
+
+        for (uint16_t r = 0; r < m; ++r)
+        {
+            float* a = (r < p_h->meq_r)? &p_h->Aeq.p_data[r*n] : &p_h->p_Ain_s[(r - p_h->meq_r)*n];
+            en[r] = 0;
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                en[r] = fmaxf(en[r], fabsf(a[j]));
+                dn[j] = fmaxf(dn[j], fabsf(a[j]));
+            }
+        }
+
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            dn[j] = 1.0f / sqrtf(presolve_clamp(dn[j]));
+            p_h->p_D[j] *= dn[j];
+        }
+        for (uint16_t r = 0; r < m; ++r)
+        {
+            en[r] = 1.0f / sqrtf(presolve_clamp(en[r]));
+            p_h->p_E[r] *= en[r];
+        }
+
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                Q[i*n + j] *= dn[i] * dn[j];
+            }
+        }
+        for (uint16_t r = 0; r < m; ++r)
+        {
+            float* a = (r < p_h->meq_r)? &p_h->Aeq.p_data[r*n] : &p_h->p_Ain_s[(r - p_h->meq_r)*n];
+            for (uint16_t j = 0; j < n; ++j)
+            {
+                a[j] *= en[r] * dn[j];
+            }
+        }
+    }
+
+    // cost scaling from Q alone, so that it does not change with c
+    float q_mean = 0;
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        float q_max = 0;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            q_max = fmaxf(q_max, fabsf(Q[i*n + j]));
+        }
+        q_mean += q_max;
+    }
+    p_h->cs = (n > 0)? 1.0f / presolve_clamp(q_mean / n) : 1.0f;
+
+    for (uint16_t i = 0; i < n*n; ++i)
+    {
+        Q[i] *= p_h->cs;
+    }
+}
+
+
+quadprog_status_t
+quadprog_presolve_init(quadprog_presolve_t* const p_h, const quadprog_t* const p_qp, uint16_t ruiz_iter,
+                       float* p_fbuf, uint16_t* p_ibuf)
+{
+    if ((NULL == p_qp->p_Q) || (NULL == p_qp->p_c))
+    {
+        return QP_BAD_DEFINED;
+    }
+
+    const uint16_t n = p_qp->p_Q->num_rows;
+    const uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+    const uint16_t min = (NULL != p_qp->p_Ain)? p_qp->p_Ain->num_rows : 0;
+
+#ifdef MATH_MATRIX_CHECK
+    if (!matf32_size_check(p_qp->p_Q, n, n) || !matf32_size_check(p_qp->p_c, n, 1))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((meq > 0) && (!matf32_size_check(p_qp->p_Aeq, meq, n) || !matf32_size_check(p_qp->p_beq, meq, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+
+    if ((min > 0) && (!matf32_size_check(p_qp->p_Ain, min, n) || !matf32_size_check(p_qp->p_bin, min, 1)))
+    {
+        return QP_SIZE_MISMATCH;
+    }
+#endif
+
+    p_h->n = n;
+    p_h->meq = meq;
+    p_h->min = min;
+
+    p_h->settings.tolerance = 1e-5f;
+    p_h->settings.drop_redundant = true;
+
+    memset(&p_h->info, 0, sizeof(quadprog_presolve_info_t));
+
+    // float storage
+    float* p_Q = p_fbuf;
+    p_fbuf += n*n;
+    float* p_Aeq = p_fbuf;
+    p_fbuf += meq*n;
+    p_h->p_Ain_s = p_fbuf;
+    p_fbuf += min*n;
+    float* p_Ain = p_fbuf;
+    p_fbuf += min*n;
+    float* p_c = p_fbuf;
+    p_fbuf += n;
+    float* p_beq = p_fbuf;
+    p_fbuf += meq;
+    float* p_bin = p_fbuf;
+    p_fbuf += min;
+    p_h->p_bin_s = p_fbuf;
+    p_fbuf += min;
+    p_h->p_D = p_fbuf;
+    p_fbuf += n;
+    p_h->p_E = p_fbuf;
+    p_fbuf += meq + min;
+    p_h->p_ratio = p_fbuf;
+    p_fbuf += meq + min;
+    p_h->p_x_fixed = p_fbuf;
+    p_fbuf += n;
+    p_h->p_lb = p_fbuf;
+    p_fbuf += n;
+    p_h->p_ub = p_fbuf;
+    p_fbuf += n;
+    p_h->p_g = p_fbuf;
+    p_fbuf += n;
+    p_h->p_rhs = p_fbuf;
+
+    // uint16_t storage
+    p_h->p_col = p_ibuf;
+    p_ibuf += n;
+    p_h->p_var_row = p_ibuf;
+    p_ibuf += n;
+    p_h->p_var = p_ibuf;
+    p_ibuf += n;
+    p_h->p_row = p_ibuf;
+    p_ibuf += meq + min;
+    p_h->p_rep = p_ibuf;
+    p_ibuf += meq + min;
+    p_h->p_arg = p_ibuf;
+    p_ibuf += min;
+    p_h->p_sel = p_ibuf;
+
+    // equality rows with a single free variable fix it, repeated since fixing a variable can leave others so
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        p_h->p_col[j] = 0;
+        p_h->p_var_row[j] = QP_PRESOLVE_NONE;
+    }
+
+    uint16_t num_fixed = 0;
+    bool is_changed = true;
+    while (is_changed)
+    {
+        is_changed = false;
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            uint16_t j;
+            if (1 == presolve_count(p_h, presolve_row(p_qp, meq, n, k), &j))
+            {
+                p_h->p_col[j] = QP_PRESOLVE_NONE;
+                p_h->p_var_row[j] = k;
+                p_h->p_var[num_fixed++] = j;
+                is_changed = true;
+            }
+        }
+    }
+
+    p_h->n_r = 0;
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        if (QP_PRESOLVE_NONE != p_h->p_col[j])
+        {
+            p_h->p_col[j] = p_h->n_r;
+            p_h->p_var[num_fixed + p_h->n_r] = j;
+            p_h->n_r++;
+        }
+    }
+    p_h->info.num_fixed = num_fixed;
+
+    const uint16_t n_r = p_h->n_r;
+
+    for (uint16_t i = 0; i < n_r; ++i)
+    {
+        for (uint16_t j = 0; j < n_r; ++j)
+        {
+            p_Q[i*n_r + j] = p_qp->p_Q->p_data[p_h->p_var[num_fixed + i]*n + p_h->p_var[num_fixed + j]];
+        }
+    }
+
+    // empty rows are removed, parallel ones merged
+    p_h->meq_r = 0;
+    for (uint16_t k = 0; k < meq; ++k)
+    {
+        p_h->meq_r = presolve_add_row(p_h, p_qp, k, p_Aeq, 0, p_h->meq_r, false);
+    }
+
+    p_h->min_s = 0;
+    for (uint16_t k = meq; k < meq + min; ++k)
+    {
+        p_h->min_s = presolve_add_row(p_h, p_qp, k, p_h->p_Ain_s, p_h->meq_r, p_h->min_s, true);
+    }
+
+    matf32_init(&p_h->Q, n_r, n_r, p_Q);
+    matf32_init(&p_h->c, n_r, 1, p_c);
+    matf32_init(&p_h->Aeq, p_h->meq_r, n_r, p_Aeq);
+    matf32_init(&p_h->beq, p_h->meq_r, 1, p_beq);
+    matf32_init(&p_h->Ain, 0, n_r, p_Ain);
+    matf32_init(&p_h->bin, 0, 1, p_bin);
+
+    presolve_ruiz(p_h, ruiz_iter);
+
+    return quadprog_presolve_update(p_h, p_qp);
+}
+
+
+quadprog_status_t
+quadprog_presolve_update(quadprog_presolve_t* const p_h, const quadprog_t* const p_qp)
+{
+    const uint16_t n = p_h->n;
+    const uint16_t meq = p_h->meq;
+    const uint16_t m = meq + p_h->min;
+    const uint16_t n_r = p_h->n_r;
+    const uint16_t meq_r = p_h->meq_r;
+    const uint16_t num_fixed = p_h->info.num_fixed;
+    const uint16_t* var = p_h->p_var;
+    const float tol = p_h->settings.tolerance;
+    float* x_fixed = p_h->p_x_fixed;
+    float* rhs = p_h->p_rhs;
+
+    // fixed variables in the order they were found, each fixing row only involves variables fixed before
+    memset(x_fixed, 0, n*sizeof(float));
+    for (uint16_t idx = 0; idx < num_fixed; ++idx)
+    {
+        uint16_t j = var[idx];
+        uint16_t k = p_h->p_var_row[j];
+        const float* a = presolve_row(p_qp, meq, n, k);
+
+        float sum = presolve_rhs(p_qp, meq, k);
+        for (uint16_t l = 0; l < n; ++l)
+        {
+            sum -= (l != j)? a[l]*x_fixed[l] : 0;
+        }
+        x_fixed[j] = sum / a[j];
+    }
+
+    for (uint16_t k = 0; k < m; ++k)
+    {
+        const float* a = presolve_row(p_qp, meq, n, k);
+
+        rhs[k] = presolve_rhs(p_qp, meq, k);
+        for (uint16_t idx = 0; idx < num_fixed; ++idx)
+        {
+            rhs[k] -= a[var[idx]] * x_fixed[var[idx]];
+        }
+    }
+
+    // removed rows (fixing rows included) and merged equalities only need to be consistent
+    for (uint16_t k = 0; k < m; ++k)
+    {
+        float b = presolve_rhs(p_qp, meq, k);
+        float s = rhs[k];
+
+        if (QP_PRESOLVE_NONE != p_h->p_row[k])
+        {
+            if ((k >= meq) || (k == p_h->p_rep[p_h->p_row[k]]))
+            {
+                continue;
+            }
+            s -= p_h->p_ratio[k] * rhs[p_h->p_rep[p_h->p_row[k]]];
+        }
+
+        if (((k < meq) && (fabsf(s) > tol*(1 + fabsf(b)))) || ((k >= meq) && (s < -tol*(1 + fabsf(b)))))
+        {
+            return QP_INFEASIBLE;
+        }
+    }
+
+    for (uint16_t r = 0; r < meq_r; ++r)
+    {
+        p_h->beq.p_data[r] = p_h->p_E[r] * rhs[p_h->p_rep[r]];
+    }
+
+    // merged inequalities keep the tightest right hand side
+    float* bin_s = p_h->p_bin_s;
+    for (uint16_t s = 0; s < p_h->min_s; ++s)
+    {
+        bin_s[s] = INFINITY;
+    }
+    for (uint16_t k = meq; k < m; ++k)
+    {
+        uint16_t s = p_h->p_row[k];
+        if ((QP_PRESOLVE_NONE != s) && (rhs[k] / p_h->p_ratio[k] < bin_s[s]))
+        {
+            bin_s[s] = rhs[k] / p_h->p_ratio[k];
+            p_h->p_arg[s] = k;
+        }
+    }
+    for (uint16_t s = 0; s < p_h->min_s; ++s)
+    {
+        bin_s[s] *= p_h->p_E[meq_r + s];
+    }
+
+    for (uint16_t j = 0; j < n_r; ++j)
+    {
+        const float* q = &p_qp->p_Q->p_data[var[num_fixed + j]*n];
+
+        float sum = p_qp->p_c->p_data[var[num_fixed + j]];
+        for (uint16_t idx = 0; idx < num_fixed; ++idx)
+        {
+            sum += q[var[idx]] * x_fixed[var[idx]];
+        }
+        p_h->c.p_data[j] = p_h->cs * p_h->p_D[j] * sum;
+    }
+
+    // bounds of the scaled variables from single variable inequalities
+    for (uint16_t j = 0; j < n_r; ++j)
+    {
+        p_h->p_lb[j] = -INFINITY;
+        p_h->p_ub[j] = INFINITY;
+    }
+    for (uint16_t s = 0; s < p_h->min_s; ++s)
+    {
+        const float* a = &p_h->p_Ain_s[s*n_r];
+        uint16_t count = 0;
+        uint16_t jj = 0;
+        for (uint16_t j = 0; j < n_r; ++j)
+        {
+            if (0 != a[j])
+            {
+                jj = j;
+                count++;
+            }
+        }
+
+        if (1 == count)
+        {
+            if (a[jj] > 0)
+            {
+                p_h->p_ub[jj] = fminf(p_h->p_ub[jj], bin_s[s] / a[jj]);
+            }
+            else
+            {
+                p_h->p_lb[jj] = fmaxf(p_h->p_lb[jj], bin_s[s] / a[jj]);
+            }
+        }
+    }
+    for (uint16_t j = 0; j < n_r; ++j)
+    {
+        if (p_h->p_lb[j] > p_h->p_ub[j] + tol*(1 + fabsf(p_h->p_ub[j])))
+        {
+            return QP_INFEASIBLE;
+        }
+    }
+
+    // inequalities that hold for every point within the bounds are dropped, those that none meets are infeasible
+    uint16_t min_r = 0;
+    p_h->info.num_redundant = 0;
+    for (uint16_t s = 0; s < p_h->min_s; ++s)
+    {
+        const float* a = &p_h->p_Ain_s[s*n_r];
+        uint16_t count = 0;
+        float act_max = 0;
+        float act_min = 0;
+        for (uint16_t j = 0; j < n_r; ++j)
+        {
+            if (0 != a[j])
+            {
+                act_max += a[j] * ((a[j] > 0)? p_h->p_ub[j] : p_h->p_lb[j]);
+                act_min += a[j] * ((a[j] > 0)? p_h->p_lb[j] : p_h->p_ub[j]);
+                count++;
+            }
+        }
+
+        if (count > 1)
+        {
+            if (act_min > bin_s[s] + tol*(1 + fabsf(bin_s[s])))
+            {
+                return QP_INFEASIBLE;
+            }
+            if (p_h->settings.drop_redundant && (act_max <= bin_s[s]))
+            {
+                p_h->info.num_redundant++;
+                continue;
+            }
+        }
+
+        memcpy(&p_h->Ain.p_data[min_r*n_r], a, n_r*sizeof(float));
+        p_h->bin.p_data[min_r] = bin_s[s];
+        p_h->p_sel[min_r] = s;
+        min_r++;
+    }
+
+    p_h->min_r = min_r;
+    matf32_init(&p_h->Ain, min_r, n_r, p_h->Ain.p_data);
+    matf32_init(&p_h->bin, min_r, 1, p_h->bin.p_data);
+
+    quadprog_init(&p_h->qp, &p_h->Q, &p_h->c, (meq_r > 0)? &p_h->Aeq : NULL, (meq_r > 0)? &p_h->beq : NULL,
+                  (min_r > 0)? &p_h->Ain : NULL, (min_r > 0)? &p_h->bin : NULL, NULL);
+
+    return QP_SUCESS;
+}
+
+
+void
+quadprog_presolve_postsolve(const quadprog_presolve_t* const p_h, const quadprog_t* const p_qp,
+                            const float* const p_x_r, const float* const p_y_r, matf32_t* const p_x,
+                            float* const p_y)
+{
+    const uint16_t n = p_h->n;
+    const uint16_t meq = p_h->meq;
+    const uint16_t m = meq + p_h->min;
+    const uint16_t num_fixed = p_h->info.num_fixed;
+    const uint16_t* var = p_h->p_var;
+    float* x = p_x->p_data;
+    float* g = p_h->p_g;
+
+    for (uint16_t idx = 0; idx < num_fixed; ++idx)
+    {
+        x[var[idx]] = p_h->p_x_fixed[var[idx]];
+    }
+    for (uint16_t j = 0; j < p_h->n_r; ++j)
+    {
+        x[var[num_fixed + j]] = p_h->p_D[j] * p_x_r[j];
+    }
+
+    if ((NULL == p_y) || (NULL == p_y_r))
+    {
+        return;
+    }
+
+    // x = D*xs, [y_eq; y_in] = E*ys/cs, a merged row takes the multiplier of its representative
+    memset(p_y, 0, m*sizeof(float));
+    for (uint16_t r = 0; r < p_h->meq_r; ++r)
+    {
+        p_y[p_h->p_rep[r]] = p_h->p_E[r] * p_y_r[r] / p_h->cs;
+    }
+    for (uint16_t i = 0; i < p_h->min_r; ++i)
+    {
+        uint16_t s = p_h->p_sel[i];
+        uint16_t k = p_h->p_arg[s];
+        p_y[k] = p_h->p_E[p_h->meq_r + s] * p_y_r[p_h->meq_r + i] / (p_h->cs * p_h->p_ratio[k]);
+    }
+
+    if (0 == num_fixed)
+    {
+        return;
+    }
+
+    // g = Qx + c + A'y over the rows kept, then the fixing rows in reverse order make g zero on their variable
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        g[i] = p_qp->p_c->p_data[i];
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            g[i] += p_qp->p_Q->p_data[i*n + j] * x[j];
+        }
+    }
+    for (uint16_t k = 0; k < m; ++k)
+    {
+        if (0 != p_y[k])
+        {
+            const float* a = presolve_row(p_qp, meq, n, k);
+            for (uint16_t i = 0; i < n; ++i)
+            {
+                g[i] += a[i] * p_y[k];
+            }
+        }
+    }
+
+    for (int16_t idx = num_fixed - 1; idx >= 0; --idx)
+    {
+        uint16_t j = var[idx];
+        uint16_t k = p_h->p_var_row[j];
+        const float* a = presolve_row(p_qp, meq, n, k);
+
+        p_y[k] = -g[j] / a[j];
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            g[i] += a[i] * p_y[k];
+        }
+    }
+}
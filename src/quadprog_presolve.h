@@ -0,0 +1,180 @@
+/**
+ * @file quadprog_presolve.h
+ *
+ * Presolve and equilibration of min 1/2 x'Qx + c'x s.t. Aeq x = beq, Ain x <= bin.
+ *
+ * quadprog_presolve_init analyzes the matrices once:
+ *  - equality rows with a single nonzero fix their variable, which is removed (repeated until none is left),
+ *  - rows without nonzeros on the remaining variables are removed (only checked for consistency),
+ *  - parallel rows are merged: duplicate equalities are checked for consistency, duplicate inequalities
+ *    with the same orientation keep the tightest right hand side (for single variable rows, the tightest bound),
+ *  - the remaining KKT matrix [Q A'; A 0] is equilibrated with Ruiz scaling, x = D xs, rows scaled by E and the
+ *    cost by cs, so the solver sees cs*D*Q*D, E*A*D.
+ *
+ * quadprog_presolve_update only recomputes the reduced vectors (c, beq, bin) for new c, beq and bin, so the
+ * scaling is computed once for a sequence of problems that share Q, Aeq and Ain. It also drops inequalities
+ * that the variable bounds (single variable rows) make redundant. The reduced problem p_h->qp is then solved with
+ * any quadprog solver and quadprog_presolve_postsolve recovers x and the multipliers of the original problem.
+ *
+ */
+
+#ifndef ROBOTAT_QUADPROG_PRESOLVE_H_
+#define ROBOTAT_QUADPROG_PRESOLVE_H_
+
+#include "quadprog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define QP_PRESOLVE_NONE        (0xFFFF)    /**< Map entry of a removed row or variable. */
+#define QP_PRESOLVE_RUIZ_ITER   (10)        /**< Default number of Ruiz equilibration passes. */
+
+/** float storage for quadprog_presolve_init. */
+#define QUADPROG_PRESOLVE_FWORK(n, meq, min)    ((n)*(n) + ((meq) + 2*(min))*(n) + 6*(n) + 4*(meq) + 5*(min))
+
+/** uint16_t storage for quadprog_presolve_init. */
+#define QUADPROG_PRESOLVE_IWORK(n, meq, min)    (3*(n) + 2*((meq) + (min)) + 2*(min))
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief Presolve settings. quadprog_presolve_init fills them with defaults, change them afterwards if needed.
+ */
+typedef struct
+{
+    float tolerance;            /** Relative tolerance of the consistency checks and of parallel rows */
+    bool drop_redundant;        /** Drop redundant inequalities in quadprog_presolve_update. Their number can then
+                                    change between updates, disable it for solvers that keep Ain factored
+                                    (quadprog_admm, quadprog_warm_t) */
+} quadprog_presolve_settings_t;
+
+
+/**
+ * @brief Presolve report.
+ */
+typedef struct
+{
+    uint16_t num_fixed;         /** Variables fixed by equality rows */
+    uint16_t num_empty;         /** Rows without nonzeros on the free variables (fixing rows included) */
+    uint16_t num_duplicate;     /** Rows merged into a parallel row */
+    uint16_t num_redundant;     /** Inequalities dropped by the last update */
+} quadprog_presolve_info_t;
+
+
+/**
+ * @brief Presolve handle. Holds the reduced and scaled problem and the maps back to the original one.
+ */
+typedef struct
+{
+    uint16_t n;                             /** Original variables */
+    uint16_t meq;                           /** Original equalities */
+    uint16_t min;                           /** Original inequalities */
+    uint16_t n_r;                           /** Free (reduced) variables */
+    uint16_t meq_r;                         /** Reduced equalities */
+    uint16_t min_s;                         /** Reduced inequalities before redundancy checks */
+    uint16_t min_r;                         /** Reduced inequalities passed to the solver */
+    float cs;                               /** Cost scaling */
+    quadprog_presolve_settings_t settings;  /** Settings */
+    quadprog_presolve_info_t info;          /** Report */
+    quadprog_t qp;                          /** Reduced and scaled problem, the one to solve */
+    matf32_t Q;                             /** n_r x n_r, cs*D*Q*D */
+    matf32_t c;                             /** n_r, cs*D*(c + Q(free, fixed)*x_fixed) */
+    matf32_t Aeq;                           /** meq_r x n_r, E*Aeq*D */
+    matf32_t beq;                           /** meq_r */
+    matf32_t Ain;                           /** min_r x n_r, E*Ain*D, the rows of Ain_s that are kept */
+    matf32_t bin;                           /** min_r */
+    float* p_Ain_s;                         /** min_s x n_r, every reduced inequality */
+    float* p_bin_s;                         /** min_s */
+    float* p_D;                             /** n_r, column scaling */
+    float* p_E;                             /** meq_r + min_s, row scaling */
+    float* p_ratio;                         /** meq + min, original row = ratio*representative row */
+    float* p_x_fixed;                       /** n, values of the fixed variables */
+    float* p_lb;                            /** n_r, scaled bounds implied by single variable rows */
+    float* p_ub;                            /** n_r */
+    float* p_g;                             /** n, work */
+    float* p_rhs;                           /** meq + min, right hand sides with the fixed variables moved over */
+    uint16_t* p_col;                        /** n, reduced index of each variable or QP_PRESOLVE_NONE */
+    uint16_t* p_var_row;                    /** n, equality row that fixes each variable or QP_PRESOLVE_NONE */
+    uint16_t* p_var;                        /** n, fixed variables in fixing order, then the free ones */
+    uint16_t* p_row;                        /** meq + min, reduced row of each row or QP_PRESOLVE_NONE */
+    uint16_t* p_rep;                        /** meq_r + min_s, original row represented by each reduced row */
+    uint16_t* p_arg;                        /** min_s, original row with the tightest right hand side */
+    uint16_t* p_sel;                        /** min_r, reduced inequality of each row of Ain */
+} quadprog_presolve_t;
+
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+
+/**
+ * @brief   Analyzes and scales the matrices of a problem, then builds the reduced problem for its vectors.
+ *
+ * @param[in, out]  p_h         Points to the presolve handle.
+ * @param[in]       p_qp        Points to the problem. Aeq/beq and Ain/bin can be NULL.
+ * @param[in]       ruiz_iter   Ruiz equilibration passes, 0 for no scaling (QP_PRESOLVE_RUIZ_ITER is a good default).
+ * @param[in]       p_fbuf      Points to storage, QUADPROG_PRESOLVE_FWORK(n, meq, min) elements.
+ * @param[in]       p_ibuf      Points to storage, QUADPROG_PRESOLVE_IWORK(n, meq, min) elements.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrices/vectors are not the correct size.
+ *              QP_BAD_DEFINED :    Q or c missing.
+ *              QP_INFEASIBLE :     Removed or merged rows are inconsistent, or a variable has crossing bounds.
+ */
+quadprog_status_t
+quadprog_presolve_init(quadprog_presolve_t* const p_h, const quadprog_t* const p_qp, uint16_t ruiz_iter,
+                       float* p_fbuf, uint16_t* p_ibuf);
+
+
+/**
+ * @brief   Rebuilds the reduced vectors after c, beq or bin changed. Q, Aeq and Ain must be the ones given to
+ * quadprog_presolve_init.
+ *
+ * @param[in, out]  p_h     Points to the presolve handle.
+ * @param[in]       p_qp    Points to the problem.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_INFEASIBLE :     Removed or merged rows are inconsistent, a variable has crossing bounds or an
+ *                                  inequality cannot be met within the bounds.
+ */
+quadprog_status_t
+quadprog_presolve_update(quadprog_presolve_t* const p_h, const quadprog_t* const p_qp);
+
+
+/**
+ * @brief   Recovers the solution and multipliers of the original problem from those of the reduced one.
+ *
+ * Multipliers follow the convention Qx + c + Aeq'y_eq + Ain'y_in = 0, y_in >= 0 (the one of quadprog_admm).
+ * Removed and merged rows get a zero multiplier, except for the rows that fix a variable, whose multipliers
+ * are recovered from the stationarity condition of that variable.
+ *
+ * @param[in]       p_h     Points to the presolve handle.
+ * @param[in]       p_qp    Points to the original problem.
+ * @param[in]       p_x_r   Points to the reduced solution, n_r elements. Can be NULL when n_r is 0.
+ * @param[in]       p_y_r   Points to the reduced multipliers [y_eq; y_in], meq_r + min_r elements. Can be NULL.
+ * @param[out]      p_x     Points to the solution, n x 1.
+ * @param[out]      p_y     Points to the multipliers [y_eq; y_in], meq + min elements. Ignored if p_y_r is NULL.
+ *
+ * @return  None.
+ */
+void
+quadprog_presolve_postsolve(const quadprog_presolve_t* const p_h, const quadprog_t* const p_qp,
+                            const float* const p_x_r, const float* const p_y_r, matf32_t* const p_x,
+                            float* const p_y);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_QUADPROG_PRESOLVE_H_
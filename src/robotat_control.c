@@ -269,6 +269,37 @@ sys_nonlin_init(sys_nonlin_t* const sys, matf32_t* const state, uint16_t input_d
 }
 
 
+// Forward difference Jacobian of fun with respect to x (or u when is_input), written column by column into the
+// row-major J. p_f0 holds fun(x, u), v is the work copy of the perturbed argument and df a work vector.
+static err_status_t
+jacobian_fd(err_status_t (*fun)(matf32_t* const, const matf32_t*, const matf32_t*), const matf32_t* x,
+	const matf32_t* u, bool is_input, float delta, const float* const p_f0, matf32_t* const J, matf32_t* const v,
+	matf32_t* const df)
+{
+	const uint16_t rows = J->num_rows;
+	const uint16_t cols = J->num_cols;
+	err_status_t status;
+
+	memcpy(v->p_data, is_input ? u->p_data : x->p_data, cols * sizeof(float));
+	for (uint16_t j = 0; j < cols; ++j)
+	{
+		const float v_j = v->p_data[j];
+		v->p_data[j] = v_j + delta;
+
+		status = is_input ? fun(df, x, v) : fun(df, v, u);
+		if (status != MATH_SUCCESS)
+			return status;
+
+		for (uint16_t i = 0; i < rows; ++i)
+			J->p_data[i*cols + j] = (df->p_data[i] - p_f0[i]) / delta;
+
+		v->p_data[j] = v_j;
+	}
+
+	return MATH_SUCCESS;
+}
+
+
 err_status_t
 linloc(sys_nonlin_t* const src_sys, sys_lti_t* const dst_sys, const matf32_t* const xss, const matf32_t* const uss, float delta)
 {
@@ -276,85 +307,36 @@ linloc(sys_nonlin_t* const src_sys, sys_lti_t* const dst_sys, const matf32_t* co
 	if ((src_sys->state_dim == dst_sys->state_dim) && (src_sys->input_dim == dst_sys->input_dim) && (src_sys->output_dim == dst_sys->output_dim));
 	else return MATH_SIZE_MISMATCH;
 
-	if (matf32_size_check(xss, src_sys->state_dim, 1) && matf32_size_check(uss, src_sys->output_dim, 1));
+	if (matf32_size_check(xss, src_sys->state_dim, 1) && matf32_size_check(uss, src_sys->input_dim, 1));
 	else return MATH_SIZE_MISMATCH;
 #endif
 
 	matf32_t* const fss = &m1;
 	matf32_t* const hss = &m2;
 	matf32_t* const dx = &m3;
-	matf32_t* const df = &m4;
-	matf32_t* const dh = &m5;
+	matf32_t* const du = &m4;
+	matf32_t* const df = &m5;
 	const uint16_t state_dim = src_sys->state_dim;
 	const uint16_t input_dim = src_sys->input_dim;
 	const uint16_t output_dim = src_sys->output_dim;
-	float xss_i; // xss[i, 1]
-	float uss_i; // uss[i, 1]
 
 	matf32_init(fss, state_dim, 1, m1data);
 	matf32_init(hss, output_dim, 1, m2data);
 	matf32_init(dx, state_dim, 1, m3data);
-	matf32_init(df, state_dim, 1, m4data);
-	matf32_init(dh, output_dim, 1, m5data);
+	matf32_init(du, input_dim, 1, m4data);
 
 	// Get the derivative and output at steady state (does not necessarily have to be an equilibrium point)
 	src_sys->dynamics(fss, xss, uss); // xdot_ss = fss = f(xss, uss) 
 	src_sys->outputs(hss, xss, uss); // yss = hss = h(xss, uss)
 
-	// Transpose the resulting LTI system's matrices to use column linear indexing
-	matf32_trans(dst_sys->A, dst_sys->A);
-	matf32_trans(dst_sys->B, dst_sys->B);
-	matf32_trans(dst_sys->C, dst_sys->C);
-	matf32_trans(dst_sys->D, dst_sys->D);
-
-	// Get the Jacobians with respect to the state vector
-	matf32_copy(xss, dx);
-	for (uint16_t i = 1; i <= state_dim; i++)
-	{
-		matf32_get(dx, i, 1, &xss_i);
-		matf32_set(dx, i, 1, xss_i + delta);
-		
-		src_sys->dynamics(df, dx, uss);
-		matf32_sub(df, df, fss);
-		matf32_scale(df, 1 / delta, df);
-		memcpy(dst_sys->A->p_data + (i - 1) * state_dim, df->p_data, state_dim * sizeof(float));
-
-		src_sys->outputs(dh, dx, uss);
-		matf32_sub(dh, dh, hss);
-		matf32_scale(dh, 1 / delta, dh);
-		memcpy(dst_sys->C->p_data + (i - 1) * output_dim, df->p_data, output_dim * sizeof(float));
-
-		matf32_set(dx, i, 1, xss_i);
-	}
-
-	// Get the Jacobians with respecto to the input vector
-	matf32_t* const du = &m3;
-	matf32_reshape(du, output_dim, 1);
-
-	matf32_copy(uss, du);
-	for (uint16_t i = 1; i <= input_dim; i++)
-	{
-		matf32_get(du, i, 1, &uss_i);
-		matf32_set(du, i, 1, uss_i + delta);
-
-		src_sys->dynamics(df, xss, du);
-		matf32_sub(df, df, fss);
-		matf32_scale(df, 1 / delta, df);
-		memcpy(dst_sys->B->p_data + (i - 1) * state_dim, df->p_data, state_dim * sizeof(float));
-
-		src_sys->outputs(dh, xss, du);
-		matf32_sub(dh, dh, hss);
-		matf32_scale(dh, 1 / delta, dh);
-		memcpy(dst_sys->D->p_data + (i - 1) * output_dim, df->p_data, output_dim * sizeof(float));
-
-		matf32_set(du, i, 1, uss_i);
-	}
+	// The Jacobians are written a column at a time with a row stride, no transposes are needed
+	matf32_init(df, state_dim, 1, m5data);
+	jacobian_fd(src_sys->dynamics, xss, uss, false, delta, m1data, dst_sys->A, dx, df); // A = df/dx
+	jacobian_fd(src_sys->dynamics, xss, uss, true, delta, m1data, dst_sys->B, du, df); // B = df/du
 
-	// Return to row linear indexing
-	matf32_trans(dst_sys->A, dst_sys->A);
-	matf32_trans(dst_sys->B, dst_sys->B);
-	matf32_trans(dst_sys->C, dst_sys->C);
-	matf32_trans(dst_sys->D, dst_sys->D);
+	matf32_init(df, output_dim, 1, m5data);
+	jacobian_fd(src_sys->outputs, xss, uss, false, delta, m2data, dst_sys->C, dx, df); // C = dh/dx
+	jacobian_fd(src_sys->outputs, xss, uss, true, delta, m2data, dst_sys->D, du, df); // D = dh/du
 
 	return MATH_SUCCESS;
 }
@@ -386,6 +368,429 @@ linear_state_feedback(matf32_t* const u, const matf32_t* K, const matf32_t* x, c
 }
 
 
+// ====================================================================================================
+// Algebraic Riccati equations and LQR
+// ====================================================================================================
+#define SDA_MAX_ITER		(50)				/**< Doubling steps, each one doubles the horizon. */
+#define SDA_TOLERANCE		(10*FLT_EPSILON)	/**< Relative change of X that stops the iteration. */
+
+
+// M = M + s*I for a square M
+static void
+sda_add_identity(matf32_t* const M, float s)
+{
+	for (uint16_t i = 0; i < M->num_rows; ++i)
+		M->p_data[i*M->num_cols + i] += s;
+}
+
+
+// G = B * R^-1 * B' for the n x dim(R) matrix B, through m4 and m5
+static err_status_t
+sda_gramian(const matf32_t* B, const matf32_t* R, matf32_t* const G)
+{
+	const uint16_t n = B->num_rows;
+	const uint16_t m = R->num_rows;
+	matf32_t* const Y = &m4;
+	matf32_t* const W = &m5;
+	uint16_t piv[MAX_VEC_SIZE];
+
+	matf32_init(Y, m, n, m4data);
+	matf32_init(W, m, m, m5data);
+	matf32_copy(R, W);
+	matf32_trans(B, Y);
+	if (matf32_lu_factor(W, piv) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+	matf32_lu_factor_solve(W, piv, Y); // R^-1 * B'
+
+	return matf32_mul(B, Y, G);
+}
+
+
+// Explicit inverse of a square matrix, through m5. A_inv can share storage with A.
+static err_status_t
+sda_inverse(const matf32_t* A, matf32_t* const A_inv)
+{
+	matf32_t* const W = &m5;
+	uint16_t piv[MAX_VEC_SIZE];
+
+	matf32_init(W, A->num_rows, A->num_rows, m5data);
+	matf32_copy(A, W);
+	if (matf32_lu_factor(W, piv) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+
+	matf32_eye(A_inv);
+	return matf32_lu_factor_solve(W, piv, A_inv);
+}
+
+
+// Structure-preserving doubling from A0 in m1, G0 in m2 and H0 in H, for the Riccati equation
+// X = A0'XA0 - A0'X(I + G0*X)^-1 G0*X*A0 + H0:
+//   A+ = A*(I + G*H)^-1*A, G+ = G + A*(I + G*H)^-1*G*A', H+ = H + A'*H*(I + G*H)^-1*A
+// H converges quadratically to the stabilizing solution.
+static err_status_t
+sda_iterate(matf32_t* const H)
+{
+	const uint16_t n = H->num_rows;
+	matf32_t* const Ak = &m1;
+	matf32_t* const G = &m2;
+	matf32_t* const Y1 = &m3;
+	matf32_t* const Y2 = &m4;
+	matf32_t* const W = &m5;
+	uint16_t piv[MAX_VEC_SIZE];
+
+	matf32_init(Y1, n, n, m3data);
+	matf32_init(Y2, n, n, m4data);
+	matf32_init(W, n, n, m5data);
+
+	for (uint16_t iter = 0; iter < SDA_MAX_ITER; ++iter)
+	{
+		// W = I + G * H, Y1 = W^-1 * A, Y2 = W^-1 * G
+		matf32_mul(G, H, W);
+		sda_add_identity(W, 1);
+		if (matf32_lu_factor(W, piv) != MATH_SUCCESS)
+			return MATH_SINGULAR;
+
+		matf32_copy(Ak, Y1);
+		matf32_copy(G, Y2);
+		matf32_lu_factor_solve(W, piv, Y1);
+		matf32_lu_factor_solve(W, piv, Y2);
+
+		// G += A * Y2 * A', W holds A'
+		matf32_trans(Ak, W);
+		const matf32_t* AY2At[] = { Ak, Y2, W };
+		matf32_arr_mul(AY2At, 3, Y2);
+		matf32_add(G, Y2, G);
+
+		// H += A' * H * Y1
+		const matf32_t* AtHY1[] = { W, H, Y1 };
+		matf32_arr_mul(AtHY1, 3, Y2);
+		matf32_add(H, Y2, H);
+
+		float delta = 0;
+		float h_max = 0;
+		for (uint16_t i = 0; i < n * n; ++i)
+		{
+			if (!isfinite(H->p_data[i]))
+				return MATH_DECOMPOSITION_FAILURE;
+			delta = fmaxf(delta, fabsf(Y2->p_data[i]));
+			h_max = fmaxf(h_max, fabsf(H->p_data[i]));
+		}
+
+		// A = A * Y1, through Y2
+		matf32_mul(Ak, Y1, Y2);
+		matf32_copy(Y2, Ak);
+
+		if (delta <= SDA_TOLERANCE * h_max)
+		{
+			// symmetric in exact arithmetic, remove the rounding
+			matf32_trans(H, Y2);
+			matf32_add(H, Y2, H);
+			matf32_scale(H, 0.5f, H);
+			return MATH_SUCCESS;
+		}
+	}
+
+	return MATH_DECOMPOSITION_FAILURE;
+}
+
+
+// SDA for X = Ak'XAk - Ak'XBk(R + Bk'XBk)^-1 Bk'XAk + Q: A0 = Ak, G0 = Bk*R^-1*Bk', H0 = Q. Ak can be stored in
+// m1 and Bk in m3, X can share storage with Q.
+static err_status_t
+dare_sda(const matf32_t* Ak, const matf32_t* Bk, const matf32_t* R, const matf32_t* Q, matf32_t* const X)
+{
+	const uint16_t n = Ak->num_rows;
+
+	matf32_init(&m2, n, n, m2data);
+	if (sda_gramian(Bk, R, &m2) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+
+	if (X->p_data != Q->p_data)
+		matf32_copy(Q, X);
+
+	if (Ak->p_data != m1data)
+	{
+		matf32_init(&m1, n, n, m1data);
+		matf32_copy(Ak, &m1);
+	}
+
+	return sda_iterate(X);
+}
+
+
+// Cayley shift for the continuous time equations, above the spectral radius of A
+static float
+sda_shift(const matf32_t* A)
+{
+	const uint16_t n = A->num_rows;
+	float a_norm = 0;
+
+	for (uint16_t i = 0; i < n; ++i)
+	{
+		float row = 0;
+		for (uint16_t j = 0; j < n; ++j)
+			row += fabsf(A->p_data[i*n + j]);
+		a_norm = fmaxf(a_norm, row);
+	}
+
+	return (a_norm > FLT_EPSILON) ? 2 * a_norm : 1;
+}
+
+
+static err_status_t
+riccati_size_check(const matf32_t* A, const matf32_t* B, const matf32_t* Q, const matf32_t* R, const matf32_t* X)
+{
+	const uint16_t n = A->num_rows;
+	const uint16_t m = B->num_cols;
+
+	if (!matf32_size_check(A, n, n) || (B->num_rows != n) || !matf32_size_check(Q, n, n)
+		|| !matf32_size_check(R, m, m) || !matf32_size_check(X, n, n))
+		return MATH_SIZE_MISMATCH;
+
+	// the iteration works on n x n copies in the static buffers
+	if ((n > MAX_VEC_SIZE) || (m > MAX_VEC_SIZE) || (n * n > MAX_MAT_SIZE))
+		return MATH_LENGTH_ERROR;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+dare(const matf32_t* A, const matf32_t* B, const matf32_t* Q, const matf32_t* R, matf32_t* const X)
+{
+	err_status_t status = riccati_size_check(A, B, Q, R, X);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	return dare_sda(A, B, R, Q, X);
+}
+
+
+err_status_t
+care(const matf32_t* A, const matf32_t* B, const matf32_t* Q, const matf32_t* R, matf32_t* const X)
+{
+	err_status_t status = riccati_size_check(A, B, Q, R, X);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	// The Cayley transform (H - g*I)^-1 (H + g*I) of the Hamiltonian maps its stable eigenvalues inside the unit
+	// circle and keeps the invariant subspace [I; X], in the SDA form with
+	//   Ag = A - g*I, W = Ag' + Q*Ag^-1*G
+	//   A0 = I + 2g*W^-T, G0 = 2g*Ag^-1*G*W^-1, H0 = 2g*W^-1*Q*Ag^-1
+	const uint16_t n = A->num_rows;
+	const float g = sda_shift(A);
+	matf32_t* const A0 = &m1;
+	matf32_t* const G = &m2;
+	matf32_t* const Wt = &m3;
+	matf32_t* const Z = &m4;
+	matf32_t* const T = &m5;
+	matf32_t* const H = X;
+
+	matf32_init(A0, n, n, m1data);
+	matf32_init(G, n, n, m2data);
+	matf32_init(Wt, n, n, m3data);
+
+	if (sda_gramian(B, R, G) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+
+	// Ag^-1 into A0
+	matf32_copy(A, Wt);
+	sda_add_identity(Wt, -g);
+	if (sda_inverse(Wt, A0) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+
+	// Z = Ag^-1 * G
+	matf32_init(Z, n, n, m4data);
+	matf32_init(T, n, n, m5data);
+	matf32_mul(A0, G, Z);
+
+	// W' = Ag + Z'*Q, nonsingular since Ag^-1*G*Ag^-T*Q has no negative eigenvalues
+	matf32_trans(Z, Wt);
+	matf32_mul(Wt, Q, T);
+	matf32_copy(A, Wt);
+	sda_add_identity(Wt, -g);
+	matf32_add(Wt, T, Wt);
+	if (sda_inverse(Wt, Wt) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+
+	// G0 = 2g * W^-T * Z'
+	matf32_trans(Z, T);
+	matf32_mul(Wt, T, G);
+	matf32_scale(G, 2 * g, G);
+
+	// H0 = 2g * W^-1 * (Q * Ag^-1), X can share storage with Q
+	matf32_mul(Q, A0, Z);
+	matf32_trans(Wt, T);
+	matf32_mul(T, Z, H);
+	matf32_scale(H, 2 * g, H);
+
+	// A0 = I + 2g * W^-T
+	matf32_scale(Wt, 2 * g, A0);
+	sda_add_identity(A0, 1);
+
+	return sda_iterate(H);
+}
+
+
+// K = (R + B'XB)^-1 * B'XA in discrete time, K = R^-1 * B'X in continuous time, through m2 to m5
+static err_status_t
+lqr_gain(const sys_lti_t* sys, const matf32_t* R, const matf32_t* X, matf32_t* const K)
+{
+	const uint16_t n = sys->state_dim;
+	const uint16_t m = sys->input_dim;
+	matf32_t* const BtXB = &m2;
+	matf32_t* const Bt = &m3;
+	matf32_t* const BtX = &m4;
+	matf32_t* const S = &m5;
+	uint16_t piv[MAX_VEC_SIZE];
+
+	matf32_init(Bt, m, n, m3data);
+	matf32_init(BtX, m, n, m4data);
+	matf32_init(S, m, m, m5data);
+
+	matf32_trans(sys->B, Bt);
+	matf32_mul(Bt, X, BtX);
+	matf32_copy(R, S);
+
+	if (sys->is_continuous)
+		matf32_copy(BtX, K);
+	else
+	{
+		matf32_init(BtXB, m, m, m2data);
+		matf32_mul(BtX, sys->B, BtXB);
+		matf32_add(S, BtXB, S);
+		matf32_mul(BtX, sys->A, K);
+	}
+
+	if (matf32_lu_factor(S, piv) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+
+	return matf32_lu_factor_solve(S, piv, K);
+}
+
+
+// Newton-Kleinman (Hewer in discrete time) step: with Acl = A - B*K, X solves the Stein equation
+// X = Acl'X*Acl + Q + K'RK, or the Lyapunov equation Acl'X + X*Acl + Q + K'RK = 0 mapped to one by a Cayley
+// transform. The Stein equation is solved with the doubling (squared Smith) iteration.
+static err_status_t
+lqr_newton(const sys_lti_t* sys, const matf32_t* Q, const matf32_t* R, const matf32_t* K, matf32_t* const X)
+{
+	const uint16_t n = sys->state_dim;
+	const uint16_t m = sys->input_dim;
+	matf32_t* const Acl = &m1;
+	matf32_t* const T = &m2;
+	matf32_t* const Ad = &m3;
+	matf32_t* const X0 = X;
+
+	matf32_init(Acl, n, n, m1data);
+	matf32_init(Ad, n, n, m3data);
+
+	// Acl = A - B*K
+	matf32_mul(sys->B, K, Acl);
+	matf32_sub(sys->A, Acl, Acl);
+
+	// X0 = Q + K'RK
+	matf32_init(T, n, m, m2data);
+	matf32_trans(K, T);
+	const matf32_t* KtRK[] = { T, R, K };
+	matf32_arr_mul(KtRK, 3, X0);
+	matf32_add(Q, X0, X0);
+
+	matf32_init(T, n, n, m2data);
+	if (sys->is_continuous)
+	{
+		// Ad = (Acl - g*I)^-1 (Acl + g*I), Qd = 2g * (Acl - g*I)^-T Qc (Acl - g*I)^-1
+		const float g = sda_shift(sys->A);
+		matf32_copy(Acl, Ad);
+		sda_add_identity(Ad, -g);
+		if (sda_inverse(Ad, T) != MATH_SUCCESS)
+			return MATH_SINGULAR;
+
+		matf32_trans(T, Ad);
+		const matf32_t* TtX0T[] = { Ad, X0, T };
+		matf32_arr_mul(TtX0T, 3, X0);
+		matf32_scale(X0, 2 * g, X0);
+
+		sda_add_identity(Acl, g);
+		matf32_mul(T, Acl, Ad);
+		matf32_copy(Ad, Acl);
+	}
+
+	// X = sum_k (Acl^k)' X0 Acl^k, doubling the number of terms each step: X += Ak'X*Ak, Ak = Ak*Ak
+	for (uint16_t iter = 0; iter < SDA_MAX_ITER; ++iter)
+	{
+		matf32_trans(Acl, T);
+		const matf32_t* AtXA[] = { T, X0, Acl };
+		matf32_arr_mul(AtXA, 3, Ad);
+		matf32_add(X0, Ad, X0);
+
+		float delta = 0;
+		float x_max = 0;
+		for (uint16_t i = 0; i < n * n; ++i)
+		{
+			if (!isfinite(X0->p_data[i]))
+				return MATH_DECOMPOSITION_FAILURE;
+			delta = fmaxf(delta, fabsf(Ad->p_data[i]));
+			x_max = fmaxf(x_max, fabsf(X0->p_data[i]));
+		}
+
+		matf32_mul(Acl, Acl, T);
+		matf32_copy(T, Acl);
+
+		if (delta <= SDA_TOLERANCE * x_max)
+			return MATH_SUCCESS;
+	}
+
+	return MATH_DECOMPOSITION_FAILURE;
+}
+
+
+// Riccati solution, optional Newton refinement and gain shared by lqr and dlqr
+static err_status_t
+lqr_synthesis(const sys_lti_t* sys, const matf32_t* Q, const matf32_t* R, matf32_t* const K, matf32_t* const X,
+	uint16_t newton_steps)
+{
+	if (!matf32_size_check(K, sys->input_dim, sys->state_dim))
+		return MATH_SIZE_MISMATCH;
+
+	err_status_t status = sys->is_continuous ? care(sys->A, sys->B, Q, R, X) : dare(sys->A, sys->B, Q, R, X);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	status = lqr_gain(sys, R, X, K);
+	for (uint16_t k = 0; (k < newton_steps) && (status == MATH_SUCCESS); ++k)
+	{
+		status = lqr_newton(sys, Q, R, K, X);
+		if (status == MATH_SUCCESS)
+			status = lqr_gain(sys, R, X, K);
+	}
+
+	return status;
+}
+
+
+err_status_t
+lqr(const sys_lti_t* sys, const matf32_t* Q, const matf32_t* R, matf32_t* const K, matf32_t* const X,
+	uint16_t newton_steps)
+{
+	if (!sys->is_continuous)
+		return MATH_ARGUMENT_ERROR;
+
+	return lqr_synthesis(sys, Q, R, K, X, newton_steps);
+}
+
+
+err_status_t
+dlqr(const sys_lti_t* sys, const matf32_t* Q, const matf32_t* R, matf32_t* const K, matf32_t* const X,
+	uint16_t newton_steps)
+{
+	if (sys->is_continuous)
+		return MATH_ARGUMENT_ERROR;
+
+	return lqr_synthesis(sys, Q, R, K, X, newton_steps);
+}
+
+
 // ====================================================================================================
 // Linear time-varying, discrete time Kalman filter
 // ====================================================================================================
@@ -409,6 +814,22 @@ kalman_init(kalman_info_t* const kf, sys_lti_t* const sys, matf32_t* F, matf32_t
 	kf->xhat = xhat;
 	kf->P = P;
 
+	kf->L = NULL;
+	kf->is_steady = false;
+	kf->steady_tol = 0;
+	kf->trace_P = 0;
+
+	// Uncorrelated measurement noise allows processing the measurements one at a time
+	kf->is_sequential = true;
+	for (uint16_t i = 0; i < Qv->num_rows; ++i)
+	{
+		for (uint16_t j = 0; j < Qv->num_cols; ++j)
+		{
+			if ((i != j) && (Qv->p_data[i*Qv->num_cols + j] != 0))
+				kf->is_sequential = false;
+		}
+	}
+
 	return MATH_SUCCESS;
 }
 
@@ -436,6 +857,10 @@ kalman_predict(kalman_info_t* const kf, const matf32_t* inputs)
 	matf32_mul(kf->sys->A, kf->xhat, Ax); // A[k] * xhat[k-1|k-1]
 	matf32_mul(kf->sys->B, inputs, Bu); // B[k] * u[k]
 	matf32_add(Ax, Bu, kf->xhat); // xhat[k|k-1] = A[k] * xhat[k-1|k-1] + B[k] * u[k] 
+
+	// The covariance does not change anymore in steady state
+	if (kf->is_steady)
+		return MATH_SUCCESS;
 	
 	// Update the covariance matrix using the dynamics and process noise covariance
 	matf32_t* const At = &m1;
@@ -460,13 +885,61 @@ kalman_predict(kalman_info_t* const kf, const matf32_t* inputs)
 }
 
 
-err_status_t
-kalman_correct(kalman_info_t* const kf, const matf32_t* measurements)
+// Scalar update per measurement, valid when Qv is diagonal. P stays symmetric since every update is h*h'/s.
+// s of a row depends on the updates of the previous ones, so xhat and P are saved first and restored on failure.
+static err_status_t
+kalman_correct_sequential(kalman_info_t* const kf, const matf32_t* measurements)
 {
-	// Check if the measurements vector has the correct size
-	if ((measurements->num_rows != kf->sys->output_dim) || (measurements->num_cols != 1))
-		return MATH_SIZE_MISMATCH;
+	const uint16_t n = kf->sys->state_dim;
+	const uint16_t dim_y = kf->sys->output_dim;
+	float* const P = kf->P->p_data;
+	float* const h = m1data;
+
+	memcpy(m2data, kf->xhat->p_data, n*sizeof(float));
+	memcpy(m3data, P, n*n*sizeof(float));
+
+	for (uint16_t r = 0; r < dim_y; ++r)
+	{
+		const float* c = &kf->sys->C->p_data[r*n];
+
+		// h = P[k] * c', s = c * h + Qv(r, r), e = y(r) - c * xhat
+		float s = kf->Qv->p_data[r*dim_y + r];
+		float e = measurements->p_data[r];
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			float sum = 0;
+			for (uint16_t j = 0; j < n; ++j)
+				sum += P[i*n + j] * c[j];
+			h[i] = sum;
+			e -= c[i] * kf->xhat->p_data[i];
+		}
+		for (uint16_t i = 0; i < n; ++i)
+			s += c[i] * h[i];
+
+		if (s <= 0)
+		{
+			memcpy(kf->xhat->p_data, m2data, n*sizeof(float));
+			memcpy(P, m3data, n*n*sizeof(float));
+			return MATH_SINGULAR;
+		}
+
+		// xhat += h * e / s, P -= h * h' / s
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			kf->xhat->p_data[i] += h[i] * e / s;
+			for (uint16_t j = 0; j < n; ++j)
+				P[i*n + j] -= h[i] * h[j] / s;
+		}
+	}
+
+	return MATH_SUCCESS;
+}
 
+
+// Measurement update with the gain L[k] = P[k|k-1] * C[k]' * S[k]^-1
+static err_status_t
+kalman_correct_full(kalman_info_t* const kf, const matf32_t* measurements)
+{
 	// State, input, output and noise dimensions
 	const float dim_xhat = kf->sys->state_dim;
 	const float dim_u = kf->sys->input_dim;
@@ -531,6 +1004,982 @@ kalman_correct(kalman_info_t* const kf, const matf32_t* measurements)
 }
 
 
+err_status_t
+kalman_correct(kalman_info_t* const kf, const matf32_t* measurements)
+{
+	// Check if the measurements vector has the correct size
+	if ((measurements->num_rows != kf->sys->output_dim) || (measurements->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t n = kf->sys->state_dim;
+	const uint16_t dim_y = kf->sys->output_dim;
+
+	// x[k|k] = xhat[k|k-1] + L * (y[k] - C[k] * xhat[k|k-1])
+	if (kf->is_steady)
+	{
+		float* const e = m1data;
+		for (uint16_t r = 0; r < dim_y; ++r)
+		{
+			e[r] = measurements->p_data[r];
+			for (uint16_t j = 0; j < n; ++j)
+				e[r] -= kf->sys->C->p_data[r*n + j] * kf->xhat->p_data[j];
+		}
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			for (uint16_t r = 0; r < dim_y; ++r)
+				kf->xhat->p_data[i] += kf->L->p_data[i*dim_y + r] * e[r];
+		}
+		return MATH_SUCCESS;
+	}
+
+	err_status_t status = kf->is_sequential ? kalman_correct_sequential(kf, measurements)
+		: kalman_correct_full(kf, measurements);
+
+	if ((status != MATH_SUCCESS) || (kf->L == NULL) || (kf->steady_tol <= 0))
+		return status;
+
+	// Switch to the steady state once trace(P) stops changing
+	float trace = 0;
+	for (uint16_t i = 0; i < n; ++i)
+		trace += kf->P->p_data[i*n + i];
+
+	bool is_settled = (fabsf(trace - kf->trace_P) <= kf->steady_tol * trace);
+	kf->trace_P = trace;
+
+	return is_settled ? kalman_steady_state(kf, kf->L, 0) : MATH_SUCCESS;
+}
+
+
+err_status_t
+kalman_steady_state(kalman_info_t* const kf, matf32_t* const L, float steady_tol)
+{
+	const uint16_t n = kf->sys->state_dim;
+	const uint16_t dim_y = kf->sys->output_dim;
+	const uint16_t dim_w = kf->F->num_cols;
+
+	if (!matf32_size_check(L, n, dim_y))
+		return MATH_SIZE_MISMATCH;
+
+	if ((n > MAX_VEC_SIZE) || (dim_y > MAX_VEC_SIZE) || (n * n > MAX_MAT_SIZE))
+		return MATH_LENGTH_ERROR;
+
+	kf->L = L;
+	kf->steady_tol = steady_tol;
+	kf->trace_P = 0;
+	if (steady_tol > 0)
+		return MATH_SUCCESS;
+
+	// G = F * Qw * F' into P, it is the constant term of the filter DARE
+	matf32_t* const Ft = &m1;
+	matf32_init(Ft, dim_w, n, m1data);
+	matf32_trans(kf->F, Ft);
+	const matf32_t* FQwFt[] = { kf->F, kf->Qw, Ft };
+	matf32_arr_mul(FQwFt, 3, kf->P);
+
+	// P = A*P*A' - A*P*C'*(C*P*C' + Qv)^-1*C*P*A' + F*Qw*F', the dual of the control DARE with (A', C')
+	matf32_t* const At = &m1;
+	matf32_t* const Ct = &m3;
+	matf32_init(At, n, n, m1data);
+	matf32_init(Ct, n, dim_y, m3data);
+	matf32_trans(kf->sys->A, At);
+	matf32_trans(kf->sys->C, Ct);
+	err_status_t status = dare_sda(At, Ct, kf->Qv, kf->P, kf->P);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	// L = P*C'*S^-1, from S*L' = C*P with S = C*P*C' + Qv
+	matf32_t* const CP = &m2;
+	matf32_t* const S = &m4;
+	uint16_t piv[MAX_VEC_SIZE];
+	matf32_init(Ct, n, dim_y, m3data);
+	matf32_init(CP, dim_y, n, m2data);
+	matf32_init(S, dim_y, dim_y, m4data);
+	matf32_trans(kf->sys->C, Ct);
+	matf32_mul(kf->sys->C, kf->P, CP);
+	matf32_mul(CP, Ct, S);
+	matf32_add(S, kf->Qv, S);
+	if (matf32_lu_factor(S, piv) != MATH_SUCCESS)
+		return MATH_SINGULAR;
+	matf32_lu_factor_solve(S, piv, CP);
+	matf32_trans(CP, L);
+
+	kf->is_steady = true;
+
+	return MATH_SUCCESS;
+}
+
+
+
+// ====================================================================================================
+// Kalman filter with packed symmetric covariances
+// ====================================================================================================
+err_status_t
+kalman_sym_init(kalman_sym_info_t* const kf, sys_lti_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+	matf32_t* const xhat, matf32_sym_t* const P)
+{
+	if ((sys->A->num_rows != P->num_rows) || (F->num_rows != P->num_rows) || (F->num_cols != Qw->num_rows)
+		|| (Qv->num_rows != sys->output_dim) || (xhat->num_rows != P->num_rows))
+		return MATH_SIZE_MISMATCH;
+
+	// Check if the dynamics are discrete-time
+	if (sys->is_continuous)
+		return MATH_ARGUMENT_ERROR;
+
+	kf->sys = sys;
+	kf->F = F;
+	kf->Qw = Qw;
+	kf->Qv = Qv;
+	kf->xhat = xhat;
+	kf->P = P;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+kalman_sym_predict(kalman_sym_info_t* const kf, const matf32_t* inputs)
+{
+	// Check if the inputs vector has the correct size
+	if ((inputs->num_rows != kf->sys->input_dim) || (inputs->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t dim_xhat = kf->sys->state_dim;
+
+	// Use the dynamics to get the a-priori estimate
+	matf32_t* const Ax = &m1;
+	matf32_t* const Bu = &m2;
+	matf32_init(Ax, dim_xhat, 1, m1data); // Ax: dim(xhat) x 1
+	matf32_init(Bu, dim_xhat, 1, m2data); // Bu: dim(xhat) x 1
+
+	matf32_mul(kf->sys->A, kf->xhat, Ax); // A[k] * xhat[k-1|k-1]
+	matf32_mul(kf->sys->B, inputs, Bu); // B[k] * u[k]
+	matf32_add(Ax, Bu, kf->xhat); // xhat[k|k-1] = A[k] * xhat[k-1|k-1] + B[k] * u[k]
+
+	// P[k|k-1] = A[k] * P[k-1|k-1] * A[k]' + F[k] * Qw[k-1] * F[k]', upper triangles only
+	matf32_sym_t Pkk1;
+	matf32_sym_init(&Pkk1, dim_xhat, m4data);
+
+	matf32_sym_congruence(kf->sys->A, kf->P, 0, &Pkk1, m1data);
+	matf32_sym_congruence(kf->F, kf->Qw, 1, &Pkk1, m1data);
+	matf32_sym_copy(&Pkk1, kf->P);
+
+	return MATH_SUCCESS;
+}
+
+
+// Update with the innovation covariance S packed in m4, the cross covariance W = Cov(y, x) in m1 (dim(y) x
+// dim(xhat)) and the innovation e (overwritten, not in m1 or m4). The gain W' * S^-1 is never formed.
+static err_status_t
+sym_gain_update(matf32_sym_t* const P, uint16_t dim_y, matf32_t* const xhat, matf32_t* const e)
+{
+	const uint16_t dim_xhat = P->num_rows;
+	matf32_sym_t S;
+	matf32_sym_init(&S, dim_y, m4data);
+
+	// S[k] = U'U
+	err_status_t status = matf32_sym_cholesky(&S);
+
+	if (status != MATH_SUCCESS)
+		return status;
+
+	// V = U'^-1 * W: dim(y) x dim(xhat)
+	matf32_t* const V = &m1;
+	matf32_init(V, dim_y, dim_xhat, m1data);
+	matf32_sym_cholesky_fwdsub(&S, V);
+
+	// z = U'^-1 * e: dim(y) x 1
+	matf32_sym_cholesky_fwdsub(&S, e);
+
+	// x[k|k] = xhat[k|k-1] + V' * z, since L[k] = W' * S[k]^-1 = V' * U^-1
+	for (uint16_t i = 0; i < dim_xhat; ++i)
+	{
+		float sum = 0;
+		for (uint16_t r = 0; r < dim_y; ++r)
+			sum += m1data[r*dim_xhat + i] * e->p_data[r];
+		xhat->p_data[i] += sum;
+	}
+
+	// P[k|k] = P[k|k-1] - W' * S[k]^-1 * W = P[k|k-1] - V' * V
+	matf32_sym_rank_update(V, -1, P);
+
+	return MATH_SUCCESS;
+}
+
+
+// Measurement update with the innovation e (overwritten, not in m1 or m4), shared by kalman_sym_correct and
+// ekf_correct
+static err_status_t
+sym_measurement_update(matf32_sym_t* const P, const matf32_t* C, const matf32_sym_t* Qv, matf32_t* const xhat,
+	matf32_t* const e)
+{
+	const uint16_t dim_y = C->num_rows;
+
+	// S[k] = C[k] * P[k|k-1] * C[k]' + Qv[k], the congruence leaves W = C[k] * P[k|k-1] in m1
+	matf32_sym_t S;
+	matf32_sym_init(&S, dim_y, m4data);
+	matf32_sym_copy(Qv, &S);
+	matf32_sym_congruence(C, P, 1, &S, m1data);
+
+	return sym_gain_update(P, dim_y, xhat, e);
+}
+
+
+err_status_t
+kalman_sym_correct(kalman_sym_info_t* const kf, const matf32_t* measurements)
+{
+	// Check if the measurements vector has the correct size
+	if ((measurements->num_rows != kf->sys->output_dim) || (measurements->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	// e = y[k] - C[k] * xhat[k|k-1]: dim(y) x 1
+	matf32_t* const e = &m2;
+	matf32_init(e, kf->sys->output_dim, 1, m2data);
+	matf32_mul(kf->sys->C, kf->xhat, e);
+	matf32_sub(measurements, e, e);
+
+	return sym_measurement_update(kf->P, kf->sys->C, kf->Qv, kf->xhat, e);
+}
+
+
+
+
+// ====================================================================================================
+// Square-root Kalman filter
+// ====================================================================================================
+
+// Householder triangularization of a rows x cols (rows >= cols) row-major array in place, only R is kept.
+// Rows of R are sign flipped to leave a nonnegative diagonal, which does not change R'R.
+static void
+sqrt_triangularize(float* const p_m, uint16_t rows, uint16_t cols)
+{
+	for (uint16_t j = 0; j < cols; ++j)
+	{
+		float norm = 0;
+		for (uint16_t i = j; i < rows; ++i)
+			norm += p_m[i*cols + j] * p_m[i*cols + j];
+		norm = sqrtf(norm);
+
+		if (norm > 0)
+		{
+			// v = m(j:, j) - alpha*e1, stored over the column, H = I - v*v'/(v'v/2)
+			float alpha = (p_m[j*cols + j] > 0) ? -norm : norm;
+			p_m[j*cols + j] -= alpha;
+			float vtv_2 = -alpha * p_m[j*cols + j];
+
+			for (uint16_t k = j + 1; k < cols; ++k)
+			{
+				float dot = 0;
+				for (uint16_t i = j; i < rows; ++i)
+					dot += p_m[i*cols + j] * p_m[i*cols + k];
+				dot /= vtv_2;
+				for (uint16_t i = j; i < rows; ++i)
+					p_m[i*cols + k] -= dot * p_m[i*cols + j];
+			}
+			p_m[j*cols + j] = alpha;
+		}
+
+		for (uint16_t i = j + 1; i < rows; ++i)
+			p_m[i*cols + j] = 0;
+
+		if (p_m[j*cols + j] < 0)
+		{
+			for (uint16_t k = j; k < cols; ++k)
+				p_m[j*cols + k] = -p_m[j*cols + k];
+		}
+	}
+}
+
+
+// Upper triangle of the square block at (offset, offset) of a row-major array with stride cols, packed
+static void
+sqrt_pack(const float* const p_m, uint16_t cols, uint16_t offset, matf32_sym_t* const p_dst)
+{
+	for (uint16_t j = 0; j < p_dst->num_rows; ++j)
+	{
+		for (uint16_t i = 0; i <= j; ++i)
+			p_dst->p_data[matf32_sym_idx(i, j)] = p_m[(offset + i)*cols + offset + j];
+	}
+}
+
+
+// Block of p_m (stride cols) at (row0, col0) = S * X', S packed upper k x k and X dense r x k
+static void
+sqrt_mul_trans(const matf32_sym_t* const p_s, const matf32_t* const p_x, float* const p_m, uint16_t cols,
+	uint16_t row0, uint16_t col0)
+{
+	const uint16_t k = p_s->num_rows;
+
+	for (uint16_t i = 0; i < k; ++i)
+	{
+		for (uint16_t r = 0; r < p_x->num_rows; ++r)
+		{
+			float sum = 0;
+			for (uint16_t j = i; j < k; ++j)
+				sum += p_s->p_data[matf32_sym_idx(i, j)] * p_x->p_data[r*k + j];
+			p_m[(row0 + i)*cols + col0 + r] = sum;
+		}
+	}
+}
+
+
+err_status_t
+kalman_sqrt_init(kalman_sqrt_info_t* const kf, sys_lti_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+	matf32_t* const xhat, matf32_sym_t* const P)
+{
+	const uint16_t n = P->num_rows;
+
+	if ((sys->A->num_rows != n) || (F->num_rows != n) || (F->num_cols != Qw->num_rows)
+		|| (Qv->num_rows != sys->output_dim) || (xhat->num_rows != n))
+		return MATH_SIZE_MISMATCH;
+
+	// Pre-arrays of both updates must fit in the static work matrices
+	if (((n + Qw->num_rows) * n > MAX_MAT_SIZE) || ((n + Qv->num_rows) * (n + Qv->num_rows) > MAX_MAT_SIZE))
+		return MATH_SIZE_MISMATCH;
+
+	// Check if the dynamics are discrete-time
+	if (sys->is_continuous)
+		return MATH_ARGUMENT_ERROR;
+
+	if ((matf32_sym_cholesky(Qw) != MATH_SUCCESS) || (matf32_sym_cholesky(Qv) != MATH_SUCCESS)
+		|| (matf32_sym_cholesky(P) != MATH_SUCCESS))
+		return MATH_DECOMPOSITION_FAILURE;
+
+	kf->sys = sys;
+	kf->F = F;
+	kf->Sw = Qw;
+	kf->Sv = Qv;
+	kf->xhat = xhat;
+	kf->U = P;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+kalman_sqrt_predict(kalman_sqrt_info_t* const kf, const matf32_t* inputs)
+{
+	// Check if the inputs vector has the correct size
+	if ((inputs->num_rows != kf->sys->input_dim) || (inputs->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t dim_xhat = kf->sys->state_dim;
+	const uint16_t dim_w = kf->Sw->num_rows;
+
+	// Use the dynamics to get the a-priori estimate
+	matf32_t* const Ax = &m1;
+	matf32_t* const Bu = &m2;
+	matf32_init(Ax, dim_xhat, 1, m1data); // Ax: dim(xhat) x 1
+	matf32_init(Bu, dim_xhat, 1, m2data); // Bu: dim(xhat) x 1
+
+	matf32_mul(kf->sys->A, kf->xhat, Ax); // A[k] * xhat[k-1|k-1]
+	matf32_mul(kf->sys->B, inputs, Bu); // B[k] * u[k]
+	matf32_add(Ax, Bu, kf->xhat); // xhat[k|k-1] = A[k] * xhat[k-1|k-1] + B[k] * u[k]
+
+	// [U * A[k]'; Sw * F[k]']: (dim(xhat) + dim(w)) x dim(xhat), its R factor is the factor of P[k|k-1]
+	sqrt_mul_trans(kf->U, kf->sys->A, m1data, dim_xhat, 0, 0);
+	sqrt_mul_trans(kf->Sw, kf->F, m1data, dim_xhat, dim_xhat, 0);
+	sqrt_triangularize(m1data, dim_xhat + dim_w, dim_xhat);
+	sqrt_pack(m1data, dim_xhat, 0, kf->U);
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+kalman_sqrt_correct(kalman_sqrt_info_t* const kf, const matf32_t* measurements)
+{
+	// Check if the measurements vector has the correct size
+	if ((measurements->num_rows != kf->sys->output_dim) || (measurements->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t dim_xhat = kf->sys->state_dim;
+	const uint16_t dim_y = kf->sys->output_dim;
+	const uint16_t dim = dim_y + dim_xhat;
+
+	// [Sv 0; U * C[k]' U]: dim(y) + dim(xhat) square
+	memset(m1data, 0, dim * dim * sizeof(float));
+	for (uint16_t j = 0; j < dim_y; ++j)
+	{
+		for (uint16_t i = 0; i <= j; ++i)
+			m1data[i*dim + j] = kf->Sv->p_data[matf32_sym_idx(i, j)];
+	}
+	sqrt_mul_trans(kf->U, kf->sys->C, m1data, dim, dim_y, 0);
+	for (uint16_t j = 0; j < dim_xhat; ++j)
+	{
+		for (uint16_t i = 0; i <= j; ++i)
+			m1data[(dim_y + i)*dim + dim_y + j] = kf->U->p_data[matf32_sym_idx(i, j)];
+	}
+
+	// [R11 R12; 0 R22]: R11'R11 = S[k], R11'R12 = C[k] * P[k|k-1], R22'R22 = P[k|k]
+	sqrt_triangularize(m1data, dim, dim);
+
+	matf32_sym_t R11;
+	matf32_sym_init(&R11, dim_y, m4data);
+	sqrt_pack(m1data, dim, 0, &R11);
+	sqrt_pack(m1data, dim, dim_y, kf->U);
+
+	// z = R11'^-1 * (y[k] - C[k] * xhat[k|k-1]): dim(y) x 1
+	matf32_t* const z = &m2;
+	matf32_init(z, dim_y, 1, m2data);
+	matf32_mul(kf->sys->C, kf->xhat, z);
+	matf32_sub(measurements, z, z);
+	matf32_sym_cholesky_fwdsub(&R11, z);
+
+	// x[k|k] = xhat[k|k-1] + R12' * z, since L[k] = P[k|k-1] * C[k]' * S[k]^-1 = R12' * R11'^-1
+	for (uint16_t i = 0; i < dim_xhat; ++i)
+	{
+		float sum = 0;
+		for (uint16_t r = 0; r < dim_y; ++r)
+			sum += m1data[r*dim + dim_y + i] * m2data[r];
+		kf->xhat->p_data[i] += sum;
+	}
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+kalman_sqrt_get_covariance(const kalman_sqrt_info_t* const kf, matf32_sym_t* const P)
+{
+	const uint16_t n = kf->U->num_rows;
+
+	if (P->num_rows != n)
+		return MATH_SIZE_MISMATCH;
+
+	// P(i, j) = sum over k <= min(i, j) of U(k, i) * U(k, j)
+	for (uint16_t j = 0; j < n; ++j)
+	{
+		for (uint16_t i = 0; i <= j; ++i)
+		{
+			float sum = 0;
+			for (uint16_t k = 0; k <= i; ++k)
+				sum += kf->U->p_data[matf32_sym_idx(k, i)] * kf->U->p_data[matf32_sym_idx(k, j)];
+			P->p_data[matf32_sym_idx(i, j)] = sum;
+		}
+	}
+
+	return MATH_SUCCESS;
+}
+
+
+
+// ====================================================================================================
+// Extended Kalman filter
+// ====================================================================================================
+err_status_t
+ekf_init(ekf_info_t* const kf, sys_nonlin_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+	matf32_t* const xhat, matf32_sym_t* const P, matf32_t* const A, matf32_t* const C)
+{
+	const uint16_t n = sys->state_dim;
+
+	if ((P->num_rows != n) || (xhat->num_rows != n) || (F->num_rows != n) || (F->num_cols != Qw->num_rows)
+		|| (Qv->num_rows != sys->output_dim) || !matf32_size_check(A, n, n) || !matf32_size_check(C, sys->output_dim, n))
+		return MATH_SIZE_MISMATCH;
+
+	// The linearization points are kept in the data structure
+	if ((n > MAX_VEC_SIZE) || (sys->output_dim > MAX_VEC_SIZE) || (sys->input_dim > MAX_VEC_SIZE))
+		return MATH_LENGTH_ERROR;
+
+	// Check if the dynamics are discrete-time
+	if (sys->is_continuous)
+		return MATH_ARGUMENT_ERROR;
+
+	kf->sys = sys;
+	kf->F = F;
+	kf->Qw = Qw;
+	kf->Qv = Qv;
+	kf->xhat = xhat;
+	kf->P = P;
+	kf->A = A;
+	kf->C = C;
+	kf->jac_dynamics = NULL;
+	kf->jac_outputs = NULL;
+	kf->delta = EKF_FD_DELTA;
+	kf->relin_tol = 0;
+	kf->inputs = NULL;
+	kf->is_A_valid = false;
+	kf->is_C_valid = false;
+	kf->jacobian_evals = 0;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+ekf_set_jacobians(ekf_info_t* const kf,
+	err_status_t (*jac_dynamics)(matf32_t* const, const matf32_t*, const matf32_t*),
+	err_status_t (*jac_outputs)(matf32_t* const, const matf32_t*, const matf32_t*))
+{
+	kf->jac_dynamics = jac_dynamics;
+	kf->jac_outputs = jac_outputs;
+	kf->is_A_valid = false;
+	kf->is_C_valid = false;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+ekf_set_relinearization(ekf_info_t* const kf, float delta, float relin_tol)
+{
+	if ((delta <= 0) || (relin_tol < 0))
+		return MATH_ARGUMENT_ERROR;
+
+	kf->delta = delta;
+	kf->relin_tol = relin_tol;
+	kf->is_A_valid = false;
+	kf->is_C_valid = false;
+
+	return MATH_SUCCESS;
+}
+
+
+// true when the estimate moved less than relin_tol (infinity norm) from the point of the last Jacobian
+static bool
+ekf_is_near(const ekf_info_t* const kf, const float* const p_x_lin)
+{
+	for (uint16_t i = 0; i < kf->sys->state_dim; ++i)
+	{
+		if (fabsf(kf->xhat->p_data[i] - p_x_lin[i]) > kf->relin_tol)
+			return false;
+	}
+
+	return true;
+}
+
+
+err_status_t
+ekf_predict(ekf_info_t* const kf, const matf32_t* inputs)
+{
+	// Check if the inputs vector has the correct size
+	if ((inputs->num_rows != kf->sys->input_dim) || (inputs->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t dim_xhat = kf->sys->state_dim;
+	err_status_t status;
+	kf->inputs = inputs;
+
+	// xhat[k|k-1] = f(xhat[k-1|k-1], u[k]), kept in m2 until the Jacobian is done
+	matf32_t* const fx = &m2;
+	matf32_init(fx, dim_xhat, 1, m2data);
+	status = kf->sys->dynamics(fx, kf->xhat, inputs);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	// A[k] = df/dx at xhat[k-1|k-1], reused while the estimate stays close to its linearization point
+	if (!kf->is_A_valid || !ekf_is_near(kf, kf->x_A))
+	{
+		if (kf->jac_dynamics != NULL)
+		{
+			status = kf->jac_dynamics(kf->A, kf->xhat, inputs);
+		}
+		else
+		{
+			matf32_init(&m3, dim_xhat, 1, m3data);
+			matf32_init(&m5, dim_xhat, 1, m5data);
+			status = jacobian_fd(kf->sys->dynamics, kf->xhat, inputs, false, kf->delta, m2data, kf->A, &m3, &m5);
+		}
+		if (status != MATH_SUCCESS)
+			return status;
+
+		memcpy(kf->x_A, kf->xhat->p_data, dim_xhat * sizeof(float));
+		kf->is_A_valid = true;
+		kf->jacobian_evals++;
+	}
+
+	memcpy(kf->xhat->p_data, m2data, dim_xhat * sizeof(float));
+
+	// P[k|k-1] = A[k] * P[k-1|k-1] * A[k]' + F[k] * Qw[k-1] * F[k]', upper triangles only
+	matf32_sym_t Pkk1;
+	matf32_sym_init(&Pkk1, dim_xhat, m4data);
+
+	matf32_sym_congruence(kf->A, kf->P, 0, &Pkk1, m1data);
+	matf32_sym_congruence(kf->F, kf->Qw, 1, &Pkk1, m1data);
+	matf32_sym_copy(&Pkk1, kf->P);
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+ekf_correct(ekf_info_t* const kf, const matf32_t* measurements)
+{
+	// Check if the measurements vector has the correct size
+	if ((measurements->num_rows != kf->sys->output_dim) || (measurements->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t dim_xhat = kf->sys->state_dim;
+	const uint16_t dim_y = kf->sys->output_dim;
+	err_status_t status;
+
+	// Without a previous prediction the outputs are evaluated with a zero input
+	matf32_t zero_input;
+	const matf32_t* inputs = kf->inputs;
+	if (inputs == NULL)
+	{
+		matf32_init(&zero_input, kf->sys->input_dim, 1, m3data);
+		matf32_zeros(&zero_input);
+		inputs = &zero_input;
+	}
+
+	// yhat = h(xhat[k|k-1], u[k]) in m2
+	matf32_t* const e = &m2;
+	matf32_init(e, dim_y, 1, m2data);
+	status = kf->sys->outputs(e, kf->xhat, inputs);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	// C[k] = dh/dx at xhat[k|k-1]
+	if (!kf->is_C_valid || !ekf_is_near(kf, kf->x_C))
+	{
+		if (kf->jac_outputs != NULL)
+		{
+			status = kf->jac_outputs(kf->C, kf->xhat, inputs);
+		}
+		else
+		{
+			matf32_init(&m4, dim_xhat, 1, m4data);
+			matf32_init(&m5, dim_y, 1, m5data);
+			status = jacobian_fd(kf->sys->outputs, kf->xhat, inputs, false, kf->delta, m2data, kf->C, &m4, &m5);
+		}
+		if (status != MATH_SUCCESS)
+			return status;
+
+		memcpy(kf->x_C, kf->xhat->p_data, dim_xhat * sizeof(float));
+		kf->is_C_valid = true;
+		kf->jacobian_evals++;
+	}
+
+	// e = y[k] - h(xhat[k|k-1], u[k])
+	matf32_sub(measurements, e, e);
+
+	return sym_measurement_update(kf->P, kf->C, kf->Qv, kf->xhat, e);
+}
+
+
+
+// ====================================================================================================
+// Unscented Kalman filter
+// ====================================================================================================
+err_status_t
+ukf_init(ukf_info_t* const kf, sys_nonlin_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+	matf32_t* const xhat, matf32_sym_t* const P, float* const p_work)
+{
+	const uint16_t n = sys->state_dim;
+
+	if ((P->num_rows != n) || (xhat->num_rows != n) || (F->num_rows != n) || (F->num_cols != Qw->num_rows)
+		|| (Qv->num_rows != sys->output_dim))
+		return MATH_SIZE_MISMATCH;
+
+	// Single sigma points and the covariances go through the static buffers
+	if ((n > MAX_VEC_SIZE) || (sys->output_dim > MAX_VEC_SIZE) || (sys->input_dim > MAX_VEC_SIZE))
+		return MATH_LENGTH_ERROR;
+
+	// Check if the dynamics are discrete-time
+	if (sys->is_continuous)
+		return MATH_ARGUMENT_ERROR;
+
+	kf->sys = sys;
+	kf->F = F;
+	kf->Qw = Qw;
+	kf->Qv = Qv;
+	kf->xhat = xhat;
+	kf->P = P;
+	kf->dynamics_batch = NULL;
+	kf->outputs_batch = NULL;
+	kf->inputs = NULL;
+	kf->num_workers = 1;
+	kf->p_sigma = p_work;
+	kf->p_sigma_y = p_work + n * UKF_NUM_SIGMA(n);
+
+	return ukf_set_parameters(kf, 1, 2, 0);
+}
+
+
+err_status_t
+ukf_set_parameters(ukf_info_t* const kf, float alpha, float beta, float kappa)
+{
+	const float n = kf->sys->state_dim;
+	const float lambda = alpha * alpha * (n + kappa) - n;
+
+	if ((alpha <= 0) || (n + lambda <= 0))
+		return MATH_ARGUMENT_ERROR;
+
+	kf->scale = sqrtf(n + lambda);
+	kf->wm0 = lambda / (n + lambda);
+	kf->wc0 = kf->wm0 + 1 - alpha * alpha + beta;
+	kf->wi = 0.5f / (n + lambda);
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+ukf_set_batch(ukf_info_t* const kf, err_status_t (*dynamics_batch)(float* const, uint16_t, const matf32_t*),
+	err_status_t (*outputs_batch)(float* const, const float*, uint16_t, const matf32_t*))
+{
+	kf->dynamics_batch = dynamics_batch;
+	kf->outputs_batch = outputs_batch;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+ukf_set_workers(ukf_info_t* const kf, uint16_t num_workers)
+{
+	if ((num_workers == 0) || (num_workers > PARALLEL_MAX_WORKERS) || (num_workers > UKF_NUM_SIGMA(kf->sys->state_dim)))
+		return MATH_ARGUMENT_ERROR;
+
+	kf->num_workers = num_workers;
+
+	return MATH_SUCCESS;
+}
+
+
+// Sigma points xhat and xhat +- scale * U(k, :)' with P = U'U, stored by state component: p_sigma[i*ns + k]
+static err_status_t
+ukf_sigma_points(ukf_info_t* const kf)
+{
+	const uint16_t n = kf->sys->state_dim;
+	const uint16_t ns = UKF_NUM_SIGMA(n);
+	float* const X = kf->p_sigma;
+	const float* const x = kf->xhat->p_data;
+
+	matf32_sym_t U;
+	matf32_sym_init(&U, n, m5data);
+	matf32_sym_copy(kf->P, &U);
+	if (matf32_sym_cholesky(&U) != MATH_SUCCESS)
+		return MATH_DECOMPOSITION_FAILURE;
+
+	for (uint16_t i = 0; i < n; ++i)
+	{
+		X[i*ns] = x[i];
+		for (uint16_t k = 0; k < n; ++k)
+		{
+			const float d = (k <= i) ? kf->scale * m5data[matf32_sym_idx(k, i)] : 0;
+			X[i*ns + 1 + k] = x[i] + d;
+			X[i*ns + 1 + n + k] = x[i] - d;
+		}
+	}
+
+	return MATH_SUCCESS;
+}
+
+
+// Arguments of the sigma point workers
+typedef struct
+{
+	ukf_info_t* kf;
+	bool is_outputs;
+	const matf32_t* inputs;
+	err_status_t status[PARALLEL_MAX_WORKERS];
+} ukf_eval_arg_t;
+
+
+// Worker w evaluates the model on its block of sigma points, with its own stack buffers
+static void
+ukf_eval_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+	ukf_eval_arg_t* const p = (ukf_eval_arg_t*) p_arg;
+	const uint16_t n = p->kf->sys->state_dim;
+	const uint16_t ns = UKF_NUM_SIGMA(n);
+	const uint16_t dim_out = p->is_outputs ? p->kf->sys->output_dim : n;
+	float* const Z = p->is_outputs ? p->kf->p_sigma_y : p->kf->p_sigma;
+	const float* const X = p->kf->p_sigma;
+	float x_data[MAX_VEC_SIZE];
+	float z_data[MAX_VEC_SIZE];
+	matf32_t x, z;
+	matf32_init(&x, n, 1, x_data);
+	matf32_init(&z, dim_out, 1, z_data);
+
+	p->status[worker] = MATH_SUCCESS;
+	for (uint16_t k = worker * ns / num_workers; k < (worker + 1) * ns / num_workers; ++k)
+	{
+		for (uint16_t i = 0; i < n; ++i)
+			x_data[i] = X[i*ns + k];
+
+		p->status[worker] = p->is_outputs ? p->kf->sys->outputs(&z, &x, p->inputs)
+			: p->kf->sys->dynamics(&z, &x, p->inputs);
+		if (p->status[worker] != MATH_SUCCESS)
+			return;
+
+		for (uint16_t r = 0; r < dim_out; ++r)
+			Z[r*ns + k] = z_data[r];
+	}
+}
+
+
+// One model call per sigma point, Y_k = h(X_k) or X_k = f(X_k) in place, split over the workers
+static err_status_t
+ukf_eval_points(ukf_info_t* const kf, bool is_outputs, const matf32_t* inputs)
+{
+	ukf_eval_arg_t arg;
+	arg.kf = kf;
+	arg.is_outputs = is_outputs;
+	arg.inputs = inputs;
+
+	parallel_run(ukf_eval_task, &arg, kf->num_workers);
+
+	for (uint16_t w = 0; w < kf->num_workers; ++w)
+	{
+		if (arg.status[w] != MATH_SUCCESS)
+			return arg.status[w];
+	}
+
+	return MATH_SUCCESS;
+}
+
+
+// Weighted mean of the sigma point rows p_s (dim x ns) into p_mean, deviations left in p_s
+static void
+ukf_mean(ukf_info_t* const kf, float* const p_s, uint16_t dim, float* const p_mean)
+{
+	const uint16_t ns = UKF_NUM_SIGMA(kf->sys->state_dim);
+
+	for (uint16_t i = 0; i < dim; ++i)
+	{
+		float* const row = &p_s[i*ns];
+		float sum = 0;
+		for (uint16_t k = 1; k < ns; ++k)
+			sum += row[k];
+		const float mean = kf->wm0 * row[0] + kf->wi * sum;
+
+		for (uint16_t k = 0; k < ns; ++k)
+			row[k] -= mean;
+		p_mean[i] = mean;
+	}
+}
+
+
+// Weighted covariance of the deviation rows p_a (rows_a x ns) and p_b (rows_b x ns), element (i, j)
+static float
+ukf_cov(const ukf_info_t* const kf, const float* const p_a, uint16_t i, const float* const p_b, uint16_t j)
+{
+	const uint16_t ns = UKF_NUM_SIGMA(kf->sys->state_dim);
+	const float* const a = &p_a[i*ns];
+	const float* const b = &p_b[j*ns];
+	float sum = 0;
+
+	for (uint16_t k = 1; k < ns; ++k)
+		sum += a[k] * b[k];
+
+	return kf->wc0 * a[0] * b[0] + kf->wi * sum;
+}
+
+
+err_status_t
+ukf_predict(ukf_info_t* const kf, const matf32_t* inputs)
+{
+	// Check if the inputs vector has the correct size
+	if ((inputs->num_rows != kf->sys->input_dim) || (inputs->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t n = kf->sys->state_dim;
+	const uint16_t ns = UKF_NUM_SIGMA(n);
+	float* const X = kf->p_sigma;
+	err_status_t status;
+	kf->inputs = inputs;
+
+	status = ukf_sigma_points(kf);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	// X_k = f(X_k, u[k]), in one call when the model takes the whole set
+	if (kf->dynamics_batch != NULL)
+	{
+		status = kf->dynamics_batch(X, ns, inputs);
+		if (status != MATH_SUCCESS)
+			return status;
+	}
+	else
+	{
+		status = ukf_eval_points(kf, false, inputs);
+		if (status != MATH_SUCCESS)
+			return status;
+	}
+
+	// xhat[k|k-1] = sum of Wm_k X_k, P[k|k-1] = sum of Wc_k (X_k - xhat)(X_k - xhat)' + F[k] * Qw[k-1] * F[k]'
+	ukf_mean(kf, X, n, kf->xhat->p_data);
+	for (uint16_t j = 0; j < n; ++j)
+	{
+		for (uint16_t i = 0; i <= j; ++i)
+			kf->P->p_data[matf32_sym_idx(i, j)] = ukf_cov(kf, X, i, X, j);
+	}
+	matf32_sym_congruence(kf->F, kf->Qw, 1, kf->P, m1data);
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+ukf_correct(ukf_info_t* const kf, const matf32_t* measurements)
+{
+	// Check if the measurements vector has the correct size
+	if ((measurements->num_rows != kf->sys->output_dim) || (measurements->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t n = kf->sys->state_dim;
+	const uint16_t dim_y = kf->sys->output_dim;
+	const uint16_t ns = UKF_NUM_SIGMA(n);
+	float* const X = kf->p_sigma;
+	float* const Y = kf->p_sigma_y;
+	err_status_t status;
+
+	// Without a previous prediction the outputs are evaluated with a zero input
+	matf32_t zero_input;
+	const matf32_t* inputs = kf->inputs;
+	if (inputs == NULL)
+	{
+		matf32_init(&zero_input, kf->sys->input_dim, 1, m1data);
+		matf32_zeros(&zero_input);
+		inputs = &zero_input;
+	}
+
+	// Redraw the sigma points from P[k|k-1], Y_k = h(X_k, u[k])
+	status = ukf_sigma_points(kf);
+	if (status != MATH_SUCCESS)
+		return status;
+
+	if (kf->outputs_batch != NULL)
+	{
+		status = kf->outputs_batch(Y, X, ns, inputs);
+		if (status != MATH_SUCCESS)
+			return status;
+	}
+	else
+	{
+		status = ukf_eval_points(kf, true, inputs);
+		if (status != MATH_SUCCESS)
+			return status;
+	}
+
+	// e = y[k] - yhat with yhat = sum of Wm_k Y_k, in m2
+	matf32_t* const e = &m2;
+	matf32_init(e, dim_y, 1, m2data);
+	ukf_mean(kf, Y, dim_y, m2data);
+	matf32_sub(measurements, e, e);
+
+	// X_k - xhat[k|k-1], the mean of the sigma points is xhat[k|k-1] itself
+	for (uint16_t i = 0; i < n; ++i)
+	{
+		for (uint16_t k = 0; k < ns; ++k)
+			X[i*ns + k] -= kf->xhat->p_data[i];
+	}
+
+	// S = sum of Wc_k (Y_k - yhat)(Y_k - yhat)' + Qv[k] packed in m4, W = Pxy' in m1
+	for (uint16_t j = 0; j < dim_y; ++j)
+	{
+		for (uint16_t i = 0; i <= j; ++i)
+			m4data[matf32_sym_idx(i, j)] = ukf_cov(kf, Y, i, Y, j) + kf->Qv->p_data[matf32_sym_idx(i, j)];
+
+		for (uint16_t i = 0; i < n; ++i)
+			m1data[j*n + i] = ukf_cov(kf, Y, j, X, i);
+	}
+
+	return sym_gain_update(kf->P, dim_y, kf->xhat, e);
+}
+
 //void
 //kalman_predict(kalman_info_t* const kf, float* const inputs)
 //{
@@ -20,6 +20,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include "robotat_linalg.h"
+#include "robotat_parallel.h"
 
 // ====================================================================================================
 // Data structures, enums and type definitions
@@ -105,9 +106,105 @@ typedef struct
     matf32_t* Qv;       /**< Measurement noise covariance matrix. */
     matf32_t* xhat;     /**< State estimate. */
     matf32_t* P;        /**< Estimation covariance matrix. */
+    bool is_sequential; /**< Process the measurements one at a time (needs a diagonal Qv), set by kalman_init. */
+    matf32_t* L;        /**< Steady-state gain, dim(xhat) x dim(y), NULL until kalman_steady_state is called. */
+    bool is_steady;     /**< Only the estimate is propagated, with the constant gain L. */
+    float steady_tol;   /**< Relative change of trace(P) per correction that switches to steady state, 0 never. */
+    float trace_P;      /**< trace(P) after the last correction. */
 } kalman_info_t;
 
 
+/**
+ * @brief   Linear time-varying Kalman filter data structure with packed symmetric covariances.
+ *
+ * Same filter as kalman_info_t, but Qw, Qv and P only store their upper triangle (see matf32_sym.h).
+ */
+typedef struct
+{
+    sys_lti_t* sys;     /**< LTI system model(has to be discrete time). */
+    matf32_t* F;        /**< Coupling matrix for the process noise. */
+    matf32_sym_t* Qw;   /**< Process noise covariance matrix, packed. */
+    matf32_sym_t* Qv;   /**< Measurement noise covariance matrix, packed. */
+    matf32_t* xhat;     /**< State estimate. */
+    matf32_sym_t* P;    /**< Estimation covariance matrix, packed. */
+} kalman_sym_info_t;
+
+
+/**
+ * @brief   Square-root Kalman filter data structure.
+ *
+ * Same filter as kalman_info_t, but the covariances are kept as packed upper Cholesky factors
+ * (P = U'U, Qw = Sw'Sw, Qv = Sv'Sv, see matf32_sym_cholesky), so P stays symmetric positive semidefinite
+ * by construction and the filter only needs half the significant digits of the covariance form.
+ */
+typedef struct
+{
+    sys_lti_t* sys;     /**< LTI system model(has to be discrete time). */
+    matf32_t* F;        /**< Coupling matrix for the process noise. */
+    matf32_sym_t* Sw;   /**< Cholesky factor of the process noise covariance matrix, packed. */
+    matf32_sym_t* Sv;   /**< Cholesky factor of the measurement noise covariance matrix, packed. */
+    matf32_t* xhat;     /**< State estimate. */
+    matf32_sym_t* U;    /**< Cholesky factor of the estimation covariance matrix, packed. */
+} kalman_sqrt_info_t;
+
+
+/**
+ * @brief   Extended Kalman filter data structure.
+ *
+ * The covariances are packed as in kalman_sym_info_t. The Jacobians A = df/dx and C = dh/dx come from user
+ * callbacks or forward differences and are only recomputed when the estimate moved more than relin_tol
+ * (infinity norm) from the point where they were last evaluated.
+ */
+typedef struct
+{
+    sys_nonlin_t* sys;  /**< Nonlinear system model (has to be discrete time), x[k+1] = f(x[k], u[k]). */
+    matf32_t* F;        /**< Coupling matrix for the process noise. */
+    matf32_sym_t* Qw;   /**< Process noise covariance matrix, packed. */
+    matf32_sym_t* Qv;   /**< Measurement noise covariance matrix, packed. */
+    matf32_t* xhat;     /**< State estimate. */
+    matf32_sym_t* P;    /**< Estimation covariance matrix, packed. */
+    matf32_t* A;        /**< Jacobian of the dynamics, dim(xhat) x dim(xhat). */
+    matf32_t* C;        /**< Jacobian of the outputs, dim(y) x dim(xhat). */
+    err_status_t (*jac_dynamics)(matf32_t* const, const matf32_t*, const matf32_t*);  /**< A(x, u), NULL for finite differences. */
+    err_status_t (*jac_outputs)(matf32_t* const, const matf32_t*, const matf32_t*);   /**< C(x, u), NULL for finite differences. */
+    float delta;        /**< Finite difference step. */
+    float relin_tol;    /**< Displacement of the estimate that triggers new Jacobians, 0 to evaluate them every time. */
+    const matf32_t* inputs;         /**< Last inputs, used by the outputs in the correction. */
+    float x_A[MAX_VEC_SIZE];        /**< Linearization point of A. */
+    float x_C[MAX_VEC_SIZE];        /**< Linearization point of C. */
+    bool is_A_valid;    /**< A has been evaluated. */
+    bool is_C_valid;    /**< C has been evaluated. */
+    uint32_t jacobian_evals;        /**< Number of Jacobian evaluations, for profiling. */
+} ekf_info_t;
+
+
+/**
+ * @brief   Unscented Kalman filter data structure.
+ *
+ * The 2n + 1 sigma points are stored by state component, p_sigma[i*(2n + 1) + k] is component i of point k, so
+ * the mean and covariance reductions and batched model callbacks run over contiguous arrays.
+ */
+typedef struct
+{
+    sys_nonlin_t* sys;  /**< Nonlinear system model (has to be discrete time), x[k+1] = f(x[k], u[k]). */
+    matf32_t* F;        /**< Coupling matrix for the process noise. */
+    matf32_sym_t* Qw;   /**< Process noise covariance matrix, packed. */
+    matf32_sym_t* Qv;   /**< Measurement noise covariance matrix, packed. */
+    matf32_t* xhat;     /**< State estimate. */
+    matf32_sym_t* P;    /**< Estimation covariance matrix, packed. */
+    err_status_t (*dynamics_batch)(float* const, uint16_t, const matf32_t*);               /**< f on all points in place, NULL for one call per point. */
+    err_status_t (*outputs_batch)(float* const, const float*, uint16_t, const matf32_t*);  /**< h on all points, NULL for one call per point. */
+    const matf32_t* inputs;         /**< Last inputs, used by the outputs in the correction. */
+    uint16_t num_workers;           /**< Workers sharing the per point model calls, see ukf_set_workers. */
+    float scale;        /**< Spread of the sigma points, sqrt(n + lambda). */
+    float wm0;          /**< Weight of the central point in the mean. */
+    float wc0;          /**< Weight of the central point in the covariance. */
+    float wi;           /**< Weight of the other points, 1 / (2(n + lambda)). */
+    float* p_sigma;     /**< Sigma points, dim(xhat) x (2n + 1). */
+    float* p_sigma_y;   /**< Sigma point outputs, dim(y) x (2n + 1). */
+} ukf_info_t;
+
+
 // ====================================================================================================
 // Public function prototypes
 // ====================================================================================================
@@ -252,6 +349,104 @@ err_status_t
 linear_state_feedback(matf32_t* const u, const matf32_t* K, const matf32_t* x, const matf32_t* xss, const matf32_t* uss);
 
 
+/**
+ * @brief   Solves the discrete algebraic Riccati equation X = A'XA - A'XB(R + B'XB)^-1 B'XA + Q for its
+ * stabilizing solution, with the structure-preserving doubling algorithm: every step doubles the horizon of
+ * the underlying Riccati recursion, so convergence is quadratic and takes a few tens of O(n^3) steps at most.
+ *
+ * @param[in]       A   System matrix, n x n.
+ * @param[in]       B   Input matrix, n x m.
+ * @param[in]       Q   State weight, n x n, symmetric positive semidefinite.
+ * @param[in]       R   Input weight, m x m, symmetric positive definite.
+ * @param[out]      X   Solution, n x n. Can be the same as Q.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_LENGTH_ERROR :             The problem does not fit in the static buffers.
+ *              MATH_SINGULAR :                 R or an intermediate I + G*H is singular.
+ *              MATH_DECOMPOSITION_FAILURE :    No convergence, (A, B) is not stabilizable or (A, Q) not detectable.
+ */
+err_status_t
+dare(const matf32_t* A, const matf32_t* B, const matf32_t* Q, const matf32_t* R, matf32_t* const X);
+
+
+/**
+ * @brief   Solves the continuous algebraic Riccati equation A'X + XA - XBR^-1B'X + Q = 0 for its stabilizing
+ * solution. A Cayley transform of the Hamiltonian turns it into the doubling iteration used by dare.
+ *
+ * @param[in]       A   System matrix, n x n.
+ * @param[in]       B   Input matrix, n x m.
+ * @param[in]       Q   State weight, n x n, symmetric positive semidefinite.
+ * @param[in]       R   Input weight, m x m, symmetric positive definite.
+ * @param[out]      X   Solution, n x n. Can be the same as Q.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_LENGTH_ERROR :             The problem does not fit in the static buffers.
+ *              MATH_SINGULAR :                 R or an intermediate matrix is singular.
+ *              MATH_DECOMPOSITION_FAILURE :    No convergence, (A, B) is not stabilizable or (A, Q) not detectable.
+ */
+err_status_t
+care(const matf32_t* A, const matf32_t* B, const matf32_t* Q, const matf32_t* R, matf32_t* const X);
+
+
+/**
+ * @brief   Linear quadratic regulator for a continuous time LTI system: the gain K = R^-1 B'X of
+ * u = -K * (x - xss) + uss (see linear_state_feedback) that minimizes the integral of x'Qx + u'Ru.
+ *
+ * X is computed with care and can be refined with Newton-Kleinman steps, each one solving the Lyapunov equation
+ * of the closed loop A - BK. One or two steps remove the rounding left by the doubling iteration at the cost of
+ * about one more Riccati solve each.
+ *
+ * @param[in]       sys             Continuous time LTI system data structure.
+ * @param[in]       Q               State weight, n x n.
+ * @param[in]       R               Input weight, m x m.
+ * @param[out]      K               Gain, m x n.
+ * @param[out]      X               Riccati solution, n x n.
+ * @param[in]       newton_steps    Number of Newton-Kleinman refinement steps, 0 for none.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_ARGUMENT_ERROR :           The system is discrete time.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_LENGTH_ERROR :             The problem does not fit in the static buffers.
+ *              MATH_SINGULAR :                 R or an intermediate matrix is singular.
+ *              MATH_DECOMPOSITION_FAILURE :    No convergence.
+ */
+err_status_t
+lqr(const sys_lti_t* sys, const matf32_t* Q, const matf32_t* R, matf32_t* const K, matf32_t* const X,
+    uint16_t newton_steps);
+
+
+/**
+ * @brief   Linear quadratic regulator for a discrete time LTI system: the gain K = (R + B'XB)^-1 B'XA of
+ * u = -K * (x - xss) + uss (see linear_state_feedback) that minimizes the sum of x'Qx + u'Ru.
+ *
+ * X is computed with dare and can be refined with Newton (Hewer) steps, each one solving the Stein equation of
+ * the closed loop A - BK. Gains can be recomputed on-board after the model is re-linearized with linloc.
+ *
+ * @param[in]       sys             Discrete time LTI system data structure.
+ * @param[in]       Q               State weight, n x n.
+ * @param[in]       R               Input weight, m x m.
+ * @param[out]      K               Gain, m x n.
+ * @param[out]      X               Riccati solution, n x n.
+ * @param[in]       newton_steps    Number of Newton refinement steps, 0 for none.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_ARGUMENT_ERROR :           The system is continuous time.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_LENGTH_ERROR :             The problem does not fit in the static buffers.
+ *              MATH_SINGULAR :                 R + B'XB or an intermediate matrix is singular.
+ *              MATH_DECOMPOSITION_FAILURE :    No convergence.
+ */
+err_status_t
+dlqr(const sys_lti_t* sys, const matf32_t* Q, const matf32_t* R, matf32_t* const K, matf32_t* const X,
+    uint16_t newton_steps);
+
+
 // ====================================================================================================
 // Linear time-varying, discrete time Kalman filter
 // ====================================================================================================
@@ -279,10 +474,49 @@ err_status_t
 kalman_predict(kalman_info_t* const kf, const matf32_t* inputs);
 
 
+/**
+ * @brief   Measurement update.
+ *
+ * With kf->is_sequential, which kalman_init sets when Qv is diagonal, every measurement is a scalar update:
+ * h = P*c', s = c*h + Qv(i,i), x += h*(y(i) - c*x)/s and P -= h*h'/s for each row c of C, dim(y) rank-1
+ * updates of O(dim(xhat)^2) without inverting S. Otherwise the gain is computed with S^-1. Either way xhat and P
+ * are left unchanged when MATH_SINGULAR is returned.
+ *
+ * @param[in, out]  kf              Kalman filter data structure.
+ * @param[in]       measurements    Measurement vector y[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_SINGULAR :         Innovation covariance is singular.
+ */
 err_status_t
 kalman_correct(kalman_info_t* const kf, const matf32_t* measurements);
 
 
+/**
+ * @brief   Steady-state mode for time-invariant models: kalman_predict only propagates the estimate and
+ * kalman_correct applies the constant gain L, O(dim(xhat)^2) per step.
+ *
+ * With steady_tol = 0 the filter DARE P = A*P*A' - A*P*C'*S^-1*C*P*A' + F*Qw*F' is solved now (see dare), P is
+ * set to its a priori solution and L = P*C'*S^-1. With steady_tol > 0 the filter keeps propagating P and does
+ * the same inside kalman_correct once trace(P) changes by less than steady_tol (relative) in one step.
+ *
+ * @param[in, out]  kf          Kalman filter data structure.
+ * @param[in]       L           Gain storage, dim(xhat) x dim(y).
+ * @param[in]       steady_tol  Relative change of trace(P) that switches to steady state, 0 to switch now.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_LENGTH_ERROR :             The problem does not fit in the static buffers.
+ *              MATH_SINGULAR :                 Qv or the innovation covariance is singular.
+ *              MATH_DECOMPOSITION_FAILURE :    The Riccati equation did not converge.
+ */
+err_status_t
+kalman_steady_state(kalman_info_t* const kf, matf32_t* const L, float steady_tol);
+
+
 static inline err_status_t
 kalman_update(kalman_info_t* const kf, const matf32_t* inputs, const matf32_t* measurements)
 {
@@ -298,12 +532,381 @@ kalman_get_estimate(kalman_info_t* const kf, float* const estimate)
 }
 
 
+/**
+ * @brief   Initializes a Kalman filter with packed symmetric covariance matrices.
+ *
+ * @param[in, out]  kf      Kalman filter data structure.
+ * @param[in]       sys     LTI system model.
+ * @param[in]       F       Coupling matrix of the process noise.
+ * @param[in]       Qw      Packed process noise covariance matrix.
+ * @param[in]       Qv      Packed measurement noise covariance matrix.
+ * @param[in]       xhat    State estimate.
+ * @param[in]       P       Packed estimation covariance matrix.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_ARGUMENT_ERROR :   LTI system model is not discrete time.
+ */
+err_status_t
+kalman_sym_init(kalman_sym_info_t* const kf, sys_lti_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+    matf32_t* const xhat, matf32_sym_t* const P);
+
+
+/**
+ * @brief   Time update, P = A*P*A' + F*Qw*F', computed with the packed congruence kernel.
+ *
+ * @param[in, out]  kf      Kalman filter data structure.
+ * @param[in]       inputs  Input vector u[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+kalman_sym_predict(kalman_sym_info_t* const kf, const matf32_t* inputs);
+
+
+/**
+ * @brief   Measurement update. The innovation covariance S = C*P*C' + Qv is factorized as U'U and the
+ * covariance is downdated as P = P - V'V with V = U'^-1*C*P, which keeps P symmetric by construction and
+ * avoids forming S^-1 or the gain explicitly.
+ *
+ * @param[in, out]  kf              Kalman filter data structure.
+ * @param[in]       measurements    Measurement vector y[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_DECOMPOSITION_FAILURE :    Innovation covariance is not positive definite.
+ */
+err_status_t
+kalman_sym_correct(kalman_sym_info_t* const kf, const matf32_t* measurements);
+
+
+static inline err_status_t
+kalman_sym_update(kalman_sym_info_t* const kf, const matf32_t* inputs, const matf32_t* measurements)
+{
+    kalman_sym_predict(kf, inputs);
+    return kalman_sym_correct(kf, measurements);
+}
+
+
+/**
+ * @brief   Initializes a square-root Kalman filter. Qw, Qv and P are factored in place and keep their Cholesky
+ * factors afterwards.
+ *
+ * The time update triangularizes a (dim(xhat) + dim(w)) x dim(xhat) array and the measurement update a
+ * (dim(y) + dim(xhat)) square array, both must fit in MAX_MAT_SIZE.
+ *
+ * @param[in, out]  kf      Kalman filter data structure.
+ * @param[in]       sys     LTI system model.
+ * @param[in]       F       Coupling matrix of the process noise.
+ * @param[in, out]  Qw      Packed process noise covariance matrix, overwritten with its Cholesky factor.
+ * @param[in, out]  Qv      Packed measurement noise covariance matrix, overwritten with its Cholesky factor.
+ * @param[in]       xhat    State estimate.
+ * @param[in, out]  P       Packed estimation covariance matrix, overwritten with its Cholesky factor.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_ARGUMENT_ERROR :           LTI system model is not discrete time.
+ *              MATH_DECOMPOSITION_FAILURE :    A covariance matrix is not positive definite.
+ */
+err_status_t
+kalman_sqrt_init(kalman_sqrt_info_t* const kf, sys_lti_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+    matf32_t* const xhat, matf32_sym_t* const P);
+
+
+/**
+ * @brief   Time update. U is replaced by the triangular factor R of the QR decomposition of [U*A'; Sw*F'],
+ * since R'R = A*P*A' + F*Qw*F'.
+ *
+ * @param[in, out]  kf      Kalman filter data structure.
+ * @param[in]       inputs  Input vector u[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+kalman_sqrt_predict(kalman_sqrt_info_t* const kf, const matf32_t* inputs);
+
+
+/**
+ * @brief   Measurement update. The QR decomposition of [Sv 0; U*C' U] gives [R11 R12; 0 R22] with R11'R11 = S,
+ * R11'R12 = C*P and R22'R22 = P[k|k]. The estimate is corrected with the gain R12'*R11'^-1, applied by a
+ * triangular solve, without forming S^-1.
+ *
+ * @param[in, out]  kf              Kalman filter data structure.
+ * @param[in]       measurements    Measurement vector y[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+kalman_sqrt_correct(kalman_sqrt_info_t* const kf, const matf32_t* measurements);
+
+
+static inline err_status_t
+kalman_sqrt_update(kalman_sqrt_info_t* const kf, const matf32_t* inputs, const matf32_t* measurements)
+{
+    kalman_sqrt_predict(kf, inputs);
+    return kalman_sqrt_correct(kf, measurements);
+}
+
+
+/**
+ * @brief   Recovers the estimation covariance matrix P = U'U.
+ *
+ * @param[in]       kf      Kalman filter data structure.
+ * @param[out]      P       Packed covariance matrix, dim(xhat) x dim(xhat).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+kalman_sqrt_get_covariance(const kalman_sqrt_info_t* const kf, matf32_sym_t* const P);
+
+
+// ====================================================================================================
+// Extended Kalman filter
+// ====================================================================================================
+#define EKF_FD_DELTA    (1e-3f)     /**< Default step of the finite difference Jacobians. */
+
+/**
+ * @brief   Initializes an extended Kalman filter with finite difference Jacobians evaluated every time step.
+ *
+ * @param[in, out]  kf      EKF data structure.
+ * @param[in]       sys     Discrete time nonlinear system model.
+ * @param[in]       F       Coupling matrix of the process noise.
+ * @param[in]       Qw      Packed process noise covariance matrix.
+ * @param[in]       Qv      Packed measurement noise covariance matrix.
+ * @param[in]       xhat    State estimate.
+ * @param[in]       P       Packed estimation covariance matrix.
+ * @param[in]       A       Storage for the Jacobian of the dynamics, dim(xhat) x dim(xhat).
+ * @param[in]       C       Storage for the Jacobian of the outputs, dim(y) x dim(xhat).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_LENGTH_ERROR :     The dimensions exceed MAX_VEC_SIZE.
+ *              MATH_ARGUMENT_ERROR :   System model is not discrete time.
+ */
+err_status_t
+ekf_init(ekf_info_t* const kf, sys_nonlin_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+    matf32_t* const xhat, matf32_sym_t* const P, matf32_t* const A, matf32_t* const C);
+
+
+/**
+ * @brief   Sets analytic Jacobians, with the same signature as the model callbacks. NULL keeps finite differences.
+ *
+ * @param[in, out]  kf              EKF data structure.
+ * @param[in]       jac_dynamics    Computes A = df/dx at (x, u).
+ * @param[in]       jac_outputs     Computes C = dh/dx at (x, u).
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ */
+err_status_t
+ekf_set_jacobians(ekf_info_t* const kf,
+    err_status_t (*jac_dynamics)(matf32_t* const, const matf32_t*, const matf32_t*),
+    err_status_t (*jac_outputs)(matf32_t* const, const matf32_t*, const matf32_t*));
+
+
+/**
+ * @brief   Sets the finite difference step and the displacement of the estimate below which the last
+ * Jacobians are reused. Reusing them trades some accuracy of the covariance for one model evaluation per
+ * state instead of dim(xhat) + 1 when the estimate moves slowly.
+ *
+ * @param[in, out]  kf          EKF data structure.
+ * @param[in]       delta       Finite difference step, > 0.
+ * @param[in]       relin_tol   Infinity norm of the displacement that triggers new Jacobians, 0 for every step.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_ARGUMENT_ERROR :   Nonpositive step or negative tolerance.
+ */
+err_status_t
+ekf_set_relinearization(ekf_info_t* const kf, float delta, float relin_tol);
+
+
+/**
+ * @brief   Time update, xhat = f(xhat, u) and P = A*P*A' + F*Qw*F' with A = df/dx at the previous estimate.
+ *
+ * @param[in, out]  kf      EKF data structure.
+ * @param[in]       inputs  Input vector u[k], kept for the next correction.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              Any error returned by the model or Jacobian callbacks.
+ */
+err_status_t
+ekf_predict(ekf_info_t* const kf, const matf32_t* inputs);
+
+
+/**
+ * @brief   Measurement update with the innovation y - h(xhat, u) and C = dh/dx, through the same packed
+ * Cholesky update as kalman_sym_correct.
+ *
+ * @param[in, out]  kf              EKF data structure.
+ * @param[in]       measurements    Measurement vector y[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_DECOMPOSITION_FAILURE :    Innovation covariance is not positive definite.
+ *              Any error returned by the model or Jacobian callbacks.
+ */
+err_status_t
+ekf_correct(ekf_info_t* const kf, const matf32_t* measurements);
+
+
+static inline err_status_t
+ekf_update(ekf_info_t* const kf, const matf32_t* inputs, const matf32_t* measurements)
+{
+    err_status_t status = ekf_predict(kf, inputs);
+    if (status != MATH_SUCCESS)
+        return status;
+
+    return ekf_correct(kf, measurements);
+}
+
+
+// ====================================================================================================
+// Unscented Kalman filter
+// ====================================================================================================
+#define UKF_NUM_SIGMA(n)        (2*(n) + 1)                     /**< Number of sigma points. */
+#define UKF_FWORK(n, dim_y)     (((n) + (dim_y))*UKF_NUM_SIGMA(n))  /**< Size of the work array. */
+
+/**
+ * @brief   Initializes an unscented Kalman filter with alpha = 1, beta = 2, kappa = 0 and one model call per
+ * sigma point.
+ *
+ * @param[in, out]  kf      UKF data structure.
+ * @param[in]       sys     Discrete time nonlinear system model.
+ * @param[in]       F       Coupling matrix of the (additive) process noise.
+ * @param[in]       Qw      Packed process noise covariance matrix.
+ * @param[in]       Qv      Packed (additive) measurement noise covariance matrix.
+ * @param[in]       xhat    State estimate.
+ * @param[in]       P       Packed estimation covariance matrix.
+ * @param[in]       p_work  Work array of UKF_FWORK(dim(xhat), dim(y)) floats for the sigma points.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_LENGTH_ERROR :     The dimensions exceed MAX_VEC_SIZE.
+ *              MATH_ARGUMENT_ERROR :   System model is not discrete time.
+ */
+err_status_t
+ukf_init(ukf_info_t* const kf, sys_nonlin_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+    matf32_t* const xhat, matf32_sym_t* const P, float* const p_work);
+
+
+/**
+ * @brief   Sets the scaled unscented transform parameters, lambda = alpha^2 (n + kappa) - n.
+ *
+ * @param[in, out]  kf      UKF data structure.
+ * @param[in]       alpha   Spread of the sigma points, > 0.
+ * @param[in]       beta    Prior knowledge of the distribution, 2 is optimal for Gaussians.
+ * @param[in]       kappa   Secondary scaling.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_ARGUMENT_ERROR :   alpha <= 0 or n + lambda <= 0.
+ */
+err_status_t
+ukf_set_parameters(ukf_info_t* const kf, float alpha, float beta, float kappa);
+
+
+/**
+ * @brief   Sets model callbacks that process all 2n + 1 sigma points in one call, stored by component
+ * (p[i*count + k] is component i of point k), so the model can vectorize across the points. NULL keeps one
+ * sys->dynamics or sys->outputs call per point.
+ *
+ * @param[in, out]  kf              UKF data structure.
+ * @param[in]       dynamics_batch  Overwrites the dim(xhat) x count points with f(x, u).
+ * @param[in]       outputs_batch   Writes the dim(y) x count outputs h(x, u) of the dim(xhat) x count points.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ */
+err_status_t
+ukf_set_batch(ukf_info_t* const kf, err_status_t (*dynamics_batch)(float* const, uint16_t, const matf32_t*),
+    err_status_t (*outputs_batch)(float* const, const float*, uint16_t, const matf32_t*));
+
+
+/**
+ * @brief   Splits the per point model calls (the ones not made through ukf_set_batch callbacks) over num_workers
+ * workers of parallel_run, each taking a contiguous block of the 2n + 1 sigma points. They run as POSIX
+ * threads when the library is built with PARALLEL_PTHREAD, in which case sys->dynamics and
+ * sys->outputs must be safe to call concurrently; otherwise the blocks are evaluated in turn. Worth it only for
+ * expensive models, threads are started on every call.
+ *
+ * @param[in, out]  kf              UKF data structure.
+ * @param[in]       num_workers     Number of workers, 1 (the default) to PARALLEL_MAX_WORKERS and at most 2n + 1.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_ARGUMENT_ERROR :   num_workers is 0, above PARALLEL_MAX_WORKERS or above 2n + 1.
+ */
+err_status_t
+ukf_set_workers(ukf_info_t* const kf, uint16_t num_workers);
+
+
+/**
+ * @brief   Time update: the sigma points of P = U'U are propagated through the dynamics and their weighted
+ * mean and covariance, plus F*Qw*F', become the a priori estimate and covariance.
+ *
+ * @param[in, out]  kf      UKF data structure.
+ * @param[in]       inputs  Input vector u[k], kept for the next correction.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_DECOMPOSITION_FAILURE :    P is not positive definite.
+ *              Any error returned by the model callbacks.
+ */
+err_status_t
+ukf_predict(ukf_info_t* const kf, const matf32_t* inputs);
+
+
+/**
+ * @brief   Measurement update: sigma points redrawn from the a priori covariance give the innovation and cross
+ * covariances, then the packed Cholesky update of kalman_sym_correct is applied.
+ *
+ * @param[in, out]  kf              UKF data structure.
+ * @param[in]       measurements    Measurement vector y[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_DECOMPOSITION_FAILURE :    P or the innovation covariance is not positive definite.
+ *              Any error returned by the model callbacks.
+ */
+err_status_t
+ukf_correct(ukf_info_t* const kf, const matf32_t* measurements);
+
+
+static inline err_status_t
+ukf_update(ukf_info_t* const kf, const matf32_t* inputs, const matf32_t* measurements)
+{
+    err_status_t status = ukf_predict(kf, inputs);
+    if (status != MATH_SUCCESS)
+        return status;
+
+    return ukf_correct(kf, measurements);
+}
+
+
 // TODO:
 // 1. Nonlinear system linearization
 // 2. Nonlinear system discretization
-// 3. Extended Kalman Filter
-// 4. Linear time-varying LQR
-// 5. Linear MPC
+// 3. Linear time-varying LQR
+// 4. Linear MPC (condensed formulation in robotat_mpc.h)
 
 
 //void
@@ -47,6 +47,10 @@
 #include "matf32.h"
 #include "linsolve.h"
 #include "quadprog.h"
+#include "quadprog_admm.h"
+#include "quadprog_batch.h"
+#include "quadprog_mp.h"
+#include "quadprog_presolve.h"
 
 
 
@@ -0,0 +1,910 @@
+#include "robotat_mpc.h"
+
+// ====================================================================================================
+// Auxiliary routines
+// ====================================================================================================
+
+/**
+ * @brief   C = A' * B for row-major A (k x r) and B (k x s), C is r x s with leading dimension ldc.
+ */
+static void
+mpc_mul_tn(const float* A, const float* B, uint16_t k, uint16_t r, uint16_t s, float* C, uint16_t ldc)
+{
+	for (uint16_t i = 0; i < r; ++i)
+	{
+		for (uint16_t j = 0; j < s; ++j)
+		{
+			float sum = 0;
+			for (uint16_t l = 0; l < k; ++l)
+				sum += A[l*r + i] * B[l*s + j];
+			C[i*ldc + j] = sum;
+		}
+	}
+}
+
+
+/**
+ * @brief   C = A * B for row-major A (r x k) and B (k x s).
+ */
+static void
+mpc_mul(const float* A, const float* B, uint16_t r, uint16_t k, uint16_t s, float* C)
+{
+	for (uint16_t i = 0; i < r; ++i)
+	{
+		for (uint16_t j = 0; j < s; ++j)
+		{
+			float sum = 0;
+			for (uint16_t l = 0; l < k; ++l)
+				sum += A[i*k + l] * B[l*s + j];
+			C[i*s + j] = sum;
+		}
+	}
+}
+
+
+// ====================================================================================================
+// Condensed MPC
+// ====================================================================================================
+err_status_t
+mpc_condensed_init(mpc_condensed_t* const mpc, const sys_lti_t* const sys, uint16_t horizon, const matf32_t* Qx,
+	const matf32_t* R, const matf32_t* P, const matf32_t* umin, const matf32_t* umax, float* p_fwork)
+{
+	const uint16_t n = sys->state_dim;
+	const uint16_t m = sys->input_dim;
+	const uint16_t nu = horizon * m;
+
+	// Check if the dynamics are discrete-time
+	if (sys->is_continuous || (0 == horizon) || ((NULL == umin) != (NULL == umax)))
+		return MATH_ARGUMENT_ERROR;
+
+#ifdef MATH_MATRIX_CHECK
+	if (!matf32_size_check(Qx, n, n) || !matf32_size_check(R, m, m) || ((NULL != P) && !matf32_size_check(P, n, n)))
+		return MATH_SIZE_MISMATCH;
+
+	if ((NULL != umin) && (!matf32_size_check(umin, m, 1) || !matf32_size_check(umax, m, 1)))
+		return MATH_SIZE_MISMATCH;
+#endif
+
+	mpc->sys = sys;
+	mpc->horizon = horizon;
+	mpc->Qx = Qx;
+	mpc->R = R;
+	mpc->P = (NULL != P) ? P : Qx;
+	mpc->has_bounds = (NULL != umin);
+
+	matf32_init(&mpc->H, nu, nu, p_fwork);
+	p_fwork += nu*nu;
+	matf32_init(&mpc->F, nu, n, p_fwork);
+	p_fwork += nu*n;
+	matf32_init(&mpc->G, nu, n, p_fwork);
+	p_fwork += nu*n;
+	matf32_init(&mpc->c, nu, 1, p_fwork);
+	p_fwork += nu;
+	matf32_init(&mpc->U, nu, 1, p_fwork);
+	p_fwork += nu;
+	matf32_init(&mpc->Ain, 2*nu, nu, p_fwork);
+	p_fwork += 2*nu*nu;
+	matf32_init(&mpc->bin, 2*nu, 1, p_fwork);
+	p_fwork += 2*nu;
+	mpc->p_AkB = p_fwork;
+	p_fwork += horizon*n*m;
+	mpc->p_QAkB = p_fwork;
+	p_fwork += horizon*n*m;
+	mpc->p_PAkB = p_fwork;
+	p_fwork += horizon*n*m;
+	mpc->p_work = p_fwork;
+
+	matf32_zeros(&mpc->c);
+	matf32_zeros(&mpc->U);
+
+	// [I; -I] U <= [umax; -umin], a signed identity so quadprog dispatches to the bound constrained solver
+	if (mpc->has_bounds)
+	{
+		matf32_zeros(&mpc->Ain);
+		for (uint16_t k = 0; k < nu; ++k)
+		{
+			mpc->Ain.p_data[k*nu + k] = 1;
+			mpc->Ain.p_data[(nu + k)*nu + k] = -1;
+			mpc->bin.p_data[k] = umax->p_data[k % m];
+			mpc->bin.p_data[nu + k] = -umin->p_data[k % m];
+		}
+	}
+
+	quadprog_init(&mpc->qp, &mpc->H, &mpc->c, NULL, NULL,
+		mpc->has_bounds ? &mpc->Ain : NULL, mpc->has_bounds ? &mpc->bin : NULL, NULL);
+
+	mpc_condensed_update_model(mpc);
+
+	return MATH_SUCCESS;
+}
+
+
+void
+mpc_condensed_update_model(mpc_condensed_t* const mpc)
+{
+	const uint16_t n = mpc->sys->state_dim;
+	const uint16_t m = mpc->sys->input_dim;
+	const uint16_t N = mpc->horizon;
+	const uint16_t nu = N * m;
+	const uint16_t nm = n * m;
+	const float* A = mpc->sys->A->p_data;
+	const float* B = mpc->sys->B->p_data;
+	const float* Qx = mpc->Qx->p_data;
+	const float* P = mpc->P->p_data;
+	float* H = mpc->H.p_data;
+
+	float* Pi = mpc->p_work;
+	float* Z = &Pi[n*n];
+	float* tmp = &Z[n*n];
+	float* Apow = &tmp[n*n];
+	float* S = &Apow[n*n];
+	float* row = &S[m*m];
+
+	// A^k B, Qx A^k B and P A^k B
+	memcpy(mpc->p_AkB, B, nm*sizeof(float));
+	for (uint16_t k = 1; k < N; ++k)
+		mpc_mul(A, &mpc->p_AkB[(k - 1)*nm], n, n, m, &mpc->p_AkB[k*nm]);
+
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		mpc_mul(Qx, &mpc->p_AkB[k*nm], n, n, m, &mpc->p_QAkB[k*nm]);
+		mpc_mul(P, &mpc->p_AkB[k*nm], n, n, m, &mpc->p_PAkB[k*nm]);
+	}
+
+	// H(i, j), i = j + d, sums (A^t B)' Q_t+i (A^t+d B) over the L = N-1-i remaining steps: the stage terms are a
+	// running sum S along the block diagonal d, the terminal term uses P
+	for (uint16_t d = 0; d < N; ++d)
+	{
+		memset(S, 0, m*m*sizeof(float));
+
+		for (uint16_t L = 0; L < N - d; ++L)
+		{
+			const uint16_t i = N - 1 - L;
+			const uint16_t j = i - d;
+			float* Hij = &H[(i*m)*nu + j*m];
+
+			mpc_mul_tn(&mpc->p_AkB[L*nm], &mpc->p_PAkB[(L + d)*nm], n, m, m, Hij, nu);
+			for (uint16_t r = 0; r < m; ++r)
+			{
+				for (uint16_t s = 0; s < m; ++s)
+					Hij[r*nu + s] += S[r*m + s] + ((0 == d) ? mpc->R->p_data[r*m + s] : 0);
+			}
+
+			// H(j, i) = H(i, j)', diagonal blocks are made exactly symmetric from their upper triangle
+			for (uint16_t r = 0; r < m; ++r)
+			{
+				for (uint16_t s = (0 == d) ? r + 1 : 0; s < m; ++s)
+					H[(j*m + s)*nu + i*m + r] = Hij[r*nu + s];
+			}
+
+			// S += (A^L B)' Qx A^L+d B
+			for (uint16_t r = 0; r < m; ++r)
+			{
+				for (uint16_t s = 0; s < m; ++s)
+				{
+					float sum = 0;
+					for (uint16_t l = 0; l < n; ++l)
+						sum += mpc->p_AkB[L*nm + l*m + r] * mpc->p_QAkB[(L + d)*nm + l*m + s];
+					S[r*m + s] += sum;
+				}
+			}
+		}
+	}
+
+	// F_i = B' Pi_i A^(i+1), G_i = B' Z_i; the backward pass stores B' Pi_i in F
+	memcpy(Pi, P, n*n*sizeof(float));
+	memcpy(Z, P, n*n*sizeof(float));
+	for (int16_t i = N - 1; i >= 0; --i)
+	{
+		mpc_mul_tn(B, Pi, n, m, n, &mpc->F.p_data[i*m*n], n);
+		mpc_mul_tn(B, Z, n, m, n, &mpc->G.p_data[i*m*n], n);
+
+		if (i > 0)
+		{
+			// Pi = Qx + A' Pi A, Z = Qx + A' Z
+			mpc_mul(Pi, A, n, n, n, tmp);
+			mpc_mul_tn(A, tmp, n, n, n, Pi, n);
+			mpc_mul_tn(A, Z, n, n, n, tmp, n);
+			for (uint16_t k = 0; k < n*n; ++k)
+			{
+				Pi[k] += Qx[k];
+				Z[k] = tmp[k] + Qx[k];
+			}
+		}
+	}
+
+	// forward pass F_i = (B' Pi_i) A^(i+1), one row at a time
+	memcpy(Apow, A, n*n*sizeof(float));
+	for (uint16_t i = 0; i < N; ++i)
+	{
+		for (uint16_t r = 0; r < m; ++r)
+		{
+			float* Fr = &mpc->F.p_data[(i*m + r)*n];
+			mpc_mul(Fr, Apow, 1, n, n, row);
+			memcpy(Fr, row, n*sizeof(float));
+		}
+
+		mpc_mul(A, Apow, n, n, n, tmp);
+		memcpy(Apow, tmp, n*n*sizeof(float));
+	}
+}
+
+
+err_status_t
+mpc_condensed_update_state(mpc_condensed_t* const mpc, const matf32_t* x0, const matf32_t* xref)
+{
+	const uint16_t n = mpc->sys->state_dim;
+	const uint16_t nu = mpc->c.num_rows;
+
+#ifdef MATH_MATRIX_CHECK
+	if (!matf32_size_check(x0, n, 1) || ((NULL != xref) && !matf32_size_check(xref, n, 1)))
+		return MATH_SIZE_MISMATCH;
+#endif
+
+	// c = F x0 - G xref
+	for (uint16_t k = 0; k < nu; ++k)
+	{
+		float sum = 0;
+		for (uint16_t l = 0; l < n; ++l)
+		{
+			sum += mpc->F.p_data[k*n + l] * x0->p_data[l];
+			if (NULL != xref)
+				sum -= mpc->G.p_data[k*n + l] * xref->p_data[l];
+		}
+		mpc->c.p_data[k] = sum;
+	}
+
+	return MATH_SUCCESS;
+}
+
+
+quadprog_status_t
+mpc_condensed_solve(mpc_condensed_t* const mpc, const matf32_t* x0, const matf32_t* xref,
+	quadprog_workspace_t* const p_ws, matf32_t* const u)
+{
+	const uint16_t m = mpc->sys->input_dim;
+
+#ifdef MATH_MATRIX_CHECK
+	if (!matf32_size_check(u, m, 1))
+		return QP_SIZE_MISMATCH;
+#endif
+
+	if (MATH_SUCCESS != mpc_condensed_update_state(mpc, x0, xref))
+		return QP_SIZE_MISMATCH;
+
+	quadprog_status_t status = mpc->has_bounds ? quadprog(&mpc->qp, p_ws, &mpc->U) : quadprog_qp(&mpc->qp, p_ws, &mpc->U);
+
+	memcpy(u->p_data, mpc->U.p_data, m*sizeof(float));
+
+	return status;
+}
+
+
+// ====================================================================================================
+// Riccati recursion
+// ====================================================================================================
+err_status_t
+mpc_riccati_init(mpc_riccati_t* const ric, const sys_lti_t* const sys, uint16_t horizon, float* p_fwork)
+{
+	const uint16_t n = sys->state_dim;
+	const uint16_t m = sys->input_dim;
+
+	if (sys->is_continuous || (0 == horizon))
+		return MATH_ARGUMENT_ERROR;
+
+	ric->sys = sys;
+	ric->horizon = horizon;
+	ric->p_P = p_fwork;
+	p_fwork += (horizon + 1)*n*n;
+	ric->p_K = p_fwork;
+	p_fwork += horizon*m*n;
+	ric->p_U = p_fwork;
+	p_fwork += horizon*MATF32_SYM_SIZE(m);
+	ric->p_p = p_fwork;
+	p_fwork += (horizon + 1)*n;
+	ric->p_d = p_fwork;
+	p_fwork += horizon*m;
+	ric->p_work = p_fwork;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+mpc_riccati_factor(mpc_riccati_t* const ric, const matf32_t* Qx, const matf32_t* R, const matf32_t* P,
+	const float* p_dq, const float* p_dr)
+{
+	const uint16_t n = ric->sys->state_dim;
+	const uint16_t m = ric->sys->input_dim;
+	const uint16_t N = ric->horizon;
+	const float* A = ric->sys->A->p_data;
+	const float* B = ric->sys->B->p_data;
+
+	float* PA = ric->p_work;
+	float* PB = &PA[n*n];
+	float* L = &PB[n*m];
+	matf32_sym_t U;
+	matf32_t col;
+
+	// PN = P + diag(dqN)
+	float* Pk = &ric->p_P[N*n*n];
+	memcpy(Pk, P->p_data, n*n*sizeof(float));
+	if (NULL != p_dq)
+	{
+		for (uint16_t i = 0; i < n; ++i)
+			Pk[i*n + i] += p_dq[N*n + i];
+	}
+
+	for (int16_t k = N - 1; k >= 0; --k)
+	{
+		const float* Pn = &ric->p_P[(k + 1)*n*n];
+		float* K = &ric->p_K[k*m*n];
+		Pk = &ric->p_P[k*n*n];
+
+		// R + diag(drk) + B'Pk+1B = U'U
+		mpc_mul(Pn, A, n, n, n, PA);
+		mpc_mul(Pn, B, n, n, m, PB);
+		matf32_sym_init(&U, m, &ric->p_U[k*MATF32_SYM_SIZE(m)]);
+		for (uint16_t j = 0; j < m; ++j)
+		{
+			for (uint16_t i = 0; i <= j; ++i)
+			{
+				float sum = R->p_data[i*m + j] + (((i == j) && (NULL != p_dr)) ? p_dr[k*m + i] : 0);
+				for (uint16_t l = 0; l < n; ++l)
+					sum += B[l*m + i] * PB[l*m + j];
+				*matf32_sym_at(&U, i, j) = sum;
+			}
+		}
+
+		if (MATH_SUCCESS != matf32_sym_cholesky(&U))
+			return MATH_DECOMPOSITION_FAILURE;
+
+		// L = B'Pk+1A, K = -(U'U)^-1 L one column at a time
+		mpc_mul_tn(B, PA, n, m, n, L, n);
+		for (uint16_t j = 0; j < n; ++j)
+		{
+			float* t = &L[n*m];
+			for (uint16_t i = 0; i < m; ++i)
+				t[i] = L[i*n + j];
+			matf32_init(&col, m, 1, t);
+			matf32_sym_cholesky_solve(&U, &col, &col);
+			for (uint16_t i = 0; i < m; ++i)
+				K[i*n + j] = -t[i];
+		}
+
+		if (0 == k)
+			break;
+
+		// Pk = Qx + diag(dqk) + A'Pk+1A + L'K, symmetrized
+		mpc_mul_tn(A, PA, n, n, n, Pk, n);
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			for (uint16_t j = 0; j < n; ++j)
+			{
+				float sum = 0;
+				for (uint16_t l = 0; l < m; ++l)
+					sum += L[l*n + i] * K[l*n + j];
+				Pk[i*n + j] += sum + Qx->p_data[i*n + j];
+			}
+
+			if (NULL != p_dq)
+				Pk[i*n + i] += p_dq[k*n + i];
+		}
+
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			for (uint16_t j = i + 1; j < n; ++j)
+			{
+				float v = 0.5f*(Pk[i*n + j] + Pk[j*n + i]);
+				Pk[i*n + j] = v;
+				Pk[j*n + i] = v;
+			}
+		}
+	}
+
+	return MATH_SUCCESS;
+}
+
+
+void
+mpc_riccati_solve(mpc_riccati_t* const ric, const float* p_q, const float* p_r, const float* p_b, const float* p_x0,
+	float* p_x, float* p_u, float* p_lambda)
+{
+	const uint16_t n = ric->sys->state_dim;
+	const uint16_t m = ric->sys->input_dim;
+	const uint16_t N = ric->horizon;
+	const float* A = ric->sys->A->p_data;
+	const float* B = ric->sys->B->p_data;
+
+	float* h = ric->p_work;
+	float* t = &h[n];
+	matf32_sym_t U;
+	matf32_t tv;
+
+	// backward: h = Pk+1 bk + pk+1, dk = -(R + B'Pk+1B)^-1 (rk + B'h), pk = qk + A'h + Kk'(rk + B'h)
+	memcpy(&ric->p_p[N*n], &p_q[N*n], n*sizeof(float));
+	for (int16_t k = N - 1; k >= 0; --k)
+	{
+		const float* Pn = &ric->p_P[(k + 1)*n*n];
+		const float* pn = &ric->p_p[(k + 1)*n];
+		const float* K = &ric->p_K[k*m*n];
+		float* d = &ric->p_d[k*m];
+
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			float sum = pn[i];
+			if (NULL != p_b)
+			{
+				for (uint16_t j = 0; j < n; ++j)
+					sum += Pn[i*n + j] * p_b[k*n + j];
+			}
+			h[i] = sum;
+		}
+
+		for (uint16_t i = 0; i < m; ++i)
+		{
+			float sum = p_r[k*m + i];
+			for (uint16_t l = 0; l < n; ++l)
+				sum += B[l*m + i] * h[l];
+			t[i] = sum;
+		}
+
+		if (k > 0)
+		{
+			float* pk = &ric->p_p[k*n];
+			for (uint16_t j = 0; j < n; ++j)
+			{
+				float sum = p_q[k*n + j];
+				for (uint16_t l = 0; l < n; ++l)
+					sum += A[l*n + j] * h[l];
+				for (uint16_t l = 0; l < m; ++l)
+					sum += K[l*n + j] * t[l];
+				pk[j] = sum;
+			}
+		}
+
+		matf32_sym_init(&U, m, &ric->p_U[k*MATF32_SYM_SIZE(m)]);
+		matf32_init(&tv, m, 1, t);
+		matf32_sym_cholesky_solve(&U, &tv, &tv);
+		for (uint16_t i = 0; i < m; ++i)
+			d[i] = -t[i];
+	}
+
+	// forward: uk = Kk xk + dk, xk+1 = A xk + B uk + bk, lambdak+1 = Pk+1 xk+1 + pk+1
+	if (NULL != p_x0)
+		memcpy(p_x, p_x0, n*sizeof(float));
+	else
+		memset(p_x, 0, n*sizeof(float));
+
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		const float* x = &p_x[k*n];
+		float* u = &p_u[k*m];
+		float* xn = &p_x[(k + 1)*n];
+
+		mpc_mul(&ric->p_K[k*m*n], x, m, n, 1, u);
+		for (uint16_t i = 0; i < m; ++i)
+			u[i] += ric->p_d[k*m + i];
+
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			float sum = (NULL != p_b) ? p_b[k*n + i] : 0;
+			for (uint16_t j = 0; j < n; ++j)
+				sum += A[i*n + j] * x[j];
+			for (uint16_t j = 0; j < m; ++j)
+				sum += B[i*m + j] * u[j];
+			xn[i] = sum;
+		}
+
+		if (NULL != p_lambda)
+		{
+			const float* Pn = &ric->p_P[(k + 1)*n*n];
+			for (uint16_t i = 0; i < n; ++i)
+			{
+				float sum = ric->p_p[(k + 1)*n + i];
+				for (uint16_t j = 0; j < n; ++j)
+					sum += Pn[i*n + j] * xn[j];
+				p_lambda[(k + 1)*n + i] = sum;
+			}
+		}
+	}
+
+	if (NULL != p_lambda)
+		memset(p_lambda, 0, n*sizeof(float));
+}
+
+
+// ====================================================================================================
+// Sparse MPC (interior-point method on the Riccati recursion)
+// ====================================================================================================
+#define MPC_IPM_TOLERANCE       (1e-4)  /**< Tolerance of the primal and dual residuals, relative to the state size. */
+#define MPC_IPM_MU_TOLERANCE    (1e-6)  /**< Tolerance of the average complementarity. */
+#define MPC_IPM_DIVERGENCE      (1e8)   /**< Average complementarity taken as divergence (bounds that can not be met). */
+
+
+/**
+ * @brief   Element a of the stage k variables [uk; xk+1] of the stage-stacked vectors u (N x m) and x ((N + 1) x n).
+ */
+static inline float*
+mpc_stage_var(float* p_u, float* p_x, uint16_t k, uint16_t a, uint16_t m, uint16_t n)
+{
+	return (a < m) ? &p_u[k*m + a] : &p_x[(k + 1)*n + a - m];
+}
+
+
+/**
+ * @brief   Iteration vectors of mpc_sparse_solve, carved from mpc->p_work.
+ */
+typedef struct
+{
+	float* dx;      /**< (N + 1) x n */
+	float* lam;     /**< (N + 1) x n, multipliers of the Newton step */
+	float* q;       /**< (N + 1) x n */
+	float* b;       /**< (N + 1) x n, dynamics residual */
+	float* dq;      /**< (N + 1) x n */
+	float* du;      /**< N x m */
+	float* r;       /**< N x m */
+	float* dr;      /**< N x m */
+	float* sl;      /**< N x (m + n) for each of the following */
+	float* su;
+	float* zl;
+	float* zu;
+	float* dsl;
+	float* dsu;
+	float* dzl;
+	float* dzu;
+	float* cl;
+	float* cu;
+	float* rpl;
+	float* rpu;
+} mpc_ipm_vec_t;
+
+
+/**
+ * @brief   Newton step for the centering target sigma*mu and the corrections cl, cu: linear terms of the Riccati
+ * problem, its solution and the slack and multiplier steps.
+ */
+static void
+mpc_ipm_direction(mpc_sparse_t* const mpc, mpc_ipm_vec_t* v, const float* xref, float sigma_mu)
+{
+	const uint16_t n = mpc->sys->state_dim;
+	const uint16_t m = mpc->sys->input_dim;
+	const uint16_t N = mpc->horizon;
+	const uint16_t nk = m + n;
+
+	// gradient of the cost
+	for (uint16_t k = 1; k <= N; ++k)
+	{
+		const float* W = (k == N) ? mpc->P->p_data : mpc->Qx->p_data;
+		for (uint16_t i = 0; i < n; ++i)
+		{
+			float sum = 0;
+			for (uint16_t j = 0; j < n; ++j)
+				sum += W[i*n + j] * (mpc->p_x[k*n + j] - ((NULL != xref) ? xref[j] : 0));
+			v->q[k*n + i] = sum;
+		}
+	}
+	mpc_mul(mpc->p_u, mpc->R->p_data, N, m, m, v->r);
+
+	// bound terms a*(z*rp + sigma*mu - c)/s, a = -1 for lower and 1 for upper bounds
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		for (uint16_t a = 0; a < nk; ++a)
+		{
+			const uint16_t j = k*nk + a;
+			float* g = mpc_stage_var(v->r, v->q, k, a, m, n);
+
+			if (v->zl[j] > 0)
+				*g -= (v->zl[j]*v->rpl[j] + sigma_mu - v->cl[j]) / v->sl[j];
+			if (v->zu[j] > 0)
+				*g += (v->zu[j]*v->rpu[j] + sigma_mu - v->cu[j]) / v->su[j];
+		}
+	}
+
+	mpc_riccati_solve(&mpc->riccati, v->q, v->r, v->b, NULL, v->dx, v->du, v->lam);
+
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		for (uint16_t a = 0; a < nk; ++a)
+		{
+			const uint16_t j = k*nk + a;
+			const float dvj = *mpc_stage_var(v->du, v->dx, k, a, m, n);
+
+			if (v->zl[j] > 0)
+			{
+				v->dsl[j] = -v->rpl[j] + dvj;
+				v->dzl[j] = (-(v->sl[j]*v->zl[j] - sigma_mu + v->cl[j]) - v->zl[j]*v->dsl[j]) / v->sl[j];
+			}
+			if (v->zu[j] > 0)
+			{
+				v->dsu[j] = -v->rpu[j] - dvj;
+				v->dzu[j] = (-(v->su[j]*v->zu[j] - sigma_mu + v->cu[j]) - v->zu[j]*v->dsu[j]) / v->su[j];
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief   Largest step in [0, 1] keeping the bounded slacks and multipliers nonnegative, and the average
+ * complementarity at that step.
+ */
+static float
+mpc_ipm_step_length(const mpc_ipm_vec_t* v, uint16_t nv, uint16_t mi, float* p_mu)
+{
+	float alpha = 1;
+
+	for (uint16_t j = 0; j < nv; ++j)
+	{
+		if (v->zl[j] > 0)
+		{
+			if (v->dsl[j] < 0) alpha = fminf(alpha, -v->sl[j]/v->dsl[j]);
+			if (v->dzl[j] < 0) alpha = fminf(alpha, -v->zl[j]/v->dzl[j]);
+		}
+		if (v->zu[j] > 0)
+		{
+			if (v->dsu[j] < 0) alpha = fminf(alpha, -v->su[j]/v->dsu[j]);
+			if (v->dzu[j] < 0) alpha = fminf(alpha, -v->zu[j]/v->dzu[j]);
+		}
+	}
+
+	if (NULL != p_mu)
+	{
+		float gap = 0;
+		for (uint16_t j = 0; j < nv; ++j)
+		{
+			if (v->zl[j] > 0)
+				gap += (v->sl[j] + alpha*v->dsl[j]) * (v->zl[j] + alpha*v->dzl[j]);
+			if (v->zu[j] > 0)
+				gap += (v->su[j] + alpha*v->dsu[j]) * (v->zu[j] + alpha*v->dzu[j]);
+		}
+		*p_mu = (mi > 0) ? gap/mi : 0;
+	}
+
+	return alpha;
+}
+
+
+err_status_t
+mpc_sparse_init(mpc_sparse_t* const mpc, const sys_lti_t* const sys, uint16_t horizon, const matf32_t* Qx,
+	const matf32_t* R, const matf32_t* P, const float* p_lb, const float* p_ub, float* p_fwork)
+{
+	const uint16_t n = sys->state_dim;
+	const uint16_t m = sys->input_dim;
+
+	err_status_t status = mpc_riccati_init(&mpc->riccati, sys, horizon, p_fwork);
+	if (MATH_SUCCESS != status)
+		return status;
+
+#ifdef MATH_MATRIX_CHECK
+	if (!matf32_size_check(Qx, n, n) || !matf32_size_check(R, m, m) || ((NULL != P) && !matf32_size_check(P, n, n)))
+		return MATH_SIZE_MISMATCH;
+#endif
+
+	mpc->sys = sys;
+	mpc->horizon = horizon;
+	mpc->Qx = Qx;
+	mpc->R = R;
+	mpc->P = (NULL != P) ? P : Qx;
+	mpc->p_lb = p_lb;
+	mpc->p_ub = p_ub;
+	mpc->iter = 0;
+
+	p_fwork += MPC_RICCATI_FWORK(n, m, horizon);
+	mpc->p_x = p_fwork;
+	p_fwork += (horizon + 1)*n;
+	mpc->p_lambda = p_fwork;
+	p_fwork += (horizon + 1)*n;
+	mpc->p_u = p_fwork;
+	p_fwork += horizon*m;
+	mpc->p_work = p_fwork;
+
+	return MATH_SUCCESS;
+}
+
+
+quadprog_status_t
+mpc_sparse_solve(mpc_sparse_t* const mpc, const matf32_t* x0, const matf32_t* xref, matf32_t* const u)
+{
+	const uint16_t n = mpc->sys->state_dim;
+	const uint16_t m = mpc->sys->input_dim;
+	const uint16_t N = mpc->horizon;
+	const uint16_t nk = m + n;
+	const uint16_t nv = N*nk;
+	const float* A = mpc->sys->A->p_data;
+	const float* B = mpc->sys->B->p_data;
+	const float* r_ref = (NULL != xref) ? xref->p_data : NULL;
+
+#ifdef MATH_MATRIX_CHECK
+	if (!matf32_size_check(x0, n, 1) || ((NULL != xref) && !matf32_size_check(xref, n, 1))
+		|| !matf32_size_check(u, m, 1))
+		return QP_SIZE_MISMATCH;
+#endif
+
+	mpc_ipm_vec_t v;
+	float* p_w = mpc->p_work;
+	float** nx_vec[] = {&v.dx, &v.lam, &v.q, &v.b, &v.dq};
+	float** nu_vec[] = {&v.du, &v.r, &v.dr};
+	float** nv_vec[] = {&v.sl, &v.su, &v.zl, &v.zu, &v.dsl, &v.dsu, &v.dzl, &v.dzu, &v.cl, &v.cu, &v.rpl, &v.rpu};
+
+	for (uint16_t i = 0; i < sizeof(nx_vec)/sizeof(nx_vec[0]); ++i, p_w += (N + 1)*n)
+		*nx_vec[i] = p_w;
+	for (uint16_t i = 0; i < sizeof(nu_vec)/sizeof(nu_vec[0]); ++i, p_w += N*m)
+		*nu_vec[i] = p_w;
+	for (uint16_t i = 0; i < sizeof(nv_vec)/sizeof(nv_vec[0]); ++i, p_w += nv)
+		*nv_vec[i] = p_w;
+
+	// start from the free response, slacks and multipliers of the finite bounds at max(1, slack) and 1
+	memset(mpc->p_u, 0, N*m*sizeof(float));
+	memset(mpc->p_lambda, 0, (N + 1)*n*sizeof(float));
+	memcpy(mpc->p_x, x0->p_data, n*sizeof(float));
+	for (uint16_t k = 0; k < N; ++k)
+		mpc_mul(A, &mpc->p_x[k*n], n, n, 1, &mpc->p_x[(k + 1)*n]);
+
+	uint16_t mi = 0;
+	float scale = 1;
+	for (uint16_t i = 0; i < n; ++i)
+		scale = fmaxf(scale, fabsf(x0->p_data[i]));
+
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		for (uint16_t a = 0; a < nk; ++a)
+		{
+			const uint16_t j = k*nk + a;
+			const float vj = *mpc_stage_var(mpc->p_u, mpc->p_x, k, a, m, n);
+			const float lb = (NULL != mpc->p_lb) ? mpc->p_lb[a] : -INFINITY;
+			const float ub = (NULL != mpc->p_ub) ? mpc->p_ub[a] : INFINITY;
+
+			v.zl[j] = isfinite(lb) ? 1 : 0;
+			v.zu[j] = isfinite(ub) ? 1 : 0;
+			v.sl[j] = isfinite(lb) ? fmaxf(1, vj - lb) : 1;
+			v.su[j] = isfinite(ub) ? fmaxf(1, ub - vj) : 1;
+			v.dsl[j] = v.dsu[j] = v.dzl[j] = v.dzu[j] = 0;
+			mi += isfinite(lb) + isfinite(ub);
+		}
+	}
+
+	quadprog_status_t status = QP_MAX_ITERATIONS;
+
+	for (mpc->iter = 0; mpc->iter < MAX_ITERATION_COUNT_IPM; ++mpc->iter)
+	{
+		float r_prim = 0;
+		float r_dual = 0;
+		float gap = 0;
+
+		// dynamics residual bk = A xk + B uk - xk+1
+		for (uint16_t k = 0; k < N; ++k)
+		{
+			for (uint16_t i = 0; i < n; ++i)
+			{
+				float sum = -mpc->p_x[(k + 1)*n + i];
+				for (uint16_t j = 0; j < n; ++j)
+					sum += A[i*n + j] * mpc->p_x[k*n + j];
+				for (uint16_t j = 0; j < m; ++j)
+					sum += B[i*m + j] * mpc->p_u[k*m + j];
+				v.b[k*n + i] = sum;
+				r_prim = fmaxf(r_prim, fabsf(sum));
+			}
+		}
+
+		// bound residuals lb - v + sl, v - ub + su, and the diagonal weights z/s
+		for (uint16_t k = 0; k < N; ++k)
+		{
+			for (uint16_t a = 0; a < nk; ++a)
+			{
+				const uint16_t j = k*nk + a;
+				const float vj = *mpc_stage_var(mpc->p_u, mpc->p_x, k, a, m, n);
+				float* d = mpc_stage_var(v.dr, v.dq, k, a, m, n);
+
+				*d = 0;
+				v.rpl[j] = v.rpu[j] = 0;
+				v.cl[j] = v.cu[j] = 0;
+				if (v.zl[j] > 0)
+				{
+					v.rpl[j] = mpc->p_lb[a] - vj + v.sl[j];
+					*d += v.zl[j]/v.sl[j];
+					gap += v.sl[j]*v.zl[j];
+					r_prim = fmaxf(r_prim, fabsf(v.rpl[j]));
+				}
+				if (v.zu[j] > 0)
+				{
+					v.rpu[j] = vj - mpc->p_ub[a] + v.su[j];
+					*d += v.zu[j]/v.su[j];
+					gap += v.su[j]*v.zu[j];
+					r_prim = fmaxf(r_prim, fabsf(v.rpu[j]));
+				}
+			}
+		}
+
+		// stationarity: R uk + B'lambdak+1 + zu - zl, Wk (xk - xref) + A'lambdak+1 - lambdak + zu - zl
+		for (uint16_t k = 0; k < N; ++k)
+		{
+			for (uint16_t a = 0; a < nk; ++a)
+			{
+				const uint16_t j = k*nk + a;
+				float sum = v.zu[j] - v.zl[j];
+
+				if (a < m)
+				{
+					for (uint16_t l = 0; l < m; ++l)
+						sum += mpc->R->p_data[a*m + l] * mpc->p_u[k*m + l];
+					for (uint16_t l = 0; l < n; ++l)
+						sum += B[l*m + a] * mpc->p_lambda[(k + 1)*n + l];
+				}
+				else
+				{
+					const uint16_t i = a - m;
+					const float* W = (k == N - 1) ? mpc->P->p_data : mpc->Qx->p_data;
+					for (uint16_t l = 0; l < n; ++l)
+						sum += W[i*n + l] * (mpc->p_x[(k + 1)*n + l] - ((NULL != r_ref) ? r_ref[l] : 0));
+					if (k < N - 1)
+					{
+						for (uint16_t l = 0; l < n; ++l)
+							sum += A[l*n + i] * mpc->p_lambda[(k + 2)*n + l];
+					}
+					sum -= mpc->p_lambda[(k + 1)*n + i];
+				}
+				r_dual = fmaxf(r_dual, fabsf(sum));
+			}
+		}
+
+		// the multipliers grow without bound when the bounds can not be met together with the dynamics
+		const float mu = (mi > 0) ? gap/mi : 0;
+		if (!isfinite(r_prim + r_dual + mu) || (mu > MPC_IPM_DIVERGENCE))
+		{
+			status = QP_INFEASIBLE;
+			break;
+		}
+
+		if ((r_prim <= MPC_IPM_TOLERANCE*scale) && (r_dual <= MPC_IPM_TOLERANCE*scale) && (mu <= MPC_IPM_MU_TOLERANCE))
+		{
+			status = QP_SUCESS;
+			break;
+		}
+
+		if (MATH_SUCCESS != mpc_riccati_factor(&mpc->riccati, mpc->Qx, mpc->R, mpc->P, v.dq, v.dr))
+		{
+			status = QP_NOT_CONVEX;
+			break;
+		}
+
+		// predictor, centering sigma = (mu_aff/mu)^3 and corrector with the second order terms
+		float mu_aff = 0;
+		float sigma = 0;
+		mpc_ipm_direction(mpc, &v, r_ref, 0);
+		if (mi > 0)
+		{
+			mpc_ipm_step_length(&v, nv, mi, &mu_aff);
+			sigma = powf(mu_aff/mu, 3);
+			for (uint16_t j = 0; j < nv; ++j)
+			{
+				v.cl[j] = v.dsl[j]*v.dzl[j];
+				v.cu[j] = v.dsu[j]*v.dzu[j];
+			}
+			mpc_ipm_direction(mpc, &v, r_ref, sigma*mu);
+		}
+
+		float alpha = mpc_ipm_step_length(&v, nv, mi, NULL);
+		if (alpha < 1)
+			alpha *= fmaxf(0.99f, 1 - mu);
+
+		for (uint16_t k = 0; k < N*m; ++k)
+			mpc->p_u[k] += alpha*v.du[k];
+		for (uint16_t k = n; k < (N + 1)*n; ++k)
+		{
+			mpc->p_x[k] += alpha*v.dx[k];
+			mpc->p_lambda[k] += alpha*(v.lam[k] - mpc->p_lambda[k]);
+		}
+		for (uint16_t j = 0; j < nv; ++j)
+		{
+			v.sl[j] += alpha*v.dsl[j];
+			v.zl[j] += alpha*v.dzl[j];
+			v.su[j] += alpha*v.dsu[j];
+			v.zu[j] += alpha*v.dzu[j];
+		}
+	}
+
+	memcpy(u->p_data, mpc->p_u, m*sizeof(float));
+
+	return status;
+}
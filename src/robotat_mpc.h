@@ -0,0 +1,289 @@
+/**
+ * @file robotat_mpc.h
+ * @brief   Linear model predictive control.
+ *
+ * Condensed formulation: for the discrete time model x[k+1] = A x[k] + B u[k] and horizon N, the predicted states
+ * X = [x1; ...; xN] are eliminated with X = Phi x0 + Gamma U (U = [u0; ...; uN-1]), and
+ *
+ *      J = 1/2 sum_{k=1..N} (xk - xref)' Qk (xk - xref) + 1/2 sum_{k=0..N-1} uk' R uk,  Qk = Qx (k < N), QN = P
+ *
+ * becomes the dense QP 1/2 U'HU + c'U with H = Gamma' Qbar Gamma + Rbar and c = F x0 - G xref. H, F and G only
+ * depend on the model and the weights, so each tick only recomputes c (O(N m n)).
+ *
+ * H is built from cached blocks A^k B, Qx A^k B and P A^k B: its block (i, j) only depends on i - j and on how
+ * far i is from the end of the horizon, so each block diagonal is filled by a running sum, in O(N^2 m^2 n) instead
+ * of forming Gamma' Qbar Gamma. F and G are built with the backward recursions Pi_i = Qx + A' Pi_i+1 A and
+ * Z_i = Qx + A' Z_i+1 (Pi_N-1 = Z_N-1 = P).
+ *
+ */
+
+#ifndef ROBOTAT_MPC_H_
+#define ROBOTAT_MPC_H_
+
+#include "robotat_control.h"
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+
+/** float storage of a condensed MPC with n states, m inputs and horizon N. */
+#define MPC_CONDENSED_FWORK(n, m, N)    (3*((N)*(m))*((N)*(m)) + 5*(N)*(m)*(n) + 4*(N)*(m) + 4*(n)*(n) + (m)*(m) + (n))
+
+/** float storage of the Riccati recursion with n states, m inputs and horizon N. */
+#define MPC_RICCATI_FWORK(n, m, N)      (((N) + 1)*(n)*(n) + (N)*(m)*(n) + (N)*MATF32_SYM_SIZE(m) + ((N) + 1)*(n) \
+                                        + (N)*(m) + (n)*(n) + 2*(n)*(m) + (n) + (m))
+
+/** float storage of a sparse (Riccati based) MPC with n states, m inputs and horizon N. */
+#define MPC_SPARSE_FWORK(n, m, N)       (MPC_RICCATI_FWORK(n, m, N) + 7*((N) + 1)*(n) + 4*(N)*(m) \
+                                        + 12*(N)*((n) + (m)))
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief   Condensed linear MPC data structure.
+ */
+typedef struct
+{
+    const sys_lti_t* sys;   /**< Discrete time model. */
+    uint16_t horizon;       /**< Prediction horizon N. */
+    const matf32_t* Qx;     /**< State weight, n x n. */
+    const matf32_t* R;      /**< Input weight, m x m. */
+    const matf32_t* P;      /**< Terminal state weight, n x n. */
+    bool has_bounds;        /**< Whether input bounds are imposed. */
+    matf32_t H;             /**< Hessian, Nm x Nm. */
+    matf32_t F;             /**< Gradient term of the initial state, Nm x n. */
+    matf32_t G;             /**< Gradient term of the state reference, Nm x n. */
+    matf32_t c;             /**< Gradient, Nm x 1. */
+    matf32_t U;             /**< Input sequence of the last solve, Nm x 1. */
+    matf32_t Ain;           /**< Input bounds as [I; -I] U <= [umax; -umin], 2Nm x Nm. */
+    matf32_t bin;           /**< 2Nm x 1. */
+    float* p_AkB;           /**< Cache of A^k B, k = 0..N-1, n x m blocks. */
+    float* p_QAkB;          /**< Cache of Qx A^k B. */
+    float* p_PAkB;          /**< Cache of P A^k B. */
+    float* p_work;          /**< 4n^2 + m^2 + n. */
+    quadprog_t qp;          /**< QP over U. */
+} mpc_condensed_t;
+
+
+/**
+ * @brief   Riccati recursion for the stage-wise linear quadratic problem
+ *
+ *      min sum_{k=0..N-1} (1/2 xk'Qk xk + qk'xk + 1/2 uk'Rk uk + rk'uk) + 1/2 xN'QN xN + qN'xN
+ *      s.t. x[k+1] = A x[k] + B u[k] + b[k], x[0] given,
+ *
+ * with Qk = Qx + diag(dqk) (QN = P + diag(dqN)) and Rk = R + diag(drk). The factorization (backward sweep over
+ * Pk, the feedback gains Kk and the Cholesky factors of R + B'Pk+1B) only depends on the quadratic terms, the solve
+ * (backward sweep over the linear terms and forward simulation) can be repeated for several right hand sides, e.g.
+ * the predictor and corrector of an interior-point method. Both cost O(N (n^3 + n^2 m + m^3)).
+ */
+typedef struct
+{
+    const sys_lti_t* sys;   /**< Discrete time model. */
+    uint16_t horizon;       /**< Horizon N. */
+    float* p_P;             /**< Cost-to-go Hessians Pk, k = 0..N, n x n each. */
+    float* p_K;             /**< Feedback gains Kk, m x n each. */
+    float* p_U;             /**< Packed Cholesky factors of R + B'Pk+1B. */
+    float* p_p;             /**< Cost-to-go gradients pk, k = 0..N. */
+    float* p_d;             /**< Feedforward terms dk. */
+    float* p_work;          /**< n^2 + 2nm + n + m. */
+} mpc_riccati_t;
+
+
+/**
+ * @brief   Sparse MPC data structure: primal-dual interior-point method over the stage-wise variables whose
+ * Newton systems are solved by the Riccati recursion. Inputs and states have box constraints.
+ *
+ *      min 1/2 sum_{k=1..N} (xk - xref)' Qk (xk - xref) + 1/2 sum_{k=0..N-1} uk' R uk
+ *      s.t. x[k+1] = A x[k] + B u[k], umin <= uk <= umax, xmin <= xk <= xmax (k = 1..N).
+ */
+typedef struct
+{
+    const sys_lti_t* sys;   /**< Discrete time model. */
+    uint16_t horizon;       /**< Prediction horizon N. */
+    const matf32_t* Qx;     /**< State weight, n x n. */
+    const matf32_t* R;      /**< Input weight, m x m. */
+    const matf32_t* P;      /**< Terminal state weight, n x n. */
+    const float* p_lb;      /**< Lower bounds of [umin; xmin], -INFINITY entries for none, or NULL. */
+    const float* p_ub;      /**< Upper bounds of [umax; xmax], INFINITY entries for none, or NULL. */
+    mpc_riccati_t riccati;  /**< Riccati factorization. */
+    float* p_x;             /**< States x0..xN of the last solve. */
+    float* p_u;             /**< Inputs u0..uN-1 of the last solve. */
+    float* p_lambda;        /**< Multipliers of the dynamics. */
+    float* p_work;          /**< Iteration storage. */
+    uint16_t iter;          /**< Iterations of the last solve. */
+} mpc_sparse_t;
+
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+
+/**
+ * @brief   Initializes a condensed MPC and builds its QP (see mpc_condensed_update_model).
+ *
+ * @param[in, out]  mpc         MPC data structure.
+ * @param[in]       sys         Discrete time LTI model.
+ * @param[in]       horizon     Prediction horizon N.
+ * @param[in]       Qx          State weight.
+ * @param[in]       R           Input weight, positive definite.
+ * @param[in]       P           Terminal state weight, NULL to use Qx.
+ * @param[in]       umin        Lower input bound (m x 1), NULL if inputs are not bounded. Entries can be -INFINITY.
+ * @param[in]       umax        Upper input bound (m x 1), NULL if inputs are not bounded. Entries can be INFINITY.
+ * @param[in]       p_fwork     Storage, MPC_CONDENSED_FWORK(n, m, N) elements.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_ARGUMENT_ERROR :   LTI system model is not discrete time, horizon is 0 or only one bound given.
+ */
+err_status_t
+mpc_condensed_init(mpc_condensed_t* const mpc, const sys_lti_t* const sys, uint16_t horizon, const matf32_t* Qx,
+    const matf32_t* R, const matf32_t* P, const matf32_t* umin, const matf32_t* umax, float* p_fwork);
+
+
+/**
+ * @brief   Rebuilds the A^k B caches, H, F and G. Call it after A, B or the weights change (in place).
+ *
+ * @param[in, out]  mpc     MPC data structure.
+ *
+ * @return  None.
+ */
+void
+mpc_condensed_update_model(mpc_condensed_t* const mpc);
+
+
+/**
+ * @brief   Recomputes the gradient c = F x0 - G xref for the current state.
+ *
+ * @param[in, out]  mpc     MPC data structure.
+ * @param[in]       x0      Current state.
+ * @param[in]       xref    State reference, NULL for the origin.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ */
+err_status_t
+mpc_condensed_update_state(mpc_condensed_t* const mpc, const matf32_t* x0, const matf32_t* xref);
+
+
+/**
+ * @brief   Updates the gradient, solves the QP and returns the first input of the optimal sequence. Bounded
+ * problems go through quadprog (bound constrained solver), unbounded ones through quadprog_qp.
+ *
+ * @param[in, out]  mpc     MPC data structure, the full sequence is left in mpc->U.
+ * @param[in]       x0      Current state.
+ * @param[in]       xref    State reference, NULL for the origin.
+ * @param[in, out]  p_ws    Solver workspace for Nm variables and 2Nm inequalities.
+ * @param[out]      u       First input u0.
+ *
+ * @return  Solver status.
+ */
+quadprog_status_t
+mpc_condensed_solve(mpc_condensed_t* const mpc, const matf32_t* x0, const matf32_t* xref,
+    quadprog_workspace_t* const p_ws, matf32_t* const u);
+
+
+/**
+ * @brief   Initializes the Riccati recursion.
+ *
+ * @param[in, out]  ric         Riccati data structure.
+ * @param[in]       sys         Discrete time LTI model.
+ * @param[in]       horizon     Horizon N.
+ * @param[in]       p_fwork     Storage, MPC_RICCATI_FWORK(n, m, N) elements.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_ARGUMENT_ERROR :   LTI system model is not discrete time or horizon is 0.
+ */
+err_status_t
+mpc_riccati_init(mpc_riccati_t* const ric, const sys_lti_t* const sys, uint16_t horizon, float* p_fwork);
+
+
+/**
+ * @brief   Backward sweep over the quadratic terms.
+ *
+ * @param[in, out]  ric     Riccati data structure.
+ * @param[in]       Qx      State weight.
+ * @param[in]       R       Input weight.
+ * @param[in]       P       Terminal state weight.
+ * @param[in]       p_dq    Diagonal added to the state weights, (N + 1) x n (stage 0 unused), or NULL.
+ * @param[in]       p_dr    Diagonal added to the input weights, N x m, or NULL.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_DECOMPOSITION_FAILURE :    Some R + B'Pk+1B is not positive definite.
+ */
+err_status_t
+mpc_riccati_factor(mpc_riccati_t* const ric, const matf32_t* Qx, const matf32_t* R, const matf32_t* P,
+    const float* p_dq, const float* p_dr);
+
+
+/**
+ * @brief   Solves the problem factored by mpc_riccati_factor for the given linear terms.
+ *
+ * @param[in, out]  ric         Riccati data structure.
+ * @param[in]       p_q         State gradients, (N + 1) x n (stage 0 unused).
+ * @param[in]       p_r         Input gradients, N x m.
+ * @param[in]       p_b         Dynamics offsets, N x n, or NULL.
+ * @param[in]       p_x0        Initial state, n, or NULL for the origin.
+ * @param[out]      p_x         States x0..xN, (N + 1) x n.
+ * @param[out]      p_u         Inputs, N x m.
+ * @param[out]      p_lambda    Multipliers of the dynamics, lambda[k] = Pk xk + pk (k = 1..N), (N + 1) x n, or NULL.
+ *
+ * @return  None.
+ */
+void
+mpc_riccati_solve(mpc_riccati_t* const ric, const float* p_q, const float* p_r, const float* p_b, const float* p_x0,
+    float* p_x, float* p_u, float* p_lambda);
+
+
+/**
+ * @brief   Initializes a sparse MPC.
+ *
+ * @param[in, out]  mpc         MPC data structure.
+ * @param[in]       sys         Discrete time LTI model.
+ * @param[in]       horizon     Prediction horizon N.
+ * @param[in]       Qx          State weight.
+ * @param[in]       R           Input weight, positive definite.
+ * @param[in]       P           Terminal state weight, NULL to use Qx.
+ * @param[in]       p_lb        Lower bounds [umin; xmin] (m + n elements) or NULL. Entries can be -INFINITY.
+ * @param[in]       p_ub        Upper bounds [umax; xmax] (m + n elements) or NULL. Entries can be INFINITY.
+ * @param[in]       p_fwork     Storage, MPC_SPARSE_FWORK(n, m, N) elements.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_ARGUMENT_ERROR :   LTI system model is not discrete time or horizon is 0.
+ */
+err_status_t
+mpc_sparse_init(mpc_sparse_t* const mpc, const sys_lti_t* const sys, uint16_t horizon, const matf32_t* Qx,
+    const matf32_t* R, const matf32_t* P, const float* p_lb, const float* p_ub, float* p_fwork);
+
+
+/**
+ * @brief   Solves the sparse MPC problem with a Mehrotra predictor-corrector interior-point method. Every
+ * iteration factors the Riccati recursion once (the bound multipliers enter as diagonal weights) and solves it for
+ * the predictor and the corrector.
+ *
+ * @param[in, out]  mpc     MPC data structure, the trajectories are left in mpc->p_x, mpc->p_u.
+ * @param[in]       x0      Current state.
+ * @param[in]       xref    State reference, NULL for the origin.
+ * @param[out]      u       First input u0.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_SIZE_MISMATCH :  Matrix size check failed.
+ *              QP_NOT_CONVEX :     The Riccati recursion failed (R not positive definite).
+ *              QP_INFEASIBLE :     The bounds can not be met, the multipliers diverged.
+ *              QP_MAX_ITERATIONS : MAX_ITERATION_COUNT_IPM iterations reached, u holds the last iterate.
+ */
+quadprog_status_t
+mpc_sparse_solve(mpc_sparse_t* const mpc, const matf32_t* x0, const matf32_t* xref, matf32_t* const u);
+
+
+#endif /* ROBOTAT_MPC_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file robotat_parallel.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "robotat_parallel.h"
+
+#ifdef PARALLEL_PTHREAD
+#include <pthread.h>
+
+
+/**
+ * @brief Arguments of a worker thread.
+ */
+typedef struct
+{
+    void (*task)(void*, uint16_t, uint16_t);
+    void* p_arg;
+    uint16_t worker;
+    uint16_t num_workers;
+} parallel_thread_arg_t;
+
+
+static void*
+parallel_thread(void* p_arg)
+{
+    parallel_thread_arg_t* p = (parallel_thread_arg_t*) p_arg;
+    p->task(p->p_arg, p->worker, p->num_workers);
+
+    return NULL;
+}
+#endif
+
+
+void
+parallel_run(void (*task)(void*, uint16_t, uint16_t), void* p_arg, uint16_t num_workers)
+{
+#ifdef PARALLEL_PTHREAD
+    pthread_t threads[PARALLEL_MAX_WORKERS];
+    parallel_thread_arg_t args[PARALLEL_MAX_WORKERS];
+    bool started[PARALLEL_MAX_WORKERS];
+
+    for (uint16_t w = 1; w < num_workers; ++w)
+    {
+        args[w].task = task;
+        args[w].p_arg = p_arg;
+        args[w].worker = w;
+        args[w].num_workers = num_workers;
+        started[w] = (0 == pthread_create(&threads[w], NULL, parallel_thread, &args[w]));
+    }
+
+    task(p_arg, 0, num_workers);
+
+    // a worker that failed to start is run here instead
+    for (uint16_t w = 1; w < num_workers; ++w)
+    {
+        if (started[w])
+        {
+            pthread_join(threads[w], NULL);
+        }
+        else
+        {
+            task(p_arg, w, num_workers);
+        }
+    }
+#else
+    for (uint16_t w = 0; w < num_workers; ++w)
+    {
+        task(p_arg, w, num_workers);
+    }
+#endif
+}
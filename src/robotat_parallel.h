@@ -0,0 +1,51 @@
+/**
+ * @file robotat_parallel.h
+ *
+ * Fork/join of a fixed number of workers over a shared task, used by quadprog_batch and by the sampling filters
+ * of robotat_control and robotat_pf.
+ *
+ * The workers run as POSIX threads when the library is built with PARALLEL_PTHREAD defined (and linked with
+ * -pthread); by default, or on an RTOS, they run one after the other in the calling thread, so a task must give
+ * the same result either way.
+ *
+ */
+
+#ifndef ROBOTAT_PARALLEL_H_
+#define ROBOTAT_PARALLEL_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+#define PARALLEL_MAX_WORKERS    (16)    /**< Maximum number of workers of parallel_run. */
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+
+/**
+ * @brief   Runs task(p_arg, w, num_workers) for every worker w in [0, num_workers), the calling thread running
+ * w = 0. With PARALLEL_PTHREAD the others run as POSIX threads, a task whose thread fails to start runs in the
+ * calling thread.
+ *
+ * @param[in]       task            Work of worker w out of num_workers, usually a static block of the data.
+ * @param[in, out]  p_arg           Argument shared by the workers.
+ * @param[in]       num_workers     Number of workers, at most PARALLEL_MAX_WORKERS.
+ *
+ * @return  None.
+ */
+void
+parallel_run(void (*task)(void*, uint16_t, uint16_t), void* p_arg, uint16_t num_workers);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBOTAT_PARALLEL_H_
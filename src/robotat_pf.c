@@ -0,0 +1,594 @@
+#include "robotat_pf.h"
+
+// ====================================================================================================
+// Random number generation
+// ====================================================================================================
+static inline uint32_t
+rotl(uint32_t x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+
+void
+pf_rng_seed(pf_rng_t* const rng, uint32_t seed)
+{
+	// splitmix32 spreads the seed over the four words, the state is never all zero
+	for (uint16_t i = 0; i < 4; ++i)
+	{
+		uint32_t z = (seed += 0x9E3779B9u);
+		z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+		z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+		rng->s[i] = z ^ (z >> 16);
+	}
+	if ((rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]) == 0)
+		rng->s[0] = 1;
+
+	rng->has_spare = false;
+}
+
+
+uint32_t
+pf_rng_next(pf_rng_t* const rng)
+{
+	uint32_t* const s = rng->s;
+	const uint32_t result = s[0] + s[3];
+	const uint32_t t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+
+	return result;
+}
+
+
+float
+pf_rng_uniform(pf_rng_t* const rng)
+{
+	return (float)(pf_rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+
+float
+pf_rng_normal(pf_rng_t* const rng)
+{
+	if (rng->has_spare)
+	{
+		rng->has_spare = false;
+		return rng->normal_spare;
+	}
+
+	float u, v, s;
+	do
+	{
+		u = 2 * pf_rng_uniform(rng) - 1;
+		v = 2 * pf_rng_uniform(rng) - 1;
+		s = u * u + v * v;
+	} while ((s >= 1) || (s == 0));
+
+	s = sqrtf(-2 * logf(s) / s);
+	rng->normal_spare = v * s;
+	rng->has_spare = true;
+
+	return u * s;
+}
+
+
+// ====================================================================================================
+// Auxiliary routines
+// ====================================================================================================
+
+/**
+ * @brief   Adds F * S' * z, z ~ N(0, I), to every particle. S is a packed upper Cholesky factor.
+ */
+static void
+pf_add_noise(pf_info_t* const pf, const matf32_t* F, const matf32_sym_t* S)
+{
+	const uint16_t n = pf->sys->state_dim;
+	const uint16_t N = pf->num_particles;
+	const uint16_t dim_w = S->num_rows;
+	float z[MAX_VEC_SIZE];
+	float w[MAX_VEC_SIZE];
+
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		for (uint16_t r = 0; r < dim_w; ++r)
+			z[r] = pf_rng_normal(&pf->rng);
+
+		// w = S' * z
+		for (uint16_t i = 0; i < dim_w; ++i)
+		{
+			float sum = 0;
+			for (uint16_t r = 0; r <= i; ++r)
+				sum += S->p_data[matf32_sym_idx(r, i)] * z[r];
+			w[i] = sum;
+		}
+
+		for (uint16_t j = 0; j < n; ++j)
+		{
+			float sum = 0;
+			if (NULL == F)
+				sum = w[j];
+			else
+			{
+				for (uint16_t i = 0; i < dim_w; ++i)
+					sum += F->p_data[j*dim_w + i] * w[i];
+			}
+			pf->p_x[j*N + k] += sum;
+		}
+	}
+}
+
+
+/**
+ * @brief   xhat = sum of w_k x_k.
+ */
+static void
+pf_mean(pf_info_t* const pf)
+{
+	const uint16_t N = pf->num_particles;
+
+	for (uint16_t i = 0; i < pf->sys->state_dim; ++i)
+	{
+		const float* const row = &pf->p_x[i*N];
+		float sum = 0;
+		for (uint16_t k = 0; k < N; ++k)
+			sum += pf->p_w[k] * row[k];
+		pf->xhat->p_data[i] = sum;
+	}
+}
+
+
+/**
+ * @brief   Arguments shared by the particle workers, worker w takes the particles [first(w), first(w + 1)).
+ */
+typedef struct
+{
+	pf_info_t* pf;
+	const matf32_t* inputs;
+	const matf32_t* measurements;
+	float u;                                    /**< Offset of the systematic resampling comb. */
+	float part[PARALLEL_MAX_WORKERS];           /**< Largest log-likelihood, or weight sum, of each block. */
+	err_status_t status[PARALLEL_MAX_WORKERS];
+} pf_task_arg_t;
+
+
+static inline uint16_t
+pf_block_first(const pf_info_t* const pf, uint16_t worker, uint16_t num_workers)
+{
+	return (uint32_t)worker * pf->num_particles / num_workers;
+}
+
+
+/**
+ * @brief   x_k = f(x_k, u) for the particles of the block, one model call each.
+ */
+static void
+pf_dynamics_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+	pf_task_arg_t* const p = (pf_task_arg_t*) p_arg;
+	pf_info_t* const pf = p->pf;
+	const uint16_t n = pf->sys->state_dim;
+	const uint16_t N = pf->num_particles;
+	float x_data[MAX_VEC_SIZE];
+	float f_data[MAX_VEC_SIZE];
+	matf32_t x, f;
+	matf32_init(&x, n, 1, x_data);
+	matf32_init(&f, n, 1, f_data);
+
+	p->status[worker] = MATH_SUCCESS;
+	for (uint16_t k = pf_block_first(pf, worker, num_workers); k < pf_block_first(pf, worker + 1, num_workers); ++k)
+	{
+		for (uint16_t i = 0; i < n; ++i)
+			x_data[i] = pf->p_x[i*N + k];
+
+		p->status[worker] = pf->sys->dynamics(&f, &x, p->inputs);
+		if (p->status[worker] != MATH_SUCCESS)
+			return;
+
+		for (uint16_t i = 0; i < n; ++i)
+			pf->p_x[i*N + k] = f_data[i];
+	}
+}
+
+
+/**
+ * @brief   Log-likelihoods of the particles of the block, log p(y | x_k) = -1/2 |z_k|^2 + const with
+ * Sv' z_k = y - h(x_k), solved a row at a time over the block. The outputs are evaluated here unless a batch
+ * callback already wrote them to p_y. part[w] gets the largest log-likelihood of the block.
+ */
+static void
+pf_likelihood_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+	pf_task_arg_t* const p = (pf_task_arg_t*) p_arg;
+	pf_info_t* const pf = p->pf;
+	const uint16_t n = pf->sys->state_dim;
+	const uint16_t dim_y = pf->sys->output_dim;
+	const uint16_t N = pf->num_particles;
+	const uint16_t first = pf_block_first(pf, worker, num_workers);
+	const uint16_t last = pf_block_first(pf, worker + 1, num_workers);
+	float* const Y = pf->p_y;
+	float* const ll = pf->p_aux;
+
+	p->status[worker] = MATH_SUCCESS;
+	p->part[worker] = -INFINITY;
+
+	if (pf->outputs_batch == NULL)
+	{
+		float x_data[MAX_VEC_SIZE];
+		float h_data[MAX_VEC_SIZE];
+		matf32_t x, h;
+		matf32_init(&x, n, 1, x_data);
+		matf32_init(&h, dim_y, 1, h_data);
+
+		for (uint16_t k = first; k < last; ++k)
+		{
+			for (uint16_t i = 0; i < n; ++i)
+				x_data[i] = pf->p_x[i*N + k];
+
+			p->status[worker] = pf->sys->outputs(&h, &x, p->inputs);
+			if (p->status[worker] != MATH_SUCCESS)
+				return;
+
+			for (uint16_t r = 0; r < dim_y; ++r)
+				Y[r*N + k] = h_data[r];
+		}
+	}
+
+	for (uint16_t k = first; k < last; ++k)
+		ll[k] = 0;
+
+	for (uint16_t r = 0; r < dim_y; ++r)
+	{
+		float* const z = &Y[r*N];
+		const float y_r = p->measurements->p_data[r];
+		const float s_rr = pf->Sv->p_data[matf32_sym_idx(r, r)];
+
+		for (uint16_t k = first; k < last; ++k)
+			z[k] = y_r - z[k];
+		for (uint16_t q = 0; q < r; ++q)
+		{
+			const float s_qr = pf->Sv->p_data[matf32_sym_idx(q, r)];
+			const float* const z_q = &Y[q*N];
+			for (uint16_t k = first; k < last; ++k)
+				z[k] -= s_qr * z_q[k];
+		}
+		for (uint16_t k = first; k < last; ++k)
+		{
+			z[k] /= s_rr;
+			ll[k] -= 0.5f * z[k] * z[k];
+		}
+	}
+
+	for (uint16_t k = first; k < last; ++k)
+		p->part[worker] = fmaxf(p->part[worker], ll[k]);
+}
+
+
+/**
+ * @brief   First pass of the blocked prefix sum: cumulative weights within the block, part[w] gets its total.
+ */
+static void
+pf_prefix_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+	pf_task_arg_t* const p = (pf_task_arg_t*) p_arg;
+	pf_info_t* const pf = p->pf;
+	float* const c = pf->p_aux;
+	float sum = 0;
+
+	for (uint16_t k = pf_block_first(pf, worker, num_workers); k < pf_block_first(pf, worker + 1, num_workers); ++k)
+	{
+		sum += pf->p_w[k];
+		c[k] = sum;
+	}
+	p->part[worker] = sum;
+}
+
+
+/**
+ * @brief   Second pass: adds the total of the previous blocks (part[w] after the scan) to the block.
+ */
+static void
+pf_offset_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+	pf_task_arg_t* const p = (pf_task_arg_t*) p_arg;
+	pf_info_t* const pf = p->pf;
+	float* const c = pf->p_aux;
+	const float offset = p->part[worker];
+
+	for (uint16_t k = pf_block_first(pf, worker, num_workers); k < pf_block_first(pf, worker + 1, num_workers); ++k)
+		c[k] += offset;
+}
+
+
+/**
+ * @brief   Copies the new particles [first, last) of the block, the source of the first one is found by
+ * bisection of the cumulative weights and the others by walking forward from it.
+ */
+static void
+pf_select_task(void* p_arg, uint16_t worker, uint16_t num_workers)
+{
+	pf_task_arg_t* const p = (pf_task_arg_t*) p_arg;
+	pf_info_t* const pf = p->pf;
+	const uint16_t n = pf->sys->state_dim;
+	const uint16_t N = pf->num_particles;
+	const uint16_t first = pf_block_first(pf, worker, num_workers);
+	const float* const c = pf->p_aux;
+
+	// First k with c_k > (first + u) / N
+	uint16_t k = 0;
+	uint16_t hi = N - 1;
+	const float target = (first + p->u) / N;
+	while (k < hi)
+	{
+		const uint16_t mid = k + (hi - k) / 2;
+		if (c[mid] <= target)
+			k = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (uint16_t j = first; j < pf_block_first(pf, worker + 1, num_workers); ++j)
+	{
+		const float t = (j + p->u) / N;
+		while ((k < N - 1) && (c[k] <= t))
+			++k;
+
+		for (uint16_t i = 0; i < n; ++i)
+			pf->p_x_new[i*N + j] = pf->p_x[i*N + k];
+	}
+}
+
+
+// ====================================================================================================
+// Particle filter
+// ====================================================================================================
+err_status_t
+pf_init(pf_info_t* const pf, sys_nonlin_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+	matf32_t* const xhat, const matf32_sym_t* P, uint16_t num_particles, float* p_fwork, uint32_t seed)
+{
+	const uint16_t n = sys->state_dim;
+	const uint16_t N = num_particles;
+
+	if ((P->num_rows != n) || (xhat->num_rows != n) || (F->num_rows != n) || (F->num_cols != Qw->num_rows)
+		|| (Qv->num_rows != sys->output_dim))
+		return MATH_SIZE_MISMATCH;
+
+	// Single particles and noise samples go through stack arrays
+	if ((n > MAX_VEC_SIZE) || (sys->output_dim > MAX_VEC_SIZE) || (Qw->num_rows > MAX_VEC_SIZE))
+		return MATH_LENGTH_ERROR;
+
+	if (sys->is_continuous || (0 == N))
+		return MATH_ARGUMENT_ERROR;
+
+	if ((matf32_sym_cholesky(Qw) != MATH_SUCCESS) || (matf32_sym_cholesky(Qv) != MATH_SUCCESS))
+		return MATH_DECOMPOSITION_FAILURE;
+
+	float U_data[MATF32_SYM_SIZE(MAX_VEC_SIZE)];
+	matf32_sym_t U;
+	matf32_sym_init(&U, n, U_data);
+	matf32_sym_copy(P, &U);
+	if (matf32_sym_cholesky(&U) != MATH_SUCCESS)
+		return MATH_DECOMPOSITION_FAILURE;
+
+	pf->sys = sys;
+	pf->F = F;
+	pf->Sw = Qw;
+	pf->Sv = Qv;
+	pf->xhat = xhat;
+	pf->dynamics_batch = NULL;
+	pf->outputs_batch = NULL;
+	pf->inputs = NULL;
+	pf->num_workers = 1;
+	pf->num_particles = N;
+	pf->p_x = p_fwork;
+	p_fwork += n*N;
+	pf->p_w = p_fwork;
+	p_fwork += N;
+	pf->p_x_new = p_fwork;
+	p_fwork += n*N;
+	pf->p_y = p_fwork;
+	p_fwork += sys->output_dim*N;
+	pf->p_aux = p_fwork;
+	pf->resample_ratio = PF_RESAMPLE_RATIO;
+	pf->ess = N;
+	pf->num_resamples = 0;
+	pf_rng_seed(&pf->rng, seed);
+
+	// x_k = xhat + U' * z, w_k = 1 / N
+	for (uint16_t i = 0; i < n; ++i)
+	{
+		for (uint16_t k = 0; k < N; ++k)
+			pf->p_x[i*N + k] = xhat->p_data[i];
+	}
+	for (uint16_t k = 0; k < N; ++k)
+		pf->p_w[k] = 1.0f / N;
+	pf_add_noise(pf, NULL, &U);
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+pf_set_batch(pf_info_t* const pf, err_status_t (*dynamics_batch)(float* const, uint16_t, const matf32_t*),
+	err_status_t (*outputs_batch)(float* const, const float*, uint16_t, const matf32_t*))
+{
+	pf->dynamics_batch = dynamics_batch;
+	pf->outputs_batch = outputs_batch;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+pf_set_workers(pf_info_t* const pf, uint16_t num_workers)
+{
+	if ((num_workers == 0) || (num_workers > PARALLEL_MAX_WORKERS) || (num_workers > pf->num_particles))
+		return MATH_ARGUMENT_ERROR;
+
+	pf->num_workers = num_workers;
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+pf_predict(pf_info_t* const pf, const matf32_t* inputs)
+{
+	// Check if the inputs vector has the correct size
+	if ((inputs->num_rows != pf->sys->input_dim) || (inputs->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t N = pf->num_particles;
+	err_status_t status;
+	pf->inputs = inputs;
+
+	// x_k = f(x_k, u[k]), in one call when the model takes the whole set
+	if (pf->dynamics_batch != NULL)
+	{
+		status = pf->dynamics_batch(pf->p_x, N, inputs);
+		if (status != MATH_SUCCESS)
+			return status;
+	}
+	else
+	{
+		pf_task_arg_t arg;
+		arg.pf = pf;
+		arg.inputs = inputs;
+		parallel_run(pf_dynamics_task, &arg, pf->num_workers);
+
+		for (uint16_t w = 0; w < pf->num_workers; ++w)
+		{
+			if (arg.status[w] != MATH_SUCCESS)
+				return arg.status[w];
+		}
+	}
+
+	// x_k += F * w_k, w_k ~ N(0, Qw)
+	pf_add_noise(pf, pf->F, pf->Sw);
+	pf_mean(pf);
+
+	return MATH_SUCCESS;
+}
+
+
+err_status_t
+pf_correct(pf_info_t* const pf, const matf32_t* measurements)
+{
+	// Check if the measurements vector has the correct size
+	if ((measurements->num_rows != pf->sys->output_dim) || (measurements->num_cols != 1))
+		return MATH_SIZE_MISMATCH;
+
+	const uint16_t N = pf->num_particles;
+	float* const ll = pf->p_aux;
+	err_status_t status;
+
+	// Without a previous prediction the outputs are evaluated with a zero input
+	float u_data[MAX_VEC_SIZE] = {0};
+	matf32_t zero_input;
+	const matf32_t* inputs = pf->inputs;
+	if (inputs == NULL)
+	{
+		matf32_init(&zero_input, pf->sys->input_dim, 1, u_data);
+		inputs = &zero_input;
+	}
+
+	// Y_k = h(x_k, u[k]) in one call when the model takes the whole set, otherwise with the likelihoods
+	if (pf->outputs_batch != NULL)
+	{
+		status = pf->outputs_batch(pf->p_y, pf->p_x, N, inputs);
+		if (status != MATH_SUCCESS)
+			return status;
+	}
+
+	pf_task_arg_t arg;
+	arg.pf = pf;
+	arg.inputs = inputs;
+	arg.measurements = measurements;
+	parallel_run(pf_likelihood_task, &arg, pf->num_workers);
+
+	// w_k *= exp(ll_k - max ll), then normalize
+	float ll_max = -INFINITY;
+	for (uint16_t w = 0; w < pf->num_workers; ++w)
+	{
+		if (arg.status[w] != MATH_SUCCESS)
+			return arg.status[w];
+		ll_max = fmaxf(ll_max, arg.part[w]);
+	}
+	if (!isfinite(ll_max))
+		return MATH_NANINF;
+
+	float w_sum = 0;
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		pf->p_w[k] *= expf(ll[k] - ll_max);
+		w_sum += pf->p_w[k];
+	}
+
+	// Every particle with a nonzero weight has underflowed, restart from uniform weights
+	if (!(w_sum > 0))
+	{
+		w_sum = 0;
+		for (uint16_t k = 0; k < N; ++k)
+		{
+			pf->p_w[k] = expf(ll[k] - ll_max);
+			w_sum += pf->p_w[k];
+		}
+	}
+
+	float w_sq = 0;
+	for (uint16_t k = 0; k < N; ++k)
+	{
+		pf->p_w[k] /= w_sum;
+		w_sq += pf->p_w[k] * pf->p_w[k];
+	}
+	pf->ess = 1 / w_sq;
+
+	pf_mean(pf);
+
+	if (pf->ess < pf->resample_ratio * N)
+		pf_resample(pf);
+
+	return MATH_SUCCESS;
+}
+
+
+void
+pf_resample(pf_info_t* const pf)
+{
+	const uint16_t N = pf->num_particles;
+	float* const c = pf->p_aux;
+
+	// Cumulative weights by blocks, each block then shifted by the total of the previous ones. The last one is
+	// forced to 1 so rounding cannot leave a target beyond it
+	pf_task_arg_t arg;
+	arg.pf = pf;
+	parallel_run(pf_prefix_task, &arg, pf->num_workers);
+
+	float sum = 0;
+	for (uint16_t w = 0; w < pf->num_workers; ++w)
+	{
+		const float block = arg.part[w];
+		arg.part[w] = sum;
+		sum += block;
+	}
+	if (pf->num_workers > 1)
+		parallel_run(pf_offset_task, &arg, pf->num_workers);
+	c[N - 1] = 1;
+
+	arg.u = pf_rng_uniform(&pf->rng);
+	parallel_run(pf_select_task, &arg, pf->num_workers);
+
+	float* const p_tmp = pf->p_x;
+	pf->p_x = pf->p_x_new;
+	pf->p_x_new = p_tmp;
+
+	for (uint16_t j = 0; j < N; ++j)
+		pf->p_w[j] = 1.0f / N;
+
+	pf->num_resamples++;
+}
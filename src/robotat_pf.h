@@ -0,0 +1,229 @@
+/**
+ * @file robotat_pf.h
+ * @brief   Particle filter for nonlinear, non-Gaussian and multimodal estimation.
+ *
+ * Bootstrap (sampling importance resampling) filter over the sys_nonlin_t model x[k+1] = f(x[k], u[k]) + F w[k],
+ * y[k] = h(x[k], u[k]) + v[k], with Gaussian w ~ N(0, Qw) and v ~ N(0, Qv). Each particle is propagated through the
+ * dynamics with a sampled process noise and weighted with the measurement likelihood. When the effective sample
+ * size 1 / sum(w_k^2) drops below a fraction of the number of particles, the set is redrawn with systematic
+ * resampling (one uniform number and a single pass over the cumulative weights, O(N)).
+ *
+ * Particles are stored by state component (structure of arrays), p_x[i*N + k] is component i of particle k, so the
+ * noise, likelihood and mean loops are unit-stride and batched model callbacks can vectorize across particles.
+ * The per particle model calls, the likelihoods and the resampling (a blocked prefix sum of the weights followed
+ * by a blocked selection) can be split over the workers of parallel_run, see pf_set_workers.
+ * Random numbers come from a xoshiro128+ generator kept in the filter, so several filters (one per robot or per
+ * thread) never share state and runs are reproducible from the seed; the noise sampling stays sequential.
+ *
+ */
+
+#ifndef ROBOTAT_PF_H_
+#define ROBOTAT_PF_H_
+
+#include "robotat_control.h"
+
+// ====================================================================================================
+// Constant macro definitions
+// ====================================================================================================
+
+/** float storage of a particle filter with n states, dim_y outputs and N particles. */
+#define PF_FWORK(n, dim_y, N)       ((2*(n) + (dim_y) + 2)*(N))
+
+#define PF_RESAMPLE_RATIO           (0.5f)      /**< Default effective sample size ratio that triggers resampling. */
+
+// ====================================================================================================
+// Data structures, enums and type definitions
+// ====================================================================================================
+
+
+/**
+ * @brief   xoshiro128+ pseudo random number generator state.
+ */
+typedef struct
+{
+    uint32_t s[4];          /**< Generator state, never all zero. */
+    float normal_spare;     /**< Second normal deviate of the last polar draw. */
+    bool has_spare;         /**< Whether normal_spare is valid. */
+} pf_rng_t;
+
+
+/**
+ * @brief   Particle filter data structure.
+ */
+typedef struct
+{
+    sys_nonlin_t* sys;      /**< Nonlinear system model (has to be discrete time). */
+    matf32_t* F;            /**< Coupling matrix for the process noise. */
+    matf32_sym_t* Sw;       /**< Cholesky factor of the process noise covariance matrix, packed. */
+    matf32_sym_t* Sv;       /**< Cholesky factor of the measurement noise covariance matrix, packed. */
+    matf32_t* xhat;         /**< Weighted mean of the particles. */
+    err_status_t (*dynamics_batch)(float* const, uint16_t, const matf32_t*);               /**< f on all particles in place, NULL for one call per particle. */
+    err_status_t (*outputs_batch)(float* const, const float*, uint16_t, const matf32_t*);  /**< h on all particles, NULL for one call per particle. */
+    const matf32_t* inputs; /**< Last inputs, used by the outputs in the correction. */
+    uint16_t num_particles; /**< Number of particles N. */
+    uint16_t num_workers;   /**< Workers sharing the per particle work, see pf_set_workers. */
+    float* p_x;             /**< Particles, dim(xhat) x N. */
+    float* p_w;             /**< Normalized weights, N. */
+    float* p_x_new;         /**< Resampling target, dim(xhat) x N, swapped with p_x. */
+    float* p_y;             /**< Particle outputs, dim(y) x N. */
+    float* p_aux;           /**< Log-likelihoods and cumulative weights, N. */
+    float resample_ratio;   /**< Resample when the effective sample size is below resample_ratio * N. */
+    float ess;              /**< Effective sample size after the last correction. */
+    uint32_t num_resamples; /**< Number of resampling steps, for profiling. */
+    pf_rng_t rng;           /**< Random number generator of this filter. */
+} pf_info_t;
+
+
+// ====================================================================================================
+// Public function prototypes
+// ====================================================================================================
+
+/**
+ * @brief   Seeds a generator through splitmix32, so close seeds give unrelated streams.
+ *
+ * @param[out]      rng     Generator state.
+ * @param[in]       seed    Any 32 bit value.
+ */
+void
+pf_rng_seed(pf_rng_t* const rng, uint32_t seed);
+
+
+/**
+ * @brief   Next 32 random bits.
+ */
+uint32_t
+pf_rng_next(pf_rng_t* const rng);
+
+
+/**
+ * @brief   Uniform deviate in [0, 1), from the upper 24 bits.
+ */
+float
+pf_rng_uniform(pf_rng_t* const rng);
+
+
+/**
+ * @brief   Standard normal deviate, Marsaglia polar method (the second deviate of each pair is kept).
+ */
+float
+pf_rng_normal(pf_rng_t* const rng);
+
+
+/**
+ * @brief   Initializes a particle filter and draws the particles from N(xhat, P), all with the same weight.
+ *
+ * WARNING: Qw and Qv are overwritten with their Cholesky factors (see matf32_sym_cholesky), as in kalman_sqrt_init.
+ *
+ * @param[in, out]  pf              Particle filter data structure.
+ * @param[in]       sys             Discrete time nonlinear system model.
+ * @param[in]       F               Coupling matrix of the process noise, dim(xhat) x dim(w).
+ * @param[in, out]  Qw              Packed process noise covariance matrix, factored in place.
+ * @param[in, out]  Qv              Packed measurement noise covariance matrix, factored in place.
+ * @param[in, out]  xhat            Initial estimate, then the weighted mean of the particles.
+ * @param[in]       P               Packed covariance of the initial particles.
+ * @param[in]       num_particles   Number of particles N.
+ * @param[in]       p_fwork         Storage, PF_FWORK(dim(xhat), dim(y), N) elements.
+ * @param[in]       seed            Seed of the random number generator of the filter.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :                  Operation successful.
+ *              MATH_SIZE_MISMATCH :            Matrix size check failed.
+ *              MATH_LENGTH_ERROR :             The dimensions exceed MAX_VEC_SIZE.
+ *              MATH_ARGUMENT_ERROR :           System model is not discrete time or N = 0.
+ *              MATH_DECOMPOSITION_FAILURE :    A covariance is not positive definite.
+ */
+err_status_t
+pf_init(pf_info_t* const pf, sys_nonlin_t* const sys, matf32_t* F, matf32_sym_t* Qw, matf32_sym_t* Qv,
+    matf32_t* const xhat, const matf32_sym_t* P, uint16_t num_particles, float* p_fwork, uint32_t seed);
+
+
+/**
+ * @brief   Sets model callbacks that process all particles in one call, stored by component (p[i*count + k] is
+ * component i of particle k). NULL keeps one sys->dynamics or sys->outputs call per particle.
+ *
+ * @param[in, out]  pf              Particle filter data structure.
+ * @param[in]       dynamics_batch  Overwrites the dim(xhat) x count particles with f(x, u).
+ * @param[in]       outputs_batch   Writes the dim(y) x count outputs h(x, u) of the dim(xhat) x count particles.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ */
+err_status_t
+pf_set_batch(pf_info_t* const pf, err_status_t (*dynamics_batch)(float* const, uint16_t, const matf32_t*),
+    err_status_t (*outputs_batch)(float* const, const float*, uint16_t, const matf32_t*));
+
+
+/**
+ * @brief   Splits the per particle model calls (the ones not made through pf_set_batch callbacks), the likelihoods
+ * and the resampling over num_workers workers of parallel_run, each taking a contiguous block of particles.
+ * They run as POSIX threads when the library is built with PARALLEL_PTHREAD, in which case sys->dynamics and
+ * sys->outputs must be safe to call concurrently; otherwise the blocks are processed in turn.
+ * The blocked prefix sum rounds differently from a single pass, so the resampled set can depend on num_workers
+ * (but not on whether threads are used).
+ *
+ * @param[in, out]  pf              Particle filter data structure.
+ * @param[in]       num_workers     Number of workers, 1 (the default) to PARALLEL_MAX_WORKERS and at most N.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_ARGUMENT_ERROR :   num_workers is 0, above PARALLEL_MAX_WORKERS or above N.
+ */
+err_status_t
+pf_set_workers(pf_info_t* const pf, uint16_t num_workers);
+
+
+/**
+ * @brief   Time update: every particle goes through the dynamics and gets a process noise sample F * Sw' * z.
+ *
+ * @param[in, out]  pf      Particle filter data structure.
+ * @param[in]       inputs  Input vector u[k], kept for the next correction.
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              Any error returned by the model callbacks.
+ */
+err_status_t
+pf_predict(pf_info_t* const pf, const matf32_t* inputs);
+
+
+/**
+ * @brief   Measurement update: the weights are multiplied by the Gaussian likelihood of y[k] (computed in the log
+ * domain and shifted by its maximum, so a far measurement does not underflow every weight), xhat is set to the
+ * weighted mean and the particles are resampled when the effective sample size is low.
+ *
+ * @param[in, out]  pf              Particle filter data structure.
+ * @param[in]       measurements    Measurement vector y[k].
+ *
+ * @return  Execution status
+ *              MATH_SUCCESS :          Operation successful.
+ *              MATH_SIZE_MISMATCH :    Matrix size check failed.
+ *              MATH_NANINF :           The likelihoods are not finite.
+ *              Any error returned by the model callbacks.
+ */
+err_status_t
+pf_correct(pf_info_t* const pf, const matf32_t* measurements);
+
+
+/**
+ * @brief   Systematic resampling: with c_k the cumulative weights and u ~ U[0, 1), particle j of the new set is
+ * the first k with c_k > (j + u) / N. Each worker sums its block of weights, the block totals are scanned, and
+ * each worker then finds the source of its first new particle by bisection. All weights are reset to 1 / N.
+ *
+ * @param[in, out]  pf      Particle filter data structure.
+ */
+void
+pf_resample(pf_info_t* const pf);
+
+
+static inline err_status_t
+pf_update(pf_info_t* const pf, const matf32_t* inputs, const matf32_t* measurements)
+{
+    err_status_t status = pf_predict(pf, inputs);
+    if (status != MATH_SUCCESS)
+        return status;
+
+    return pf_correct(pf, measurements);
+}
+
+#endif /* ROBOTAT_PF_H_ */
@@ -0,0 +1,665 @@
+/**
+ * @file qpgen_box.c
+ *
+ * ADMM solver for n = 8, meq = 1, min = 16 and the sparsity of codegen_box.spec.
+ * Generated by quadprog_codegen, do not edit.
+ *
+ */
+
+#include "qpgen_box.h"
+
+#define N_VAR           (8)
+#define N_EQ            (1)
+#define N_CON           (17)
+#define N_KKT           (25)
+#define RHO_EQ_SCALE    (1e3f)
+#define RHO_MIN         (1e-6f)
+#define RHO_MAX         (1e6f)
+#define RHO_TOLERANCE   (5.0f)
+
+quadprog_admm_settings_t qpgen_box_settings;
+quadprog_admm_info_t qpgen_box_info;
+float qpgen_box_dx[N_VAR];
+float qpgen_box_dy[N_CON + 1];
+
+static float x[N_VAR];
+static float xt[N_VAR];
+static float z[N_CON + 1];
+static float zt[N_CON + 1];
+static float y[N_CON + 1];
+static float rho_vec[N_CON + 1];
+static float rho_inv[N_CON + 1];
+static float w[N_KKT];
+static float Lx[31];
+static float D[N_KKT];
+static float D_inv[N_KKT];
+
+
+// P*KKT*P' = L*D*L' with the ordering and pattern of quadprog_admm, unrolled
+static quadprog_status_t
+kkt_factor(const quadprog_t* const p_qp)
+{
+    const float* Q = p_qp->p_Q->p_data;
+    const float* Aeq = p_qp->p_Aeq->p_data;
+    const float* Ain = p_qp->p_Ain->p_data;
+    const float sigma = qpgen_box_settings.sigma;
+
+    D[0] = -rho_inv[1];
+    if (0 == D[0]) return QP_NOT_CONVEX;
+    D_inv[0] = 1.0f / D[0];
+    Lx[0] = (Ain[0])*D_inv[0];
+    D[1] = -rho_inv[2];
+    if (0 == D[1]) return QP_NOT_CONVEX;
+    D_inv[1] = 1.0f / D[1];
+    Lx[1] = (Ain[9])*D_inv[1];
+    D[2] = -rho_inv[3];
+    if (0 == D[2]) return QP_NOT_CONVEX;
+    D_inv[2] = 1.0f / D[2];
+    Lx[2] = (Ain[18])*D_inv[2];
+    D[3] = -rho_inv[4];
+    if (0 == D[3]) return QP_NOT_CONVEX;
+    D_inv[3] = 1.0f / D[3];
+    Lx[3] = (Ain[27])*D_inv[3];
+    D[4] = -rho_inv[5];
+    if (0 == D[4]) return QP_NOT_CONVEX;
+    D_inv[4] = 1.0f / D[4];
+    Lx[4] = (Ain[36])*D_inv[4];
+    D[5] = -rho_inv[6];
+    if (0 == D[5]) return QP_NOT_CONVEX;
+    D_inv[5] = 1.0f / D[5];
+    Lx[5] = (Ain[45])*D_inv[5];
+    D[6] = -rho_inv[7];
+    if (0 == D[6]) return QP_NOT_CONVEX;
+    D_inv[6] = 1.0f / D[6];
+    Lx[6] = (Ain[54])*D_inv[6];
+    D[7] = -rho_inv[8];
+    if (0 == D[7]) return QP_NOT_CONVEX;
+    D_inv[7] = 1.0f / D[7];
+    Lx[7] = (Ain[63])*D_inv[7];
+    D[8] = -rho_inv[9];
+    if (0 == D[8]) return QP_NOT_CONVEX;
+    D_inv[8] = 1.0f / D[8];
+    Lx[8] = (Ain[64])*D_inv[8];
+    D[9] = -rho_inv[10];
+    if (0 == D[9]) return QP_NOT_CONVEX;
+    D_inv[9] = 1.0f / D[9];
+    Lx[9] = (Ain[73])*D_inv[9];
+    D[10] = -rho_inv[11];
+    if (0 == D[10]) return QP_NOT_CONVEX;
+    D_inv[10] = 1.0f / D[10];
+    Lx[10] = (Ain[82])*D_inv[10];
+    D[11] = -rho_inv[12];
+    if (0 == D[11]) return QP_NOT_CONVEX;
+    D_inv[11] = 1.0f / D[11];
+    Lx[11] = (Ain[91])*D_inv[11];
+    D[12] = -rho_inv[13];
+    if (0 == D[12]) return QP_NOT_CONVEX;
+    D_inv[12] = 1.0f / D[12];
+    Lx[12] = (Ain[100])*D_inv[12];
+    D[13] = -rho_inv[14];
+    if (0 == D[13]) return QP_NOT_CONVEX;
+    D_inv[13] = 1.0f / D[13];
+    Lx[13] = (Ain[109])*D_inv[13];
+    D[14] = -rho_inv[15];
+    if (0 == D[14]) return QP_NOT_CONVEX;
+    D_inv[14] = 1.0f / D[14];
+    Lx[14] = (Ain[118])*D_inv[14];
+    D[15] = -rho_inv[16];
+    if (0 == D[15]) return QP_NOT_CONVEX;
+    D_inv[15] = 1.0f / D[15];
+    Lx[15] = (Ain[127])*D_inv[15];
+    D[16] = Q[0] + sigma - Lx[0]*Lx[0]*D[0] - Lx[8]*Lx[8]*D[8];
+    if (0 == D[16]) return QP_NOT_CONVEX;
+    D_inv[16] = 1.0f / D[16];
+    Lx[16] = (Q[8])*D_inv[16];
+    Lx[17] = (Aeq[0])*D_inv[16];
+    D[17] = Q[9] + sigma - Lx[1]*Lx[1]*D[1] - Lx[9]*Lx[9]*D[9] - Lx[16]*Lx[16]*D[16];
+    if (0 == D[17]) return QP_NOT_CONVEX;
+    D_inv[17] = 1.0f / D[17];
+    Lx[18] = (Q[17])*D_inv[17];
+    Lx[19] = (Aeq[1] - Lx[17]*Lx[16]*D[16])*D_inv[17];
+    D[18] = Q[18] + sigma - Lx[2]*Lx[2]*D[2] - Lx[10]*Lx[10]*D[10] - Lx[18]*Lx[18]*D[17];
+    if (0 == D[18]) return QP_NOT_CONVEX;
+    D_inv[18] = 1.0f / D[18];
+    Lx[20] = (Q[26])*D_inv[18];
+    Lx[21] = (Aeq[2] - Lx[19]*Lx[18]*D[17])*D_inv[18];
+    D[19] = Q[27] + sigma - Lx[3]*Lx[3]*D[3] - Lx[11]*Lx[11]*D[11] - Lx[20]*Lx[20]*D[18];
+    if (0 == D[19]) return QP_NOT_CONVEX;
+    D_inv[19] = 1.0f / D[19];
+    Lx[22] = (Q[35])*D_inv[19];
+    Lx[23] = (Aeq[3] - Lx[21]*Lx[20]*D[18])*D_inv[19];
+    D[20] = Q[36] + sigma - Lx[4]*Lx[4]*D[4] - Lx[12]*Lx[12]*D[12] - Lx[22]*Lx[22]*D[19];
+    if (0 == D[20]) return QP_NOT_CONVEX;
+    D_inv[20] = 1.0f / D[20];
+    Lx[24] = (Q[44])*D_inv[20];
+    Lx[25] = (Aeq[4] - Lx[23]*Lx[22]*D[19])*D_inv[20];
+    D[21] = Q[45] + sigma - Lx[5]*Lx[5]*D[5] - Lx[13]*Lx[13]*D[13] - Lx[24]*Lx[24]*D[20];
+    if (0 == D[21]) return QP_NOT_CONVEX;
+    D_inv[21] = 1.0f / D[21];
+    Lx[26] = (Q[53])*D_inv[21];
+    Lx[27] = (Aeq[5] - Lx[25]*Lx[24]*D[20])*D_inv[21];
+    D[22] = Q[54] + sigma - Lx[6]*Lx[6]*D[6] - Lx[14]*Lx[14]*D[14] - Lx[26]*Lx[26]*D[21];
+    if (0 == D[22]) return QP_NOT_CONVEX;
+    D_inv[22] = 1.0f / D[22];
+    Lx[28] = (Q[62])*D_inv[22];
+    Lx[29] = (Aeq[6] - Lx[27]*Lx[26]*D[21])*D_inv[22];
+    D[23] = Q[63] + sigma - Lx[7]*Lx[7]*D[7] - Lx[15]*Lx[15]*D[15] - Lx[28]*Lx[28]*D[22];
+    if (0 == D[23]) return QP_NOT_CONVEX;
+    D_inv[23] = 1.0f / D[23];
+    Lx[30] = (Aeq[7] - Lx[29]*Lx[28]*D[22])*D_inv[23];
+    D[24] = -rho_inv[0] - Lx[17]*Lx[17]*D[16] - Lx[19]*Lx[19]*D[17] - Lx[21]*Lx[21]*D[18] - Lx[23]*Lx[23]*D[19] - Lx[25]*Lx[25]*D[20] - Lx[27]*Lx[27]*D[21] - Lx[29]*Lx[29]*D[22] - Lx[30]*Lx[30]*D[23];
+    if (0 == D[24]) return QP_NOT_CONVEX;
+    D_inv[24] = 1.0f / D[24];
+
+    qpgen_box_info.num_factor++;
+
+    return QP_SUCESS;
+}
+
+
+// w = KKT^-1*w with the cached factor, unrolled
+static void
+kkt_solve(float* const w)
+{
+    float t[25];
+
+    t[0] = w[9];
+    t[1] = w[10];
+    t[2] = w[11];
+    t[3] = w[12];
+    t[4] = w[13];
+    t[5] = w[14];
+    t[6] = w[15];
+    t[7] = w[16];
+    t[8] = w[17];
+    t[9] = w[18];
+    t[10] = w[19];
+    t[11] = w[20];
+    t[12] = w[21];
+    t[13] = w[22];
+    t[14] = w[23];
+    t[15] = w[24];
+    t[16] = w[0];
+    t[17] = w[1];
+    t[18] = w[2];
+    t[19] = w[3];
+    t[20] = w[4];
+    t[21] = w[5];
+    t[22] = w[6];
+    t[23] = w[7];
+    t[24] = w[8];
+    t[16] -= Lx[0]*t[0];
+    t[17] -= Lx[1]*t[1];
+    t[18] -= Lx[2]*t[2];
+    t[19] -= Lx[3]*t[3];
+    t[20] -= Lx[4]*t[4];
+    t[21] -= Lx[5]*t[5];
+    t[22] -= Lx[6]*t[6];
+    t[23] -= Lx[7]*t[7];
+    t[16] -= Lx[8]*t[8];
+    t[17] -= Lx[9]*t[9];
+    t[18] -= Lx[10]*t[10];
+    t[19] -= Lx[11]*t[11];
+    t[20] -= Lx[12]*t[12];
+    t[21] -= Lx[13]*t[13];
+    t[22] -= Lx[14]*t[14];
+    t[23] -= Lx[15]*t[15];
+    t[17] -= Lx[16]*t[16];
+    t[24] -= Lx[17]*t[16];
+    t[18] -= Lx[18]*t[17];
+    t[24] -= Lx[19]*t[17];
+    t[19] -= Lx[20]*t[18];
+    t[24] -= Lx[21]*t[18];
+    t[20] -= Lx[22]*t[19];
+    t[24] -= Lx[23]*t[19];
+    t[21] -= Lx[24]*t[20];
+    t[24] -= Lx[25]*t[20];
+    t[22] -= Lx[26]*t[21];
+    t[24] -= Lx[27]*t[21];
+    t[23] -= Lx[28]*t[22];
+    t[24] -= Lx[29]*t[22];
+    t[24] -= Lx[30]*t[23];
+    t[0] *= D_inv[0];
+    t[1] *= D_inv[1];
+    t[2] *= D_inv[2];
+    t[3] *= D_inv[3];
+    t[4] *= D_inv[4];
+    t[5] *= D_inv[5];
+    t[6] *= D_inv[6];
+    t[7] *= D_inv[7];
+    t[8] *= D_inv[8];
+    t[9] *= D_inv[9];
+    t[10] *= D_inv[10];
+    t[11] *= D_inv[11];
+    t[12] *= D_inv[12];
+    t[13] *= D_inv[13];
+    t[14] *= D_inv[14];
+    t[15] *= D_inv[15];
+    t[16] *= D_inv[16];
+    t[17] *= D_inv[17];
+    t[18] *= D_inv[18];
+    t[19] *= D_inv[19];
+    t[20] *= D_inv[20];
+    t[21] *= D_inv[21];
+    t[22] *= D_inv[22];
+    t[23] *= D_inv[23];
+    t[24] *= D_inv[24];
+    t[23] -= Lx[30]*t[24];
+    t[22] -= Lx[28]*t[23];
+    t[22] -= Lx[29]*t[24];
+    t[21] -= Lx[26]*t[22];
+    t[21] -= Lx[27]*t[24];
+    t[20] -= Lx[24]*t[21];
+    t[20] -= Lx[25]*t[24];
+    t[19] -= Lx[22]*t[20];
+    t[19] -= Lx[23]*t[24];
+    t[18] -= Lx[20]*t[19];
+    t[18] -= Lx[21]*t[24];
+    t[17] -= Lx[18]*t[18];
+    t[17] -= Lx[19]*t[24];
+    t[16] -= Lx[16]*t[17];
+    t[16] -= Lx[17]*t[24];
+    t[15] -= Lx[15]*t[23];
+    t[14] -= Lx[14]*t[22];
+    t[13] -= Lx[13]*t[21];
+    t[12] -= Lx[12]*t[20];
+    t[11] -= Lx[11]*t[19];
+    t[10] -= Lx[10]*t[18];
+    t[9] -= Lx[9]*t[17];
+    t[8] -= Lx[8]*t[16];
+    t[7] -= Lx[7]*t[23];
+    t[6] -= Lx[6]*t[22];
+    t[5] -= Lx[5]*t[21];
+    t[4] -= Lx[4]*t[20];
+    t[3] -= Lx[3]*t[19];
+    t[2] -= Lx[2]*t[18];
+    t[1] -= Lx[1]*t[17];
+    t[0] -= Lx[0]*t[16];
+    w[9] = t[0];
+    w[10] = t[1];
+    w[11] = t[2];
+    w[12] = t[3];
+    w[13] = t[4];
+    w[14] = t[5];
+    w[15] = t[6];
+    w[16] = t[7];
+    w[17] = t[8];
+    w[18] = t[9];
+    w[19] = t[10];
+    w[20] = t[11];
+    w[21] = t[12];
+    w[22] = t[13];
+    w[23] = t[14];
+    w[24] = t[15];
+    w[0] = t[16];
+    w[1] = t[17];
+    w[2] = t[18];
+    w[3] = t[19];
+    w[4] = t[20];
+    w[5] = t[21];
+    w[6] = t[22];
+    w[7] = t[23];
+    w[8] = t[24];
+}
+
+
+// out = Q*v, unrolled over the nonzeros
+static void
+mul_Q(const float* const Q, const float* const v, float* const out)
+{
+    out[0] = 0 + Q[0]*v[0] + Q[1]*v[1];
+    out[1] = 0 + Q[8]*v[0] + Q[9]*v[1] + Q[10]*v[2];
+    out[2] = 0 + Q[17]*v[1] + Q[18]*v[2] + Q[19]*v[3];
+    out[3] = 0 + Q[26]*v[2] + Q[27]*v[3] + Q[28]*v[4];
+    out[4] = 0 + Q[35]*v[3] + Q[36]*v[4] + Q[37]*v[5];
+    out[5] = 0 + Q[44]*v[4] + Q[45]*v[5] + Q[46]*v[6];
+    out[6] = 0 + Q[53]*v[5] + Q[54]*v[6] + Q[55]*v[7];
+    out[7] = 0 + Q[62]*v[6] + Q[63]*v[7];
+}
+
+
+// out = A*v with A = [Aeq; Ain], unrolled over the nonzeros
+static void
+mul_A(const quadprog_t* const p_qp, const float* const v, float* const out)
+{
+    const float* Aeq = p_qp->p_Aeq->p_data;
+    const float* Ain = p_qp->p_Ain->p_data;
+
+    out[0] = 0 + Aeq[0]*v[0] + Aeq[1]*v[1] + Aeq[2]*v[2] + Aeq[3]*v[3] + Aeq[4]*v[4] + Aeq[5]*v[5] + Aeq[6]*v[6] + Aeq[7]*v[7];
+    out[1] = 0 + Ain[0]*v[0];
+    out[2] = 0 + Ain[9]*v[1];
+    out[3] = 0 + Ain[18]*v[2];
+    out[4] = 0 + Ain[27]*v[3];
+    out[5] = 0 + Ain[36]*v[4];
+    out[6] = 0 + Ain[45]*v[5];
+    out[7] = 0 + Ain[54]*v[6];
+    out[8] = 0 + Ain[63]*v[7];
+    out[9] = 0 + Ain[64]*v[0];
+    out[10] = 0 + Ain[73]*v[1];
+    out[11] = 0 + Ain[82]*v[2];
+    out[12] = 0 + Ain[91]*v[3];
+    out[13] = 0 + Ain[100]*v[4];
+    out[14] = 0 + Ain[109]*v[5];
+    out[15] = 0 + Ain[118]*v[6];
+    out[16] = 0 + Ain[127]*v[7];
+}
+
+
+// out = A'*v, unrolled over the nonzeros
+static void
+mul_At(const quadprog_t* const p_qp, const float* const v, float* const out)
+{
+    const float* Aeq = p_qp->p_Aeq->p_data;
+    const float* Ain = p_qp->p_Ain->p_data;
+
+    out[0] = 0 + Aeq[0]*v[0] + Ain[0]*v[1] + Ain[64]*v[9];
+    out[1] = 0 + Aeq[1]*v[0] + Ain[9]*v[2] + Ain[73]*v[10];
+    out[2] = 0 + Aeq[2]*v[0] + Ain[18]*v[3] + Ain[82]*v[11];
+    out[3] = 0 + Aeq[3]*v[0] + Ain[27]*v[4] + Ain[91]*v[12];
+    out[4] = 0 + Aeq[4]*v[0] + Ain[36]*v[5] + Ain[100]*v[13];
+    out[5] = 0 + Aeq[5]*v[0] + Ain[45]*v[6] + Ain[109]*v[14];
+    out[6] = 0 + Aeq[6]*v[0] + Ain[54]*v[7] + Ain[118]*v[15];
+    out[7] = 0 + Aeq[7]*v[0] + Ain[63]*v[8] + Ain[127]*v[16];
+}
+
+
+static void
+set_rho(float rho)
+{
+    qpgen_box_settings.rho = rho;
+    for (uint16_t k = 0; k < N_EQ; ++k)
+    {
+        rho_vec[k] = RHO_EQ_SCALE*rho;
+        rho_inv[k] = 1.0f / rho_vec[k];
+    }
+    for (uint16_t k = N_EQ; k < N_CON; ++k)
+    {
+        rho_vec[k] = rho;
+        rho_inv[k] = 1.0f / rho;
+    }
+}
+
+
+static bool
+prim_infeasible(const quadprog_t* const p_qp)
+{
+    float* dy = qpgen_box_dy;
+    float dy_max = 0;
+    float bound = 0;
+
+    for (uint16_t k = N_EQ; k < N_CON; ++k)
+    {
+        dy[k] = fmaxf(dy[k], 0);
+    }
+    for (uint16_t k = 0; k < N_CON; ++k)
+    {
+        dy_max = fmaxf(dy_max, fabsf(dy[k]));
+    }
+    if (dy_max <= FLT_EPSILON)
+    {
+        return false;
+    }
+
+    for (uint16_t k = 0; k < N_CON; ++k)
+    {
+        dy[k] /= dy_max;
+    }
+    for (uint16_t k = 0; k < N_EQ; ++k)
+    {
+        bound += p_qp->p_beq->p_data[k]*dy[k];
+    }
+    for (uint16_t k = N_EQ; k < N_CON; ++k)
+    {
+        bound += p_qp->p_bin->p_data[k - N_EQ]*dy[k];
+    }
+    if (bound >= -qpgen_box_settings.eps_prim_inf)
+    {
+        return false;
+    }
+
+    mul_At(p_qp, dy, xt);
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        if (fabsf(xt[i]) > qpgen_box_settings.eps_prim_inf)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool
+dual_infeasible(const quadprog_t* const p_qp)
+{
+    const float eps = qpgen_box_settings.eps_dual_inf;
+    float* dx = qpgen_box_dx;
+    float dx_max = 0;
+    float cdx = 0;
+
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        dx_max = fmaxf(dx_max, fabsf(dx[i]));
+    }
+    if (dx_max <= FLT_EPSILON)
+    {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        dx[i] /= dx_max;
+        cdx += p_qp->p_c->p_data[i]*dx[i];
+    }
+    if (cdx >= -eps)
+    {
+        return false;
+    }
+
+    mul_Q(p_qp->p_Q->p_data, dx, xt);
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        if (fabsf(xt[i]) > eps)
+        {
+            return false;
+        }
+    }
+
+    mul_A(p_qp, dx, zt);
+    for (uint16_t k = 0; k < N_EQ; ++k)
+    {
+        if (fabsf(zt[k]) > eps)
+        {
+            return false;
+        }
+    }
+    for (uint16_t k = N_EQ; k < N_CON; ++k)
+    {
+        if (zt[k] > eps)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+quadprog_status_t
+qpgen_box_init(const quadprog_t* const p_qp)
+{
+    qpgen_box_settings.rho = 0.1f;
+    qpgen_box_settings.sigma = 1e-6f;
+    qpgen_box_settings.alpha = 1.6f;
+    qpgen_box_settings.eps_abs = 1e-4f;
+    qpgen_box_settings.eps_rel = 1e-4f;
+    qpgen_box_settings.eps_prim_inf = 1e-4f;
+    qpgen_box_settings.eps_dual_inf = 1e-4f;
+    qpgen_box_settings.max_iter = 4000;
+    qpgen_box_settings.adapt_interval = 25;
+    memset(&qpgen_box_info, 0, sizeof(quadprog_admm_info_t));
+
+    set_rho(qpgen_box_settings.rho);
+    qpgen_box_cold_start();
+
+    return kkt_factor(p_qp);
+}
+
+
+quadprog_status_t
+qpgen_box_update_matrices(const quadprog_t* const p_qp)
+{
+    return kkt_factor(p_qp);
+}
+
+
+void
+qpgen_box_warm_start(const float* const p_x, const float* const p_y)
+{
+    if (NULL != p_x)
+    {
+        memcpy(x, p_x, sizeof(x));
+    }
+
+    if (NULL != p_y)
+    {
+        memcpy(y, p_y, N_CON*sizeof(float));
+    }
+}
+
+
+void
+qpgen_box_cold_start(void)
+{
+    memset(x, 0, sizeof(x));
+    memset(z, 0, sizeof(z));
+    memset(y, 0, sizeof(y));
+}
+
+
+quadprog_status_t
+qpgen_box_solve(const quadprog_t* const p_qp, matf32_t* const p_x)
+{
+    const quadprog_admm_settings_t* const p_set = &qpgen_box_settings;
+    const float* q = p_qp->p_c->p_data;
+    float* dx = qpgen_box_dx;
+    float* dy = qpgen_box_dy;
+    const float* beq = p_qp->p_beq->p_data;
+    const float* bin = p_qp->p_bin->p_data;
+    quadprog_status_t status = QP_MAX_ITERATIONS;
+    uint16_t iter;
+
+    qpgen_box_info.num_factor = 0;
+
+    for (uint16_t k = 0; k < N_EQ; ++k)
+    {
+        z[k] = beq[k];
+    }
+    for (uint16_t k = N_EQ; k < N_CON; ++k)
+    {
+        z[k] = fminf(z[k], bin[k - N_EQ]);
+    }
+
+    for (iter = 1; iter <= p_set->max_iter; ++iter)
+    {
+        for (uint16_t i = 0; i < N_VAR; ++i)
+        {
+            w[i] = p_set->sigma*x[i] - q[i];
+        }
+        for (uint16_t k = 0; k < N_CON; ++k)
+        {
+            w[N_VAR + k] = z[k] - y[k]*rho_inv[k];
+        }
+
+        kkt_solve(w);
+
+        for (uint16_t i = 0; i < N_VAR; ++i)
+        {
+            float x_new = p_set->alpha*w[i] + (1 - p_set->alpha)*x[i];
+            dx[i] = x_new - x[i];
+            x[i] = x_new;
+        }
+        for (uint16_t k = 0; k < N_CON; ++k)
+        {
+            float zt_k = z[k] + (w[N_VAR + k] - y[k])*rho_inv[k];
+            zt[k] = p_set->alpha*zt_k + (1 - p_set->alpha)*z[k];
+        }
+        for (uint16_t k = 0; k < N_EQ; ++k)
+        {
+            dy[k] = rho_vec[k]*(zt[k] - beq[k]);
+            y[k] += dy[k];
+            z[k] = beq[k];
+        }
+        for (uint16_t k = N_EQ; k < N_CON; ++k)
+        {
+            float z_new = fminf(zt[k] + y[k]*rho_inv[k], bin[k - N_EQ]);
+            dy[k] = rho_vec[k]*(zt[k] - z_new);
+            y[k] += dy[k];
+            z[k] = z_new;
+        }
+
+        // residuals
+        float r_prim = 0;
+        float prim_scale = 0;
+        mul_A(p_qp, x, zt);
+        for (uint16_t k = 0; k < N_CON; ++k)
+        {
+            r_prim = fmaxf(r_prim, fabsf(zt[k] - z[k]));
+            prim_scale = fmaxf(prim_scale, fmaxf(fabsf(zt[k]), fabsf(z[k])));
+        }
+
+        mul_At(p_qp, y, w);
+        mul_Q(p_qp->p_Q->p_data, x, xt);
+        float r_dual = 0;
+        float dual_scale = 0;
+        for (uint16_t i = 0; i < N_VAR; ++i)
+        {
+            r_dual = fmaxf(r_dual, fabsf(xt[i] + q[i] + w[i]));
+            dual_scale = fmaxf(dual_scale, fmaxf(fabsf(xt[i]), fmaxf(fabsf(w[i]), fabsf(q[i]))));
+        }
+
+        qpgen_box_info.r_prim = r_prim;
+        qpgen_box_info.r_dual = r_dual;
+
+        if ((r_prim <= p_set->eps_abs + p_set->eps_rel*prim_scale)
+            && (r_dual <= p_set->eps_abs + p_set->eps_rel*dual_scale))
+        {
+            status = QP_SUCESS;
+            break;
+        }
+
+        if (prim_infeasible(p_qp))
+        {
+            status = QP_INFEASIBLE;
+            break;
+        }
+
+        if (dual_infeasible(p_qp))
+        {
+            status = QP_UNBOUNDED;
+            break;
+        }
+
+        if ((p_set->adapt_interval > 0) && (0 == iter % p_set->adapt_interval))
+        {
+            float ratio = (r_prim / fmaxf(prim_scale, FLT_EPSILON)) / fmaxf(r_dual / fmaxf(dual_scale, FLT_EPSILON), FLT_EPSILON);
+            float rho_new = fminf(fmaxf(p_set->rho * sqrtf(ratio), RHO_MIN), RHO_MAX);
+
+            if ((rho_new > RHO_TOLERANCE*p_set->rho) || (rho_new < p_set->rho/RHO_TOLERANCE))
+            {
+                set_rho(rho_new);
+                if (QP_SUCESS != kkt_factor(p_qp))
+                {
+                    status = QP_NOT_CONVEX;
+                    break;
+                }
+            }
+        }
+    }
+
+    qpgen_box_info.iter = (iter > p_set->max_iter)? p_set->max_iter : iter;
+    memcpy(p_x->p_data, x, sizeof(x));
+
+    return status;
+}
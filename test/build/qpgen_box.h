@@ -0,0 +1,97 @@
+/**
+ * @file qpgen_box.h
+ *
+ * ADMM solver for n = 8, meq = 1, min = 16 and the sparsity of codegen_box.spec.
+ * Generated by quadprog_codegen, do not edit.
+ *
+ */
+
+#ifndef QPGEN_BOX_H_
+#define QPGEN_BOX_H_
+
+#include "quadprog_admm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QPGEN_BOX_N      (8)
+#define QPGEN_BOX_MEQ    (1)
+#define QPGEN_BOX_MIN    (16)
+#define QPGEN_BOX_LNZ    (31)    /**< Nonzeros of the L factor of the KKT matrix. */
+
+extern quadprog_admm_settings_t qpgen_box_settings;   /**< Settings, same meaning and defaults as quadprog_admm. */
+extern quadprog_admm_info_t qpgen_box_info;           /**< Statistics of the last call. */
+extern float qpgen_box_dx[QPGEN_BOX_N];                      /**< Last primal step, the certificate after QP_UNBOUNDED. */
+extern float qpgen_box_dy[QPGEN_BOX_MEQ + QPGEN_BOX_MIN + 1];       /**< Last dual step, the certificate after QP_INFEASIBLE. */
+
+
+/**
+ * @brief   Sets the default settings, cold starts and factors the KKT matrix (see quadprog_admm_init).
+ *
+ * @param[in]   p_qp    Points to a problem with the structure the solver was generated for.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_NOT_CONVEX :     KKT matrix could not be factored.
+ */
+quadprog_status_t
+qpgen_box_init(const quadprog_t* const p_qp);
+
+
+/**
+ * @brief   Refactors the KKT matrix after the values of Q, Aeq or Ain, or settings.sigma, changed.
+ *
+ * @param[in]   p_qp    Points to the problem.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Operation successful.
+ *              QP_NOT_CONVEX :     KKT matrix could not be factored.
+ */
+quadprog_status_t
+qpgen_box_update_matrices(const quadprog_t* const p_qp);
+
+
+/**
+ * @brief   Sets the primal and/or dual iterates (NULL keeps the current one).
+ *
+ * @param[in]   p_x     Points to primal start, QPGEN_BOX_N elements, or NULL.
+ * @param[in]   p_y     Points to dual start, QPGEN_BOX_MEQ + QPGEN_BOX_MIN elements, or NULL.
+ *
+ * @return  None.
+ */
+void
+qpgen_box_warm_start(const float* const p_x, const float* const p_y);
+
+
+/**
+ * @brief   Resets the iterates to zero.
+ *
+ * @return  None.
+ */
+void
+qpgen_box_cold_start(void);
+
+
+/**
+ * @brief   Runs the ADMM iteration from the stored iterates (see quadprog_admm). Sizes are not checked.
+ *
+ * @param[in]   p_qp    Points to the problem.
+ * @param[out]  p_x     Points to the vector to store the result.
+ *
+ * @return  Execution status
+ *              QP_SUCESS :         Residuals within tolerance.
+ *              QP_NOT_CONVEX :     KKT matrix could not be refactored after a rho update.
+ *              QP_INFEASIBLE :     Constraints are inconsistent, qpgen_box_dy holds the certificate.
+ *              QP_UNBOUNDED :      Cost is unbounded below, qpgen_box_dx holds the direction.
+ *              QP_MAX_ITERATIONS : settings.max_iter reached, p_x holds the last iterate.
+ */
+quadprog_status_t
+qpgen_box_solve(const quadprog_t* const p_qp, matf32_t* const p_x);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QPGEN_BOX_H_
@@ -0,0 +1,37 @@
+# Tridiagonal cost, a budget equality and box bounds on 8 variables, the structure of
+# test_quadprog_budget. Generated into build/ by the quadprog_codegen test target.
+name    qpgen_box
+n       8
+meq     1
+min     16
+
+Q
+1 1 0 0 0 0 0 0
+1 1 1 0 0 0 0 0
+0 1 1 1 0 0 0 0
+0 0 1 1 1 0 0 0
+0 0 0 1 1 1 0 0
+0 0 0 0 1 1 1 0
+0 0 0 0 0 1 1 1
+0 0 0 0 0 0 1 1
+
+Aeq
+1 1 1 1 1 1 1 1
+
+Ain
+ 1  0  0  0  0  0  0  0
+ 0  1  0  0  0  0  0  0
+ 0  0  1  0  0  0  0  0
+ 0  0  0  1  0  0  0  0
+ 0  0  0  0  1  0  0  0
+ 0  0  0  0  0  1  0  0
+ 0  0  0  0  0  0  1  0
+ 0  0  0  0  0  0  0  1
+-1  0  0  0  0  0  0  0
+ 0 -1  0  0  0  0  0  0
+ 0  0 -1  0  0  0  0  0
+ 0  0  0 -1  0  0  0  0
+ 0  0  0  0 -1  0  0  0
+ 0  0  0  0  0 -1  0  0
+ 0  0  0  0  0  0 -1  0
+ 0  0  0  0  0  0  0 -1
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_X     2
+#define N_U     1
+#define N_Y     2
+#define N_W     1
+#define STEPS   2000
+#define DT      0.01f
+#define G_L     9.81f
+#define DAMP    0.2f
+#define LEN     0.5f
+
+// damped pendulum, the position of the bob is measured
+float F_data[] = {0,
+                  DT};
+
+float Qw_data[MATF32_SYM_SIZE(N_W)] = {1};
+float Qv_data[MATF32_SYM_SIZE(N_Y)] = {1e-4f, 0, 1e-4f};
+
+float P_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+float P2_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+float P3_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+
+float A_data[N_X*N_X];
+float A2_data[N_X*N_X];
+float A3_data[N_X*N_X];
+float C_data[N_Y*N_X];
+float C2_data[N_Y*N_X];
+float C3_data[N_Y*N_X];
+
+float Al_data[N_X*N_X];
+float Bl_data[N_X*N_U];
+float Cl_data[N_Y*N_X];
+float Dl_data[N_Y*N_U];
+
+float state_data[N_X];
+float x_data[N_X] = {1, 0};
+float xhat_data[N_X];
+float xhat2_data[N_X];
+float xhat3_data[N_X];
+float u_data[N_U];
+float y_data[N_Y];
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+static err_status_t
+dynamics(matf32_t* const x_next, const matf32_t* x, const matf32_t* u)
+{
+    float th = x->p_data[0];
+    float om = x->p_data[1];
+
+    x_next->p_data[0] = th + DT*om;
+    x_next->p_data[1] = om + DT*(-G_L*sinf(th) - DAMP*om + u->p_data[0]);
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+outputs(matf32_t* const y, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    y->p_data[0] = LEN*sinf(x->p_data[0]);
+    y->p_data[1] = -LEN*cosf(x->p_data[0]);
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+jac_dynamics(matf32_t* const A, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    A->p_data[0] = 1;
+    A->p_data[1] = DT;
+    A->p_data[2] = -DT*G_L*cosf(x->p_data[0]);
+    A->p_data[3] = 1 - DT*DAMP;
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+jac_outputs(matf32_t* const C, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    C->p_data[0] = LEN*cosf(x->p_data[0]);
+    C->p_data[1] = 0;
+    C->p_data[2] = LEN*sinf(x->p_data[0]);
+    C->p_data[3] = 0;
+
+    return MATH_SUCCESS;
+}
+
+
+int main(void)
+{
+    matf32_t F, A, A2, A3, C, C2, C3, Al, Bl, Cl, Dl, state, x, xhat, xhat2, xhat3, u, y;
+    matf32_sym_t Qw, Qv, P, P2, P3;
+    sys_nonlin_t sys;
+    sys_lti_t sys_lin;
+    ekf_info_t kf_exact, kf_fd, kf_reuse;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&F, N_X, N_W, F_data);
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&A2, N_X, N_X, A2_data);
+    matf32_init(&A3, N_X, N_X, A3_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&C2, N_Y, N_X, C2_data);
+    matf32_init(&C3, N_Y, N_X, C3_data);
+    matf32_init(&Al, N_X, N_X, Al_data);
+    matf32_init(&Bl, N_X, N_U, Bl_data);
+    matf32_init(&Cl, N_Y, N_X, Cl_data);
+    matf32_init(&Dl, N_Y, N_U, Dl_data);
+    matf32_init(&state, N_X, 1, state_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xhat, N_X, 1, xhat_data);
+    matf32_init(&xhat2, N_X, 1, xhat2_data);
+    matf32_init(&xhat3, N_X, 1, xhat3_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&y, N_Y, 1, y_data);
+    matf32_sym_init(&Qw, N_W, Qw_data);
+    matf32_sym_init(&Qv, N_Y, Qv_data);
+    matf32_sym_init(&P, N_X, P_data);
+    matf32_sym_init(&P2, N_X, P2_data);
+    matf32_sym_init(&P3, N_X, P3_data);
+    sys_nonlin_init(&sys, &state, N_U, N_Y, dynamics, outputs, DT);
+    ss(&Al, &Bl, &Cl, &Dl, DT, &sys_lin);
+
+    printf("Testing linloc against the analytic Jacobians: \n");
+    u_data[0] = 0.3f;
+    linloc(&sys, &sys_lin, &x, &u, 1e-3f);
+    jac_dynamics(&A, &x, &u);
+    jac_outputs(&C, &x, &u);
+    float err = fmaxf(fabsf(Bl_data[0]), fabsf(Bl_data[1] - DT));
+    for (uint16_t i = 0; i < N_X*N_X; ++i)
+    {
+        err = fmaxf(err, fabsf(Al_data[i] - A_data[i]));
+    }
+    for (uint16_t i = 0; i < N_Y*N_X; ++i)
+    {
+        err = fmaxf(err, fabsf(Cl_data[i] - C_data[i]));
+        err = fmaxf(err, fabsf(Dl_data[i % (N_Y*N_U)]));
+    }
+    printf("max error %e\n", err);
+    ok = (err < 1e-2f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing initialization: \n");
+    ok = (MATH_SUCCESS == ekf_init(&kf_exact, &sys, &F, &Qw, &Qv, &xhat, &P, &A, &C))
+         && (MATH_SUCCESS == ekf_init(&kf_fd, &sys, &F, &Qw, &Qv, &xhat2, &P2, &A2, &C2))
+         && (MATH_SUCCESS == ekf_init(&kf_reuse, &sys, &F, &Qw, &Qv, &xhat3, &P3, &A3, &C3))
+         && (MATH_SUCCESS == ekf_set_jacobians(&kf_exact, jac_dynamics, jac_outputs))
+         && (MATH_SUCCESS == ekf_set_relinearization(&kf_reuse, EKF_FD_DELTA, 0.1f))
+         && (MATH_SIZE_MISMATCH == ekf_init(&kf_fd, &sys, &F, &Qw, &Qv, &xhat2, &P2, &Bl, &C2));
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing %u steps of a noisy pendulum: \n", STEPS);
+    float err_fd = 0;
+    float err_reuse = 0;
+    float err_true = 0;
+    for (uint16_t k = 0; k < STEPS; ++k)
+    {
+        u_data[0] = 0.5f*sinf(0.005f*k);
+
+        // simulated plant with process and measurement noise
+        float w = noise();
+        dynamics(&x, &x, &u);
+        x_data[1] += DT*w;
+        outputs(&y, &x, &u);
+        y_data[0] += 0.01f*noise();
+        y_data[1] += 0.01f*noise();
+
+        ok = (MATH_SUCCESS == ekf_update(&kf_exact, &u, &y))
+             && (MATH_SUCCESS == ekf_update(&kf_fd, &u, &y))
+             && (MATH_SUCCESS == ekf_update(&kf_reuse, &u, &y));
+        if (!ok)
+        {
+            break;
+        }
+
+        if (k > STEPS/10)
+        {
+            for (uint16_t i = 0; i < N_X; ++i)
+            {
+                err_fd = fmaxf(err_fd, fabsf(xhat_data[i] - xhat2_data[i]));
+                err_reuse = fmaxf(err_reuse, fabsf(xhat_data[i] - xhat3_data[i]));
+            }
+            err_true = fmaxf(err_true, fabsf(xhat_data[0] - x_data[0]));
+        }
+    }
+    printf("max angle error %e, finite differences %e, reused Jacobians %e\n", err_true, err_fd, err_reuse);
+    printf("Jacobian evaluations: %u exact, %u finite differences, %u reused\n", kf_exact.jacobian_evals,
+           kf_fd.jacobian_evals, kf_reuse.jacobian_evals);
+    ok = ok && (err_true < 0.05f) && (err_fd < 1e-2f) && (err_reuse < 5e-2f)
+         && (kf_fd.jacobian_evals == 2*STEPS) && (kf_reuse.jacobian_evals < kf_fd.jacobian_evals/2);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("ekf sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("ekf failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_X     4
+#define N_U     2
+#define N_Y     2
+#define N_W     2
+#define STEPS   1000
+#define DT      0.01f
+
+// two decoupled double integrators, positions measured, accelerations driven by noise
+float A_data[] = {1, DT, 0,  0,
+                  0,  1, 0,  0,
+                  0,  0, 1, DT,
+                  0,  0, 0,  1};
+
+float B_data[] = {0.5f*DT*DT, 0,
+                  DT,         0,
+                  0,          0.5f*DT*DT,
+                  0,          DT};
+
+float C_data[] = {1, 0, 0, 0,
+                  0, 0, 1, 0};
+
+float D_data[N_Y*N_U];
+
+float F_data[] = {0.5f*DT*DT, 0,
+                  DT,         0,
+                  0,          0.5f*DT*DT,
+                  0,          DT};
+
+float Qw_data[] = {4, 0,
+                  0, 1};
+
+float Qv_data[] = {1e-4f, 0,
+                   0,     4e-4f};
+
+float Qc_data[] = {1e-4f, 1e-5f,
+                   1e-5f, 4e-4f};
+
+float P_data[N_X*N_X];
+float P2_data[N_X*N_X];
+
+float x_data[N_X];
+float xhat_data[N_X];
+float xhat2_data[N_X];
+float u_data[N_U];
+float y_data[N_Y];
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+int main(void)
+{
+    matf32_t A, B, C, D, F, Qw, Qv, Qc, P, P2, x, xhat, xhat2, u, y;
+    sys_lti_t sys;
+    kalman_info_t kf_seq, kf_inv;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&D, N_Y, N_U, D_data);
+    matf32_init(&F, N_X, N_W, F_data);
+    matf32_init(&Qw, N_W, N_W, Qw_data);
+    matf32_init(&Qv, N_Y, N_Y, Qv_data);
+    matf32_init(&Qc, N_Y, N_Y, Qc_data);
+    matf32_init(&P, N_X, N_X, P_data);
+    matf32_init(&P2, N_X, N_X, P2_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xhat, N_X, 1, xhat_data);
+    matf32_init(&xhat2, N_X, 1, xhat2_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&y, N_Y, 1, y_data);
+    ss(&A, &B, &C, &D, DT, &sys);
+    matf32_eye(&P);
+    matf32_eye(&P2);
+
+    printf("Testing the selection of the sequential update: \n");
+    ok = (MATH_SUCCESS == kalman_init(&kf_inv, &sys, &F, &Qw, &Qc, &xhat2, &P2)) && !kf_inv.is_sequential
+         && (MATH_SUCCESS == kalman_init(&kf_seq, &sys, &F, &Qw, &Qv, &xhat, &P)) && kf_seq.is_sequential;
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing %u steps against the update with S^-1: \n", STEPS);
+    kalman_init(&kf_inv, &sys, &F, &Qw, &Qv, &xhat2, &P2);
+    kf_inv.is_sequential = false;
+    float err_x = 0;
+    float err_p = 0;
+    float asym = 0;
+    for (uint16_t k = 0; k < STEPS; ++k)
+    {
+        u_data[0] = sinf(0.01f*k);
+        u_data[1] = cosf(0.02f*k);
+
+        // simulated plant with process and measurement noise
+        float w0 = 2.0f*noise();
+        float w1 = noise();
+        float x0 = x_data[0] + DT*x_data[1] + 0.5f*DT*DT*(u_data[0] + w0);
+        float x1 = x_data[1] + DT*(u_data[0] + w0);
+        float x2 = x_data[2] + DT*x_data[3] + 0.5f*DT*DT*(u_data[1] + w1);
+        float x3 = x_data[3] + DT*(u_data[1] + w1);
+        x_data[0] = x0;
+        x_data[1] = x1;
+        x_data[2] = x2;
+        x_data[3] = x3;
+        y_data[0] = x_data[0] + 0.01f*noise();
+        y_data[1] = x_data[2] + 0.02f*noise();
+
+        kalman_update(&kf_seq, &u, &y);
+        kalman_update(&kf_inv, &u, &y);
+
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            err_x = fmaxf(err_x, fabsf(xhat_data[i] - xhat2_data[i]));
+        }
+    }
+
+    for (uint16_t i = 0; i < N_X; ++i)
+    {
+        for (uint16_t j = 0; j < N_X; ++j)
+        {
+            err_p = fmaxf(err_p, fabsf(P_data[i*N_X + j] - P2_data[i*N_X + j]) / (1e-6f + fabsf(P2_data[i*N_X + j])));
+            asym = fmaxf(asym, fabsf(P_data[i*N_X + j] - P_data[j*N_X + i]));
+        }
+    }
+    printf("max estimate difference %e, max relative covariance difference %e, asymmetry %e\n", err_x, err_p,
+           asym);
+    ok = (err_x < 1e-3f) && (err_p < 1e-2f) && (asym == 0);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a failed update on the second measurement: \n");
+    float xhat_old[N_X];
+    float P_old[N_X*N_X];
+    memcpy(xhat_old, xhat_data, sizeof(xhat_old));
+    memcpy(P_old, P_data, sizeof(P_old));
+    Qv_data[3] = -1;
+    ok = (MATH_SINGULAR == kalman_correct(&kf_seq, &y))
+         && (0 == memcmp(xhat_old, xhat_data, sizeof(xhat_old))) && (0 == memcmp(P_old, P_data, sizeof(P_old)));
+    Qv_data[3] = 4e-4f;
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("kalman_sequential sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("kalman_sequential failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_X     4
+#define N_U     2
+#define N_Y     2
+#define N_W     2
+#define STEPS   5000
+#define DT      0.01f
+
+// two decoupled double integrators, positions measured, accelerations driven by noise
+float A_data[] = {1, DT, 0,  0,
+                  0,  1, 0,  0,
+                  0,  0, 1, DT,
+                  0,  0, 0,  1};
+
+float B_data[] = {0.5f*DT*DT, 0,
+                  DT,         0,
+                  0,          0.5f*DT*DT,
+                  0,          DT};
+
+float C_data[] = {1, 0, 0, 0,
+                  0, 0, 1, 0};
+
+float D_data[N_Y*N_U];
+
+float F_data[] = {0.5f*DT*DT, 0,
+                  DT,         0,
+                  0,          0.5f*DT*DT,
+                  0,          DT};
+
+float Qw_data[MATF32_SYM_SIZE(N_W)] = {4, 0, 1};
+float Qv_data[MATF32_SYM_SIZE(N_Y)] = {1e-4f, 0, 4e-4f};
+float P_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1, 0, 0, 1, 0, 0, 0, 1};
+
+float Qw2_data[MATF32_SYM_SIZE(N_W)];
+float Qv2_data[MATF32_SYM_SIZE(N_Y)];
+float P2_data[MATF32_SYM_SIZE(N_X)];
+float Pr_data[MATF32_SYM_SIZE(N_X)];
+
+float x_data[N_X];
+float xhat_data[N_X];
+float xhat2_data[N_X];
+float u_data[N_U];
+float y_data[N_Y];
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+int main(void)
+{
+    matf32_t A, B, C, D, F, x, xhat, xhat2, u, y;
+    matf32_sym_t Qw, Qv, P, Qw2, Qv2, P2, Pr;
+    sys_lti_t sys;
+    kalman_sym_info_t kf_sym;
+    kalman_sqrt_info_t kf_sqrt;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&D, N_Y, N_U, D_data);
+    matf32_init(&F, N_X, N_W, F_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xhat, N_X, 1, xhat_data);
+    matf32_init(&xhat2, N_X, 1, xhat2_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&y, N_Y, 1, y_data);
+    ss(&A, &B, &C, &D, DT, &sys);
+
+    for (uint16_t k = 0; k < MATF32_SYM_SIZE(N_X); ++k)
+    {
+        P2_data[k] = P_data[k];
+    }
+    for (uint16_t k = 0; k < MATF32_SYM_SIZE(N_W); ++k)
+    {
+        Qw2_data[k] = Qw_data[k];
+        Qv2_data[k] = Qv_data[k];
+    }
+    matf32_sym_init(&Qw, N_W, Qw_data);
+    matf32_sym_init(&Qv, N_Y, Qv_data);
+    matf32_sym_init(&P, N_X, P_data);
+    matf32_sym_init(&Qw2, N_W, Qw2_data);
+    matf32_sym_init(&Qv2, N_Y, Qv2_data);
+    matf32_sym_init(&P2, N_X, P2_data);
+    matf32_sym_init(&Pr, N_X, Pr_data);
+
+    printf("Testing initialization: \n");
+    ok = (MATH_SUCCESS == kalman_sym_init(&kf_sym, &sys, &F, &Qw, &Qv, &xhat, &P))
+         && (MATH_SUCCESS == kalman_sqrt_init(&kf_sqrt, &sys, &F, &Qw2, &Qv2, &xhat2, &P2))
+         && (fabsf(Qv2_data[0] - 1e-2f) < 1e-6f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing %u steps against the packed covariance filter: \n", STEPS);
+    float err_x = 0;
+    float err_p = 0;
+    for (uint16_t k = 0; k < STEPS; ++k)
+    {
+        u_data[0] = sinf(0.01f*k);
+        u_data[1] = cosf(0.02f*k);
+
+        // simulated plant with process and measurement noise
+        float w0 = 2.0f*noise();
+        float w1 = noise();
+        float x0 = x_data[0] + DT*x_data[1] + 0.5f*DT*DT*(u_data[0] + w0);
+        float x1 = x_data[1] + DT*(u_data[0] + w0);
+        float x2 = x_data[2] + DT*x_data[3] + 0.5f*DT*DT*(u_data[1] + w1);
+        float x3 = x_data[3] + DT*(u_data[1] + w1);
+        x_data[0] = x0;
+        x_data[1] = x1;
+        x_data[2] = x2;
+        x_data[3] = x3;
+        y_data[0] = x_data[0] + 0.01f*noise();
+        y_data[1] = x_data[2] + 0.02f*noise();
+
+        kalman_sym_update(&kf_sym, &u, &y);
+        kalman_sqrt_update(&kf_sqrt, &u, &y);
+
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            err_x = fmaxf(err_x, fabsf(xhat_data[i] - xhat2_data[i]));
+        }
+    }
+
+    kalman_sqrt_get_covariance(&kf_sqrt, &Pr);
+    for (uint16_t k = 0; k < MATF32_SYM_SIZE(N_X); ++k)
+    {
+        err_p = fmaxf(err_p, fabsf(Pr_data[k] - P_data[k]) / (1e-6f + fabsf(P_data[k])));
+    }
+    printf("max estimate difference %e, max relative covariance difference %e\n", err_x, err_p);
+    ok = (err_x < 1e-3f) && (err_p < 1e-2f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing that the factor stays a valid Cholesky factor: \n");
+    ok = true;
+    for (uint16_t i = 0; i < N_X; ++i)
+    {
+        ok = ok && (P2_data[matf32_sym_idx(i, i)] > 0);
+    }
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("kalman_sqrt sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("kalman_sqrt failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_X     4
+#define N_U     2
+#define N_Y     2
+#define N_W     2
+#define STEPS   3000
+#define DT      0.01f
+
+// two decoupled double integrators, positions measured, accelerations driven by noise
+float A_data[] = {1, DT, 0,  0,
+                  0,  1, 0,  0,
+                  0,  0, 1, DT,
+                  0,  0, 0,  1};
+
+float B_data[] = {0.5f*DT*DT, 0,
+                  DT,         0,
+                  0,          0.5f*DT*DT,
+                  0,          DT};
+
+float C_data[] = {1, 0, 0, 0,
+                  0, 0, 1, 0};
+
+float D_data[N_Y*N_U];
+
+float F_data[] = {0.5f*DT*DT, 0,
+                  DT,         0,
+                  0,          0.5f*DT*DT,
+                  0,          DT};
+
+float Qw_data[] = {4, 0,
+                   0, 1};
+
+float Qv_data[] = {1e-4f, 0,
+                   0,     4e-4f};
+
+float Qx_data[] = {1, 0, 0, 0,
+                   0, 1, 0, 0,
+                   0, 0, 1, 0,
+                   0, 0, 0, 1};
+
+float Ru_data[] = {1, 0,
+                   0, 1};
+
+float X_data[N_X*N_X];
+float P_data[N_X*N_X];
+float P2_data[N_X*N_X];
+float P3_data[N_X*N_X];
+float L_data[N_X*N_Y];
+float L3_data[N_X*N_Y];
+
+float x_data[N_X];
+float xhat_data[N_X];
+float xhat2_data[N_X];
+float xhat3_data[N_X];
+float u_data[N_U];
+float y_data[N_Y];
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+/**
+ * @brief   Max relative residual of X = A'XA - A'XB(R + B'XB)^-1 B'XA + Q, with a 2 x 2 R.
+ */
+static float
+dare_residual(void)
+{
+    float XA[N_X*N_X], XB[N_X*N_U], S[N_U*N_U], Si[N_U*N_U], BtXA[N_U*N_X];
+    float res = 0;
+    float x_max = 0;
+
+    for (uint16_t i = 0; i < N_X; ++i)
+    {
+        for (uint16_t j = 0; j < N_X; ++j)
+        {
+            XA[i*N_X + j] = 0;
+            for (uint16_t k = 0; k < N_X; ++k)
+            {
+                XA[i*N_X + j] += X_data[i*N_X + k]*A_data[k*N_X + j];
+            }
+        }
+        for (uint16_t j = 0; j < N_U; ++j)
+        {
+            XB[i*N_U + j] = 0;
+            for (uint16_t k = 0; k < N_X; ++k)
+            {
+                XB[i*N_U + j] += X_data[i*N_X + k]*B_data[k*N_U + j];
+            }
+        }
+    }
+    for (uint16_t i = 0; i < N_U; ++i)
+    {
+        for (uint16_t j = 0; j < N_U; ++j)
+        {
+            S[i*N_U + j] = Ru_data[i*N_U + j];
+            for (uint16_t k = 0; k < N_X; ++k)
+            {
+                S[i*N_U + j] += B_data[k*N_U + i]*XB[k*N_U + j];
+            }
+        }
+        for (uint16_t j = 0; j < N_X; ++j)
+        {
+            BtXA[i*N_X + j] = 0;
+            for (uint16_t k = 0; k < N_X; ++k)
+            {
+                BtXA[i*N_X + j] += B_data[k*N_U + i]*XA[k*N_X + j];
+            }
+        }
+    }
+    float det = S[0]*S[3] - S[1]*S[2];
+    Si[0] = S[3]/det;
+    Si[1] = -S[1]/det;
+    Si[2] = -S[2]/det;
+    Si[3] = S[0]/det;
+
+    for (uint16_t i = 0; i < N_X; ++i)
+    {
+        for (uint16_t j = 0; j < N_X; ++j)
+        {
+            float r = Qx_data[i*N_X + j] - X_data[i*N_X + j];
+            for (uint16_t k = 0; k < N_X; ++k)
+            {
+                r += A_data[k*N_X + i]*XA[k*N_X + j];
+            }
+            for (uint16_t k = 0; k < N_U; ++k)
+            {
+                for (uint16_t l = 0; l < N_U; ++l)
+                {
+                    r -= BtXA[k*N_X + i]*Si[k*N_U + l]*BtXA[l*N_X + j];
+                }
+            }
+            res = fmaxf(res, fabsf(r));
+            x_max = fmaxf(x_max, fabsf(X_data[i*N_X + j]));
+        }
+    }
+
+    return res / x_max;
+}
+
+
+int main(void)
+{
+    matf32_t A, B, C, D, F, Qw, Qv, Qx, Ru, X, P, P2, P3, L, L3, x, xhat, xhat2, xhat3, u, y;
+    sys_lti_t sys;
+    kalman_info_t kf_full, kf_steady, kf_auto;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&D, N_Y, N_U, D_data);
+    matf32_init(&F, N_X, N_W, F_data);
+    matf32_init(&Qw, N_W, N_W, Qw_data);
+    matf32_init(&Qv, N_Y, N_Y, Qv_data);
+    matf32_init(&Qx, N_X, N_X, Qx_data);
+    matf32_init(&Ru, N_U, N_U, Ru_data);
+    matf32_init(&X, N_X, N_X, X_data);
+    matf32_init(&P, N_X, N_X, P_data);
+    matf32_init(&P2, N_X, N_X, P2_data);
+    matf32_init(&P3, N_X, N_X, P3_data);
+    matf32_init(&L, N_X, N_Y, L_data);
+    matf32_init(&L3, N_X, N_Y, L3_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xhat, N_X, 1, xhat_data);
+    matf32_init(&xhat2, N_X, 1, xhat2_data);
+    matf32_init(&xhat3, N_X, 1, xhat3_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&y, N_Y, 1, y_data);
+    ss(&A, &B, &C, &D, DT, &sys);
+    matf32_eye(&P);
+    matf32_eye(&P2);
+    matf32_eye(&P3);
+
+    printf("Testing the DARE residual: \n");
+    ok = (MATH_SUCCESS == dare(&A, &B, &Qx, &Ru, &X));
+    float res = dare_residual();
+    printf("relative residual %e\n", res);
+    ok = ok && (res < 1e-4f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a non-stabilizable pair: \n");
+    A_data[0] = 1.1f;
+    B_data[0] = 0;
+    B_data[2] = 0;
+    ok = (MATH_DECOMPOSITION_FAILURE == dare(&A, &B, &Qx, &Ru, &X));
+    A_data[0] = 1;
+    B_data[0] = 0.5f*DT*DT;
+    B_data[2] = DT;
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing the steady-state filter against the full filter: \n");
+    kalman_init(&kf_full, &sys, &F, &Qw, &Qv, &xhat, &P);
+    kalman_init(&kf_steady, &sys, &F, &Qw, &Qv, &xhat2, &P2);
+    kalman_init(&kf_auto, &sys, &F, &Qw, &Qv, &xhat3, &P3);
+    ok = (MATH_SUCCESS == kalman_steady_state(&kf_steady, &L, 0)) && kf_steady.is_steady
+         && (MATH_SUCCESS == kalman_steady_state(&kf_auto, &L3, 1e-5f)) && !kf_auto.is_steady;
+
+    float err_x = 0;
+    float err_p = 0;
+    uint16_t k_switch = 0;
+    for (uint16_t k = 0; k < STEPS; ++k)
+    {
+        u_data[0] = sinf(0.01f*k);
+        u_data[1] = cosf(0.02f*k);
+
+        // simulated plant with process and measurement noise
+        float w0 = 2.0f*noise();
+        float w1 = noise();
+        float x0 = x_data[0] + DT*x_data[1] + 0.5f*DT*DT*(u_data[0] + w0);
+        float x1 = x_data[1] + DT*(u_data[0] + w0);
+        float x2 = x_data[2] + DT*x_data[3] + 0.5f*DT*DT*(u_data[1] + w1);
+        float x3 = x_data[3] + DT*(u_data[1] + w1);
+        x_data[0] = x0;
+        x_data[1] = x1;
+        x_data[2] = x2;
+        x_data[3] = x3;
+        y_data[0] = x_data[0] + 0.01f*noise();
+        y_data[1] = x_data[2] + 0.02f*noise();
+
+        kalman_predict(&kf_full, &u);
+        if (k == STEPS - 1)
+        {
+            // a priori covariance of the full filter against the DARE solution
+            for (uint16_t i = 0; i < N_X*N_X; ++i)
+            {
+                err_p = fmaxf(err_p, fabsf(P_data[i] - P2_data[i]) / (1e-6f + fabsf(P_data[i])));
+            }
+        }
+        kalman_correct(&kf_full, &y);
+        kalman_update(&kf_steady, &u, &y);
+        kalman_update(&kf_auto, &u, &y);
+
+        if (kf_auto.is_steady && (k_switch == 0))
+        {
+            k_switch = k;
+        }
+        if (k > STEPS / 2)
+        {
+            for (uint16_t i = 0; i < N_X; ++i)
+            {
+                err_x = fmaxf(err_x, fabsf(xhat_data[i] - xhat2_data[i]));
+            }
+        }
+    }
+    printf("max estimate difference %e, max relative covariance difference %e\n", err_x, err_p);
+    ok = ok && (err_x < 1e-3f) && (err_p < 1e-2f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing the automatic switch to steady state: \n");
+    float err_l = 0;
+    for (uint16_t i = 0; i < N_X*N_Y; ++i)
+    {
+        err_l = fmaxf(err_l, fabsf(L_data[i] - L3_data[i]) / (1e-6f + fabsf(L_data[i])));
+    }
+    printf("switched at step %u, max relative gain difference %e\n", k_switch, err_l);
+    ok = kf_auto.is_steady && (k_switch > 0) && (err_l < 1e-2f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("kalman_steady sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("kalman_steady failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_X     4
+#define N_U     2
+#define N_Y     2
+#define DT      0.05f
+
+// double integrator, x'' = u
+float Ac_data[] = {0, 1,
+                   0, 0};
+
+float Bc_data[] = {0,
+                   1};
+
+float Cc_data[] = {1, 0};
+
+float Dc_data[] = {0};
+
+float Qc_data[] = {1, 0,
+                   0, 1};
+
+float Rc_data[] = {1};
+
+// analytic solution of the double integrator problem
+float Xc_ref[] = {1.7320508f, 1,
+                  1,          1.7320508f};
+
+float Kc_ref[] = {1, 1.7320508f};
+
+// two coupled, lightly damped masses
+float A_data[] = {1,      DT,     0,      0,
+                  -2*DT,  0.99f,  DT,     0,
+                  0,      0,      1,      DT,
+                  DT,     0,      -2*DT,  0.99f};
+
+float B_data[] = {0,  0,
+                  DT, 0,
+                  0,  0,
+                  0,  DT};
+
+float C_data[] = {1, 0, 0, 0,
+                  0, 0, 1, 0};
+
+float D_data[N_Y*N_U];
+
+float Q_data[] = {10, 0, 0, 0,
+                  0,  1, 0, 0,
+                  0,  0, 10, 0,
+                  0,  0, 0,  1};
+
+float R_data[] = {0.1f, 0,
+                  0,    0.2f};
+
+float Xc_data[2*2];
+float Kc_data[1*2];
+float X_data[N_X*N_X];
+float K_data[N_U*N_X];
+float X2_data[N_X*N_X];
+float K2_data[N_U*N_X];
+
+
+/**
+ * @brief   Gain of the Riccati difference equation after many steps back from X = Q, in double precision.
+ */
+static void
+dlqr_reference(double* const K)
+{
+    double X[N_X*N_X], Xn[N_X*N_X], XA[N_X*N_X], XB[N_X*N_U], S[N_U*N_U], BtXA[N_U*N_X];
+
+    for (uint16_t i = 0; i < N_X*N_X; ++i)
+    {
+        X[i] = Q_data[i];
+    }
+
+    for (uint16_t iter = 0; iter < 500; ++iter)
+    {
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            for (uint16_t j = 0; j < N_X; ++j)
+            {
+                XA[i*N_X + j] = 0;
+                for (uint16_t k = 0; k < N_X; ++k)
+                {
+                    XA[i*N_X + j] += X[i*N_X + k]*A_data[k*N_X + j];
+                }
+            }
+            for (uint16_t j = 0; j < N_U; ++j)
+            {
+                XB[i*N_U + j] = 0;
+                for (uint16_t k = 0; k < N_X; ++k)
+                {
+                    XB[i*N_U + j] += X[i*N_X + k]*B_data[k*N_U + j];
+                }
+            }
+        }
+        for (uint16_t i = 0; i < N_U; ++i)
+        {
+            for (uint16_t j = 0; j < N_U; ++j)
+            {
+                S[i*N_U + j] = R_data[i*N_U + j];
+                for (uint16_t k = 0; k < N_X; ++k)
+                {
+                    S[i*N_U + j] += B_data[k*N_U + i]*XB[k*N_U + j];
+                }
+            }
+            for (uint16_t j = 0; j < N_X; ++j)
+            {
+                BtXA[i*N_X + j] = 0;
+                for (uint16_t k = 0; k < N_X; ++k)
+                {
+                    BtXA[i*N_X + j] += B_data[k*N_U + i]*XA[k*N_X + j];
+                }
+            }
+        }
+
+        // K = S^-1 * B'XA
+        double det = S[0]*S[3] - S[1]*S[2];
+        for (uint16_t j = 0; j < N_X; ++j)
+        {
+            K[j] = (S[3]*BtXA[j] - S[1]*BtXA[N_X + j])/det;
+            K[N_X + j] = (S[0]*BtXA[N_X + j] - S[2]*BtXA[j])/det;
+        }
+
+        // X = A'XA - A'XB*K + Q
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            for (uint16_t j = 0; j < N_X; ++j)
+            {
+                double sum = Q_data[i*N_X + j];
+                for (uint16_t k = 0; k < N_X; ++k)
+                {
+                    sum += A_data[k*N_X + i]*XA[k*N_X + j];
+                }
+                for (uint16_t k = 0; k < N_U; ++k)
+                {
+                    sum -= BtXA[k*N_X + i]*K[k*N_X + j];
+                }
+                Xn[i*N_X + j] = sum;
+            }
+        }
+        for (uint16_t i = 0; i < N_X*N_X; ++i)
+        {
+            X[i] = 0.5*(Xn[i] + Xn[(i % N_X)*N_X + i / N_X]);
+        }
+    }
+}
+
+
+int main(void)
+{
+    matf32_t Ac, Bc, Cc, Dc, Qc, Rc, Xc, Kc, A, B, C, D, Q, R, X, K, X2, K2;
+    sys_lti_t sys_c, sys_d;
+    double K_ref[N_U*N_X];
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&Ac, 2, 2, Ac_data);
+    matf32_init(&Bc, 2, 1, Bc_data);
+    matf32_init(&Cc, 1, 2, Cc_data);
+    matf32_init(&Dc, 1, 1, Dc_data);
+    matf32_init(&Qc, 2, 2, Qc_data);
+    matf32_init(&Rc, 1, 1, Rc_data);
+    matf32_init(&Xc, 2, 2, Xc_data);
+    matf32_init(&Kc, 1, 2, Kc_data);
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&D, N_Y, N_U, D_data);
+    matf32_init(&Q, N_X, N_X, Q_data);
+    matf32_init(&R, N_U, N_U, R_data);
+    matf32_init(&X, N_X, N_X, X_data);
+    matf32_init(&K, N_U, N_X, K_data);
+    matf32_init(&X2, N_X, N_X, X2_data);
+    matf32_init(&K2, N_U, N_X, K2_data);
+    ss(&Ac, &Bc, &Cc, &Dc, 0, &sys_c);
+    ss(&A, &B, &C, &D, DT, &sys_d);
+
+    printf("Testing lqr on the double integrator: \n");
+    ok = (MATH_SUCCESS == lqr(&sys_c, &Qc, &Rc, &Kc, &Xc, 0));
+    float err = 0;
+    for (uint16_t i = 0; i < 4; ++i)
+    {
+        err = fmaxf(err, fabsf(Xc_data[i] - Xc_ref[i]));
+    }
+    for (uint16_t i = 0; i < 2; ++i)
+    {
+        err = fmaxf(err, fabsf(Kc_data[i] - Kc_ref[i]));
+    }
+    matf32_print(&Kc);
+    printf("max error %e\n", err);
+    ok = ok && (err < 1e-4f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing lqr with Newton-Kleinman refinement: \n");
+    ok = (MATH_SUCCESS == lqr(&sys_c, &Qc, &Rc, &Kc, &Xc, 2));
+    err = 0;
+    for (uint16_t i = 0; i < 4; ++i)
+    {
+        err = fmaxf(err, fabsf(Xc_data[i] - Xc_ref[i]));
+    }
+    printf("max error %e\n", err);
+    ok = ok && (err < 1e-4f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing dlqr against the Riccati difference equation: \n");
+    dlqr_reference(K_ref);
+    ok = (MATH_SUCCESS == dlqr(&sys_d, &Q, &R, &K, &X, 0))
+         && (MATH_SUCCESS == dlqr(&sys_d, &Q, &R, &K2, &X2, 1));
+    float err_k = 0;
+    float err_k2 = 0;
+    for (uint16_t i = 0; i < N_U*N_X; ++i)
+    {
+        err_k = fmaxf(err_k, fabsf(K_data[i] - (float)K_ref[i]) / (1e-3f + fabsf((float)K_ref[i])));
+        err_k2 = fmaxf(err_k2, fabsf(K2_data[i] - (float)K_ref[i]) / (1e-3f + fabsf((float)K_ref[i])));
+    }
+    printf("max relative gain error %e, refined %e\n", err_k, err_k2);
+    ok = ok && (err_k < 1e-3f) && (err_k2 < 1e-3f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing the time domain checks: \n");
+    ok = (MATH_ARGUMENT_ERROR == dlqr(&sys_c, &Qc, &Rc, &Kc, &Xc, 0))
+         && (MATH_ARGUMENT_ERROR == lqr(&sys_d, &Q, &R, &K, &X, 0))
+         && (MATH_SIZE_MISMATCH == dlqr(&sys_d, &Q, &R, &Kc, &X, 0));
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("lqr sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("lqr failure.\n");
+        return 1;
+    }
+}
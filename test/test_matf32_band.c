@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "robotat_linalg.h"
+
+float T_data[] = { 4, -1,  0,  0,  0,  0,
+                  -1,  4, -1,  0,  0,  0,
+                   0, -1,  4, -1,  0,  0,
+                   0,  0, -1,  4, -1,  0,
+                   0,  0,  0, -1,  4, -1,
+                   0,  0,  0,  0, -1,  4};
+
+float bt_data[] = {2, 4, 6, 8, 10, 19};
+
+float rt_data[] = {1, 2, 3, 4, 5, 6};
+
+
+float P_data[] = { 6, -1,  0,  0,  0,  0,  0,
+                  -2,  6, -1,  0,  0,  0,  0,
+                   1, -2,  6, -1,  0,  0,  0,
+                   0,  1, -2,  6, -1,  0,  0,
+                   0,  0,  1, -2,  6, -1,  0,
+                   0,  0,  0,  1, -2,  6, -1,
+                   0,  0,  0,  0,  1, -2,  6};
+
+float bp_data[] = {7, -10, 17, -20, 27, -30, 33};
+
+
+float S_data[] = { 6, -2,  1,  0,  0,  0,  0,
+                  -2,  6, -2,  1,  0,  0,  0,
+                   1, -2,  6, -2,  1,  0,  0,
+                   0,  1, -2,  6, -2,  1,  0,
+                   0,  0,  1, -2,  6, -2,  1,
+                   0,  0,  0,  1, -2,  6, -2,
+                   0,  0,  0,  0,  1, -2,  6};
+
+float bs_data[] = {10, -14, 22, -26, 34, -34, 33};
+
+float r_data[] = {1, -1, 2, -2, 3, -3, 4};
+
+float band_data[7*7];
+float x_data[7];
+
+int
+main(void)
+{
+    matf32_t T, P, S, bt, bp, bs, x, Result;
+    matf32_band_t band;
+    uint16_t kl, ku;
+    bool ans = true;
+
+    matf32_init(&T, 6, 6, T_data);
+    matf32_init(&bt, 6, 1, bt_data);
+    matf32_init(&P, 7, 7, P_data);
+    matf32_init(&bp, 7, 1, bp_data);
+    matf32_init(&S, 7, 7, S_data);
+    matf32_init(&bs, 7, 1, bs_data);
+
+    printf("Testing bandwidth: \n");
+    matf32_bandwidth(&P, &kl, &ku);
+    printf("kl = %i, ku = %i\n", kl, ku);
+    ans = ans && (2 == kl) && (1 == ku);
+
+    printf("Testing method selection: \n");
+    print_linsolve_method(matf32_linsolve_get_method(&T));
+    print_linsolve_method(matf32_linsolve_get_method(&P));
+    ans = ans && (BANDED == matf32_linsolve_get_method(&T)) && (BANDED == matf32_linsolve_get_method(&P));
+
+    printf("Testing tridiagonal linsolve: \n");
+    matf32_init(&x, 6, 1, x_data);
+    matf32_init(&Result, 6, 1, rt_data);
+    matf32_linsolve(&T, &bt, &x);
+    matf32_print(&x);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    printf("Testing banded linsolve: \n");
+    matf32_init(&x, 7, 1, x_data);
+    matf32_init(&Result, 7, 1, r_data);
+    matf32_linsolve(&P, &bp, &x);
+    matf32_print(&x);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    printf("Testing banded cholesky: \n");
+    matf32_bandwidth(&S, &kl, &ku);
+    matf32_band_init(&band, 7, kl, ku, band_data);
+    matf32_band_from_dense(&S, &band);
+    ans = ans && (MATH_SUCCESS == matf32_band_cholesky(&band));
+    matf32_band_cholesky_solve(&band, &bs, &x);
+    matf32_print(&x);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    if (ans)
+    {
+        printf("matf32_band sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("matf32_band failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "robotat_linalg.h"
+
+// zero leading element, the factorization has to pivot
+float A_data[] = {0,  2, 1, -1,
+                  3,  1, 0,  2,
+                  1, -1, 4,  0,
+                  2,  0, 1,  3};
+
+float B_data[] = { 3,  2,
+                   5, -1,
+                  -5, 11,
+                   1,  4};
+
+float X_data[] = { 1, -1,
+                   2,  0,
+                  -1,  3,
+                   0,  1};
+
+float S_data[] = {1, 2,
+                  2, 4};
+
+float N_data[6];
+
+int
+main(void)
+{
+    matf32_t A, B, X, S, N;
+    uint16_t piv[4];
+    bool ans = true;
+
+    matf32_init(&A, 4, 4, A_data);
+    matf32_init(&B, 4, 2, B_data);
+    matf32_init(&X, 4, 2, X_data);
+    matf32_init(&S, 2, 2, S_data);
+    matf32_init(&N, 2, 3, N_data);
+
+    printf("Testing the pivoted factorization and a two column solve: \n");
+    ans = ans && (MATH_SUCCESS == matf32_lu_factor(&A, piv));
+    ans = ans && (MATH_SUCCESS == matf32_lu_factor_solve(&A, piv, &B));
+    matf32_print(&B);
+    ans = ans && matf32_is_equal(&B, &X);
+
+    printf("Testing a singular and a non square matrix: \n");
+    ans = ans && (MATH_SINGULAR == matf32_lu_factor(&S, piv));
+    ans = ans && (MATH_SIZE_MISMATCH == matf32_lu_factor(&N, piv));
+
+    if (ans)
+    {
+        printf("matf32_lu_factor sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("matf32_lu_factor failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "robotat_linalg.h"
+
+#define N_LAP   (9)
+#define N_KKT   (5)
+
+// 3x3 grid laplacian
+float L_data[] = { 4, -1,  0, -1,  0,  0,  0,  0,  0,
+                  -1,  4, -1,  0, -1,  0,  0,  0,  0,
+                   0, -1,  4,  0,  0, -1,  0,  0,  0,
+                  -1,  0,  0,  4, -1,  0, -1,  0,  0,
+                   0, -1,  0, -1,  4, -1,  0, -1,  0,
+                   0,  0, -1,  0, -1,  4,  0,  0, -1,
+                   0,  0,  0, -1,  0,  0,  4, -1,  0,
+                   0,  0,  0,  0, -1,  0, -1,  4, -1,
+                   0,  0,  0,  0,  0, -1,  0, -1,  4};
+
+float bl_data[] = {-2, -1, 4, 3, 0, 7, 16, 11, 22};
+
+float rl_data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+float rl2_data[] = {0.5, 1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5};
+
+// quasi-definite KKT matrix [Q A'; A -I]
+float K_data[] = {4, 1, 0,  1,  0,
+                  1, 3, 0,  0,  1,
+                  0, 0, 2,  1,  1,
+                  1, 0, 1, -1,  0,
+                  0, 1, 1,  0, -1};
+
+float bk_data[] = {1, -3, 7, 5, -1};
+
+float rk_data[] = {1, -2, 3, -1, 2};
+
+float R_data[] = {1, 0, 2,
+                  0, 3, 0};
+
+float x_data[N_LAP];
+
+uint16_t ptr_data[N_LAP + 1];
+uint16_t ind_data[N_LAP*N_LAP];
+float sp_data[N_LAP*N_LAP];
+
+uint16_t ptr2_data[N_LAP + 1];
+uint16_t ind2_data[N_LAP*N_LAP];
+float sp2_data[N_LAP*N_LAP];
+
+uint16_t perm_data[N_LAP];
+uint16_t order_work[SPMAT_MINDEG_IWORK(N_LAP)];
+uint16_t sym_buf[SPLDL_SYMBOLIC_IWORK(N_LAP)];
+uint16_t num_ibuf[SPLDL_NUMERIC_IWORK(N_LAP, SPLDL_DENSE_LNZ(N_LAP))];
+float num_fbuf[SPLDL_NUMERIC_FWORK(N_LAP, SPLDL_DENSE_LNZ(N_LAP))];
+
+int
+main(void)
+{
+    matf32_t L, K, M, x, Result;
+    spmatf32_t A, B;
+    spldl_symbolic_t sym;
+    spldl_numeric_t num;
+    bool ans = true;
+
+    float v3[3] = {1, 1, 1};
+    float v2[2] = {1, 2};
+    float y[3];
+
+    printf("Testing spmv: \n");
+    matf32_init(&M, 2, 3, R_data);
+    spmatf32_init(&A, 2, 3, SPMAT_CSR, 6, ptr_data, ind_data, sp_data);
+    spmatf32_from_matf32(&M, &A);
+    spmatf32_init(&B, 2, 3, SPMAT_CSC, 6, ptr2_data, ind2_data, sp2_data);
+    spmatf32_convert(&A, &B);
+
+    spmatf32_vecmul(&A, v3, y);
+    ans = ans && is_equal_margin(y[0], 3) && is_equal_margin(y[1], 3);
+    spmatf32_vecmul(&B, v3, y);
+    ans = ans && is_equal_margin(y[0], 3) && is_equal_margin(y[1], 3);
+    spmatf32_vecmul_trans(&A, v2, y);
+    ans = ans && is_equal_margin(y[0], 1) && is_equal_margin(y[1], 6) && is_equal_margin(y[2], 2);
+    spmatf32_vecmul_trans(&B, v2, y);
+    ans = ans && is_equal_margin(y[0], 1) && is_equal_margin(y[1], 6) && is_equal_margin(y[2], 2);
+    printf("%s\n", ans? "sucess" : "failure");
+
+    printf("Testing sparse cholesky with minimum degree ordering: \n");
+    matf32_init(&L, N_LAP, N_LAP, L_data);
+    spmatf32_init(&A, N_LAP, N_LAP, SPMAT_CSC, N_LAP*N_LAP, ptr_data, ind_data, sp_data);
+    spmatf32_from_matf32(&L, &A);
+    printf("nnz(A) = %i\n", spmatf32_nnz(&A));
+
+    spldl_symbolic_init(&sym, N_LAP, sym_buf);
+    spldl_symbolic(&A, &sym, NULL);
+    printf("nnz(L) natural order = %i\n", sym.lnz);
+
+    spmatf32_order_mindeg(&A, perm_data, order_work);
+    spldl_symbolic(&A, &sym, perm_data);
+    printf("nnz(L) minimum degree = %i\n", sym.lnz);
+
+    spldl_numeric_init(&num, &sym, SPLDL_DENSE_LNZ(N_LAP), num_ibuf, num_fbuf);
+    ans = ans && (MATH_SUCCESS == spldl_cholesky(&A, &num));
+    spldl_solve(&num, bl_data, x_data);
+
+    matf32_init(&x, N_LAP, 1, x_data);
+    matf32_init(&Result, N_LAP, 1, rl_data);
+    matf32_print(&x);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    printf("Testing numeric refactorization: \n");
+    for (uint16_t p = 0; p < spmatf32_nnz(&A); ++p)
+    {
+        sp_data[p] *= 2;
+    }
+    ans = ans && (MATH_SUCCESS == spldl_cholesky(&A, &num));
+    spldl_solve(&num, bl_data, x_data);
+    matf32_init(&Result, N_LAP, 1, rl2_data);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    printf("Testing sparse LDL' on quasi-definite matrix: \n");
+    matf32_init(&K, N_KKT, N_KKT, K_data);
+    spmatf32_init(&A, N_KKT, N_KKT, SPMAT_CSC, N_LAP*N_LAP, ptr_data, ind_data, sp_data);
+    spmatf32_from_matf32(&K, &A);
+
+    spldl_symbolic_init(&sym, N_KKT, sym_buf);
+    spmatf32_order_mindeg(&A, perm_data, order_work);
+    spldl_symbolic(&A, &sym, perm_data);
+    spldl_numeric_init(&num, &sym, SPLDL_DENSE_LNZ(N_KKT), num_ibuf, num_fbuf);
+
+    ans = ans && (MATH_DECOMPOSITION_FAILURE == spldl_cholesky(&A, &num));
+    ans = ans && (MATH_SUCCESS == spldl_numeric(&A, &num));
+    spldl_solve(&num, bk_data, x_data);
+
+    matf32_init(&x, N_KKT, 1, x_data);
+    matf32_init(&Result, N_KKT, 1, rk_data);
+    matf32_print(&x);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    if (ans)
+    {
+        printf("matf32_sparse sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("matf32_sparse failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_SYM   (4)
+
+float S_data[] = { 4, 1, 0, 2,
+                   1, 5, 1, 0,
+                   0, 1, 6, 1,
+                   2, 0, 1, 7};
+
+float A_data[] = { 1, 2, 0, -1,
+                   0, 1, 3,  1};
+
+float b_data[] = {14, 14, 24, 33};
+
+float r_data[] = {1, 2, 3, 4};
+
+// discrete double integrator with a bias state, position and bias measured
+float Ad_data[] = {1, 0.1, 0,
+                   0, 1,   0,
+                   0, 0,   1};
+float Bd_data[] = {0.005, 0.1, 0};
+float Cd_data[] = {1, 0, 1,
+                   0, 0, 1};
+float Dd_data[] = {0, 0};
+float Fd_data[] = {0.005, 0.1, 0.01};
+float Qw_data[] = {0.5};
+float Qv_data[] = {0.1, 0.02,
+                   0.02, 0.05};
+
+float sym_data[MATF32_SYM_SIZE(N_SYM)];
+float full_data[N_SYM*N_SYM];
+float work_data[N_SYM*N_SYM];
+float x_data[N_SYM];
+
+int
+main(void)
+{
+    matf32_t S, A, b, x, full, Result;
+    matf32_sym_t Sp, ASAt;
+    bool ans = true;
+
+    matf32_init(&S, N_SYM, N_SYM, S_data);
+    matf32_init(&A, 2, N_SYM, A_data);
+    matf32_init(&b, N_SYM, 1, b_data);
+    matf32_init(&full, N_SYM, N_SYM, full_data);
+    matf32_sym_init(&Sp, N_SYM, sym_data);
+
+    printf("Testing pack/unpack: \n");
+    matf32_sym_from_dense(&S, &Sp);
+    matf32_sym_to_dense(&Sp, &full);
+    ans = ans && matf32_is_equal(&S, &full) && is_equal_margin(*matf32_sym_at(&Sp, 3, 0), 2);
+    printf("%s\n", ans? "sucess" : "failure");
+
+    printf("Testing symmetric vecmul: \n");
+    matf32_init(&x, N_SYM, 1, x_data);
+    matf32_init(&Result, N_SYM, 1, b_data);
+    matf32_sym_vecmul(&Sp, r_data, x_data);
+    ans = ans && matf32_is_equal(&x, &Result);
+    printf("%s\n", ans? "sucess" : "failure");
+
+    printf("Testing congruence A*S*A': \n");
+    float asat_dense_data[4];
+    float asat_packed_data[MATF32_SYM_SIZE(2)];
+    float at_data[N_SYM*2];
+    matf32_t At, ASAt_dense, ASAt_full;
+    matf32_init(&At, N_SYM, 2, at_data);
+    matf32_init(&ASAt_dense, 2, 2, asat_dense_data);
+    matf32_trans(&A, &At);
+    const matf32_t* ASAt_arr[] = {&A, &S, &At};
+    matf32_arr_mul(ASAt_arr, 3, &ASAt_dense);
+
+    matf32_sym_init(&ASAt, 2, asat_packed_data);
+    matf32_sym_congruence(&A, &Sp, 0, &ASAt, work_data);
+    matf32_init(&ASAt_full, 2, 2, full_data);
+    matf32_sym_to_dense(&ASAt, &ASAt_full);
+    matf32_print(&ASAt_full);
+    ans = ans && matf32_is_equal(&ASAt_full, &ASAt_dense);
+
+    printf("Testing packed cholesky: \n");
+    ans = ans && (MATH_SUCCESS == matf32_sym_cholesky(&Sp));
+    matf32_sym_cholesky_solve(&Sp, &b, &x);
+    matf32_init(&Result, N_SYM, 1, r_data);
+    matf32_print(&x);
+    ans = ans && matf32_is_equal(&x, &Result);
+
+    printf("Testing packed kalman filter against dense kalman filter: \n");
+    float state_data[3] = {0};
+    float xhat_data[3] = {0};
+    float xhat_sym_data[3] = {0};
+    float P_data[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    float P_sym_data[MATF32_SYM_SIZE(3)];
+    float Qw_sym_data[MATF32_SYM_SIZE(1)];
+    float Qv_sym_data[MATF32_SYM_SIZE(2)];
+    float u_data[1], y_data[2];
+    float P_full_data[9];
+
+    matf32_t state, Ad, Bd, Cd, Dd, Fd, Qw, Qv, xhat, xhat_sym, P, P_full, u, y;
+    matf32_sym_t P_sym, Qw_sym, Qv_sym;
+    sys_lti_t sys;
+    kalman_info_t kf;
+    kalman_sym_info_t kf_sym;
+
+    matf32_init(&state, 3, 1, state_data);
+    matf32_init(&Ad, 3, 3, Ad_data);
+    matf32_init(&Bd, 3, 1, Bd_data);
+    matf32_init(&Cd, 2, 3, Cd_data);
+    matf32_init(&Dd, 2, 1, Dd_data);
+    matf32_init(&Fd, 3, 1, Fd_data);
+    matf32_init(&Qw, 1, 1, Qw_data);
+    matf32_init(&Qv, 2, 2, Qv_data);
+    matf32_init(&xhat, 3, 1, xhat_data);
+    matf32_init(&xhat_sym, 3, 1, xhat_sym_data);
+    matf32_init(&P, 3, 3, P_data);
+    matf32_init(&P_full, 3, 3, P_full_data);
+    matf32_init(&u, 1, 1, u_data);
+    matf32_init(&y, 2, 1, y_data);
+
+    matf32_sym_init(&P_sym, 3, P_sym_data);
+    matf32_sym_init(&Qw_sym, 1, Qw_sym_data);
+    matf32_sym_init(&Qv_sym, 2, Qv_sym_data);
+    matf32_sym_from_dense(&P, &P_sym);
+    matf32_sym_from_dense(&Qw, &Qw_sym);
+    matf32_sym_from_dense(&Qv, &Qv_sym);
+
+    sys_lti_init(&sys, &state, &Ad, &Bd, &Cd, &Dd, 0.1);
+    ans = ans && (MATH_SUCCESS == kalman_init(&kf, &sys, &Fd, &Qw, &Qv, &xhat, &P));
+    ans = ans && (MATH_SUCCESS == kalman_sym_init(&kf_sym, &sys, &Fd, &Qw_sym, &Qv_sym, &xhat_sym, &P_sym));
+
+    for (uint16_t k = 0; k < 20; ++k)
+    {
+        u_data[0] = 1;
+        y_data[0] = 0.05*k*k*0.01 + 0.3;
+        y_data[1] = 0.3;
+
+        kalman_update(&kf, &u, &y);
+        ans = ans && (MATH_SUCCESS == kalman_sym_update(&kf_sym, &u, &y));
+    }
+
+    matf32_sym_to_dense(&P_sym, &P_full);
+    matf32_print(&xhat_sym);
+    matf32_print(&P_full);
+    ans = ans && matf32_is_equal(&xhat, &xhat_sym) && matf32_is_equal(&P, &P_full);
+
+    if (ans)
+    {
+        printf("matf32_sym sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("matf32_sym failure.\n");
+        return 1;
+    }
+}
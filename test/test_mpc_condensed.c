@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_mpc.h"
+
+#define N_X     (3)
+#define N_U     (2)
+#define HORIZON (8)
+#define N_V     (HORIZON*N_U)
+
+float A_data[] = {1.0, 0.1, 0.0,
+                  0.0, 1.0, 0.1,
+                  0.2, -0.1, 0.9};
+
+float B_data[] = {0.0, 0.1,
+                  0.1, 0.0,
+                  0.05, 0.2};
+
+float C_data[] = {1, 0, 0};
+
+float D_data[] = {0, 0};
+
+float state_data[N_X];
+
+float Qx_data[] = {2.0, 0.1, 0.0,
+                   0.1, 1.0, 0.0,
+                   0.0, 0.0, 0.5};
+
+float R_data[] = {0.2, 0.05,
+                  0.05, 0.1};
+
+float P_data[] = {5.0, 0.5, 0.0,
+                  0.5, 3.0, 0.2,
+                  0.0, 0.2, 1.0};
+
+float umin_data[] = {-0.5, -0.3};
+float umax_data[] = {0.5, 0.4};
+
+float x_data[] = {1.0, -0.5, 0.3};
+float xref_data[] = {0.2, 0.0, -0.1};
+float u_data[N_U];
+float ref_data[N_V];
+
+float mpc_fwork[MPC_CONDENSED_FWORK(N_X, N_U, HORIZON)];
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(N_V, 0, 2*N_V)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(N_V, 0, 2*N_V)];
+
+// naive prediction matrices X = Phi x0 + Gamma U
+float Phi_data[HORIZON*N_X*N_X];
+float Gamma_data[HORIZON*N_X*N_V];
+
+
+static float
+max_diff(const float* a, const float* b, uint16_t len)
+{
+    float d = 0;
+    for (uint16_t k = 0; k < len; ++k)
+    {
+        d = fmaxf(d, fabsf(a[k] - b[k]) / (1 + fabsf(b[k])));
+    }
+
+    return d;
+}
+
+
+/**
+ * @brief   Builds Phi and Gamma by simulation and returns the error of H, F and G against Gamma'Qbar Gamma + Rbar,
+ * Gamma'Qbar Phi and Gamma'Qbar [I; ...; I].
+ */
+static float
+check_matrices(const mpc_condensed_t* mpc)
+{
+    // Phi block k = A^(k+1), Gamma block (k, j) = A^(k-j) B
+    for (uint16_t k = 0; k < HORIZON; ++k)
+    {
+        for (uint16_t r = 0; r < N_X; ++r)
+        {
+            for (uint16_t s = 0; s < N_X; ++s)
+            {
+                float v = A_data[r*N_X + s];
+                if (k > 0)
+                {
+                    v = 0;
+                    for (uint16_t l = 0; l < N_X; ++l)
+                    {
+                        v += A_data[r*N_X + l] * Phi_data[((k - 1)*N_X + l)*N_X + s];
+                    }
+                }
+                Phi_data[(k*N_X + r)*N_X + s] = v;
+            }
+
+            for (uint16_t s = 0; s < N_V; ++s)
+            {
+                uint16_t j = s / N_U;
+                float v = 0;
+                if (j == k)
+                {
+                    v = B_data[r*N_U + s % N_U];
+                }
+                else if (j < k)
+                {
+                    for (uint16_t l = 0; l < N_X; ++l)
+                    {
+                        v += A_data[r*N_X + l] * Gamma_data[((k - 1)*N_X + l)*N_V + s];
+                    }
+                }
+                Gamma_data[(k*N_X + r)*N_V + s] = v;
+            }
+        }
+    }
+
+    float err = 0;
+    float H_ref[N_V*N_V], F_ref[N_V*N_X], G_ref[N_V*N_X];
+
+    for (uint16_t a = 0; a < N_V; ++a)
+    {
+        for (uint16_t b = 0; b < N_V; ++b)
+        {
+            float sum = ((a / N_U) == (b / N_U)) ? R_data[(a % N_U)*N_U + b % N_U] : 0;
+            for (uint16_t k = 0; k < HORIZON; ++k)
+            {
+                const float* W = (k == HORIZON - 1) ? P_data : Qx_data;
+                for (uint16_t r = 0; r < N_X; ++r)
+                {
+                    for (uint16_t s = 0; s < N_X; ++s)
+                    {
+                        sum += Gamma_data[(k*N_X + r)*N_V + a] * W[r*N_X + s] * Gamma_data[(k*N_X + s)*N_V + b];
+                    }
+                }
+            }
+            H_ref[a*N_V + b] = sum;
+        }
+
+        for (uint16_t b = 0; b < N_X; ++b)
+        {
+            float sumF = 0, sumG = 0;
+            for (uint16_t k = 0; k < HORIZON; ++k)
+            {
+                const float* W = (k == HORIZON - 1) ? P_data : Qx_data;
+                for (uint16_t r = 0; r < N_X; ++r)
+                {
+                    for (uint16_t s = 0; s < N_X; ++s)
+                    {
+                        sumF += Gamma_data[(k*N_X + r)*N_V + a] * W[r*N_X + s] * Phi_data[(k*N_X + s)*N_X + b];
+                    }
+                    sumG += Gamma_data[(k*N_X + r)*N_V + a] * W[r*N_X + b];
+                }
+            }
+            F_ref[a*N_X + b] = sumF;
+            G_ref[a*N_X + b] = sumG;
+        }
+    }
+
+    err = fmaxf(err, max_diff(mpc->H.p_data, H_ref, N_V*N_V));
+    err = fmaxf(err, max_diff(mpc->F.p_data, F_ref, N_V*N_X));
+    err = fmaxf(err, max_diff(mpc->G.p_data, G_ref, N_V*N_X));
+
+    return err;
+}
+
+
+int main(void)
+{
+    matf32_t A, B, C, D, state, Qx, R, P, umin, umax, x, xref, u, ref;
+    sys_lti_t sys;
+    mpc_condensed_t mpc;
+    quadprog_workspace_t ws;
+    quadprog_status_t status;
+    bool ans = true;
+
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, 1, N_X, C_data);
+    matf32_init(&D, 1, N_U, D_data);
+    matf32_init(&state, N_X, 1, state_data);
+    matf32_init(&Qx, N_X, N_X, Qx_data);
+    matf32_init(&R, N_U, N_U, R_data);
+    matf32_init(&P, N_X, N_X, P_data);
+    matf32_init(&umin, N_U, 1, umin_data);
+    matf32_init(&umax, N_U, 1, umax_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xref, N_X, 1, xref_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&ref, N_V, 1, ref_data);
+
+    sys_lti_init(&sys, &state, &A, &B, &C, &D, 0.1);
+    quadprog_workspace_init(&ws, N_V, 0, 2*N_V, ws_fwork, ws_iwork);
+
+    printf("Testing condensed matrices against the prediction matrices: \n");
+    mpc_condensed_init(&mpc, &sys, HORIZON, &Qx, &R, &P, &umin, &umax, mpc_fwork);
+    float err = check_matrices(&mpc);
+    printf("max relative error %e\n", err);
+    ans = ans && (err < 1e-5);
+
+    printf("Testing model update: \n");
+    A_data[8] = 0.8;
+    B_data[0] = 0.02;
+    mpc_condensed_update_model(&mpc);
+    err = check_matrices(&mpc);
+    printf("max relative error %e\n", err);
+    ans = ans && (err < 1e-5);
+
+    printf("Testing bounded closed loop: \n");
+    bool in_bounds = true;
+    bool agree = true;
+    for (uint16_t k = 0; k < 40; ++k)
+    {
+        status = mpc_condensed_solve(&mpc, &x, &xref, &ws, &u);
+        in_bounds = in_bounds && (QP_SUCESS == status);
+
+        // same QP through the general active-set solver
+        quadprog_gi(&mpc.qp, &ws, &ref, NULL);
+        agree = agree && (max_diff(mpc.U.p_data, ref_data, N_V) < 1e-4);
+
+        for (uint16_t j = 0; j < N_U; ++j)
+        {
+            in_bounds = in_bounds && (u_data[j] >= umin_data[j] - 1e-6) && (u_data[j] <= umax_data[j] + 1e-6);
+        }
+
+        float xn[N_X];
+        for (uint16_t r = 0; r < N_X; ++r)
+        {
+            xn[r] = 0;
+            for (uint16_t s = 0; s < N_X; ++s)
+            {
+                xn[r] += A_data[r*N_X + s] * x_data[s];
+            }
+            for (uint16_t s = 0; s < N_U; ++s)
+            {
+                xn[r] += B_data[r*N_U + s] * u_data[s];
+            }
+        }
+        memcpy(x_data, xn, sizeof(xn));
+    }
+    printf("x = (%f, %f, %f), bounds %s, active-set agreement %s\n", x_data[0], x_data[1], x_data[2],
+        in_bounds ? "ok" : "violated", agree ? "ok" : "failed");
+    ans = ans && in_bounds && agree;
+
+    printf("Testing unbounded problem: \n");
+    mpc_condensed_init(&mpc, &sys, HORIZON, &Qx, &R, NULL, NULL, NULL, mpc_fwork);
+    status = mpc_condensed_solve(&mpc, &x, NULL, &ws, &u);
+    float res = 0;
+    for (uint16_t a = 0; a < N_V; ++a)
+    {
+        float g = mpc.c.p_data[a];
+        for (uint16_t b = 0; b < N_V; ++b)
+        {
+            g += mpc.H.p_data[a*N_V + b] * mpc.U.p_data[b];
+        }
+        res = fmaxf(res, fabsf(g));
+    }
+    printf("gradient norm %e\n", res);
+    ans = ans && (QP_SUCESS == status) && (res < 1e-4);
+
+    if (ans)
+    {
+        printf("mpc_condensed sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("mpc_condensed failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_mpc.h"
+
+#define N_X     (3)
+#define N_U     (2)
+#define HORIZON (8)
+#define N_V     (HORIZON*N_U)
+#define N_Z     (HORIZON*(N_U + N_X))   // sparse formulation, [u0; x1; u1; x2; ...]
+
+float A_data[] = {1.0, 0.1, 0.0,
+                  0.0, 1.0, 0.1,
+                  0.2, -0.1, 0.9};
+
+float B_data[] = {0.0, 0.1,
+                  0.1, 0.0,
+                  0.05, 0.2};
+
+float C_data[] = {1, 0, 0};
+
+float D_data[] = {0, 0};
+
+float state_data[N_X];
+
+float Qx_data[] = {2.0, 0.1, 0.0,
+                   0.1, 1.0, 0.0,
+                   0.0, 0.0, 0.5};
+
+float R_data[] = {0.2, 0.05,
+                  0.05, 0.1};
+
+float P_data[] = {5.0, 0.5, 0.0,
+                  0.5, 3.0, 0.2,
+                  0.0, 0.2, 1.0};
+
+// [umin; xmin], [umax; xmax]
+float lb_data[] = {-0.5, -0.3, -INFINITY, -0.6, -INFINITY};
+float ub_data[] = {0.5, 0.4, INFINITY, INFINITY, 0.75};
+float lbu_data[] = {-0.5, -0.3, -INFINITY, -INFINITY, -INFINITY};
+float ubu_data[] = {0.5, 0.4, INFINITY, INFINITY, INFINITY};
+float umin_data[] = {-0.5, -0.3};
+float umax_data[] = {0.5, 0.4};
+
+float x_data[] = {1.0, -0.5, 0.3};
+float xref_data[] = {0.2, 0.0, -0.1};
+float u_data[N_U];
+float uc_data[N_U];
+
+float sparse_fwork[MPC_SPARSE_FWORK(N_X, N_U, HORIZON)];
+float condensed_fwork[MPC_CONDENSED_FWORK(N_X, N_U, HORIZON)];
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(N_Z, HORIZON*N_X, 2*N_Z)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(N_Z, HORIZON*N_X, 2*N_Z)];
+
+// sparse formulation for quadprog_gi
+float Qz_data[N_Z*N_Z];
+float cz_data[N_Z];
+float Aeq_data[HORIZON*N_X*N_Z];
+float beq_data[HORIZON*N_X];
+float Ain_data[2*N_Z*N_Z];
+float bin_data[2*N_Z];
+float z_data[N_Z];
+float zs_data[N_Z];
+
+
+static float
+max_diff(const float* a, const float* b, uint16_t len)
+{
+    float d = 0;
+    for (uint16_t k = 0; k < len; ++k)
+    {
+        float e = fabsf(a[k] - b[k]) / (1 + fabsf(b[k]));
+        d = (isnan(e) || (e > d)) ? e : d;
+    }
+
+    return d;
+}
+
+
+/**
+ * @brief   Cost 1/2 z'Qz + c'z of the sparse formulation built by reference_solve.
+ */
+static float
+sparse_cost(const float* z)
+{
+    float cost = 0;
+    for (uint16_t i = 0; i < N_Z; ++i)
+    {
+        float sum = 0;
+        for (uint16_t j = 0; j < N_Z; ++j)
+        {
+            sum += Qz_data[i*N_Z + j] * z[j];
+        }
+        cost += z[i] * (0.5f*sum + cz_data[i]);
+    }
+
+    return cost;
+}
+
+
+/**
+ * @brief   Solves the same problem with quadprog_gi on the stage-wise variables and dynamics as equalities.
+ */
+static quadprog_status_t
+reference_solve(quadprog_workspace_t* ws, uint16_t* p_num_active)
+{
+    const uint16_t nk = N_U + N_X;
+    uint16_t min = 0;
+
+    memset(Qz_data, 0, sizeof(Qz_data));
+    memset(cz_data, 0, sizeof(cz_data));
+    memset(Aeq_data, 0, sizeof(Aeq_data));
+    memset(Ain_data, 0, sizeof(Ain_data));
+
+    for (uint16_t k = 0; k < HORIZON; ++k)
+    {
+        const float* W = (k == HORIZON - 1) ? P_data : Qx_data;
+        const uint16_t iu = k*nk;
+        const uint16_t ix = k*nk + N_U;
+
+        for (uint16_t i = 0; i < N_U; ++i)
+        {
+            for (uint16_t j = 0; j < N_U; ++j)
+            {
+                Qz_data[(iu + i)*N_Z + iu + j] = R_data[i*N_U + j];
+            }
+        }
+
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            for (uint16_t j = 0; j < N_X; ++j)
+            {
+                Qz_data[(ix + i)*N_Z + ix + j] = W[i*N_X + j];
+                cz_data[ix + i] -= W[i*N_X + j] * xref_data[j];
+            }
+
+            // xk+1 - A xk - B uk = 0 (A x0 on the right for k = 0)
+            uint16_t row = k*N_X + i;
+            Aeq_data[row*N_Z + ix + i] = 1;
+            beq_data[row] = 0;
+            for (uint16_t j = 0; j < N_U; ++j)
+            {
+                Aeq_data[row*N_Z + iu + j] = -B_data[i*N_U + j];
+            }
+            for (uint16_t j = 0; j < N_X; ++j)
+            {
+                if (k == 0)
+                {
+                    beq_data[row] += A_data[i*N_X + j] * x_data[j];
+                }
+                else
+                {
+                    Aeq_data[row*N_Z + (k - 1)*nk + N_U + j] = -A_data[i*N_X + j];
+                }
+            }
+        }
+
+        for (uint16_t a = 0; a < nk; ++a)
+        {
+            if (isfinite(ub_data[a]))
+            {
+                Ain_data[min*N_Z + k*nk + a] = 1;
+                bin_data[min++] = ub_data[a];
+            }
+            if (isfinite(lb_data[a]))
+            {
+                Ain_data[min*N_Z + k*nk + a] = -1;
+                bin_data[min++] = -lb_data[a];
+            }
+        }
+    }
+
+    matf32_t Q, c, Aeq, beq, Ain, bin, z;
+    quadprog_t qp;
+
+    matf32_init(&Q, N_Z, N_Z, Qz_data);
+    matf32_init(&c, N_Z, 1, cz_data);
+    matf32_init(&Aeq, HORIZON*N_X, N_Z, Aeq_data);
+    matf32_init(&beq, HORIZON*N_X, 1, beq_data);
+    matf32_init(&Ain, min, N_Z, Ain_data);
+    matf32_init(&bin, min, 1, bin_data);
+    matf32_init(&z, N_Z, 1, z_data);
+    quadprog_init(&qp, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+
+    quadprog_status_t status = quadprog_gi(&qp, ws, &z, NULL);
+
+    *p_num_active = 0;
+    for (uint16_t i = 0; i < min; ++i)
+    {
+        float sum = -bin_data[i];
+        for (uint16_t j = 0; j < N_Z; ++j)
+        {
+            sum += Ain_data[i*N_Z + j] * z_data[j];
+        }
+        *p_num_active += (fabsf(sum) < 1e-5);
+    }
+
+    return status;
+}
+
+
+int main(void)
+{
+    matf32_t A, B, C, D, state, Qx, R, P, umin, umax, x, xref, u, uc;
+    sys_lti_t sys;
+    mpc_sparse_t mpc;
+    mpc_condensed_t cmpc;
+    quadprog_workspace_t ws;
+    quadprog_status_t status;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, 1, N_X, C_data);
+    matf32_init(&D, 1, N_U, D_data);
+    matf32_init(&state, N_X, 1, state_data);
+    matf32_init(&Qx, N_X, N_X, Qx_data);
+    matf32_init(&R, N_U, N_U, R_data);
+    matf32_init(&P, N_X, N_X, P_data);
+    matf32_init(&umin, N_U, 1, umin_data);
+    matf32_init(&umax, N_U, 1, umax_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xref, N_X, 1, xref_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&uc, N_U, 1, uc_data);
+
+    sys_lti_init(&sys, &state, &A, &B, &C, &D, 0.1);
+    quadprog_workspace_init(&ws, N_Z, HORIZON*N_X, 2*N_Z, ws_fwork, ws_iwork);
+
+    printf("Testing unconstrained problem against the condensed MPC: \n");
+    mpc_sparse_init(&mpc, &sys, HORIZON, &Qx, &R, &P, NULL, NULL, sparse_fwork);
+    mpc_condensed_init(&cmpc, &sys, HORIZON, &Qx, &R, &P, NULL, NULL, condensed_fwork);
+    status = mpc_sparse_solve(&mpc, &x, &xref, &u);
+    mpc_condensed_solve(&cmpc, &x, &xref, &ws, &uc);
+    ok = (QP_SUCESS == status) && (max_diff(mpc.p_u, cmpc.U.p_data, N_V) < 1e-4);
+    printf("%d iterations, %s\n", mpc.iter, ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing input bounds against the condensed MPC: \n");
+    mpc_sparse_init(&mpc, &sys, HORIZON, &Qx, &R, &P, lbu_data, ubu_data, sparse_fwork);
+    mpc_condensed_init(&cmpc, &sys, HORIZON, &Qx, &R, &P, &umin, &umax, condensed_fwork);
+    status = mpc_sparse_solve(&mpc, &x, &xref, &u);
+    mpc_condensed_solve(&cmpc, &x, &xref, &ws, &uc);
+    ok = (QP_SUCESS == status) && (max_diff(mpc.p_u, cmpc.U.p_data, N_V) < 1e-4);
+    printf("%d iterations, %s\n", mpc.iter, ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing state and input bounds against the active-set solver: \n");
+    mpc_sparse_init(&mpc, &sys, HORIZON, &Qx, &R, &P, lb_data, ub_data, sparse_fwork);
+    for (uint16_t tick = 0; tick < 10; ++tick)
+    {
+        uint16_t num_active = 0;
+        status = mpc_sparse_solve(&mpc, &x, &xref, &u);
+        quadprog_status_t ref_status = reference_solve(&ws, &num_active);
+
+        // z = [u0; x1; u1; x2; ...]
+        for (uint16_t k = 0; k < HORIZON; ++k)
+        {
+            memcpy(&zs_data[k*(N_U + N_X)], &mpc.p_u[k*N_U], N_U*sizeof(float));
+            memcpy(&zs_data[k*(N_U + N_X) + N_U], &mpc.p_x[(k + 1)*N_X], N_X*sizeof(float));
+        }
+
+        // the cost is compared tightly, the trajectories loosely (the active set is degenerate on some ticks)
+        float err = max_diff(zs_data, z_data, N_Z);
+        float cost = sparse_cost(zs_data);
+        float cost_ref = sparse_cost(z_data);
+        ok = (QP_SUCESS == status) && (QP_SUCESS == ref_status) && (err < 1e-2)
+            && (fabsf(cost - cost_ref) < 1e-4*(1 + fabsf(cost_ref)));
+        printf("tick %d: %d iterations, %d bounds active, cost %f (%f), error %e, %s\n", tick, mpc.iter, num_active,
+            cost, cost_ref, err, ok ? "sucess" : "failure");
+        ans = ans && ok;
+
+        // apply u0
+        float xn[N_X];
+        for (uint16_t r = 0; r < N_X; ++r)
+        {
+            xn[r] = 0;
+            for (uint16_t s = 0; s < N_X; ++s)
+            {
+                xn[r] += A_data[r*N_X + s] * x_data[s];
+            }
+            for (uint16_t s = 0; s < N_U; ++s)
+            {
+                xn[r] += B_data[r*N_U + s] * u_data[s];
+            }
+        }
+        memcpy(x_data, xn, sizeof(xn));
+    }
+
+    if (ans)
+    {
+        printf("mpc_sparse sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("mpc_sparse failure.\n");
+        return 1;
+    }
+}
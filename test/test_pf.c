@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+#include "robotat_pf.h"
+
+#define N_X     2
+#define N_U     1
+#define N_Y     2
+#define N_W     1
+#define N_PART  1000
+#define STEPS   1000
+#define DRAWS   20000
+#define DT      0.01f
+#define G_L     9.81f
+#define DAMP    0.2f
+#define LEN     0.5f
+
+// damped pendulum, the position of the bob is measured
+float F_data[] = {0,
+                  DT};
+
+float Qw_data[MATF32_SYM_SIZE(N_W)];
+float Qv_data[MATF32_SYM_SIZE(N_Y)];
+float Qw2_data[MATF32_SYM_SIZE(N_W)];
+float Qv2_data[MATF32_SYM_SIZE(N_Y)];
+float P_data[MATF32_SYM_SIZE(N_X)];
+float P2_data[MATF32_SYM_SIZE(N_X)];
+
+// linearization at the bottom, for the comparison with the linear filter
+float A_data[] = {1,        DT,
+                  -DT*G_L,  1 - DT*DAMP};
+
+float B_data[] = {0,
+                  DT};
+
+float C_data[] = {LEN, 0,
+                  0,   0.5f*LEN};
+
+float D_data[N_Y*N_U];
+
+float state_data[N_X];
+float x_data[N_X] = {1.5f, 0};
+float xhat_data[N_X];
+float xhat2_data[N_X];
+float u_data[N_U];
+float y_data[N_Y];
+
+float work[PF_FWORK(N_X, N_Y, N_PART)];
+float work2[PF_FWORK(N_X, N_Y, N_PART)];
+float px_ref[N_X*N_PART];
+float pw_ref[N_PART];
+float picked[N_PART];
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+static err_status_t
+dynamics(matf32_t* const x_next, const matf32_t* x, const matf32_t* u)
+{
+    float th = x->p_data[0];
+    float om = x->p_data[1];
+
+    x_next->p_data[0] = th + DT*om;
+    x_next->p_data[1] = om + DT*(-G_L*sinf(th) - DAMP*om + u->p_data[0]);
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+outputs(matf32_t* const y, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    y->p_data[0] = LEN*sinf(x->p_data[0]);
+    y->p_data[1] = -LEN*cosf(x->p_data[0]);
+
+    return MATH_SUCCESS;
+}
+
+
+// same model over all the particles, stored by component
+static err_status_t
+dynamics_batch(float* const p_x, uint16_t count, const matf32_t* u)
+{
+    float* const th = p_x;
+    float* const om = p_x + count;
+
+    for (uint16_t k = 0; k < count; ++k)
+    {
+        float th_k = th[k];
+        th[k] = th_k + DT*om[k];
+        om[k] = om[k] + DT*(-G_L*sinf(th_k) - DAMP*om[k] + u->p_data[0]);
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+outputs_batch(float* const p_y, const float* p_x, uint16_t count, const matf32_t* u)
+{
+    (void)u;
+    for (uint16_t k = 0; k < count; ++k)
+    {
+        p_y[k] = LEN*sinf(p_x[k]);
+        p_y[count + k] = -LEN*cosf(p_x[k]);
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+linear_dynamics(matf32_t* const x_next, const matf32_t* x, const matf32_t* u)
+{
+    x_next->p_data[0] = A_data[0]*x->p_data[0] + A_data[1]*x->p_data[1] + B_data[0]*u->p_data[0];
+    x_next->p_data[1] = A_data[2]*x->p_data[0] + A_data[3]*x->p_data[1] + B_data[1]*u->p_data[0];
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+linear_outputs(matf32_t* const y, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    y->p_data[0] = C_data[0]*x->p_data[0] + C_data[1]*x->p_data[1];
+    y->p_data[1] = C_data[2]*x->p_data[0] + C_data[3]*x->p_data[1];
+
+    return MATH_SUCCESS;
+}
+
+
+// noise covariances and initial covariance of both filters, pf_init factors Qw and Qv in place
+static void
+reset_covariances(float qw, float qv)
+{
+    Qw_data[0] = Qw2_data[0] = qw;
+    Qv_data[0] = Qv2_data[0] = qv;
+    Qv_data[1] = Qv2_data[1] = 0;
+    Qv_data[2] = Qv2_data[2] = qv;
+    P_data[0] = P2_data[0] = 0.1f;
+    P_data[1] = P2_data[1] = 0;
+    P_data[2] = P2_data[2] = 0.1f;
+}
+
+
+int main(void)
+{
+    matf32_t F, A, B, C, D, state, x, xhat, xhat2, u, y;
+    matf32_sym_t Qw, Qv, Qw2, Qv2, P, P2;
+    sys_nonlin_t sys, sys_lin;
+    sys_lti_t sys_lti;
+    pf_info_t pf, pf_batch;
+    pf_rng_t rng, rng2;
+    kalman_sym_info_t kf_lin;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&F, N_X, N_W, F_data);
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&D, N_Y, N_U, D_data);
+    matf32_init(&state, N_X, 1, state_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xhat, N_X, 1, xhat_data);
+    matf32_init(&xhat2, N_X, 1, xhat2_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&y, N_Y, 1, y_data);
+    matf32_sym_init(&Qw, N_W, Qw_data);
+    matf32_sym_init(&Qv, N_Y, Qv_data);
+    matf32_sym_init(&Qw2, N_W, Qw2_data);
+    matf32_sym_init(&Qv2, N_Y, Qv2_data);
+    matf32_sym_init(&P, N_X, P_data);
+    matf32_sym_init(&P2, N_X, P2_data);
+    sys_nonlin_init(&sys, &state, N_U, N_Y, dynamics, outputs, DT);
+    sys_nonlin_init(&sys_lin, &state, N_U, N_Y, linear_dynamics, linear_outputs, DT);
+    ss(&A, &B, &C, &D, DT, &sys_lti);
+
+    printf("Testing the random number generator: \n");
+    pf_rng_seed(&rng, 1);
+    pf_rng_seed(&rng2, 1);
+    float mean_u = 0;
+    float mean_n = 0;
+    float var_n = 0;
+    ok = true;
+    for (uint16_t k = 0; k < DRAWS; ++k)
+    {
+        float r = pf_rng_uniform(&rng);
+        float z = pf_rng_normal(&rng);
+        ok = ok && (r >= 0) && (r < 1) && (r == pf_rng_uniform(&rng2)) && (z == pf_rng_normal(&rng2));
+        mean_u += r / DRAWS;
+        mean_n += z / DRAWS;
+        var_n += z*z / DRAWS;
+    }
+    printf("uniform mean %f, normal mean %f, normal variance %f\n", mean_u, mean_n, var_n);
+    ok = ok && (fabsf(mean_u - 0.5f) < 0.01f) && (fabsf(mean_n) < 0.03f) && (fabsf(var_n - 1) < 0.05f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    // enough process noise to keep the particles diverse, within a fraction of the Kalman standard deviation
+    printf("Testing a linear model against the linear filter (%u particles): \n", N_PART);
+    reset_covariances(100, 1e-2f);
+    ok = (MATH_SUCCESS == pf_init(&pf, &sys_lin, &F, &Qw, &Qv, &xhat, &P, N_PART, work, 1))
+         && (MATH_SUCCESS == kalman_sym_init(&kf_lin, &sys_lti, &F, &Qw2, &Qv2, &xhat2, &P2));
+    float err_x = 0;
+    for (uint16_t k = 0; (k < 500) && ok; ++k)
+    {
+        u_data[0] = sinf(0.01f*k);
+        y_data[0] = 0.1f*sinf(0.02f*k) + 0.1f*noise();
+        y_data[1] = 0.05f*cosf(0.03f*k) + 0.1f*noise();
+
+        ok = (MATH_SUCCESS == pf_update(&pf, &u, &y));
+        kalman_sym_update(&kf_lin, &u, &y);
+        for (uint16_t i = 0; (i < N_X) && (k > 50); ++i)
+        {
+            err_x = fmaxf(err_x, fabsf(xhat_data[i] - xhat2_data[i]));
+        }
+    }
+    printf("max estimate difference %e, %u resamples\n", err_x, pf.num_resamples);
+    ok = ok && (err_x < 0.05f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing %u steps of a noisy pendulum from a wrong initial estimate: \n", STEPS);
+    reset_covariances(1, 1e-4f);
+    P_data[0] = P2_data[0] = 1;
+    P_data[2] = P2_data[2] = 1;
+    for (uint16_t i = 0; i < N_X; ++i)
+    {
+        xhat_data[i] = 0;
+        xhat2_data[i] = 0;
+    }
+    ok = (MATH_SUCCESS == pf_init(&pf, &sys, &F, &Qw, &Qv, &xhat, &P, N_PART, work, 7))
+         && (MATH_SUCCESS == pf_init(&pf_batch, &sys, &F, &Qw2, &Qv2, &xhat2, &P2, N_PART, work2, 7))
+         && (MATH_SUCCESS == pf_set_batch(&pf_batch, dynamics_batch, outputs_batch))
+         && (MATH_SUCCESS == pf_set_workers(&pf, 4)) && (MATH_SUCCESS == pf_set_workers(&pf_batch, 4));
+    float err_true = 0;
+    float err_batch = 0;
+    for (uint16_t k = 0; (k < STEPS) && ok; ++k)
+    {
+        u_data[0] = 0.5f*sinf(0.005f*k);
+
+        // simulated plant with process and measurement noise
+        float w = noise();
+        dynamics(&x, &x, &u);
+        x_data[1] += DT*w;
+        outputs(&y, &x, &u);
+        y_data[0] += 0.01f*noise();
+        y_data[1] += 0.01f*noise();
+
+        ok = (MATH_SUCCESS == pf_update(&pf, &u, &y)) && (MATH_SUCCESS == pf_update(&pf_batch, &u, &y));
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            err_batch = fmaxf(err_batch, fabsf(xhat_data[i] - xhat2_data[i]));
+        }
+        if (k > STEPS/10)
+        {
+            err_true = fmaxf(err_true, fabsf(xhat_data[0] - x_data[0]));
+        }
+    }
+    printf("max angle error %e, batched callbacks difference %e, %u resamples\n", err_true, err_batch,
+           pf.num_resamples);
+    ok = ok && (err_true < 0.05f) && (err_batch < 1e-5f) && (pf.num_resamples > 0);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    // particle k carries k in its first component, so the selected sources can be compared directly
+    printf("Testing the blocked resampling against a single pass: \n");
+    for (uint16_t k = 0; k < N_PART; ++k)
+    {
+        px_ref[k] = k;
+        px_ref[N_PART + k] = 0;
+        pw_ref[k] = (float)(1 + k % 7) / (4*N_PART);
+    }
+    pf_rng_t rng_ref = pf.rng;
+    ok = true;
+    for (uint16_t workers = 1; workers <= 5; workers += 2)
+    {
+        pf.rng = rng_ref;
+        for (uint16_t k = 0; k < N_X*N_PART; ++k)
+        {
+            pf.p_x[k] = px_ref[k];
+        }
+        for (uint16_t k = 0; k < N_PART; ++k)
+        {
+            pf.p_w[k] = pw_ref[k];
+        }
+        ok = ok && (MATH_SUCCESS == pf_set_workers(&pf, workers));
+        pf_resample(&pf);
+        for (uint16_t k = 0; k < N_PART; ++k)
+        {
+            if (1 == workers)
+            {
+                picked[k] = pf.p_x[k];
+            }
+            ok = ok && (pf.p_x[k] == picked[k]) && (pf.p_w[k] == 1.0f / N_PART);
+            ok = ok && ((0 == k) || (pf.p_x[k] >= pf.p_x[k - 1]));
+        }
+    }
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing the argument checks: \n");
+    reset_covariances(1, 1e-2f);
+    sys.is_continuous = true;
+    ok = (MATH_ARGUMENT_ERROR == pf_init(&pf, &sys, &F, &Qw, &Qv, &xhat, &P, N_PART, work, 1));
+    sys.is_continuous = false;
+    ok = ok && (MATH_ARGUMENT_ERROR == pf_init(&pf, &sys, &F, &Qw, &Qv, &xhat, &P, 0, work, 1))
+         && (MATH_SIZE_MISMATCH == pf_init(&pf, &sys, &A, &Qw, &Qv, &xhat, &P, N_PART, work, 1))
+         && (MATH_ARGUMENT_ERROR == pf_set_workers(&pf_batch, 0))
+         && (MATH_ARGUMENT_ERROR == pf_set_workers(&pf_batch, PARALLEL_MAX_WORKERS + 1));
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("pf sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("pf failure.\n");
+        return 1;
+    }
+}
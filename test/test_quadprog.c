@@ -19,6 +19,9 @@ float x_data[] = {0,0};
 
 float Result_data[] = {-0.8, 0.8};
 
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(2, 1, 0)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(2, 1, 0)];
+
 
 int main(void)
 {
@@ -26,6 +29,9 @@ int main(void)
     float time_data = 0;
 
     matf32_t Q, c, Aeq, beq,  x, Result;
+    quadprog_workspace_t ws;
+
+    quadprog_workspace_init(&ws, 2, 1, 0, ws_fwork, ws_iwork);
 
     matf32_init(&Q, 2, 2, Q_data);
     matf32_init(&c, 2, 1, c_data);
@@ -55,7 +61,7 @@ int main(void)
     for (int i = 0; i < 100; ++i)
     {
         time = clock();
-        quadprog(&problem, &x);
+        quadprog(&problem, &ws, &x);
         time_data += ((float)clock()-time)/CLOCKS_PER_SEC;
     }
 
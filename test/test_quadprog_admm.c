@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+
+#define N_VAR   2
+#define M_CON   4
+#define NNZ_MAX QP_ADMM_KKT_NNZ_MAX(N_VAR, M_CON)
+#define LNZ_MAX QP_ADMM_LNZ_MAX(N_VAR, M_CON)
+
+float Q_data[] = { 1, -1,
+                  -1,  2};
+
+float c_data[] = {-2, -6};
+
+float c2_data[] = {-2.2, -5.8};
+
+float Ain_data[] = { 1, 1,
+                    -1, 2,
+                     2, 1};
+
+float bin_data[] = {2, 2, 3};
+
+float Aeq_data[] = {1, -1};
+
+float beq_data[] = {0};
+
+float x_data[N_VAR];
+float r_data[N_VAR];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(2, 1, 3)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(2, 1, 3)];
+
+float fbuf[QP_ADMM_FWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+uint16_t ibuf[QP_ADMM_IWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, ref;
+    quadprog_t problem;
+    quadprog_admm_t solver;
+    quadprog_status_t status;
+    quadprog_workspace_t ws;
+    bool ans = true;
+
+    quadprog_workspace_init(&ws, 2, 1, 3, ws_fwork, ws_iwork);
+
+    matf32_init(&Q, 2, 2, Q_data);
+    matf32_init(&c, 2, 1, c_data);
+    matf32_init(&Ain, 3, 2, Ain_data);
+    matf32_init(&bin, 3, 1, bin_data);
+    matf32_init(&Aeq, 1, 2, Aeq_data);
+    matf32_init(&beq, 1, 1, beq_data);
+    matf32_init(&x, 2, 1, x_data);
+    matf32_init(&ref, 2, 1, r_data);
+
+    printf("Testing inequality constrained problem: \n");
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    status = quadprog_admm_init(&solver, &problem, NNZ_MAX, LNZ_MAX, fbuf, ibuf);
+    ans = ans && (QP_SUCESS == status);
+    status = quadprog_admm(&solver, &problem, &x);
+    quadprog_status_print(status);
+    matf32_print(&x);
+    quadprog_gi(&problem, &ws, &ref, NULL);
+    printf("iterations: %d, factorizations: %d\n", solver.info.iter, solver.info.num_factor);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-3);
+
+    printf("Testing warm start after a change of c: \n");
+    matf32_init(&c, 2, 1, c2_data);
+    uint16_t cold_iter = solver.info.iter;
+    status = quadprog_admm(&solver, &problem, &x);
+    quadprog_status_print(status);
+    matf32_print(&x);
+    quadprog_gi(&problem, &ws, &ref, NULL);
+    printf("iterations: %d, factorizations: %d\n", solver.info.iter, solver.info.num_factor);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-3);
+    ans = ans && (solver.info.iter <= cold_iter);
+
+    printf("Testing mixed equality and inequality constraints: \n");
+    matf32_init(&c, 2, 1, c_data);
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+    status = quadprog_admm_init(&solver, &problem, NNZ_MAX, LNZ_MAX, fbuf, ibuf);
+    ans = ans && (QP_SUCESS == status);
+    status = quadprog_admm(&solver, &problem, &x);
+    quadprog_status_print(status);
+    matf32_print(&x);
+    quadprog_gi(&problem, &ws, &ref, NULL);
+    printf("iterations: %d, factorizations: %d\n", solver.info.iter, solver.info.num_factor);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-3);
+
+    printf("Testing capacity check: \n");
+    status = quadprog_admm_init(&solver, &problem, 4, LNZ_MAX, fbuf, ibuf);
+    quadprog_status_print(status);
+    ans = ans && (QP_SIZE_MISMATCH == status);
+
+    if (ans)
+    {
+        printf("quadprog_admm sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_admm failure.\n");
+        return 1;
+    }
+}
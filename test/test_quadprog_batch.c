@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "quadprog_data.h"
+
+#define NUM_PROBLEMS    (203)
+#define NUM_WORKERS     (4)
+
+float c_store[NUM_PROBLEMS][10];
+float x_store[NUM_PROBLEMS][10];
+float r_data[10];
+
+matf32_t Q[NUM_PROBLEMS], c[NUM_PROBLEMS], Ain[NUM_PROBLEMS], bin[NUM_PROBLEMS], Aeq[NUM_PROBLEMS], beq[NUM_PROBLEMS];
+matf32_t x[NUM_PROBLEMS];
+quadprog_t problems[NUM_PROBLEMS];
+quadprog_status_t status[NUM_PROBLEMS];
+
+float ws_fwork[NUM_WORKERS][QUADPROG_BATCH_FWORK(10, 3, 10)];
+int16_t ws_iwork[NUM_WORKERS][QUADPROG_WORKSPACE_IWORK(10, 3, 10)];
+quadprog_workspace_t ws[NUM_WORKERS];
+
+float* Q_list[] = {Q2_data, Q3_data, Q4_data, Q5_data, Q6_data, Q7_data, Q8_data, Q9_data, Q10_data};
+float* c_list[] = {c2_data, c3_data, c4_data, c5_data, c6_data, c7_data, c8_data, c9_data, c10_data};
+float* A_list[] = {A2_data, A3_data, A4_data, A5_data, A6_data, A7_data, A8_data, A9_data, A10_data};
+float* b_list[] = {b2_data, b3_data, b4_data, b5_data, b6_data, b7_data, b8_data, b9_data, b10_data};
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol*(1 + fabsf(b->p_data[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief   Problem k: inequality constrained with sizes 2..10 (mixed), or 10 variables and 3 equalities (same).
+ */
+static void
+make_problem(uint16_t k, bool same_size)
+{
+    uint16_t i = same_size? 8 : (k % 9);
+    uint16_t n = i + 2;
+
+    for (uint16_t j = 0; j < n; ++j)
+    {
+        c_store[k][j] = c_list[i][j] + 0.5f*sinf(0.1f*k + j);
+    }
+
+    matf32_init(&Q[k], n, n, Q_list[i]);
+    matf32_init(&c[k], n, 1, c_store[k]);
+    matf32_init(&x[k], n, 1, x_store[k]);
+
+    if (same_size)
+    {
+        matf32_init(&Aeq[k], 3, n, A_list[i]);
+        matf32_init(&beq[k], 3, 1, b_list[i]);
+        quadprog_init(&problems[k], &Q[k], &c[k], &Aeq[k], &beq[k], NULL, NULL, NULL);
+    }
+    else
+    {
+        matf32_init(&Ain[k], n, n, A_list[i]);
+        matf32_init(&bin[k], n, 1, b_list[i]);
+        quadprog_init(&problems[k], &Q[k], &c[k], NULL, NULL, &Ain[k], &bin[k], NULL);
+    }
+}
+
+
+/**
+ * @brief   Problem k: 3 variables and 2 equalities, solved by the null-space method since 2*meq > n.
+ */
+static void
+make_null_space_problem(uint16_t k)
+{
+    for (uint16_t j = 0; j < 3; ++j)
+    {
+        c_store[k][j] = c3_data[j] + 0.5f*sinf(0.1f*k + j);
+    }
+
+    matf32_init(&Q[k], 3, 3, Q3_data);
+    matf32_init(&c[k], 3, 1, c_store[k]);
+    matf32_init(&x[k], 3, 1, x_store[k]);
+    matf32_init(&Aeq[k], 2, 3, A3_data);
+    matf32_init(&beq[k], 2, 1, b3_data);
+    quadprog_init(&problems[k], &Q[k], &c[k], &Aeq[k], &beq[k], NULL, NULL, NULL);
+}
+
+
+static bool
+check_batch(void)
+{
+    matf32_t ref;
+    uint16_t num_ok = 0;
+
+    for (uint16_t k = 0; k < NUM_PROBLEMS; ++k)
+    {
+        matf32_init(&ref, x[k].num_rows, 1, r_data);
+        quadprog_status_t s = quadprog(&problems[k], &ws[0], &ref);
+        if (QP_NOT_RESTRICTED == s)
+        {
+            s = quadprog_qp(&problems[k], &ws[0], &ref);
+        }
+
+        num_ok += (QP_SUCESS == s) && (status[k] == s) && close_to(&x[k], &ref, 1e-4);
+    }
+
+    printf("%d of %d problems agree with quadprog.\n", num_ok, NUM_PROBLEMS);
+
+    return NUM_PROBLEMS == num_ok;
+}
+
+
+int main(void)
+{
+    quadprog_batch_t batch;
+    quadprog_status_t s;
+    bool ans = true;
+
+    for (uint16_t w = 0; w < NUM_WORKERS; ++w)
+    {
+        quadprog_workspace_init(&ws[w], 10, 3, 10, ws_fwork[w], ws_iwork[w]);
+    }
+
+    printf("Testing mixed sizes with %d workers: \n", NUM_WORKERS);
+    for (uint16_t k = 0; k < NUM_PROBLEMS; ++k)
+    {
+        make_problem(k, false);
+        x[k].p_data[0] = NAN;
+    }
+    quadprog_batch_init(&batch, problems, x, status, NUM_PROBLEMS, QP_BATCH_GENERAL);
+    s = quadprog_batch(&batch, ws, NUM_WORKERS);
+    quadprog_status_print(s);
+    ans = ans && (QP_SUCESS == s) && check_batch();
+
+    printf("Testing same size problems in lockstep: \n");
+    for (uint16_t k = 0; k < NUM_PROBLEMS; ++k)
+    {
+        make_problem(k, true);
+        x[k].p_data[0] = NAN;
+    }
+    quadprog_batch_init(&batch, problems, x, status, NUM_PROBLEMS, QP_BATCH_LOCKSTEP);
+    s = quadprog_batch(&batch, ws, NUM_WORKERS);
+    quadprog_status_print(s);
+    ans = ans && (QP_SUCESS == s) && check_batch();
+
+    printf("Testing lockstep groups falling back to single solves: \n");
+    make_problem(17, false);
+    make_problem(NUM_PROBLEMS - 1, false);
+    quadprog_batch_init(&batch, problems, x, status, NUM_PROBLEMS, QP_BATCH_LOCKSTEP);
+    uint16_t solved = quadprog_batch_worker(&batch, &ws[0]);
+    printf("%d problems solved by a single worker.\n", solved);
+    ans = ans && (NUM_PROBLEMS == solved) && check_batch();
+
+    printf("Testing null-space equality problems with %d workers: \n", NUM_WORKERS);
+    for (uint16_t k = 0; k < NUM_PROBLEMS; ++k)
+    {
+        make_null_space_problem(k);
+        x[k].p_data[0] = NAN;
+    }
+    quadprog_batch_init(&batch, problems, x, status, NUM_PROBLEMS, QP_BATCH_GENERAL);
+    s = quadprog_batch(&batch, ws, NUM_WORKERS);
+    quadprog_status_print(s);
+    ans = ans && (QP_SUCESS == s) && check_batch();
+
+    if (ans)
+    {
+        printf("quadprog_batch sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_batch failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "quadprog_data.h"
+
+float x_data[10];
+float r_data[10];
+float x0_data[10];
+float lb_data[10];
+float ub_data[10];
+
+// bounds as inequalities, [I; -I] x <= [ub; -lb]
+float Ain_data[2*10*10];
+float bin_data[2*10];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(10, 0, 20)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(10, 0, 20)];
+
+float* Q_list[] = {Q2_data, Q3_data, Q4_data, Q5_data, Q6_data, Q7_data, Q8_data, Q9_data, Q10_data};
+float* c_list[] = {c2_data, c3_data, c4_data, c5_data, c6_data, c7_data, c8_data, c9_data, c10_data};
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol*(1 + fabsf(b->p_data[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void
+bounds_to_inequalities(uint16_t n)
+{
+    for (uint16_t k = 0; k < 2*n*n; ++k)
+    {
+        Ain_data[k] = 0;
+    }
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        Ain_data[i*n + i] = 1;
+        Ain_data[(n + i)*n + i] = -1;
+        bin_data[i] = ub_data[i];
+        bin_data[n + i] = -lb_data[i];
+    }
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, lb, ub, x, x0, ref;
+    quadprog_t problem;
+    quadprog_status_t status;
+    quadprog_workspace_t ws;
+    bool ans = true;
+
+    quadprog_workspace_init(&ws, 10, 0, 20, ws_fwork, ws_iwork);
+
+    printf("Testing growing problem sizes: \n");
+    for (int i = 0; i < (11-2); ++i)
+    {
+        uint16_t n = i+2;
+
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            lb_data[j] = -0.1f - 0.02f*j;
+            ub_data[j] = 0.05f + 0.02f*j;
+        }
+        bounds_to_inequalities(n);
+
+        matf32_init(&Q, n, n, Q_list[i]);
+        matf32_init(&c, n, 1, c_list[i]);
+        matf32_init(&Ain, 2*n, n, Ain_data);
+        matf32_init(&bin, 2*n, 1, bin_data);
+        matf32_init(&lb, n, 1, lb_data);
+        matf32_init(&ub, n, 1, ub_data);
+        matf32_init(&x, n, 1, x_data);
+        matf32_init(&ref, n, 1, r_data);
+        quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+
+        quadprog_gi(&problem, &ws, &ref, NULL);
+
+        uint16_t num_active = 0;
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            num_active += (fabsf(r_data[j] - lb_data[j]) < 1e-5) || (fabsf(r_data[j] - ub_data[j]) < 1e-5);
+        }
+
+        // quadprog dispatches to the bound constrained solver
+        status = quadprog(&problem, &ws, &x);
+        bool ok = (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+        status = quadprog_box(&problem, &lb, &ub, &ws, &x);
+        ok = ok && (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+        printf("n=%i: %d bounds active, %s\n", n, num_active, ok?"sucess":"failure");
+        ans = ans && ok;
+    }
+
+    printf("Testing one sided bounds and starting point: \n");
+    {
+        uint16_t n = 10;
+
+        // only lower bounds, rows in reverse variable order
+        for (uint16_t k = 0; k < n*n; ++k)
+        {
+            Ain_data[k] = 0;
+        }
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            uint16_t row = n - 1 - j;
+            Ain_data[row*n + j] = -1;
+            bin_data[row] = 0.1f;
+            lb_data[j] = -0.1f;
+            x0_data[j] = 1.0f;
+        }
+
+        matf32_init(&Q, n, n, Q10_data);
+        matf32_init(&c, n, 1, c10_data);
+        matf32_init(&Ain, n, n, Ain_data);
+        matf32_init(&bin, n, 1, bin_data);
+        matf32_init(&lb, n, 1, lb_data);
+        matf32_init(&x, n, 1, x_data);
+        matf32_init(&x0, n, 1, x0_data);
+        matf32_init(&ref, n, 1, r_data);
+
+        quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+        quadprog_gi(&problem, &ws, &ref, NULL);
+
+        quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, &x0);
+        status = quadprog(&problem, &ws, &x);
+        bool ok = (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+        status = quadprog_box(&problem, &lb, NULL, &ws, &x);
+        ok = ok && (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+        printf("%s\n", ok?"sucess":"failure");
+        ans = ans && ok;
+    }
+
+    printf("Testing inconsistent bounds: \n");
+    {
+        float Ai_data[] = {1, 0, -1, 0};
+        float bi_data[] = {-1, -1};
+
+        matf32_init(&Q, 2, 2, Q2_data);
+        matf32_init(&c, 2, 1, c2_data);
+        matf32_init(&Ain, 2, 2, Ai_data);
+        matf32_init(&bin, 2, 1, bi_data);
+        matf32_init(&x, 2, 1, x_data);
+        quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+
+        status = quadprog(&problem, &ws, &x);
+        quadprog_status_print(status);
+        ans = ans && (QP_INFEASIBLE == status);
+    }
+
+    if (ans)
+    {
+        printf("quadprog_box sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_box failure.\n");
+        return 1;
+    }
+}
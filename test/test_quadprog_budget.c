@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+
+#define N_VAR   8
+#define N_IN    8
+
+float Q_data[N_VAR*N_VAR];
+float c_data[N_VAR];
+float Ain_data[N_IN*N_VAR];
+float bin_data[N_IN];
+float Aeq_data[N_VAR];
+float beq_data[] = {-1};
+
+float x_data[N_VAR];
+float r_data[N_VAR];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(N_VAR, 1, N_IN)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(N_VAR, 1, N_IN)];
+
+
+/**
+ * @brief   Fake clock that advances one tick per read.
+ */
+static uint32_t
+tick_clock(void* p_ctx)
+{
+    uint32_t* p_ticks = (uint32_t*)p_ctx;
+    return (*p_ticks)++;
+}
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol*(1 + fabsf(b->p_data[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, ref;
+    quadprog_t problem;
+    quadprog_workspace_t ws;
+    quadprog_warm_t warm;
+    quadprog_budget_t budget = {0};
+    quadprog_stats_t stats, ref_stats;
+    quadprog_status_t status;
+    bool ans = true;
+    bool ok;
+
+    // tridiagonal Q, a gradient that pushes every variable against its upper bound and sum(x) = 1
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        for (uint16_t j = 0; j < N_VAR; ++j)
+        {
+            Q_data[i*N_VAR + j] = (i == j)? 4.0f : ((i == j + 1) || (j == i + 1))? -1.0f : 0.0f;
+            Ain_data[i*N_VAR + j] = (i == j)? 1.0f : 0.0f;
+        }
+        c_data[i] = -1.0f - i;
+        bin_data[i] = 0.05f*i;
+        Aeq_data[i] = -1.0f;
+    }
+
+    quadprog_workspace_init(&ws, N_VAR, 1, N_IN, ws_fwork, ws_iwork);
+    matf32_init(&Q, N_VAR, N_VAR, Q_data);
+    matf32_init(&c, N_VAR, 1, c_data);
+    matf32_init(&Ain, N_IN, N_VAR, Ain_data);
+    matf32_init(&bin, N_IN, 1, bin_data);
+    matf32_init(&Aeq, 1, N_VAR, Aeq_data);
+    matf32_init(&beq, 1, 1, beq_data);
+    matf32_init(&x, N_VAR, 1, x_data);
+    matf32_init(&ref, N_VAR, 1, r_data);
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+
+    printf("Testing the solve without a budget: \n");
+    status = quadprog_gi_budget(&problem, &ws, &ref, NULL, NULL, &ref_stats, NULL);
+    printf("%u iterations, %u adds, %u drops, r_prim %e, cost %f, bound %f\n", ref_stats.iter, ref_stats.adds,
+           ref_stats.drops, ref_stats.r_prim, ref_stats.cost, ref_stats.bound);
+    ok = (QP_SUCESS == status) && (ref_stats.adds > 3) && (ref_stats.r_prim < 1e-5)
+         && (fabsf(ref_stats.cost - ref_stats.bound) < 1e-5);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing an iteration budget: \n");
+    budget.max_iter = 2;
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, &budget, &stats, NULL);
+    quadprog_status_print(status);
+    printf("%u iterations, %u adds, r_prim %e, cost %f, bound %f\n", stats.iter, stats.adds, stats.r_prim,
+           stats.cost, stats.bound);
+    ok = (QP_TRUNCATED == status) && (2 == stats.iter) && (stats.r_prim > 0) && (stats.bound <= ref_stats.cost);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a time budget: \n");
+    uint32_t ticks = 0;
+    budget.max_iter = 100;
+    budget.p_clock = tick_clock;
+    budget.p_ctx = &ticks;
+    budget.max_ticks = 3;
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, &budget, &stats, NULL);
+    quadprog_status_print(status);
+    printf("%u iterations, %u ticks\n", stats.iter, stats.ticks);
+    ok = (QP_TRUNCATED == status) && (2 == stats.iter) && (stats.bound <= ref_stats.cost);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a budget large enough to converge: \n");
+    budget.max_ticks = 1000;
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, &budget, &stats, NULL);
+    ok = (QP_SUCESS == status) && close_to(&x, &ref, 1e-5) && (stats.iter == ref_stats.iter);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing truncated warm solves resuming across calls: \n");
+    quadprog_warm_init(&warm, &ws);
+    budget.max_iter = 2;
+    budget.p_clock = NULL;
+    uint16_t calls = 0;
+    do
+    {
+        status = quadprog_solve_warm_budget(&warm, &problem, &x, &budget, &stats, NULL);
+        calls++;
+    } while ((QP_TRUNCATED == status) && (calls < 10));
+    printf("%u calls\n", calls);
+    ok = (QP_SUCESS == status) && (calls > 1) && (calls < 10) && close_to(&x, &ref, 1e-5);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("quadprog_budget sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_budget failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+
+#define N_VAR   3
+#define N_EQ    2
+#define N_IN    3
+#define M_CON   (N_EQ + N_IN)
+#define NNZ_MAX QP_ADMM_KKT_NNZ_MAX(N_VAR, M_CON)
+#define LNZ_MAX QP_ADMM_LNZ_MAX(N_VAR, M_CON)
+#define TOL     (1e-3f)
+
+float I_data[] = {1, 0, 0,
+                  0, 1, 0,
+                  0, 0, 1};
+
+// semidefinite, flat along x3
+float Qpsd_data[] = {2, 1, 0,
+                     1, 2, 0,
+                     0, 0, 0};
+
+// indefinite
+float Qind_data[] = {1, 2, 0,
+                     2, 1, 0,
+                     0, 0, 1};
+
+float c_data[] = {1, -1, 0};
+
+float cu_data[] = {1, -1, -1};
+
+// x1 + x2 <= -1 and x1 + x2 >= 1 cannot both hold
+float Ain_data[] = { 1,  1, 0,
+                    -1, -1, 0,
+                     0,  0, 1};
+
+float bin_data[] = {-1, -1, 5};
+
+// x3 only bounded from below
+float Ain2_data[] = { 1,  0,  0,
+                     -1,  0,  0,
+                      0,  0, -1};
+
+float bin2_data[] = {1, 1, 2};
+
+float Aeq_data[] = {1, -1, 0,
+                    2, -2, 0};
+
+float beq_data[] = {0, 1};
+
+float beq2_data[] = {0.5, 1};
+
+float x_data[N_VAR];
+float y_data[M_CON];
+float d_data[N_VAR];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(N_VAR, N_EQ, N_IN)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(N_VAR, N_EQ, N_IN)];
+
+float fbuf[QP_ADMM_FWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+uint16_t ibuf[QP_ADMM_IWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+
+
+/**
+ * @brief   Checks a Farkas certificate: Aeq'y_eq + Ain'y_in = 0, y_in >= 0, beq'y_eq + bin'y_in < 0, unit norm.
+ */
+static bool
+check_farkas(const quadprog_t* p_qp, const float* y)
+{
+    uint16_t n = p_qp->p_Q->num_rows;
+    uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+    uint16_t min = (NULL != p_qp->p_Ain)? p_qp->p_Ain->num_rows : 0;
+    float by = 0;
+    float y_max = 0;
+    bool ok = true;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        float aty = 0;
+        for (uint16_t k = 0; k < meq; ++k)
+        {
+            aty += p_qp->p_Aeq->p_data[k*n + i]*y[k];
+        }
+        for (uint16_t k = 0; k < min; ++k)
+        {
+            aty += p_qp->p_Ain->p_data[k*n + i]*y[meq + k];
+        }
+        ok = ok && (fabsf(aty) < TOL);
+    }
+
+    for (uint16_t k = 0; k < meq + min; ++k)
+    {
+        by += y[k]*((k < meq)? p_qp->p_beq->p_data[k] : p_qp->p_bin->p_data[k - meq]);
+        y_max = fmaxf(y_max, fabsf(y[k]));
+        ok = ok && ((k < meq) || (y[k] > -TOL));
+    }
+
+    printf("b'y = %f, max|y| = %f\n", by, y_max);
+
+    return ok && (by < -TOL) && (fabsf(y_max - 1) < TOL);
+}
+
+
+/**
+ * @brief   Checks a direction of unbounded descent: Qd = 0, c'd < 0, Aeq d = 0, Ain d <= 0, unit norm.
+ */
+static bool
+check_unbounded(const quadprog_t* p_qp, const float* d)
+{
+    uint16_t n = p_qp->p_Q->num_rows;
+    uint16_t meq = (NULL != p_qp->p_Aeq)? p_qp->p_Aeq->num_rows : 0;
+    uint16_t min = (NULL != p_qp->p_Ain)? p_qp->p_Ain->num_rows : 0;
+    float cd = 0;
+    bool ok = true;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        float qd = 0;
+        for (uint16_t j = 0; j < n; ++j)
+        {
+            qd += p_qp->p_Q->p_data[i*n + j]*d[j];
+        }
+        ok = ok && (fabsf(qd) < TOL);
+        cd += p_qp->p_c->p_data[i]*d[i];
+    }
+
+    for (uint16_t k = 0; k < meq + min; ++k)
+    {
+        const float* a = (k < meq)? &p_qp->p_Aeq->p_data[k*n] : &p_qp->p_Ain->p_data[(k - meq)*n];
+        float ad = 0;
+        for (uint16_t i = 0; i < n; ++i)
+        {
+            ad += a[i]*d[i];
+        }
+        ok = ok && ((k < meq)? (fabsf(ad) < TOL) : (ad < TOL));
+    }
+
+    printf("c'd = %f\n", cd);
+
+    return ok && (cd < -TOL);
+}
+
+
+int main(void)
+{
+    matf32_t I, Qpsd, Qind, c, cu, Ain, bin, Ain2, bin2, Aeq, beq, beq2, x;
+    quadprog_t problem;
+    quadprog_workspace_t ws;
+    quadprog_warm_t warm;
+    quadprog_admm_t solver;
+    quadprog_stats_t stats;
+    quadprog_cert_t cert = {y_data, d_data};
+    quadprog_status_t status;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&I, N_VAR, N_VAR, I_data);
+    matf32_init(&Qpsd, N_VAR, N_VAR, Qpsd_data);
+    matf32_init(&Qind, N_VAR, N_VAR, Qind_data);
+    matf32_init(&c, N_VAR, 1, c_data);
+    matf32_init(&cu, N_VAR, 1, cu_data);
+    matf32_init(&Ain, N_IN, N_VAR, Ain_data);
+    matf32_init(&bin, N_IN, 1, bin_data);
+    matf32_init(&Ain2, N_IN, N_VAR, Ain2_data);
+    matf32_init(&bin2, N_IN, 1, bin2_data);
+    matf32_init(&Aeq, N_EQ, N_VAR, Aeq_data);
+    matf32_init(&beq, N_EQ, 1, beq_data);
+    matf32_init(&beq2, N_EQ, 1, beq2_data);
+    matf32_init(&x, N_VAR, 1, x_data);
+
+    printf("Testing inconsistent inequalities (active-set): \n");
+    quadprog_workspace_init(&ws, N_VAR, 0, N_IN, ws_fwork, ws_iwork);
+    quadprog_init(&problem, &I, &c, NULL, NULL, &Ain, &bin, NULL);
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, NULL, &stats, &cert);
+    quadprog_status_print(status);
+    printf("%u iterations\n", stats.iter);
+    ok = (QP_INFEASIBLE == status) && check_farkas(&problem, y_data) && (stats.iter <= N_IN);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing inconsistent inequalities (warm solver): \n");
+    quadprog_warm_init(&warm, &ws);
+    status = quadprog_solve_warm_budget(&warm, &problem, &x, NULL, NULL, &cert);
+    ok = (QP_INFEASIBLE == status) && check_farkas(&problem, y_data);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing inconsistent dependent equalities: \n");
+    quadprog_workspace_init(&ws, N_VAR, N_EQ, N_IN, ws_fwork, ws_iwork);
+    quadprog_init(&problem, &I, &c, &Aeq, &beq, &Ain2, &bin2, NULL);
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, NULL, NULL, &cert);
+    quadprog_status_print(status);
+    ok = (QP_INFEASIBLE == status) && check_farkas(&problem, y_data);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing consistent dependent equalities: \n");
+    quadprog_init(&problem, &I, &c, &Aeq, &beq2, &Ain2, &bin2, NULL);
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, NULL, NULL, &cert);
+    quadprog_status_print(status);
+    ok = (QP_BAD_DEFINED == status);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a semidefinite cost unbounded along a free direction: \n");
+    quadprog_workspace_init(&ws, N_VAR, 0, N_IN, ws_fwork, ws_iwork);
+    quadprog_init(&problem, &Qpsd, &cu, NULL, NULL, &Ain2, &bin2, NULL);
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, NULL, NULL, &cert);
+    quadprog_status_print(status);
+    ok = (QP_UNBOUNDED == status) && check_unbounded(&problem, d_data);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a semidefinite cost bounded by the constraints: \n");
+    cu_data[2] = 1;
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, NULL, NULL, &cert);
+    quadprog_status_print(status);
+    ok = (QP_NOT_CONVEX == status) && (fabsf(d_data[0]) < TOL) && (fabsf(d_data[1]) < TOL);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+    cu_data[2] = -1;
+
+    printf("Testing an indefinite cost: \n");
+    quadprog_init(&problem, &Qind, &c, NULL, NULL, &Ain2, &bin2, NULL);
+    status = quadprog_gi_budget(&problem, &ws, &x, NULL, NULL, NULL, &cert);
+    quadprog_status_print(status);
+    float dQd = 0;
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        for (uint16_t j = 0; j < N_VAR; ++j)
+        {
+            dQd += d_data[i]*Qind_data[i*N_VAR + j]*d_data[j];
+        }
+    }
+    printf("d'Qd = %f\n", dQd);
+    ok = (QP_NOT_CONVEX == status) && (dQd < -TOL);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing inconsistent constraints (ADMM): \n");
+    quadprog_init(&problem, &I, &c, &Aeq, &beq2, &Ain, &bin, NULL);
+    quadprog_admm_init(&solver, &problem, NNZ_MAX, LNZ_MAX, fbuf, ibuf);
+    status = quadprog_admm(&solver, &problem, &x);
+    quadprog_status_print(status);
+    printf("%u iterations\n", solver.info.iter);
+    ok = (QP_INFEASIBLE == status) && check_farkas(&problem, solver.p_dy) && (solver.info.iter < 100);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing an unbounded problem (ADMM): \n");
+    quadprog_init(&problem, &Qpsd, &cu, &Aeq, &beq2, &Ain2, &bin2, NULL);
+    quadprog_admm_init(&solver, &problem, NNZ_MAX, LNZ_MAX, fbuf, ibuf);
+    status = quadprog_admm(&solver, &problem, &x);
+    quadprog_status_print(status);
+    printf("%u iterations\n", solver.info.iter);
+    ok = (QP_UNBOUNDED == status) && check_unbounded(&problem, solver.p_dx) && (solver.info.iter < 100);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("quadprog_cert sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_cert failure.\n");
+        return 1;
+    }
+}
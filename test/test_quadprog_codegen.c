@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+#include "robotat_linalg.h"
+#include "qpgen_box.h"
+
+#define N_VAR   8
+#define N_IN    16
+#define M_CON   (1 + N_IN)
+#define NNZ_MAX QP_ADMM_KKT_NNZ_MAX(N_VAR, M_CON)
+#define LNZ_MAX QP_ADMM_LNZ_MAX(N_VAR, M_CON)
+#define RUNS    2000
+
+float Q_data[N_VAR*N_VAR];
+float c_data[N_VAR];
+float Ain_data[N_IN*N_VAR];
+float bin_data[N_IN];
+float Aeq_data[N_VAR];
+float beq_data[] = {1};
+
+float x_data[N_VAR];
+float r_data[N_VAR];
+
+float fbuf[QP_ADMM_FWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+uint16_t ibuf[QP_ADMM_IWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// gradient of run k, moves the optimum across the box
+static void
+set_gradient(uint16_t k)
+{
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        c_data[i] = -1.0f - i + 2.0f*sinf(0.01f*k + i);
+    }
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, ref;
+    quadprog_t problem;
+    quadprog_admm_t solver;
+    quadprog_status_t status, ref_status;
+    bool ans = true;
+    bool ok;
+
+    // the structure of codegen_box.spec
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        for (uint16_t j = 0; j < N_VAR; ++j)
+        {
+            Q_data[i*N_VAR + j] = (i == j)? 4.0f : ((i == j + 1) || (j == i + 1))? -1.0f : 0.0f;
+            Ain_data[i*N_VAR + j] = (i == j)? 1.0f : 0.0f;
+            Ain_data[(N_VAR + i)*N_VAR + j] = (i == j)? -1.0f : 0.0f;
+        }
+        bin_data[i] = 0.3f;
+        bin_data[N_VAR + i] = 0.1f;
+        Aeq_data[i] = 1.0f;
+    }
+    set_gradient(0);
+
+    matf32_init(&Q, N_VAR, N_VAR, Q_data);
+    matf32_init(&c, N_VAR, 1, c_data);
+    matf32_init(&Ain, N_IN, N_VAR, Ain_data);
+    matf32_init(&bin, N_IN, 1, bin_data);
+    matf32_init(&Aeq, 1, N_VAR, Aeq_data);
+    matf32_init(&beq, 1, 1, beq_data);
+    matf32_init(&x, N_VAR, 1, x_data);
+    matf32_init(&ref, N_VAR, 1, r_data);
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+
+    printf("Testing the generated solver against quadprog_admm: \n");
+    ref_status = quadprog_admm_init(&solver, &problem, NNZ_MAX, LNZ_MAX, fbuf, ibuf);
+    status = qpgen_box_init(&problem);
+    ok = (QP_SUCESS == ref_status) && (QP_SUCESS == status);
+
+    ref_status = quadprog_admm(&solver, &problem, &ref);
+    status = qpgen_box_solve(&problem, &x);
+    quadprog_status_print(status);
+    printf("%u iterations (generic %u)\n", qpgen_box_info.iter, solver.info.iter);
+    matf32_print(&x);
+    ok = ok && (QP_SUCESS == status) && (QP_SUCESS == ref_status) && close_to(&x, &ref, 1e-4);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing a sequence of warm started solves: \n");
+    ok = true;
+    for (uint16_t k = 1; (k < 50) && ok; ++k)
+    {
+        set_gradient(10*k);
+        ref_status = quadprog_admm(&solver, &problem, &ref);
+        status = qpgen_box_solve(&problem, &x);
+        ok = (QP_SUCESS == status) && (QP_SUCESS == ref_status) && close_to(&x, &ref, 1e-3);
+    }
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing the latency of both solvers (%u cold solves): \n", RUNS);
+    clock_t t0 = clock();
+    for (uint16_t k = 0; k < RUNS; ++k)
+    {
+        set_gradient(k);
+        quadprog_admm_cold_start(&solver);
+        quadprog_admm(&solver, &problem, &ref);
+    }
+    clock_t t1 = clock();
+    for (uint16_t k = 0; k < RUNS; ++k)
+    {
+        set_gradient(k);
+        qpgen_box_cold_start();
+        qpgen_box_solve(&problem, &x);
+    }
+    clock_t t2 = clock();
+
+    double t_generic = 1e6*(double)(t1 - t0)/CLOCKS_PER_SEC/RUNS;
+    double t_generated = 1e6*(double)(t2 - t1)/CLOCKS_PER_SEC/RUNS;
+    printf("generic %.2f us, generated %.2f us per solve\n", t_generic, t_generated);
+    ok = close_to(&x, &ref, 1e-3);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("quadprog_codegen sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_codegen failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "robotat_linalg.h"
+
+float Q_data[] = { 1, -1,
+                  -1,  2};
+
+float c_data[] = {-2, -6};
+
+float Ain_data[] = { 1, 1,
+                    -1, 2,
+                     2, 1};
+
+float bin_data[] = {2, 2, 3};
+
+float Aeq_data[] = {1, -1};
+
+float beq_data[] = {0};
+
+float Ainf_data[] = { 1, 0,
+                     -1, 0};
+
+float binf_data[] = {-1, -1};
+
+float r_in_data[] = {0.666667, 1.333333};
+
+float r_mix_data[] = {1, 1};
+
+float x_data[2];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(2, 1, 3)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(2, 1, 3)];
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, Result;
+    quadprog_t problem;
+    quadprog_active_set_t active;
+    quadprog_status_t status;
+    quadprog_workspace_t ws;
+    bool ans = true;
+
+    quadprog_workspace_init(&ws, 2, 1, 3, ws_fwork, ws_iwork);
+
+    matf32_init(&Q, 2, 2, Q_data);
+    matf32_init(&c, 2, 1, c_data);
+    matf32_init(&Ain, 3, 2, Ain_data);
+    matf32_init(&bin, 3, 1, bin_data);
+    matf32_init(&Aeq, 1, 2, Aeq_data);
+    matf32_init(&beq, 1, 1, beq_data);
+    matf32_init(&x, 2, 1, x_data);
+
+    printf("Testing inequality constrained problem: \n");
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    active.num_active = 0;
+    status = quadprog_gi(&problem, &ws, &x, &active);
+    quadprog_status_print(status);
+    matf32_print(&x);
+    matf32_init(&Result, 2, 1, r_in_data);
+    ans = ans && (QP_SUCESS == status) && matf32_is_equal(&x, &Result);
+    ans = ans && (2 == active.num_active) && (active.p_lambda[0] > 0) && (active.p_lambda[1] > 0);
+
+    printf("Testing warm start: \n");
+    status = quadprog_gi(&problem, &ws, &x, &active);
+    quadprog_status_print(status);
+    ans = ans && (QP_SUCESS == status) && matf32_is_equal(&x, &Result) && (2 == active.num_active);
+
+    printf("Testing mixed equality and inequality constraints: \n");
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+    status = quadprog(&problem, &ws, &x);
+    quadprog_status_print(status);
+    matf32_print(&x);
+    matf32_init(&Result, 2, 1, r_mix_data);
+    ans = ans && (QP_SUCESS == status) && matf32_is_equal(&x, &Result);
+
+    printf("Testing infeasible problem: \n");
+    matf32_init(&Ain, 2, 2, Ainf_data);
+    matf32_init(&bin, 2, 1, binf_data);
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    status = quadprog_sqp(&problem, &ws, &x);
+    quadprog_status_print(status);
+    ans = ans && (QP_INFEASIBLE == status);
+
+    if (ans)
+    {
+        printf("quadprog_gi sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_gi failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "quadprog_data.h"
+
+#define RANDOM_PROBLEMS (2000)
+
+float Qs_data[] = { 1, -1,
+                   -1,  2};
+
+float cs_data[] = {-2, -6};
+
+float Ains_data[] = { 1, 1,
+                     -1, 2,
+                      2, 1};
+
+float bins_data[] = {2, 2, 3};
+
+float Aeqs_data[] = {1, -1};
+
+float beqs_data[] = {0};
+
+float x_data[10];
+float r_data[10];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(10, 1, 10)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(10, 1, 10)];
+
+float* Q_list[] = {Q2_data, Q3_data, Q4_data, Q5_data, Q6_data, Q7_data, Q8_data, Q9_data, Q10_data};
+float* c_list[] = {c2_data, c3_data, c4_data, c5_data, c6_data, c7_data, c8_data, c9_data, c10_data};
+float* A_list[] = {A2_data, A3_data, A4_data, A5_data, A6_data, A7_data, A8_data, A9_data, A10_data};
+float* b_list[] = {b2_data, b3_data, b4_data, b5_data, b6_data, b7_data, b8_data, b9_data, b10_data};
+
+float Qr_data[100];
+float cr_data[10];
+float Ainr_data[100];
+float binr_data[10];
+float Aeqr_data[10];
+float beqr_data[1];
+float Lr_data[100];
+float x0_data[10];
+
+quadprog_ipm_info_t info;
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol*(1 + fabsf(b->p_data[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void
+print_info(const quadprog_ipm_info_t* p_info)
+{
+    for (uint16_t k = 0; k <= p_info->iter; ++k)
+    {
+        printf("  %2d  r_prim %.3e  r_dual %.3e  gap %.3e\n", k, p_info->p_r_prim[k], p_info->p_r_dual[k], p_info->p_gap[k]);
+    }
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, ref;
+    quadprog_t problem;
+    quadprog_status_t status;
+    quadprog_workspace_t ws;
+    bool ans = true;
+
+    quadprog_workspace_init(&ws, 10, 1, 10, ws_fwork, ws_iwork);
+
+    matf32_init(&Q, 2, 2, Qs_data);
+    matf32_init(&c, 2, 1, cs_data);
+    matf32_init(&Ain, 3, 2, Ains_data);
+    matf32_init(&bin, 3, 1, bins_data);
+    matf32_init(&Aeq, 1, 2, Aeqs_data);
+    matf32_init(&beq, 1, 1, beqs_data);
+    matf32_init(&x, 2, 1, x_data);
+    matf32_init(&ref, 2, 1, r_data);
+
+    printf("Testing inequality constrained problem: \n");
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    status = quadprog_ipm(&problem, &ws, &x, &info);
+    quadprog_status_print(status);
+    print_info(&info);
+    quadprog_gi(&problem, &ws, &ref, NULL);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+    printf("Testing mixed equality and inequality constraints: \n");
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+    status = quadprog_ipm(&problem, &ws, &x, &info);
+    quadprog_status_print(status);
+    print_info(&info);
+    quadprog_gi(&problem, &ws, &ref, NULL);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+    printf("Testing equality constrained problem: \n");
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, NULL, NULL, NULL);
+    status = quadprog_ipm(&problem, &ws, &x, &info);
+    quadprog_status_print(status);
+    quadprog_gi(&problem, &ws, &ref, NULL);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+    printf("Testing growing problem sizes: \n");
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    for (int i = 0; i < (11-2); ++i)
+    {
+        int n = i+2;
+
+        matf32_init(&Q, n, n, Q_list[i]);
+        matf32_init(&c, n, 1, c_list[i]);
+        matf32_init(&Ain, n, n, A_list[i]);
+        matf32_init(&bin, n, 1, b_list[i]);
+        matf32_init(&x, n, 1, x_data);
+        matf32_init(&ref, n, 1, r_data);
+
+        status = quadprog_ipm(&problem, &ws, &x, &info);
+        quadprog_gi(&problem, &ws, &ref, NULL);
+
+        bool ok = (QP_SUCESS == status) && close_to(&x, &ref, 1e-4) && (info.iter <= 25);
+        printf("n=%i: %d iterations, %s\n", n, info.iter, ok?"sucess":"failure");
+        ans = ans && ok;
+    }
+
+    // strictly convex and feasible (x0 is interior to the inequalities), n and the number of constraints vary
+    printf("Testing %d random problems against quadprog_gi: \n", RANDOM_PROBLEMS);
+    uint16_t num_failed = 0;
+    for (int k = 0; k < RANDOM_PROBLEMS; ++k)
+    {
+        int n = 2 + k % 9;
+        int min = 1 + (k / 9) % 10;
+        int meq = k % 2;
+
+        for (int i = 0; i < n*n; ++i)
+        {
+            Lr_data[i] = noise();
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                float sum = (i == j)? 0.1f : 0;
+                for (int l = 0; l < n; ++l)
+                {
+                    sum += Lr_data[i*n + l]*Lr_data[j*n + l];
+                }
+                Qr_data[i*n + j] = sum;
+            }
+            cr_data[i] = 5*noise();
+            x0_data[i] = noise();
+        }
+        for (int j = 0; j < min; ++j)
+        {
+            float sum = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                Ainr_data[j*n + i] = noise();
+                sum += Ainr_data[j*n + i]*x0_data[i];
+            }
+            binr_data[j] = sum + fabsf(noise());
+        }
+        float sum = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            Aeqr_data[i] = noise();
+            sum += Aeqr_data[i]*x0_data[i];
+        }
+        beqr_data[0] = sum;
+
+        matf32_init(&Q, n, n, Qr_data);
+        matf32_init(&c, n, 1, cr_data);
+        matf32_init(&Ain, min, n, Ainr_data);
+        matf32_init(&bin, min, 1, binr_data);
+        matf32_init(&Aeq, 1, n, Aeqr_data);
+        matf32_init(&beq, 1, 1, beqr_data);
+        matf32_init(&x, n, 1, x_data);
+        matf32_init(&ref, n, 1, r_data);
+        quadprog_init(&problem, &Q, &c, meq? &Aeq : NULL, meq? &beq : NULL, &Ain, &bin, NULL);
+
+        status = quadprog_ipm(&problem, &ws, &x, NULL);
+        if ((QP_SUCESS != quadprog_gi(&problem, &ws, &ref, NULL)) || (QP_SUCESS != status)
+            || !close_to(&x, &ref, 5e-3))
+        {
+            num_failed++;
+        }
+    }
+    printf("%u failed\n", num_failed);
+    ans = ans && (0 == num_failed);
+
+    if (ans)
+    {
+        printf("quadprog_ipm sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_ipm failure.\n");
+        return 1;
+    }
+}
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_mpc.h"
+
+#define N_X         (2)
+#define N_U         (1)
+#define HORIZON     (3)
+#define N_V         (HORIZON*N_U)
+#define N_IN        (2*N_V)
+
+#define MAX_REGIONS (64)
+#define MAX_ROWS    (MAX_REGIONS*(N_IN + 2*N_X))
+#define MAX_NODES   (4*MAX_REGIONS)
+#define MAX_LEAF    (8*MAX_REGIONS)
+#define GRID        (21)
+
+// double integrator
+float A_data[] = {1.0, 1.0,
+                  0.0, 1.0};
+
+float B_data[] = {0.5,
+                  1.0};
+
+float C_data[] = {1, 0};
+
+float D_data[] = {0};
+
+float state_data[N_X];
+
+float Qx_data[] = {1.0, 0.0,
+                   0.0, 1.0};
+
+float R_data[] = {0.1};
+
+float P_data[] = {1.0, 0.0,
+                  0.0, 1.0};
+
+float umin_data[] = {-1.0};
+float umax_data[] = {1.0};
+
+float theta_min[] = {-5.0, -5.0};
+float theta_max[] = {5.0, 5.0};
+
+// projection of theta onto a polytope whose last facet moves with theta: min 1/2|z|^2 - theta'z
+float Qp_data[] = {1.0, 0.0,
+                   0.0, 1.0};
+float cp_data[] = {0.0, 0.0};
+float Fp_data[] = {-1.0, 0.0,
+                   0.0, -1.0};
+float Ap_data[] = {1.0, 1.0,
+                   -1.0, 0.0,
+                   0.0, -1.0,
+                   1.0, -1.0};
+float bp_data[] = {1.0, 1.0, 1.0, 0.5};
+float Sp_data[] = {0.0, 0.0,
+                   0.0, 0.0,
+                   0.0, 0.0,
+                   0.5, 0.0};
+float thetap_min[] = {-3.0, -3.0};
+float thetap_max[] = {3.0, 3.0};
+
+float c0_data[N_V];
+float c_data[N_V];
+float bin_data[N_IN];
+float z_data[N_V];
+
+float mpc_fwork[MPC_CONDENSED_FWORK(N_X, N_U, HORIZON)];
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(N_V, QUADPROG_MP_WS_MEQ, QUADPROG_MP_WS_MIN(N_IN, N_X))];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(N_V, QUADPROG_MP_WS_MEQ, QUADPROG_MP_WS_MIN(N_IN, N_X))];
+float mp_fwork[QUADPROG_MP_FWORK(N_X, N_V, MAX_REGIONS, MAX_ROWS, MAX_NODES)];
+uint16_t mp_iwork[QUADPROG_MP_IWORK(N_IN, MAX_REGIONS, MAX_NODES, MAX_LEAF)];
+
+
+/**
+ * @brief   Solves the parametric QP at theta with quadprog_gi.
+ */
+static quadprog_status_t
+reference_solve(const quadprog_mp_t* p_mp, quadprog_workspace_t* ws, const float* theta)
+{
+    const quadprog_t* p_qp = p_mp->p_qp;
+    const uint16_t n = p_qp->p_Q->num_rows;
+    const uint16_t min = p_qp->p_Ain->num_rows;
+    const uint16_t p = p_mp->p_F->num_cols;
+    matf32_t c, bin, z;
+    quadprog_t qp;
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        c_data[i] = p_qp->p_c->p_data[i];
+        for (uint16_t l = 0; l < p; ++l)
+        {
+            c_data[i] += p_mp->p_F->p_data[i*p + l] * theta[l];
+        }
+    }
+    for (uint16_t i = 0; i < min; ++i)
+    {
+        bin_data[i] = p_qp->p_bin->p_data[i];
+        for (uint16_t l = 0; (l < p) && (NULL != p_mp->p_S); ++l)
+        {
+            bin_data[i] += p_mp->p_S->p_data[i*p + l] * theta[l];
+        }
+    }
+
+    matf32_init(&c, n, 1, c_data);
+    matf32_init(&bin, min, 1, bin_data);
+    matf32_init(&z, n, 1, z_data);
+    quadprog_init(&qp, p_qp->p_Q, &c, NULL, NULL, p_qp->p_Ain, &bin, NULL);
+
+    return quadprog_gi(&qp, ws, &z, NULL);
+}
+
+
+/**
+ * @brief   Builds the explicit law and compares it against quadprog_gi on a grid over the parameter box.
+ */
+static bool
+check_law(const quadprog_mp_t* p_mp, quadprog_workspace_t* ws, quadprog_mp_law_t* law)
+{
+    quadprog_status_t status = quadprog_mp_build(p_mp, ws, law, MAX_REGIONS, MAX_ROWS, MAX_NODES, MAX_LEAF,
+                                                 mp_fwork, mp_iwork);
+    if (QP_SUCESS != status)
+    {
+        quadprog_status_print(status);
+        return false;
+    }
+
+    float err = 0;
+    uint16_t outside = 0;
+    for (uint16_t i = 0; i < GRID; ++i)
+    {
+        for (uint16_t j = 0; j < GRID; ++j)
+        {
+            float theta[2];
+            float z[N_V];
+            theta[0] = p_mp->p_theta_min[0] + (p_mp->p_theta_max[0] - p_mp->p_theta_min[0])*i/(GRID - 1);
+            theta[1] = p_mp->p_theta_min[1] + (p_mp->p_theta_max[1] - p_mp->p_theta_min[1])*j/(GRID - 1);
+
+            outside += (QP_SUCESS != quadprog_mp_eval(law, theta, z, NULL));
+            if (QP_SUCESS != reference_solve(p_mp, ws, theta))
+            {
+                return false;
+            }
+
+            for (uint16_t k = 0; k < p_mp->num_out; ++k)
+            {
+                float e = fabsf(z[k] - z_data[k]);
+                err = (isnan(e) || (e > err)) ? e : err;
+            }
+        }
+    }
+
+    // a parameter outside the box is reported
+    float far[2] = {2*p_mp->p_theta_max[0], 0};
+    float z[N_V];
+    bool far_found = (QP_INFEASIBLE == quadprog_mp_eval(law, far, z, NULL));
+
+    printf("%u regions, %u nodes, %u grid points outside, max error %e\n", law->num_regions, law->num_nodes, outside,
+           err);
+
+    return (0 == outside) && (err < 1e-3) && far_found;
+}
+
+
+int main(void)
+{
+    matf32_t A, B, C, D, state, Qx, R, P, umin, umax;
+    matf32_t Qp, cp, Fp, Ap, bp, Sp, c0;
+    sys_lti_t sys;
+    mpc_condensed_t mpc;
+    quadprog_workspace_t ws;
+    quadprog_mp_t mp;
+    quadprog_mp_law_t law;
+    quadprog_t qp;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, 1, N_X, C_data);
+    matf32_init(&D, 1, N_U, D_data);
+    matf32_init(&state, N_X, 1, state_data);
+    matf32_init(&Qx, N_X, N_X, Qx_data);
+    matf32_init(&R, N_U, N_U, R_data);
+    matf32_init(&P, N_X, N_X, P_data);
+    matf32_init(&umin, N_U, 1, umin_data);
+    matf32_init(&umax, N_U, 1, umax_data);
+    matf32_init(&c0, N_V, 1, c0_data);
+
+    sys_lti_init(&sys, &state, &A, &B, &C, &D, 1.0);
+    quadprog_workspace_init(&ws, N_V, QUADPROG_MP_WS_MEQ, QUADPROG_MP_WS_MIN(N_IN, N_X), ws_fwork, ws_iwork);
+
+    printf("Testing explicit MPC of a double integrator against the active-set solver: \n");
+    mpc_condensed_init(&mpc, &sys, HORIZON, &Qx, &R, &P, &umin, &umax, mpc_fwork);
+
+    // theta = x0, c = F x0
+    quadprog_init(&qp, &mpc.H, &c0, NULL, NULL, &mpc.Ain, &mpc.bin, NULL);
+    mp.p_qp = &qp;
+    mp.p_F = &mpc.F;
+    mp.p_S = NULL;
+    mp.p_theta_min = theta_min;
+    mp.p_theta_max = theta_max;
+    mp.num_out = N_U;
+
+    ok = check_law(&mp, &ws, &law);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing projection onto a parametric polytope against the active-set solver: \n");
+    matf32_init(&Qp, 2, 2, Qp_data);
+    matf32_init(&cp, 2, 1, cp_data);
+    matf32_init(&Fp, 2, 2, Fp_data);
+    matf32_init(&Ap, 4, 2, Ap_data);
+    matf32_init(&bp, 4, 1, bp_data);
+    matf32_init(&Sp, 4, 2, Sp_data);
+    quadprog_init(&qp, &Qp, &cp, NULL, NULL, &Ap, &bp, NULL);
+    mp.p_F = &Fp;
+    mp.p_S = &Sp;
+    mp.p_theta_min = thetap_min;
+    mp.p_theta_max = thetap_max;
+    mp.num_out = 2;
+
+    ok = check_law(&mp, &ws, &law);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ok)
+    {
+        printf("Generated law: \n");
+        quadprog_mp_print(&law, "projection_law");
+    }
+
+    if (ans)
+    {
+        printf("quadprog_mp sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_mp failure.\n");
+        return 1;
+    }
+}
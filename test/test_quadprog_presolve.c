@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+
+#define N_VAR   6
+#define N_EQ    3
+#define N_IN    11
+#define M_CON   (N_EQ + N_IN)
+#define NNZ_MAX QP_ADMM_KKT_NNZ_MAX(N_VAR, M_CON)
+#define LNZ_MAX QP_ADMM_LNZ_MAX(N_VAR, M_CON)
+
+// y = S x are the well scaled variables: two positions in cm, an angle, two forces in kN and a fixed input
+float S_data[N_VAR] = {100, 100, 1, 0.01, 0.01, 1};
+
+// inequalities are written in mixed units too, row k of the original problem is R(k) times row k of the scaled one
+float R_data[N_IN] = {1, 1, 1000, 1, 0.01, 0.01, 0.01, 0.01, 1, 1000, 1000};
+
+float Q0_data[N_VAR*N_VAR] = { 2.0, -0.5,  0.0,  0.0,  0.0,  0.0,
+                              -0.5,  2.0, -0.5,  0.0,  0.0,  0.0,
+                               0.0, -0.5,  2.0, -0.5,  0.0,  0.0,
+                               0.0,  0.0, -0.5,  2.0, -0.5,  0.0,
+                               0.0,  0.0,  0.0, -0.5,  2.0, -0.5,
+                               0.0,  0.0,  0.0,  0.0, -0.5,  2.0};
+
+float c0_data[N_VAR] = {-2, -3, -1, -1, -0.5, -1};
+
+// fixing row, a general equality and a multiple of it
+float Aeq0_data[N_EQ*N_VAR] = {0, 0, 0, 0, 0, 1,
+                               0, 0, 1, 1, 1, 0,
+                               0, 0, 3, 3, 3, 0};
+float beq_data[N_EQ] = {0.2, 0.5, 1.5};
+
+// a coupling row and its double, an empty row, bounds, a row the bounds make redundant
+float Ain0_data[N_IN*N_VAR] = { 1,  1, 0,  0, 0, 0,
+                                2,  2, 0,  0, 0, 0,
+                                0,  0, -1, 1, 0, 0,
+                                0,  0, 0,  0, 0, 0,
+                                1,  0, 0,  0, 0, 0,
+                               -1,  0, 0,  0, 0, 0,
+                                0,  1, 0,  0, 0, 0,
+                                0, -1, 0,  0, 0, 0,
+                                1, -1, 0,  0, 0, 0.1,
+                                0,  0, 0,  1, 0, 0,
+                                0,  0, 0,  0, 1, 0};
+float bin0_data[N_IN] = {1, 2, 0.5, 1, 0.8, 0.8, 0.8, 0.8, 5, 0.3, 0.3};
+
+float Q_data[N_VAR*N_VAR];
+float c_data[N_VAR];
+float Aeq_data[N_EQ*N_VAR];
+float Ain_data[N_IN*N_VAR];
+float bin_data[N_IN];
+
+float x_data[N_VAR];
+float r_data[N_VAR];
+float y_data[M_CON];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(N_VAR, N_EQ, N_IN)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(N_VAR, N_EQ, N_IN)];
+float admm_fbuf[QP_ADMM_FWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+uint16_t admm_ibuf[QP_ADMM_IWORK(N_VAR, M_CON, NNZ_MAX, LNZ_MAX)];
+float pre_fbuf[QUADPROG_PRESOLVE_FWORK(N_VAR, N_EQ, N_IN)];
+uint16_t pre_ibuf[QUADPROG_PRESOLVE_IWORK(N_VAR, N_EQ, N_IN)];
+
+
+/**
+ * @brief   Largest difference relative to the scale of each variable.
+ */
+static float
+scaled_error(const matf32_t* a, const matf32_t* b)
+{
+    float err = 0;
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        float e = fabsf(a->p_data[i] - b->p_data[i]) * S_data[i];
+        err = (isnan(e) || (e > err))? e : err;
+    }
+
+    return err;
+}
+
+
+/**
+ * @brief   Largest violation of the KKT conditions of the original problem, in the units of y = S x.
+ */
+static float
+kkt_error(const matf32_t* x, const float* y)
+{
+    float err = 0;
+
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        float g = c_data[i];
+        for (uint16_t j = 0; j < N_VAR; ++j)
+        {
+            g += Q_data[i*N_VAR + j] * x->p_data[j];
+        }
+        for (uint16_t k = 0; k < N_EQ; ++k)
+        {
+            g += Aeq_data[k*N_VAR + i] * y[k];
+        }
+        for (uint16_t k = 0; k < N_IN; ++k)
+        {
+            g += Ain_data[k*N_VAR + i] * y[N_EQ + k];
+        }
+        err = fmaxf(err, fabsf(g / S_data[i]));
+    }
+
+    for (uint16_t k = 0; k < N_IN; ++k)
+    {
+        float s = bin_data[k];
+        for (uint16_t j = 0; j < N_VAR; ++j)
+        {
+            s -= Ain_data[k*N_VAR + j] * x->p_data[j];
+        }
+        err = fmaxf(err, fmaxf(-y[N_EQ + k], fabsf(fminf(s, 1.0f) * y[N_EQ + k])));
+    }
+
+    return err;
+}
+
+
+/**
+ * @brief   Solves the same problem in the well scaled variables y = S x with quadprog_gi, x = y/S. The last
+ * equality is a multiple of the previous one and is left out.
+ */
+static quadprog_status_t
+reference_solve(quadprog_workspace_t* ws, matf32_t* ref)
+{
+    matf32_t Q0, c0, Aeq0, beq, Ain0, bin;
+    quadprog_t qp;
+
+    matf32_init(&Q0, N_VAR, N_VAR, Q0_data);
+    matf32_init(&c0, N_VAR, 1, c0_data);
+    matf32_init(&Aeq0, N_EQ - 1, N_VAR, Aeq0_data);
+    matf32_init(&beq, N_EQ - 1, 1, beq_data);
+    matf32_init(&Ain0, N_IN, N_VAR, Ain0_data);
+    matf32_init(&bin, N_IN, 1, bin0_data);
+    quadprog_init(&qp, &Q0, &c0, &Aeq0, &beq, &Ain0, &bin, NULL);
+
+    quadprog_status_t status = quadprog_gi(&qp, ws, ref, NULL);
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        ref->p_data[i] /= S_data[i];
+    }
+
+    return status;
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, ref;
+    quadprog_t problem;
+    quadprog_workspace_t ws;
+    quadprog_admm_t admm;
+    quadprog_presolve_t pre;
+    quadprog_status_t status;
+    quadprog_active_set_t active;
+    bool ans = true;
+    bool ok;
+
+    // Q = S*Q0*S, c = S*c0, Aeq = Aeq0*S, Ain = R*Ain0*S and bin = R*bin0 in the original units
+    for (uint16_t i = 0; i < N_VAR; ++i)
+    {
+        for (uint16_t j = 0; j < N_VAR; ++j)
+        {
+            Q_data[i*N_VAR + j] = S_data[i] * Q0_data[i*N_VAR + j] * S_data[j];
+        }
+        c_data[i] = S_data[i] * c0_data[i];
+        for (uint16_t k = 0; k < N_EQ; ++k)
+        {
+            Aeq_data[k*N_VAR + i] = Aeq0_data[k*N_VAR + i] * S_data[i];
+        }
+        for (uint16_t k = 0; k < N_IN; ++k)
+        {
+            Ain_data[k*N_VAR + i] = R_data[k] * Ain0_data[k*N_VAR + i] * S_data[i];
+        }
+    }
+    for (uint16_t k = 0; k < N_IN; ++k)
+    {
+        bin_data[k] = R_data[k] * bin0_data[k];
+    }
+
+    quadprog_workspace_init(&ws, N_VAR, N_EQ, N_IN, ws_fwork, ws_iwork);
+    matf32_init(&Q, N_VAR, N_VAR, Q_data);
+    matf32_init(&c, N_VAR, 1, c_data);
+    matf32_init(&Aeq, N_EQ, N_VAR, Aeq_data);
+    matf32_init(&beq, N_EQ, 1, beq_data);
+    matf32_init(&Ain, N_IN, N_VAR, Ain_data);
+    matf32_init(&bin, N_IN, 1, bin_data);
+    matf32_init(&x, N_VAR, 1, x_data);
+    matf32_init(&ref, N_VAR, 1, r_data);
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+
+    ans = ans && (QP_SUCESS == reference_solve(&ws, &ref));
+
+    printf("Testing the reductions: \n");
+    status = quadprog_presolve_init(&pre, &problem, QP_PRESOLVE_RUIZ_ITER, pre_fbuf, pre_ibuf);
+    printf("%u fixed, %u empty, %u duplicate, %u redundant, reduced to %u x (%u + %u)\n", pre.info.num_fixed,
+           pre.info.num_empty, pre.info.num_duplicate, pre.info.num_redundant, pre.n_r, pre.meq_r, pre.min_r);
+    ok = (QP_SUCESS == status) && (1 == pre.info.num_fixed) && (2 == pre.info.num_empty)
+         && (2 == pre.info.num_duplicate) && (1 == pre.info.num_redundant) && (5 == pre.n_r) && (1 == pre.meq_r)
+         && (8 == pre.min_r);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing ADMM iterations without and with equilibration: \n");
+    matf32_t xs;
+    uint16_t iter_unscaled = 0;
+    for (uint16_t ruiz_iter = 0; ruiz_iter <= QP_PRESOLVE_RUIZ_ITER; ruiz_iter += QP_PRESOLVE_RUIZ_ITER)
+    {
+        status = quadprog_presolve_init(&pre, &problem, ruiz_iter, pre_fbuf, pre_ibuf);
+        if (QP_SUCESS == status)
+        {
+            status = quadprog_admm_init(&admm, &pre.qp, NNZ_MAX, LNZ_MAX, admm_fbuf, admm_ibuf);
+        }
+        if (QP_SUCESS == status)
+        {
+            admm.settings.eps_abs = 1e-5f;
+            admm.settings.eps_rel = 1e-5f;
+            matf32_init(&xs, pre.n_r, 1, y_data);
+            status = quadprog_admm(&admm, &pre.qp, &xs);
+        }
+        printf("%u Ruiz passes: %u iterations, ", ruiz_iter, admm.info.iter);
+        quadprog_status_print(status);
+        iter_unscaled = (0 == ruiz_iter)? admm.info.iter : iter_unscaled;
+    }
+
+    float y[M_CON];
+    quadprog_presolve_postsolve(&pre, &problem, admm.p_x, admm.p_y, &x, y);
+    float err = scaled_error(&x, &ref);
+    float kkt = kkt_error(&x, y);
+    printf("solution error %e, KKT error %e\n", err, kkt);
+    ok = (QP_SUCESS == status) && (admm.info.iter < iter_unscaled) && (err < 1e-2) && (kkt < 1e-2);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing an update of the vectors solved with the active-set method: \n");
+    c0_data[0] = 1.5;
+    c_data[0] = S_data[0] * c0_data[0];
+    bin0_data[0] = 0.4;
+    bin0_data[9] = 0.1;
+    bin_data[0] = R_data[0] * bin0_data[0];
+    bin_data[9] = R_data[9] * bin0_data[9];
+    beq_data[0] = -0.1;
+    reference_solve(&ws, &ref);
+
+    status = quadprog_presolve_update(&pre, &problem);
+    if (QP_SUCESS == status)
+    {
+        matf32_init(&xs, pre.n_r, 1, y_data);
+        status = quadprog_gi(&pre.qp, &ws, &xs, &active);
+    }
+
+    // reduced multipliers from the active set, the equality one from the stationarity of the scaled problem
+    float y_r[N_EQ + N_IN] = {0};
+    for (uint16_t k = 0; k < active.num_active; ++k)
+    {
+        y_r[pre.meq_r + active.p_index[k]] = active.p_lambda[k];
+    }
+    float a_max = 0;
+    uint16_t j_max = 0;
+    float g[N_VAR];
+    for (uint16_t i = 0; i < pre.n_r; ++i)
+    {
+        g[i] = pre.c.p_data[i];
+        for (uint16_t j = 0; j < pre.n_r; ++j)
+        {
+            g[i] += pre.Q.p_data[i*pre.n_r + j] * xs.p_data[j];
+        }
+        for (uint16_t k = 0; k < pre.min_r; ++k)
+        {
+            g[i] += pre.Ain.p_data[k*pre.n_r + i] * y_r[pre.meq_r + k];
+        }
+        if (fabsf(pre.Aeq.p_data[i]) > a_max)
+        {
+            a_max = fabsf(pre.Aeq.p_data[i]);
+            j_max = i;
+        }
+    }
+    y_r[0] = -g[j_max] / pre.Aeq.p_data[j_max];
+
+    quadprog_presolve_postsolve(&pre, &problem, xs.p_data, y_r, &x, y);
+    err = scaled_error(&x, &ref);
+    kkt = kkt_error(&x, y);
+    printf("%u redundant, solution error %e, KKT error %e\n", pre.info.num_redundant, err, kkt);
+    ok = (QP_SUCESS == status) && (err < 1e-4) && (kkt < 1e-3);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing inconsistent duplicate equalities: \n");
+    beq_data[2] = 2.0;
+    status = quadprog_presolve_update(&pre, &problem);
+    quadprog_status_print(status);
+    ok = (QP_INFEASIBLE == status);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("quadprog_presolve sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_presolve failure.\n");
+        return 1;
+    }
+}
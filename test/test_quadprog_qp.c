@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "quadprog_data.h"
+
+float Qs_data[] = { 1, -1,
+                   -1,  2};
+
+float cs_data[] = {-2, -6};
+
+float Aeqs_data[] = {1, 1};
+
+float beqs_data[] = {0};
+
+float Results_data[] = {-0.8, 0.8};
+
+float x_data[10];
+float r_data[10];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(10, 8, 0)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(10, 8, 0)];
+
+quadprog_active_set_t active;
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol*(1 + fabsf(b->p_data[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool
+test_method(quadprog_t* p_qp, quadprog_workspace_t* p_ws, matf32_t* p_x, const matf32_t* p_ref,
+            quadprog_kkt_method_t method, const char* name)
+{
+    quadprog_status_t status = quadprog_qp_method(p_qp, p_ws, p_x, method);
+    bool ok = (QP_SUCESS == status) && close_to(p_x, p_ref, 1e-4);
+
+    printf("  %-10s status %d  %s\n", name, status, ok? "ok" : "FAIL");
+    if (!ok)
+    {
+        matf32_print(p_x);
+    }
+
+    return ok;
+}
+
+
+int main(void)
+{
+    bool pass = true;
+    matf32_t Q, c, Aeq, beq, x, r;
+    quadprog_workspace_t ws;
+    quadprog_t problem;
+
+    quadprog_workspace_init(&ws, 10, 8, 0, ws_fwork, ws_iwork);
+
+    printf("Testing quadprog_qp (2 variables, 1 equality):\n");
+    matf32_init(&Q, 2, 2, Qs_data);
+    matf32_init(&c, 2, 1, cs_data);
+    matf32_init(&Aeq, 1, 2, Aeqs_data);
+    matf32_init(&beq, 1, 1, beqs_data);
+    matf32_init(&x, 2, 1, x_data);
+    matf32_init(&r, 2, 1, Results_data);
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, NULL, NULL, NULL);
+
+    pass &= test_method(&problem, &ws, &x, &r, QP_KKT_SCHUR, "schur");
+    pass &= test_method(&problem, &ws, &x, &r, QP_KKT_NULL_SPACE, "null-space");
+
+    // first meq rows of the inequality data as equalities, reference from the active-set solver
+    uint16_t meq_list[] = {0, 2, 5, 8};
+    for (uint16_t k = 0; k < sizeof(meq_list)/sizeof(meq_list[0]); ++k)
+    {
+        uint16_t meq = meq_list[k];
+        printf("Testing quadprog_qp (10 variables, %d equalities):\n", meq);
+
+        matf32_init(&Q, 10, 10, Q10_data);
+        matf32_init(&c, 10, 1, c10_data);
+        matf32_init(&Aeq, meq, 10, A10_data);
+        matf32_init(&beq, meq, 1, b10_data);
+        matf32_init(&x, 10, 1, x_data);
+        matf32_init(&r, 10, 1, r_data);
+        quadprog_init(&problem, &Q, &c, (meq > 0)? &Aeq : NULL, (meq > 0)? &beq : NULL, NULL, NULL, NULL);
+
+        quadprog_status_t status = quadprog_gi(&problem, &ws, &r, &active);
+        if (QP_SUCESS != status)
+        {
+            printf("  reference failed, status %d\n", status);
+            pass = false;
+            continue;
+        }
+
+        pass &= test_method(&problem, &ws, &x, &r, QP_KKT_SCHUR, "schur");
+        pass &= test_method(&problem, &ws, &x, &r, QP_KKT_NULL_SPACE, "null-space");
+
+        status = quadprog_qp(&problem, &ws, &x);
+        pass &= (QP_SUCESS == status) && close_to(&x, &r, 1e-4);
+    }
+
+    printf("Testing quadprog_qp (not convex):\n");
+    float Qn_data[] = {1, 0, 0, -1};
+    float An_data[] = {0, 1};
+    float bn_data[] = {1};
+    matf32_init(&Q, 2, 2, Qn_data);
+    matf32_init(&c, 2, 1, cs_data);
+    matf32_init(&Aeq, 1, 2, An_data);
+    matf32_init(&beq, 1, 1, bn_data);
+    matf32_init(&x, 2, 1, x_data);
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, NULL, NULL, NULL);
+
+    // Q is indefinite but Z'QZ = 1 is positive, only the null-space method can solve it
+    quadprog_status_t status = quadprog_qp_method(&problem, &ws, &x, QP_KKT_SCHUR);
+    printf("  schur      status %d\n", status);
+    pass &= (QP_NOT_CONVEX == status);
+
+    status = quadprog_qp_method(&problem, &ws, &x, QP_KKT_NULL_SPACE);
+    printf("  null-space status %d  x = (%f, %f)\n", status, x_data[0], x_data[1]);
+    pass &= (QP_SUCESS == status) && (fabsf(x_data[0] - 2) < 1e-5) && (fabsf(x_data[1] - 1) < 1e-5);
+
+    if (pass)
+    {
+        printf("quadprog_qp sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_qp failure.\n");
+        return 1;
+    }
+}
@@ -9,6 +9,9 @@
 
 float x_data[10];
 
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(10, 0, 10)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(10, 0, 10)];
+
 float* Q_list[] = {Q2_data, Q3_data, Q4_data, Q5_data, Q6_data, Q7_data, Q8_data, Q9_data, Q10_data};
 float* c_list[] = {c2_data, c3_data, c4_data, c5_data, c6_data, c7_data, c8_data, c9_data, c10_data};
 float* A_list[] = {A2_data, A3_data, A4_data, A5_data, A6_data, A7_data, A8_data, A9_data, A10_data};
@@ -25,6 +28,7 @@ int main(void)
 
 
     quadprog_t problem;
+    quadprog_workspace_t ws;
 
     quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
 
@@ -32,6 +36,8 @@ int main(void)
     {
         int n = i+2;
 
+        quadprog_workspace_init(&ws, 10, 0, 10, ws_fwork, ws_iwork);
+
         matf32_init(&Q, n, n, Q_list[i]);
         matf32_init(&c, n, 1, c_list[i]);
         matf32_init(&Ain, n, n, A_list[i]);
@@ -43,7 +49,7 @@ int main(void)
         for (int j = 0; j < 100; ++j)
         {
             time = clock();
-            quadprog_sqp(&problem, &x);
+            quadprog_sqp(&problem, &ws, &x);
             time_data += ((float)clock()-time)/CLOCKS_PER_SEC;
         }
         
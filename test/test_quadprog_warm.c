@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "quadprog_data.h"
+
+#define N_TICKS 50
+
+float Qs_data[] = { 1, -1,
+                   -1,  2};
+
+float cs_data[] = {-2, -6};
+
+float Ains_data[] = { 1, 1,
+                     -1, 2,
+                      2, 1};
+
+float bins_data[] = {2, 2, 3};
+
+float Aeqs_data[] = {1, -1};
+
+float beqs_data[] = {0};
+
+float c_data[10];
+float x_data[10];
+float r_data[10];
+
+float ws_fwork[QUADPROG_WORKSPACE_FWORK(10, 1, 10)];
+int16_t ws_iwork[QUADPROG_WORKSPACE_IWORK(10, 1, 10)];
+float ref_fwork[QUADPROG_WORKSPACE_FWORK(10, 1, 10)];
+int16_t ref_iwork[QUADPROG_WORKSPACE_IWORK(10, 1, 10)];
+
+
+static bool
+close_to(const matf32_t* a, const matf32_t* b, float tol)
+{
+    for (uint16_t i = 0; i < a->num_rows; ++i)
+    {
+        if (fabsf(a->p_data[i] - b->p_data[i]) > tol*(1 + fabsf(b->p_data[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int main(void)
+{
+    matf32_t Q, c, Ain, bin, Aeq, beq, x, ref;
+    quadprog_t problem;
+    quadprog_workspace_t ws, ws_ref;
+    quadprog_warm_t warm;
+    quadprog_status_t status;
+    bool ans = true;
+
+    quadprog_workspace_init(&ws, 10, 1, 10, ws_fwork, ws_iwork);
+    quadprog_workspace_init(&ws_ref, 10, 1, 10, ref_fwork, ref_iwork);
+    quadprog_warm_init(&warm, &ws);
+
+    matf32_init(&Q, 2, 2, Qs_data);
+    matf32_init(&c, 2, 1, cs_data);
+    matf32_init(&Ain, 3, 2, Ains_data);
+    matf32_init(&bin, 3, 1, bins_data);
+    matf32_init(&Aeq, 1, 2, Aeqs_data);
+    matf32_init(&beq, 1, 1, beqs_data);
+    matf32_init(&x, 2, 1, x_data);
+    matf32_init(&ref, 2, 1, r_data);
+
+    printf("Testing mixed constraints, cold then warm: \n");
+    quadprog_init(&problem, &Q, &c, &Aeq, &beq, &Ain, &bin, NULL);
+    status = quadprog_solve_warm(&warm, &problem, &x);
+    quadprog_gi(&problem, &ws_ref, &ref, NULL);
+    printf("cold: %d active set changes\n", warm.iter);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-5);
+
+    status = quadprog_solve_warm(&warm, &problem, &x);
+    printf("warm: %d active set changes\n", warm.iter);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-5) && (0 == warm.iter);
+
+    printf("Testing a constraint leaving the active set: \n");
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    quadprog_warm_reset(&warm);
+    status = quadprog_solve_warm(&warm, &problem, &x);
+    ans = ans && (QP_SUCESS == status) && (2 == warm.active.num_active);
+    cs_data[0] = 2;
+    cs_data[1] = 2;
+    status = quadprog_solve_warm(&warm, &problem, &x);
+    quadprog_gi(&problem, &ws_ref, &ref, NULL);
+    matf32_print(&x);
+    printf("warm: %d active set changes, %d active\n", warm.iter, warm.active.num_active);
+    ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-5) && (0 == warm.active.num_active);
+
+    printf("Testing receding horizon sequence: \n");
+    matf32_init(&Q, 10, 10, Q10_data);
+    matf32_init(&c, 10, 1, c_data);
+    matf32_init(&Ain, 10, 10, A10_data);
+    matf32_init(&bin, 10, 1, b10_data);
+    matf32_init(&x, 10, 1, x_data);
+    matf32_init(&ref, 10, 1, r_data);
+    quadprog_init(&problem, &Q, &c, NULL, NULL, &Ain, &bin, NULL);
+    quadprog_warm_reset(&warm);
+
+    uint16_t steady_ticks = 0;
+    uint16_t total_iter = 0;
+    for (int k = 0; k < N_TICKS; ++k)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            c_data[i] = c10_data[i] + 1.5f*sinf(0.1f*k + i);
+        }
+
+        status = quadprog_solve_warm(&warm, &problem, &x);
+        quadprog_gi(&problem, &ws_ref, &ref, NULL);
+        ans = ans && (QP_SUCESS == status) && close_to(&x, &ref, 1e-4);
+
+        if (k > 0)
+        {
+            total_iter += warm.iter;
+            steady_ticks += (warm.iter <= 2)? 1 : 0;
+        }
+    }
+    printf("%d of %d ticks within 2 active set changes, %d changes in total\n", steady_ticks, N_TICKS - 1, total_iter);
+    ans = ans && (steady_ticks >= (N_TICKS - 1)*9/10);
+
+    if (ans)
+    {
+        printf("quadprog_warm sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("quadprog_warm failure.\n");
+        return 1;
+    }
+}
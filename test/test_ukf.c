@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "robotat_linalg.h"
+#include "robotat_control.h"
+
+#define N_X     2
+#define N_U     1
+#define N_Y     2
+#define N_W     1
+#define STEPS   2000
+#define DT      0.01f
+#define G_L     9.81f
+#define DAMP    0.2f
+#define LEN     0.5f
+
+// damped pendulum, the position of the bob is measured
+float F_data[] = {0,
+                  DT};
+
+float Qw_data[MATF32_SYM_SIZE(N_W)] = {1};
+float Qv_data[MATF32_SYM_SIZE(N_Y)] = {1e-4f, 0, 1e-4f};
+
+float P_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+float P2_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+float P3_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+float P4_data[MATF32_SYM_SIZE(N_X)] = {1, 0, 1};
+
+// linearization at the bottom, for the comparison with the linear filter
+float A_data[] = {1,        DT,
+                  -DT*G_L,  1 - DT*DAMP};
+
+float B_data[] = {0,
+                  DT};
+
+float C_data[] = {LEN, 0,
+                  0,   0.5f*LEN};
+
+float D_data[N_Y*N_U];
+
+float state_data[N_X];
+float x_data[N_X] = {1.5f, 0};
+float xhat_data[N_X];
+float xhat2_data[N_X];
+float xhat3_data[N_X];
+float xhat4_data[N_X];
+float u_data[N_U];
+float y_data[N_Y];
+
+float work[UKF_FWORK(N_X, N_Y)];
+float work2[UKF_FWORK(N_X, N_Y)];
+float work3[UKF_FWORK(N_X, N_Y)];
+
+static uint32_t seed = 12345;
+
+
+// uniform in [-1, 1]
+static float
+noise(void)
+{
+    seed = 1664525u*seed + 1013904223u;
+    return 2.0f*(float)(seed >> 8)/16777216.0f - 1.0f;
+}
+
+
+static err_status_t
+dynamics(matf32_t* const x_next, const matf32_t* x, const matf32_t* u)
+{
+    float th = x->p_data[0];
+    float om = x->p_data[1];
+
+    x_next->p_data[0] = th + DT*om;
+    x_next->p_data[1] = om + DT*(-G_L*sinf(th) - DAMP*om + u->p_data[0]);
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+outputs(matf32_t* const y, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    y->p_data[0] = LEN*sinf(x->p_data[0]);
+    y->p_data[1] = -LEN*cosf(x->p_data[0]);
+
+    return MATH_SUCCESS;
+}
+
+
+// same model over all the sigma points, stored by component
+static err_status_t
+dynamics_batch(float* const p_x, uint16_t count, const matf32_t* u)
+{
+    float* const th = p_x;
+    float* const om = p_x + count;
+
+    for (uint16_t k = 0; k < count; ++k)
+    {
+        float th_k = th[k];
+        th[k] = th_k + DT*om[k];
+        om[k] = om[k] + DT*(-G_L*sinf(th_k) - DAMP*om[k] + u->p_data[0]);
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+outputs_batch(float* const p_y, const float* p_x, uint16_t count, const matf32_t* u)
+{
+    (void)u;
+    for (uint16_t k = 0; k < count; ++k)
+    {
+        p_y[k] = LEN*sinf(p_x[k]);
+        p_y[count + k] = -LEN*cosf(p_x[k]);
+    }
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+linear_dynamics(matf32_t* const x_next, const matf32_t* x, const matf32_t* u)
+{
+    x_next->p_data[0] = A_data[0]*x->p_data[0] + A_data[1]*x->p_data[1] + B_data[0]*u->p_data[0];
+    x_next->p_data[1] = A_data[2]*x->p_data[0] + A_data[3]*x->p_data[1] + B_data[1]*u->p_data[0];
+
+    return MATH_SUCCESS;
+}
+
+
+static err_status_t
+linear_outputs(matf32_t* const y, const matf32_t* x, const matf32_t* u)
+{
+    (void)u;
+    y->p_data[0] = C_data[0]*x->p_data[0] + C_data[1]*x->p_data[1];
+    y->p_data[1] = C_data[2]*x->p_data[0] + C_data[3]*x->p_data[1];
+
+    return MATH_SUCCESS;
+}
+
+
+int main(void)
+{
+    matf32_t F, A, B, C, D, state, x, xhat, xhat2, xhat3, xhat4, u, y;
+    matf32_sym_t Qw, Qv, P, P2, P3, P4;
+    sys_nonlin_t sys, sys_lin;
+    sys_lti_t sys_lti;
+    ukf_info_t kf, kf_batch, kf_workers;
+    kalman_sym_info_t kf_lin;
+    bool ans = true;
+    bool ok;
+
+    matf32_init(&F, N_X, N_W, F_data);
+    matf32_init(&A, N_X, N_X, A_data);
+    matf32_init(&B, N_X, N_U, B_data);
+    matf32_init(&C, N_Y, N_X, C_data);
+    matf32_init(&D, N_Y, N_U, D_data);
+    matf32_init(&state, N_X, 1, state_data);
+    matf32_init(&x, N_X, 1, x_data);
+    matf32_init(&xhat, N_X, 1, xhat_data);
+    matf32_init(&xhat2, N_X, 1, xhat2_data);
+    matf32_init(&xhat3, N_X, 1, xhat3_data);
+    matf32_init(&xhat4, N_X, 1, xhat4_data);
+    matf32_init(&u, N_U, 1, u_data);
+    matf32_init(&y, N_Y, 1, y_data);
+    matf32_sym_init(&Qw, N_W, Qw_data);
+    matf32_sym_init(&Qv, N_Y, Qv_data);
+    matf32_sym_init(&P, N_X, P_data);
+    matf32_sym_init(&P2, N_X, P2_data);
+    matf32_sym_init(&P3, N_X, P3_data);
+    matf32_sym_init(&P4, N_X, P4_data);
+    sys_nonlin_init(&sys, &state, N_U, N_Y, dynamics, outputs, DT);
+    sys_nonlin_init(&sys_lin, &state, N_U, N_Y, linear_dynamics, linear_outputs, DT);
+    ss(&A, &B, &C, &D, DT, &sys_lti);
+
+    printf("Testing a linear model against the linear filter: \n");
+    ok = (MATH_SUCCESS == ukf_init(&kf, &sys_lin, &F, &Qw, &Qv, &xhat, &P, work))
+         && (MATH_SUCCESS == kalman_sym_init(&kf_lin, &sys_lti, &F, &Qw, &Qv, &xhat2, &P2));
+    float err_x = 0;
+    float err_p = 0;
+    for (uint16_t k = 0; (k < 500) && ok; ++k)
+    {
+        u_data[0] = sinf(0.01f*k);
+        y_data[0] = 0.1f*sinf(0.02f*k) + 0.01f*noise();
+        y_data[1] = 0.05f*cosf(0.03f*k) + 0.01f*noise();
+
+        ok = (MATH_SUCCESS == ukf_update(&kf, &u, &y));
+        kalman_sym_update(&kf_lin, &u, &y);
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            err_x = fmaxf(err_x, fabsf(xhat_data[i] - xhat2_data[i]));
+        }
+    }
+    for (uint16_t i = 0; i < MATF32_SYM_SIZE(N_X); ++i)
+    {
+        err_p = fmaxf(err_p, fabsf(P_data[i] - P2_data[i]) / (1e-6f + fabsf(P2_data[i])));
+    }
+    printf("max estimate difference %e, max relative covariance difference %e\n", err_x, err_p);
+    ok = ok && (err_x < 1e-3f) && (err_p < 1e-2f);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing %u steps of a noisy pendulum from a wrong initial estimate: \n", STEPS);
+    for (uint16_t i = 0; i < N_X; ++i)
+    {
+        xhat_data[i] = 0;
+        xhat3_data[i] = 0;
+        xhat4_data[i] = 0;
+    }
+    P_data[0] = P3_data[0] = 1;
+    P_data[1] = P3_data[1] = 0;
+    P_data[2] = P3_data[2] = 1;
+    ok = (MATH_SUCCESS == ukf_init(&kf, &sys, &F, &Qw, &Qv, &xhat, &P, work))
+         && (MATH_SUCCESS == ukf_init(&kf_batch, &sys, &F, &Qw, &Qv, &xhat3, &P3, work2))
+         && (MATH_SUCCESS == ukf_set_batch(&kf_batch, dynamics_batch, outputs_batch))
+         && (MATH_SUCCESS == ukf_init(&kf_workers, &sys, &F, &Qw, &Qv, &xhat4, &P4, work3))
+         && (MATH_SUCCESS == ukf_set_workers(&kf_workers, 4));
+    float err_true = 0;
+    float err_batch = 0;
+    float err_workers = 0;
+    for (uint16_t k = 0; (k < STEPS) && ok; ++k)
+    {
+        u_data[0] = 0.5f*sinf(0.005f*k);
+
+        // simulated plant with process and measurement noise
+        float w = noise();
+        dynamics(&x, &x, &u);
+        x_data[1] += DT*w;
+        outputs(&y, &x, &u);
+        y_data[0] += 0.01f*noise();
+        y_data[1] += 0.01f*noise();
+
+        ok = (MATH_SUCCESS == ukf_update(&kf, &u, &y)) && (MATH_SUCCESS == ukf_update(&kf_batch, &u, &y))
+             && (MATH_SUCCESS == ukf_update(&kf_workers, &u, &y));
+        for (uint16_t i = 0; i < N_X; ++i)
+        {
+            err_batch = fmaxf(err_batch, fabsf(xhat_data[i] - xhat3_data[i]));
+            err_workers = fmaxf(err_workers, fabsf(xhat_data[i] - xhat4_data[i]));
+        }
+        if (k > STEPS/10)
+        {
+            err_true = fmaxf(err_true, fabsf(xhat_data[0] - x_data[0]));
+        }
+    }
+    printf("max angle error %e, batched callbacks difference %e, 4 workers difference %e\n", err_true, err_batch,
+           err_workers);
+    ok = ok && (err_true < 0.05f) && (err_batch < 1e-5f) && (0 == err_workers);
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    printf("Testing the parameter checks: \n");
+    ok = (MATH_ARGUMENT_ERROR == ukf_set_parameters(&kf, 0, 2, 0))
+         && (MATH_ARGUMENT_ERROR == ukf_set_parameters(&kf, 1, 2, -N_X))
+         && (MATH_SUCCESS == ukf_set_parameters(&kf, 0.5f, 2, 1))
+         && (MATH_ARGUMENT_ERROR == ukf_set_workers(&kf, 0))
+         && (MATH_ARGUMENT_ERROR == ukf_set_workers(&kf, PARALLEL_MAX_WORKERS + 1))
+         && (MATH_ARGUMENT_ERROR == ukf_set_workers(&kf, UKF_NUM_SIGMA(N_X) + 1))
+         && (MATH_SUCCESS == ukf_set_workers(&kf, UKF_NUM_SIGMA(N_X)));
+    printf("%s\n", ok ? "sucess" : "failure");
+    ans = ans && ok;
+
+    if (ans)
+    {
+        printf("ukf sucess.\n");
+        return 0;
+    }
+    else
+    {
+        printf("ukf failure.\n");
+        return 1;
+    }
+}
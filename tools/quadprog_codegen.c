@@ -0,0 +1,1072 @@
+/**
+ * @file quadprog_codegen.c
+ *
+ * Build-time generator of ADMM solvers specialized for one problem structure.
+ *
+ * Reads the dimensions and sparsity of min 1/2 x'Qx + c'x s.t. Aeq x = beq, Ain x <= bin from a specification
+ * file and writes <name>.h and <name>.c: the quadprog_admm iteration with every size a compile-time constant,
+ * static workspace, and the KKT factorization, triangular solves and matrix products unrolled into straight-line
+ * code over the nonzeros. The fill-reducing ordering and the pattern of L are the ones quadprog_admm computes
+ * for the same structure, so both solvers do the same arithmetic.
+ *
+ * Usage: quadprog_codegen <spec> <output directory>
+ *
+ * Specification (whitespace separated, '#' starts a comment until the end of the line):
+ *
+ *      name    <C identifier, prefix of the generated API>
+ *      n       <variables>
+ *      meq     <equalities>
+ *      min     <inequalities>
+ *      Q       <n*n numbers, row major>
+ *      Aeq     <meq*n numbers>     (omitted when meq is 0)
+ *      Ain     <min*n numbers>     (omitted when min is 0)
+ *
+ * Only whether an entry is zero matters, the values are read at run time from the quadprog_t given to the
+ * generated functions. The generated code is plain C using the types of this library (quadprog_t, matf32_t,
+ * quadprog_status_t, quadprog_admm_settings_t, quadprog_admm_info_t), it links against the library objects.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "quadprog_admm.h"
+
+#define CODEGEN_N_MAX       (64)    /**< Largest number of variables. */
+#define CODEGEN_M_MAX       (128)   /**< Largest number of constraints. */
+#define CODEGEN_NAME_MAX    (64)
+#define CODEGEN_DIM_MAX     (CODEGEN_N_MAX + CODEGEN_M_MAX)
+#define CODEGEN_NNZ_MAX     (QP_ADMM_KKT_NNZ_MAX(CODEGEN_N_MAX, CODEGEN_M_MAX))
+#define CODEGEN_LNZ_MAX     (QP_ADMM_LNZ_MAX(CODEGEN_N_MAX, CODEGEN_M_MAX))
+
+static char name[CODEGEN_NAME_MAX];
+static char macro[CODEGEN_NAME_MAX];
+static int n, meq, min, m, dim;
+
+static float Q_data[CODEGEN_N_MAX*CODEGEN_N_MAX];
+static float Qa_data[CODEGEN_N_MAX*CODEGEN_N_MAX];
+static float Aeq_data[CODEGEN_M_MAX*CODEGEN_N_MAX];
+static float Ain_data[CODEGEN_M_MAX*CODEGEN_N_MAX];
+static float vec_data[CODEGEN_M_MAX + CODEGEN_N_MAX];
+
+static float fbuf[QP_ADMM_FWORK(CODEGEN_N_MAX, CODEGEN_M_MAX, CODEGEN_NNZ_MAX, CODEGEN_LNZ_MAX)];
+static uint16_t ibuf[QP_ADMM_IWORK(CODEGEN_N_MAX, CODEGEN_M_MAX, CODEGEN_NNZ_MAX, CODEGEN_LNZ_MAX)];
+
+static int L_pos[CODEGEN_DIM_MAX*CODEGEN_DIM_MAX];   /**< Position in Lx of L(i, j) in pivot order, -1 if zero. */
+
+
+// ====================================================================================================
+// Specification
+// ====================================================================================================
+
+
+// Next token, skipping comments. False at the end of the file.
+static bool
+spec_token(FILE* p_file, char* p_tok, size_t size)
+{
+    int ch;
+    size_t len = 0;
+
+    for (;;)
+    {
+        ch = fgetc(p_file);
+        if ('#' == ch)
+        {
+            while ((EOF != ch) && ('\n' != ch))
+            {
+                ch = fgetc(p_file);
+            }
+        }
+        if (EOF == ch)
+        {
+            return false;
+        }
+        if (!isspace(ch))
+        {
+            break;
+        }
+    }
+
+    while ((EOF != ch) && !isspace(ch) && ('#' != ch))
+    {
+        if (len + 1 < size)
+        {
+            p_tok[len++] = (char)ch;
+        }
+        ch = fgetc(p_file);
+    }
+    if ('#' == ch)
+    {
+        ungetc(ch, p_file);
+    }
+    p_tok[len] = '\0';
+
+    return true;
+}
+
+
+static bool
+spec_int(FILE* p_file, const char* p_key, int max, int* p_value)
+{
+    char tok[CODEGEN_NAME_MAX];
+
+    if (!spec_token(p_file, tok, sizeof(tok)) || (0 != strcmp(tok, p_key)) || !spec_token(p_file, tok, sizeof(tok)))
+    {
+        fprintf(stderr, "quadprog_codegen: expected '%s <value>'\n", p_key);
+        return false;
+    }
+
+    *p_value = atoi(tok);
+    if ((*p_value < 0) || (*p_value > max))
+    {
+        fprintf(stderr, "quadprog_codegen: %s must be in [0, %d]\n", p_key, max);
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool
+spec_matrix(FILE* p_file, const char* p_key, int rows, float* p_data)
+{
+    char tok[CODEGEN_NAME_MAX];
+
+    if (0 == rows)
+    {
+        return true;
+    }
+
+    if (!spec_token(p_file, tok, sizeof(tok)) || (0 != strcmp(tok, p_key)))
+    {
+        fprintf(stderr, "quadprog_codegen: expected '%s'\n", p_key);
+        return false;
+    }
+
+    for (int k = 0; k < rows*n; ++k)
+    {
+        if (!spec_token(p_file, tok, sizeof(tok)))
+        {
+            fprintf(stderr, "quadprog_codegen: %s needs %d entries\n", p_key, rows*n);
+            return false;
+        }
+        p_data[k] = (0.0f != strtof(tok, NULL))? 1.0f : 0.0f;
+    }
+
+    return true;
+}
+
+
+static bool
+spec_read(const char* p_path)
+{
+    char tok[CODEGEN_NAME_MAX];
+    FILE* p_file = fopen(p_path, "r");
+
+    if (NULL == p_file)
+    {
+        fprintf(stderr, "quadprog_codegen: cannot open %s\n", p_path);
+        return false;
+    }
+
+    bool ok = spec_token(p_file, tok, sizeof(tok)) && (0 == strcmp(tok, "name"))
+              && spec_token(p_file, name, sizeof(name));
+    if (!ok)
+    {
+        fprintf(stderr, "quadprog_codegen: expected 'name <identifier>'\n");
+    }
+
+    for (size_t i = 0; ok && (i < strlen(name)); ++i)
+    {
+        ok = isalnum((unsigned char)name[i]) || ('_' == name[i]);
+        macro[i] = (char)toupper((unsigned char)name[i]);
+        macro[i + 1] = '\0';
+    }
+
+    ok = ok && spec_int(p_file, "n", CODEGEN_N_MAX, &n) && spec_int(p_file, "meq", CODEGEN_M_MAX, &meq)
+         && spec_int(p_file, "min", CODEGEN_M_MAX - meq, &min) && (n > 0)
+         && spec_matrix(p_file, "Q", n, Q_data) && spec_matrix(p_file, "Aeq", meq, Aeq_data)
+         && spec_matrix(p_file, "Ain", min, Ain_data);
+
+    fclose(p_file);
+
+    m = meq + min;
+    dim = n + m;
+
+    return ok;
+}
+
+
+// ====================================================================================================
+// Structure analysis
+// ====================================================================================================
+
+
+static bool
+is_Q_nz(int i, int j)
+{
+    return (0.0f != Q_data[i*n + j]);
+}
+
+
+static bool
+is_A_nz(int k, int j)
+{
+    return (k < meq)? (0.0f != Aeq_data[k*n + j]) : (0.0f != Ain_data[(k - meq)*n + j]);
+}
+
+
+// Expression of KKT(i, j) (original indices) in the generated code, false if it is structurally zero
+static bool
+kkt_entry(int i, int j, char* p_buf)
+{
+    if ((i < n) && (j < n))
+    {
+        if ((i == j) && !is_Q_nz(i, i))
+        {
+            sprintf(p_buf, "sigma");
+            return true;
+        }
+        if (i == j)
+        {
+            sprintf(p_buf, "Q[%d] + sigma", i*n + i);
+            return true;
+        }
+        sprintf(p_buf, "Q[%d]", i*n + j);
+        return is_Q_nz(i, j);
+    }
+
+    if ((i >= n) && (j >= n))
+    {
+        sprintf(p_buf, "-rho_inv[%d]", i - n);
+        return (i == j);
+    }
+
+    int k = ((i >= n)? i : j) - n;
+    int col = (i >= n)? j : i;
+    if (k < meq)
+    {
+        sprintf(p_buf, "Aeq[%d]", k*n + col);
+    }
+    else
+    {
+        sprintf(p_buf, "Ain[%d]", (k - meq)*n + col);
+    }
+
+    return is_A_nz(k, col);
+}
+
+
+// The ordering and pattern of L of quadprog_admm for this structure. Q gets a dominant diagonal so that the
+// numeric factorization, which fills the row indices of L, succeeds.
+static bool
+analyze(quadprog_admm_t* const p_h)
+{
+    matf32_t Q, c, Aeq, beq, Ain, bin;
+    quadprog_t qp;
+
+    memcpy(Qa_data, Q_data, sizeof(Q_data));
+    for (int i = 0; i < n; ++i)
+    {
+        Qa_data[i*n + i] = 1;
+        for (int j = 0; j < n; ++j)
+        {
+            Qa_data[i*n + i] += (i != j)? Q_data[i*n + j] : 0;
+        }
+    }
+    memset(vec_data, 0, sizeof(vec_data));
+
+    matf32_init(&Q, n, n, Qa_data);
+    matf32_init(&c, n, 1, vec_data);
+    matf32_init(&Aeq, meq, n, Aeq_data);
+    matf32_init(&beq, meq, 1, vec_data);
+    matf32_init(&Ain, min, n, Ain_data);
+    matf32_init(&bin, min, 1, vec_data);
+    quadprog_init(&qp, &Q, &c, (meq > 0)? &Aeq : NULL, (meq > 0)? &beq : NULL, (min > 0)? &Ain : NULL,
+                  (min > 0)? &bin : NULL, NULL);
+
+    quadprog_status_t status = quadprog_admm_init(p_h, &qp, CODEGEN_NNZ_MAX, CODEGEN_LNZ_MAX, fbuf, ibuf);
+    if (QP_SUCESS != status)
+    {
+        fprintf(stderr, "quadprog_codegen: analysis failed: ");
+        quadprog_status_print(status);
+        return false;
+    }
+
+    for (int k = 0; k < dim*dim; ++k)
+    {
+        L_pos[k] = -1;
+    }
+    for (int j = 0; j < dim; ++j)
+    {
+        for (int p = p_h->sym.p_Lp[j]; p < p_h->sym.p_Lp[j + 1]; ++p)
+        {
+            L_pos[p_h->num.p_Li[p]*dim + j] = p;
+        }
+    }
+
+    return true;
+}
+
+
+// ====================================================================================================
+// Code emission
+// ====================================================================================================
+
+
+static void
+emit_header(FILE* p_file, const char* p_spec, const quadprog_admm_t* const p_h)
+{
+    fprintf(p_file,
+        "/**\n"
+        " * @file %s.h\n"
+        " *\n"
+        " * ADMM solver for n = %d, meq = %d, min = %d and the sparsity of %s.\n"
+        " * Generated by quadprog_codegen, do not edit.\n"
+        " *\n"
+        " */\n\n"
+        "#ifndef %s_H_\n"
+        "#define %s_H_\n\n"
+        "#include \"quadprog_admm.h\"\n\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n\n"
+        "#define %s_N      (%d)\n"
+        "#define %s_MEQ    (%d)\n"
+        "#define %s_MIN    (%d)\n"
+        "#define %s_LNZ    (%d)    /**< Nonzeros of the L factor of the KKT matrix. */\n\n",
+        name, n, meq, min, p_spec, macro, macro, macro, n, macro, meq, macro, min, macro, p_h->sym.lnz);
+}
+
+
+static void
+emit_api(FILE* p_file)
+{
+    fprintf(p_file,
+        "extern quadprog_admm_settings_t %s_settings;   /**< Settings, same meaning and defaults as quadprog_admm. */\n"
+        "extern quadprog_admm_info_t %s_info;           /**< Statistics of the last call. */\n"
+        "extern float %s_dx[%s_N];                      /**< Last primal step, the certificate after QP_UNBOUNDED. */\n"
+        "extern float %s_dy[%s_MEQ + %s_MIN + 1];       /**< Last dual step, the certificate after QP_INFEASIBLE. */\n\n\n"
+        "/**\n"
+        " * @brief   Sets the default settings, cold starts and factors the KKT matrix (see quadprog_admm_init).\n"
+        " *\n"
+        " * @param[in]   p_qp    Points to a problem with the structure the solver was generated for.\n"
+        " *\n"
+        " * @return  Execution status\n"
+        " *              QP_SUCESS :         Operation successful.\n"
+        " *              QP_NOT_CONVEX :     KKT matrix could not be factored.\n"
+        " */\n"
+        "quadprog_status_t\n"
+        "%s_init(const quadprog_t* const p_qp);\n\n\n"
+        "/**\n"
+        " * @brief   Refactors the KKT matrix after the values of Q, Aeq or Ain, or settings.sigma, changed.\n"
+        " *\n"
+        " * @param[in]   p_qp    Points to the problem.\n"
+        " *\n"
+        " * @return  Execution status\n"
+        " *              QP_SUCESS :         Operation successful.\n"
+        " *              QP_NOT_CONVEX :     KKT matrix could not be factored.\n"
+        " */\n"
+        "quadprog_status_t\n"
+        "%s_update_matrices(const quadprog_t* const p_qp);\n\n\n"
+        "/**\n"
+        " * @brief   Sets the primal and/or dual iterates (NULL keeps the current one).\n"
+        " *\n"
+        " * @param[in]   p_x     Points to primal start, %s_N elements, or NULL.\n"
+        " * @param[in]   p_y     Points to dual start, %s_MEQ + %s_MIN elements, or NULL.\n"
+        " *\n"
+        " * @return  None.\n"
+        " */\n"
+        "void\n"
+        "%s_warm_start(const float* const p_x, const float* const p_y);\n\n\n"
+        "/**\n"
+        " * @brief   Resets the iterates to zero.\n"
+        " *\n"
+        " * @return  None.\n"
+        " */\n"
+        "void\n"
+        "%s_cold_start(void);\n\n\n"
+        "/**\n"
+        " * @brief   Runs the ADMM iteration from the stored iterates (see quadprog_admm). Sizes are not checked.\n"
+        " *\n"
+        " * @param[in]   p_qp    Points to the problem.\n"
+        " * @param[out]  p_x     Points to the vector to store the result.\n"
+        " *\n"
+        " * @return  Execution status\n"
+        " *              QP_SUCESS :         Residuals within tolerance.\n"
+        " *              QP_NOT_CONVEX :     KKT matrix could not be refactored after a rho update.\n"
+        " *              QP_INFEASIBLE :     Constraints are inconsistent, %s_dy holds the certificate.\n"
+        " *              QP_UNBOUNDED :      Cost is unbounded below, %s_dx holds the direction.\n"
+        " *              QP_MAX_ITERATIONS : settings.max_iter reached, p_x holds the last iterate.\n"
+        " */\n"
+        "quadprog_status_t\n"
+        "%s_solve(const quadprog_t* const p_qp, matf32_t* const p_x);\n\n\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n\n"
+        "#endif // %s_H_\n",
+        name, name, name, macro, name, macro, macro, name, name, macro, macro, macro, name, name, name, name, name,
+        macro);
+}
+
+
+// P*KKT*P' = L*D*L', left-looking over the pattern of L, column by column in pivot order
+static void
+emit_factor(FILE* p_file, const quadprog_admm_t* const p_h)
+{
+    const uint16_t* perm = p_h->sym.p_perm;
+    char entry[64];
+
+    fprintf(p_file,
+        "// P*KKT*P' = L*D*L' with the ordering and pattern of quadprog_admm, unrolled\n"
+        "static quadprog_status_t\n"
+        "kkt_factor(const quadprog_t* const p_qp)\n"
+        "{\n"
+        "    const float* Q = p_qp->p_Q->p_data;\n");
+    if (meq > 0)
+    {
+        fprintf(p_file, "    const float* Aeq = p_qp->p_Aeq->p_data;\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file, "    const float* Ain = p_qp->p_Ain->p_data;\n");
+    }
+    fprintf(p_file, "    const float sigma = %s_settings.sigma;\n\n", name);
+
+    for (int j = 0; j < dim; ++j)
+    {
+        kkt_entry(perm[j], perm[j], entry);
+        fprintf(p_file, "    D[%d] = %s", j, entry);
+        for (int k = 0; k < j; ++k)
+        {
+            int p = L_pos[j*dim + k];
+            if (p >= 0)
+            {
+                fprintf(p_file, " - Lx[%d]*Lx[%d]*D[%d]", p, p, k);
+            }
+        }
+        fprintf(p_file, ";\n");
+        fprintf(p_file, "    if (0 == D[%d]) return QP_NOT_CONVEX;\n", j);
+        fprintf(p_file, "    D_inv[%d] = 1.0f / D[%d];\n", j, j);
+
+        for (int p = p_h->sym.p_Lp[j]; p < p_h->sym.p_Lp[j + 1]; ++p)
+        {
+            int i = p_h->num.p_Li[p];
+            fprintf(p_file, "    Lx[%d] = (%s", p, kkt_entry(perm[i], perm[j], entry)? entry : "0");
+            for (int k = 0; k < j; ++k)
+            {
+                int pi = L_pos[i*dim + k];
+                int pj = L_pos[j*dim + k];
+                if ((pi >= 0) && (pj >= 0))
+                {
+                    fprintf(p_file, " - Lx[%d]*Lx[%d]*D[%d]", pi, pj, k);
+                }
+            }
+            fprintf(p_file, ")*D_inv[%d];\n", j);
+        }
+    }
+
+    fprintf(p_file,
+        "\n    %s_info.num_factor++;\n\n"
+        "    return QP_SUCESS;\n"
+        "}\n\n\n", name);
+}
+
+
+// w = KKT^-1 w in place
+static void
+emit_solve(FILE* p_file, const quadprog_admm_t* const p_h)
+{
+    const uint16_t* perm = p_h->sym.p_perm;
+
+    fprintf(p_file,
+        "// w = KKT^-1*w with the cached factor, unrolled\n"
+        "static void\n"
+        "kkt_solve(float* const w)\n"
+        "{\n"
+        "    float t[%d];\n\n", dim);
+
+    for (int k = 0; k < dim; ++k)
+    {
+        fprintf(p_file, "    t[%d] = w[%d];\n", k, perm[k]);
+    }
+    for (int j = 0; j < dim; ++j)
+    {
+        for (int p = p_h->sym.p_Lp[j]; p < p_h->sym.p_Lp[j + 1]; ++p)
+        {
+            fprintf(p_file, "    t[%d] -= Lx[%d]*t[%d];\n", p_h->num.p_Li[p], p, j);
+        }
+    }
+    for (int k = 0; k < dim; ++k)
+    {
+        fprintf(p_file, "    t[%d] *= D_inv[%d];\n", k, k);
+    }
+    for (int j = dim - 1; j >= 0; --j)
+    {
+        for (int p = p_h->sym.p_Lp[j]; p < p_h->sym.p_Lp[j + 1]; ++p)
+        {
+            fprintf(p_file, "    t[%d] -= Lx[%d]*t[%d];\n", j, p, p_h->num.p_Li[p]);
+        }
+    }
+    for (int k = 0; k < dim; ++k)
+    {
+        fprintf(p_file, "    w[%d] = t[%d];\n", perm[k], k);
+    }
+
+    fprintf(p_file, "}\n\n\n");
+}
+
+
+// Q*x, A*x and A'*y over the nonzeros
+static void
+emit_products(FILE* p_file)
+{
+    char entry[64];
+
+    fprintf(p_file,
+        "// out = Q*v, unrolled over the nonzeros\n"
+        "static void\n"
+        "mul_Q(const float* const Q, const float* const v, float* const out)\n"
+        "{\n");
+    for (int i = 0; i < n; ++i)
+    {
+        fprintf(p_file, "    out[%d] = 0", i);
+        for (int j = 0; j < n; ++j)
+        {
+            if (is_Q_nz(i, j))
+            {
+                fprintf(p_file, " + Q[%d]*v[%d]", i*n + j, j);
+            }
+        }
+        fprintf(p_file, ";\n");
+    }
+    fprintf(p_file, "}\n\n\n");
+
+    if (0 == m)
+    {
+        return;
+    }
+
+    fprintf(p_file,
+        "// out = A*v with A = [Aeq; Ain], unrolled over the nonzeros\n"
+        "static void\n"
+        "mul_A(const quadprog_t* const p_qp, const float* const v, float* const out)\n"
+        "{\n");
+    if (meq > 0)
+    {
+        fprintf(p_file, "    const float* Aeq = p_qp->p_Aeq->p_data;\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file, "    const float* Ain = p_qp->p_Ain->p_data;\n");
+    }
+    fprintf(p_file, "\n");
+    for (int k = 0; k < m; ++k)
+    {
+        fprintf(p_file, "    out[%d] = 0", k);
+        for (int j = 0; j < n; ++j)
+        {
+            if (kkt_entry(n + k, j, entry))
+            {
+                fprintf(p_file, " + %s*v[%d]", entry, j);
+            }
+        }
+        fprintf(p_file, ";\n");
+    }
+    fprintf(p_file, "}\n\n\n");
+
+    fprintf(p_file,
+        "// out = A'*v, unrolled over the nonzeros\n"
+        "static void\n"
+        "mul_At(const quadprog_t* const p_qp, const float* const v, float* const out)\n"
+        "{\n");
+    if (meq > 0)
+    {
+        fprintf(p_file, "    const float* Aeq = p_qp->p_Aeq->p_data;\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file, "    const float* Ain = p_qp->p_Ain->p_data;\n");
+    }
+    fprintf(p_file, "\n");
+    for (int j = 0; j < n; ++j)
+    {
+        fprintf(p_file, "    out[%d] = 0", j);
+        for (int k = 0; k < m; ++k)
+        {
+            if (kkt_entry(n + k, j, entry))
+            {
+                fprintf(p_file, " + %s*v[%d]", entry, k);
+            }
+        }
+        fprintf(p_file, ";\n");
+    }
+    fprintf(p_file, "}\n\n\n");
+}
+
+
+// The iteration of quadprog_admm with constant sizes. Loops over equality and inequality rows are only
+// emitted when there are such rows, so the output has no empty loops.
+static void
+emit_iteration(FILE* p_file)
+{
+    fprintf(p_file,
+        "static void\n"
+        "set_rho(float rho)\n"
+        "{\n"
+        "    %s_settings.rho = rho;\n", name);
+    if (meq > 0)
+    {
+        fprintf(p_file,
+            "    for (uint16_t k = 0; k < N_EQ; ++k)\n"
+            "    {\n"
+            "        rho_vec[k] = RHO_EQ_SCALE*rho;\n"
+            "        rho_inv[k] = 1.0f / rho_vec[k];\n"
+            "    }\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file,
+            "    for (uint16_t k = N_EQ; k < N_CON; ++k)\n"
+            "    {\n"
+            "        rho_vec[k] = rho;\n"
+            "        rho_inv[k] = 1.0f / rho;\n"
+            "    }\n");
+    }
+    fprintf(p_file, "}\n\n\n");
+
+    // primal infeasibility, only meaningful with constraints
+    if (m > 0)
+    {
+        fprintf(p_file,
+            "static bool\n"
+            "prim_infeasible(const quadprog_t* const p_qp)\n"
+            "{\n"
+            "    float* dy = %s_dy;\n"
+            "    float dy_max = 0;\n"
+            "    float bound = 0;\n\n", name);
+        if (min > 0)
+        {
+            fprintf(p_file,
+                "    for (uint16_t k = N_EQ; k < N_CON; ++k)\n"
+                "    {\n"
+                "        dy[k] = fmaxf(dy[k], 0);\n"
+                "    }\n");
+        }
+        fprintf(p_file,
+            "    for (uint16_t k = 0; k < N_CON; ++k)\n"
+            "    {\n"
+            "        dy_max = fmaxf(dy_max, fabsf(dy[k]));\n"
+            "    }\n"
+            "    if (dy_max <= FLT_EPSILON)\n"
+            "    {\n"
+            "        return false;\n"
+            "    }\n\n"
+            "    for (uint16_t k = 0; k < N_CON; ++k)\n"
+            "    {\n"
+            "        dy[k] /= dy_max;\n"
+            "    }\n");
+        if (meq > 0)
+        {
+            fprintf(p_file,
+                "    for (uint16_t k = 0; k < N_EQ; ++k)\n"
+                "    {\n"
+                "        bound += p_qp->p_beq->p_data[k]*dy[k];\n"
+                "    }\n");
+        }
+        if (min > 0)
+        {
+            fprintf(p_file,
+                "    for (uint16_t k = N_EQ; k < N_CON; ++k)\n"
+                "    {\n"
+                "        bound += p_qp->p_bin->p_data[k - N_EQ]*dy[k];\n"
+                "    }\n");
+        }
+        fprintf(p_file,
+            "    if (bound >= -%s_settings.eps_prim_inf)\n"
+            "    {\n"
+            "        return false;\n"
+            "    }\n\n"
+            "    mul_At(p_qp, dy, xt);\n"
+            "    for (uint16_t i = 0; i < N_VAR; ++i)\n"
+            "    {\n"
+            "        if (fabsf(xt[i]) > %s_settings.eps_prim_inf)\n"
+            "        {\n"
+            "            return false;\n"
+            "        }\n"
+            "    }\n\n"
+            "    return true;\n"
+            "}\n\n\n", name, name);
+    }
+
+    fprintf(p_file,
+        "static bool\n"
+        "dual_infeasible(const quadprog_t* const p_qp)\n"
+        "{\n"
+        "    const float eps = %s_settings.eps_dual_inf;\n"
+        "    float* dx = %s_dx;\n"
+        "    float dx_max = 0;\n"
+        "    float cdx = 0;\n\n"
+        "    for (uint16_t i = 0; i < N_VAR; ++i)\n"
+        "    {\n"
+        "        dx_max = fmaxf(dx_max, fabsf(dx[i]));\n"
+        "    }\n"
+        "    if (dx_max <= FLT_EPSILON)\n"
+        "    {\n"
+        "        return false;\n"
+        "    }\n\n"
+        "    for (uint16_t i = 0; i < N_VAR; ++i)\n"
+        "    {\n"
+        "        dx[i] /= dx_max;\n"
+        "        cdx += p_qp->p_c->p_data[i]*dx[i];\n"
+        "    }\n"
+        "    if (cdx >= -eps)\n"
+        "    {\n"
+        "        return false;\n"
+        "    }\n\n"
+        "    mul_Q(p_qp->p_Q->p_data, dx, xt);\n"
+        "    for (uint16_t i = 0; i < N_VAR; ++i)\n"
+        "    {\n"
+        "        if (fabsf(xt[i]) > eps)\n"
+        "        {\n"
+        "            return false;\n"
+        "        }\n"
+        "    }\n", name, name);
+    if (m > 0)
+    {
+        fprintf(p_file, "\n    mul_A(p_qp, dx, zt);\n");
+    }
+    if (meq > 0)
+    {
+        fprintf(p_file,
+            "    for (uint16_t k = 0; k < N_EQ; ++k)\n"
+            "    {\n"
+            "        if (fabsf(zt[k]) > eps)\n"
+            "        {\n"
+            "            return false;\n"
+            "        }\n"
+            "    }\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file,
+            "    for (uint16_t k = N_EQ; k < N_CON; ++k)\n"
+            "    {\n"
+            "        if (zt[k] > eps)\n"
+            "        {\n"
+            "            return false;\n"
+            "        }\n"
+            "    }\n");
+    }
+    fprintf(p_file, "\n    return true;\n}\n\n\n");
+
+    // public functions
+    fprintf(p_file,
+        "quadprog_status_t\n"
+        "%s_init(const quadprog_t* const p_qp)\n"
+        "{\n"
+        "    %s_settings.rho = 0.1f;\n"
+        "    %s_settings.sigma = 1e-6f;\n"
+        "    %s_settings.alpha = 1.6f;\n"
+        "    %s_settings.eps_abs = 1e-4f;\n"
+        "    %s_settings.eps_rel = 1e-4f;\n"
+        "    %s_settings.eps_prim_inf = 1e-4f;\n"
+        "    %s_settings.eps_dual_inf = 1e-4f;\n"
+        "    %s_settings.max_iter = 4000;\n"
+        "    %s_settings.adapt_interval = 25;\n"
+        "    memset(&%s_info, 0, sizeof(quadprog_admm_info_t));\n\n"
+        "    set_rho(%s_settings.rho);\n"
+        "    %s_cold_start();\n\n"
+        "    return kkt_factor(p_qp);\n"
+        "}\n\n\n"
+        "quadprog_status_t\n"
+        "%s_update_matrices(const quadprog_t* const p_qp)\n"
+        "{\n"
+        "    return kkt_factor(p_qp);\n"
+        "}\n\n\n"
+        "void\n"
+        "%s_warm_start(const float* const p_x, const float* const p_y)\n"
+        "{\n"
+        "    if (NULL != p_x)\n"
+        "    {\n"
+        "        memcpy(x, p_x, sizeof(x));\n"
+        "    }\n\n"
+        "    if (NULL != p_y)\n"
+        "    {\n"
+        "        memcpy(y, p_y, N_CON*sizeof(float));\n"
+        "    }\n"
+        "}\n\n\n"
+        "void\n"
+        "%s_cold_start(void)\n"
+        "{\n"
+        "    memset(x, 0, sizeof(x));\n"
+        "    memset(z, 0, sizeof(z));\n"
+        "    memset(y, 0, sizeof(y));\n"
+        "}\n\n\n",
+        name, name, name, name, name, name, name, name, name, name, name, name, name, name, name, name);
+
+    fprintf(p_file,
+        "quadprog_status_t\n"
+        "%s_solve(const quadprog_t* const p_qp, matf32_t* const p_x)\n"
+        "{\n"
+        "    const quadprog_admm_settings_t* const p_set = &%s_settings;\n"
+        "    const float* q = p_qp->p_c->p_data;\n"
+        "    float* dx = %s_dx;\n", name, name, name);
+    if (m > 0)
+    {
+        fprintf(p_file, "    float* dy = %s_dy;\n", name);
+    }
+    if (meq > 0)
+    {
+        fprintf(p_file, "    const float* beq = p_qp->p_beq->p_data;\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file, "    const float* bin = p_qp->p_bin->p_data;\n");
+    }
+    fprintf(p_file,
+        "    quadprog_status_t status = QP_MAX_ITERATIONS;\n"
+        "    uint16_t iter;\n\n"
+        "    %s_info.num_factor = 0;\n\n", name);
+
+    if (meq > 0)
+    {
+        fprintf(p_file,
+            "    for (uint16_t k = 0; k < N_EQ; ++k)\n"
+            "    {\n"
+            "        z[k] = beq[k];\n"
+            "    }\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file,
+            "    for (uint16_t k = N_EQ; k < N_CON; ++k)\n"
+            "    {\n"
+            "        z[k] = fminf(z[k], bin[k - N_EQ]);\n"
+            "    }\n");
+    }
+
+    fprintf(p_file,
+        "\n    for (iter = 1; iter <= p_set->max_iter; ++iter)\n"
+        "    {\n"
+        "        for (uint16_t i = 0; i < N_VAR; ++i)\n"
+        "        {\n"
+        "            w[i] = p_set->sigma*x[i] - q[i];\n"
+        "        }\n");
+    if (m > 0)
+    {
+        fprintf(p_file,
+            "        for (uint16_t k = 0; k < N_CON; ++k)\n"
+            "        {\n"
+            "            w[N_VAR + k] = z[k] - y[k]*rho_inv[k];\n"
+            "        }\n");
+    }
+    fprintf(p_file,
+        "\n        kkt_solve(w);\n\n"
+        "        for (uint16_t i = 0; i < N_VAR; ++i)\n"
+        "        {\n"
+        "            float x_new = p_set->alpha*w[i] + (1 - p_set->alpha)*x[i];\n"
+        "            dx[i] = x_new - x[i];\n"
+        "            x[i] = x_new;\n"
+        "        }\n");
+    if (m > 0)
+    {
+        fprintf(p_file,
+            "        for (uint16_t k = 0; k < N_CON; ++k)\n"
+            "        {\n"
+            "            float zt_k = z[k] + (w[N_VAR + k] - y[k])*rho_inv[k];\n"
+            "            zt[k] = p_set->alpha*zt_k + (1 - p_set->alpha)*z[k];\n"
+            "        }\n");
+    }
+    if (meq > 0)
+    {
+        fprintf(p_file,
+            "        for (uint16_t k = 0; k < N_EQ; ++k)\n"
+            "        {\n"
+            "            dy[k] = rho_vec[k]*(zt[k] - beq[k]);\n"
+            "            y[k] += dy[k];\n"
+            "            z[k] = beq[k];\n"
+            "        }\n");
+    }
+    if (min > 0)
+    {
+        fprintf(p_file,
+            "        for (uint16_t k = N_EQ; k < N_CON; ++k)\n"
+            "        {\n"
+            "            float z_new = fminf(zt[k] + y[k]*rho_inv[k], bin[k - N_EQ]);\n"
+            "            dy[k] = rho_vec[k]*(zt[k] - z_new);\n"
+            "            y[k] += dy[k];\n"
+            "            z[k] = z_new;\n"
+            "        }\n");
+    }
+
+    fprintf(p_file,
+        "\n        // residuals\n"
+        "        float r_prim = 0;\n"
+        "        float prim_scale = 0;\n");
+    if (m > 0)
+    {
+        fprintf(p_file,
+            "        mul_A(p_qp, x, zt);\n"
+            "        for (uint16_t k = 0; k < N_CON; ++k)\n"
+            "        {\n"
+            "            r_prim = fmaxf(r_prim, fabsf(zt[k] - z[k]));\n"
+            "            prim_scale = fmaxf(prim_scale, fmaxf(fabsf(zt[k]), fabsf(z[k])));\n"
+            "        }\n\n"
+            "        mul_At(p_qp, y, w);\n");
+    }
+    else
+    {
+        fprintf(p_file, "        memset(w, 0, N_VAR*sizeof(float));\n");
+    }
+    fprintf(p_file,
+        "        mul_Q(p_qp->p_Q->p_data, x, xt);\n"
+        "        float r_dual = 0;\n"
+        "        float dual_scale = 0;\n"
+        "        for (uint16_t i = 0; i < N_VAR; ++i)\n"
+        "        {\n"
+        "            r_dual = fmaxf(r_dual, fabsf(xt[i] + q[i] + w[i]));\n"
+        "            dual_scale = fmaxf(dual_scale, fmaxf(fabsf(xt[i]), fmaxf(fabsf(w[i]), fabsf(q[i]))));\n"
+        "        }\n\n"
+        "        %s_info.r_prim = r_prim;\n"
+        "        %s_info.r_dual = r_dual;\n\n"
+        "        if ((r_prim <= p_set->eps_abs + p_set->eps_rel*prim_scale)\n"
+        "            && (r_dual <= p_set->eps_abs + p_set->eps_rel*dual_scale))\n"
+        "        {\n"
+        "            status = QP_SUCESS;\n"
+        "            break;\n"
+        "        }\n\n", name, name);
+    if (m > 0)
+    {
+        fprintf(p_file,
+            "        if (prim_infeasible(p_qp))\n"
+            "        {\n"
+            "            status = QP_INFEASIBLE;\n"
+            "            break;\n"
+            "        }\n\n");
+    }
+    fprintf(p_file,
+        "        if (dual_infeasible(p_qp))\n"
+        "        {\n"
+        "            status = QP_UNBOUNDED;\n"
+        "            break;\n"
+        "        }\n");
+    if (m > 0)
+    {
+        fprintf(p_file,
+            "\n        if ((p_set->adapt_interval > 0) && (0 == iter %% p_set->adapt_interval))\n"
+            "        {\n"
+            "            float ratio = (r_prim / fmaxf(prim_scale, FLT_EPSILON)) / fmaxf(r_dual / fmaxf(dual_scale, FLT_EPSILON), FLT_EPSILON);\n"
+            "            float rho_new = fminf(fmaxf(p_set->rho * sqrtf(ratio), RHO_MIN), RHO_MAX);\n\n"
+            "            if ((rho_new > RHO_TOLERANCE*p_set->rho) || (rho_new < p_set->rho/RHO_TOLERANCE))\n"
+            "            {\n"
+            "                set_rho(rho_new);\n"
+            "                if (QP_SUCESS != kkt_factor(p_qp))\n"
+            "                {\n"
+            "                    status = QP_NOT_CONVEX;\n"
+            "                    break;\n"
+            "                }\n"
+            "            }\n"
+            "        }\n");
+    }
+    fprintf(p_file,
+        "    }\n\n"
+        "    %s_info.iter = (iter > p_set->max_iter)? p_set->max_iter : iter;\n"
+        "    memcpy(p_x->p_data, x, sizeof(x));\n\n"
+        "    return status;\n"
+        "}\n", name);
+}
+
+
+static void
+emit_source(FILE* p_file, const char* p_spec, const quadprog_admm_t* const p_h)
+{
+    fprintf(p_file,
+        "/**\n"
+        " * @file %s.c\n"
+        " *\n"
+        " * ADMM solver for n = %d, meq = %d, min = %d and the sparsity of %s.\n"
+        " * Generated by quadprog_codegen, do not edit.\n"
+        " *\n"
+        " */\n\n"
+        "#include \"%s.h\"\n\n"
+        "#define N_VAR           (%d)\n"
+        "#define N_EQ            (%d)\n"
+        "#define N_CON           (%d)\n"
+        "#define N_KKT           (%d)\n"
+        "#define RHO_EQ_SCALE    (1e3f)\n"
+        "#define RHO_MIN         (1e-6f)\n"
+        "#define RHO_MAX         (1e6f)\n"
+        "#define RHO_TOLERANCE   (5.0f)\n\n"
+        "quadprog_admm_settings_t %s_settings;\n"
+        "quadprog_admm_info_t %s_info;\n"
+        "float %s_dx[N_VAR];\n"
+        "float %s_dy[N_CON + 1];\n\n"
+        "static float x[N_VAR];\n"
+        "static float xt[N_VAR];\n"
+        "static float z[N_CON + 1];\n"
+        "static float zt[N_CON + 1];\n"
+        "static float y[N_CON + 1];\n"
+        "static float rho_vec[N_CON + 1];\n"
+        "static float rho_inv[N_CON + 1];\n"
+        "static float w[N_KKT];\n"
+        "static float Lx[%d];\n"
+        "static float D[N_KKT];\n"
+        "static float D_inv[N_KKT];\n\n\n",
+        name, n, meq, min, p_spec, name, n, meq, m, dim, name, name, name, name,
+        (p_h->sym.lnz > 0)? p_h->sym.lnz : 1);
+
+    emit_factor(p_file, p_h);
+    emit_solve(p_file, p_h);
+    emit_products(p_file);
+    emit_iteration(p_file);
+}
+
+
+int main(int argc, char** argv)
+{
+    static quadprog_admm_t h;
+    char path[512];
+
+    if (3 != argc)
+    {
+        fprintf(stderr, "usage: quadprog_codegen <spec> <output directory>\n");
+        return 1;
+    }
+
+    if (!spec_read(argv[1]) || !analyze(&h))
+    {
+        return 1;
+    }
+
+    const char* p_spec = strrchr(argv[1], '/');
+    p_spec = (NULL != p_spec)? p_spec + 1 : argv[1];
+
+    snprintf(path, sizeof(path), "%s/%s.h", argv[2], name);
+    FILE* p_file = fopen(path, "w");
+    if (NULL == p_file)
+    {
+        fprintf(stderr, "quadprog_codegen: cannot write %s\n", path);
+        return 1;
+    }
+    emit_header(p_file, p_spec, &h);
+    emit_api(p_file);
+    fclose(p_file);
+
+    snprintf(path, sizeof(path), "%s/%s.c", argv[2], name);
+    p_file = fopen(path, "w");
+    if (NULL == p_file)
+    {
+        fprintf(stderr, "quadprog_codegen: cannot write %s\n", path);
+        return 1;
+    }
+    emit_source(p_file, p_spec, &h);
+    fclose(p_file);
+
+    printf("quadprog_codegen: %s.h, %s.c (n = %d, meq = %d, min = %d, %d nonzeros in L)\n", name, name, n, meq, min,
+           h.sym.lnz);
+
+    return 0;
+}